@@ -6,6 +6,8 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 */
 #include "packer.h"
 
+#include "base/binary_delta.h"
+
 #include <QtCore/QtPlugin>
 
 #ifdef Q_OS_MAC
@@ -61,6 +63,7 @@ extern const char *PrivateBetaKey;
 #include "../../../../TelegramPrivate/alpha_private.h" // private key for alpha version file generation
 
 QString countAlphaVersionSignature(quint64 version);
+int writePackage(QByteArray &result, const QString &outName);
 
 // sha1 hash
 typedef unsigned char uchar;
@@ -156,6 +159,8 @@ int main(int argc, char *argv[])
 	QString remove;
 	int version = 0;
 	bool target32 = false;
+	QString deltaPath;
+	int deltaVersion = 0;
 	QFileInfoList files;
 	for (int i = 0; i < argc; ++i) {
 		if (string("-path") == argv[i] && i + 1 < argc) {
@@ -167,6 +172,10 @@ int main(int argc, char *argv[])
 			target32 = (string("mac32") == argv[i + 1]);
 		} else if (string("-version") == argv[i] && i + 1 < argc) {
 			version = QString(argv[i + 1]).toInt();
+		} else if (string("-delta") == argv[i] && i + 1 < argc) {
+			deltaPath = workDir + QString(argv[i + 1]);
+		} else if (string("-deltaversion") == argv[i] && i + 1 < argc) {
+			deltaVersion = QString(argv[i + 1]).toInt();
 		} else if (string("-beta") == argv[i]) {
 			BetaChannel = true;
 		} else if (string("-alpha") == argv[i] && i + 1 < argc) {
@@ -186,14 +195,24 @@ int main(int argc, char *argv[])
 
 	if (files.isEmpty() || remove.isEmpty() || version <= 1016 || version > 999999999) {
 #ifdef Q_OS_WIN
-		cout << "Usage: Packer.exe -path {file} -version {version} OR Packer.exe -path {dir} -version {version}\n";
+		cout << "Usage: Packer.exe -path {file} -version {version} OR Packer.exe -path {dir} -version {version} [-delta {previous version dir} -deltaversion {previous version}]\n";
 #elif defined Q_OS_MAC
-		cout << "Usage: Packer.app -path {file} -version {version} OR Packer.app -path {dir} -version {version}\n";
+		cout << "Usage: Packer.app -path {file} -version {version} OR Packer.app -path {dir} -version {version} [-delta {previous version dir} -deltaversion {previous version}]\n";
 #else
-		cout << "Usage: Packer -path {file} -version {version} OR Packer -path {dir} -version {version}\n";
+		cout << "Usage: Packer -path {file} -version {version} OR Packer -path {dir} -version {version} [-delta {previous version dir} -deltaversion {previous version}]\n";
 #endif
 		return -1;
 	}
+	if (!deltaPath.isEmpty()) {
+		if (!QFileInfo(deltaPath).isDir()) {
+			cout << "Can't find previous version dir '" << deltaPath.toUtf8().constData() << "'\n";
+			return -1;
+		} else if (AlphaVersion || deltaVersion <= 1016 || deltaVersion >= version) {
+			cout << "Delta package needs -deltaversion {previous version} and can't be done for alpha versions\n";
+			return -1;
+		}
+		deltaPath = QFileInfo(deltaPath).canonicalFilePath() + "/";
+	}
 
 	bool hasDirs = true;
 	while (hasDirs) {
@@ -227,21 +246,32 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	QByteArray result;
+	QByteArray result, deltaResult;
 	{
 		QBuffer buffer(&result);
 		buffer.open(QIODevice::WriteOnly);
 		QDataStream stream(&buffer);
 		stream.setVersion(QDataStream::Qt_5_1);
 
+		QBuffer deltaBuffer(&deltaResult);
+		deltaBuffer.open(QIODevice::WriteOnly);
+		QDataStream deltaStream(&deltaBuffer);
+		deltaStream.setVersion(QDataStream::Qt_5_1);
+
 		if (AlphaVersion) {
 			stream << quint32(0x7FFFFFFF);
 			stream << quint64(AlphaVersion);
 		} else {
 			stream << quint32(version);
 		}
+		if (!deltaPath.isEmpty()) {
+			deltaStream << quint32(base::DeltaPackageTag) << quint32(deltaVersion) << quint32(version);
+		}
 
 		stream << quint32(files.size());
+		if (!deltaPath.isEmpty()) {
+			deltaStream << quint32(files.size());
+		}
 		cout << "Found " << files.size() << " file" << (files.size() == 1 ? "" : "s") << "..\n";
 		for (QFileInfoList::iterator i = files.begin(); i != files.end(); ++i) {
 			QFileInfo info(*i);
@@ -259,13 +289,88 @@ int main(int argc, char *argv[])
 #if defined Q_OS_MAC || defined Q_OS_LINUX
 			stream << (QFileInfo(fullName).isExecutable() ? true : false);
 #endif
+
+			if (!deltaPath.isEmpty()) {
+				const auto sha = QCryptographicHash::hash(inner, QCryptographicHash::Sha1);
+				QFile base(deltaPath + name);
+				if (!base.exists()) {
+					deltaStream << name << quint8(base::DeltaFileFull) << sha << inner;
+					cout << "Delta: new file\n";
+				} else if (!base.open(QIODevice::ReadOnly)) {
+					cout << "Can't open '" << base.fileName().toUtf8().constData() << "' for read..\n";
+					return -1;
+				} else {
+					const auto was = base.readAll();
+					if (was == inner) {
+						deltaStream << name << quint8(base::DeltaFileSame) << sha;
+						cout << "Delta: same file\n";
+					} else {
+						const auto patch = base::CountDelta(was, inner);
+						if (patch.size() < inner.size()) {
+							deltaStream << name << quint8(base::DeltaFilePatch) << sha;
+							deltaStream.writeRawData(patch.constData(), patch.size());
+							cout << "Delta: patch (" << patch.size() << ")\n";
+						} else {
+							deltaStream << name << quint8(base::DeltaFileFull) << sha << inner;
+							cout << "Delta: full file\n";
+						}
+					}
+				}
+#if defined Q_OS_MAC || defined Q_OS_LINUX
+				deltaStream << (QFileInfo(fullName).isExecutable() ? true : false);
+#endif
+			}
 		}
 		if (stream.status() != QDataStream::Ok) {
 			cout << "Stream status is bad: " << stream.status() << "\n";
 			return -1;
 		}
+		if (deltaStream.status() != QDataStream::Ok) {
+			cout << "Delta stream status is bad: " << deltaStream.status() << "\n";
+			return -1;
+		}
+	}
+
+#ifdef Q_OS_WIN
+	QString outName(QString("tupdate%1").arg(AlphaVersion ? AlphaVersion : version));
+#elif defined Q_OS_MAC
+	QString outName((target32 ? QString("tmac32upd%1") : QString("tmacupd%1")).arg(AlphaVersion ? AlphaVersion : version));
+#elif defined Q_OS_LINUX32
+	QString outName(QString("tlinux32upd%1").arg(AlphaVersion ? AlphaVersion : version));
+#elif defined Q_OS_LINUX64
+	QString outName(QString("tlinuxupd%1").arg(AlphaVersion ? AlphaVersion : version));
+#else
+#error Unknown platform!
+#endif
+	if (AlphaVersion) {
+		outName += "_" + AlphaSignature;
+	}
+
+	if (const auto error = writePackage(result, outName)) {
+		return error;
+	}
+	if (!deltaPath.isEmpty()) {
+		const QString deltaName = outName + QString("_from%1").arg(deltaVersion);
+		if (const auto error = writePackage(deltaResult, deltaName)) {
+			return error;
+		}
+	}
+
+	if (AlphaVersion) {
+		QString keyName(QString("talpha_%1_key").arg(AlphaVersion));
+		QFile key(keyName);
+		if (!key.open(QIODevice::WriteOnly)) {
+			cout << "Can't open '" << keyName.toUtf8().constData() << "' for write..\n";
+			return -1;
+		}
+		key.write(AlphaSignature.toUtf8());
+		key.close();
 	}
 
+	return 0;
+}
+
+int writePackage(QByteArray &result, const QString &outName) {
 	int32 resultSize = result.size();
 	cout << "Compression start, size: " << resultSize << "\n";
 
@@ -465,20 +570,6 @@ int main(int argc, char *argv[])
 	}
 	cout << "Signature verified!\n";
 	RSA_free(pbKey);
-#ifdef Q_OS_WIN
-	QString outName(QString("tupdate%1").arg(AlphaVersion ? AlphaVersion : version));
-#elif defined Q_OS_MAC
-	QString outName((target32 ? QString("tmac32upd%1") : QString("tmacupd%1")).arg(AlphaVersion ? AlphaVersion : version));
-#elif defined Q_OS_LINUX32
-	QString outName(QString("tlinux32upd%1").arg(AlphaVersion ? AlphaVersion : version));
-#elif defined Q_OS_LINUX64
-	QString outName(QString("tlinuxupd%1").arg(AlphaVersion ? AlphaVersion : version));
-#else
-#error Unknown platform!
-#endif
-	if (AlphaVersion) {
-		outName += "_" + AlphaSignature;
-	}
 	QFile out(outName);
 	if (!out.open(QIODevice::WriteOnly)) {
 		cout << "Can't open '" << outName.toUtf8().constData() << "' for write..\n";
@@ -487,17 +578,6 @@ int main(int argc, char *argv[])
 	out.write(compressed);
 	out.close();
 
-	if (AlphaVersion) {
-		QString keyName(QString("talpha_%1_key").arg(AlphaVersion));
-		QFile key(keyName);
-		if (!key.open(QIODevice::WriteOnly)) {
-			cout << "Can't open '" << keyName.toUtf8().constData() << "' for write..\n";
-			return -1;
-		}
-		key.write(AlphaSignature.toUtf8());
-		key.close();
-	}
-
 	cout << "Update file '" << outName.toUtf8().constData() << "' written successfully!\n";
 
 	return 0;
@@ -13,6 +13,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include <QtCore/QStringList>
 #include <QtCore/QBuffer>
 #include <QtCore/QDataStream>
+#include <QtCore/QCryptographicHash>
 
 #include <zlib.h>
 
@@ -35,6 +36,8 @@ extern "C" {
 #include <string>
 #include <iostream>
 #include <exception>
+#include <unordered_map>
+#include <vector>
 
 using std::string;
 using std::wstring;
@@ -14,6 +14,8 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "data/data_media_types.h"
 #include "data/data_sparse_ids.h"
 #include "data/data_search_controller.h"
+#include "data/data_shared_media_cache.h"
+#include "data/data_history_cache.h"
 #include "data/data_channel_admins.h"
 #include "data/data_session.h"
 #include "data/data_channel.h"
@@ -84,6 +86,7 @@ constexpr auto kSharedMediaLimit = 100;
 constexpr auto kFeedMessagesLimit = 50;
 constexpr auto kReadFeaturedSetsTimeout = crl::time(1000);
 constexpr auto kFileLoaderQueueStopTimeout = crl::time(5000);
+constexpr auto kFileLoaderMaxThreadsCount = 4;
 constexpr auto kFeedReadTimeout = crl::time(1000);
 constexpr auto kStickersByEmojiInvalidateTimeout = crl::time(60 * 60 * 1000);
 constexpr auto kNotifySettingSaveTimeout = crl::time(1000);
@@ -189,7 +192,9 @@ ApiWrap::ApiWrap(not_null<AuthSession*> session)
 , _webPagesTimer([=] { resolveWebPages(); })
 , _draftsSaveTimer([=] { saveDraftsToCloud(); })
 , _featuredSetsReadTimer([=] { readFeaturedSets(); })
-, _fileLoader(std::make_unique<TaskQueue>(kFileLoaderQueueStopTimeout))
+, _fileLoader(std::make_unique<TaskQueue>(
+	kFileLoaderQueueStopTimeout,
+	snap(QThread::idealThreadCount() / 2, 1, kFileLoaderMaxThreadsCount)))
 , _feedReadTimer([=] { readFeeds(); })
 , _proxyPromotionTimer([=] { refreshProxyPromotion(); })
 , _updateNotifySettingsTimer([=] { sendNotifySettingsUpdates(); }) {
@@ -3534,6 +3539,7 @@ void ApiWrap::applyUpdateNoPtsCheck(const MTPUpdate &update) {
 		if (d.vmessage.type() == mtpc_message) { // index forwarded messages to links _overview
 			if (App::checkEntitiesAndViewsUpdate(d.vmessage.c_message())) { // already in blocks
 				LOG(("Skipping message, because it is already in blocks!"));
+				_session->data().historyCache().newMessage(d.vmessage);
 				needToAdd = false;
 			}
 		}
@@ -3592,6 +3598,7 @@ void ApiWrap::applyUpdateNoPtsCheck(const MTPUpdate &update) {
 		if (d.vmessage.type() == mtpc_message) { // index forwarded messages to links _overview
 			if (App::checkEntitiesAndViewsUpdate(d.vmessage.c_message())) { // already in blocks
 				LOG(("Skipping message, because it is already in blocks!"));
+				_session->data().historyCache().newMessage(d.vmessage);
 				needToAdd = false;
 			}
 		}
@@ -3895,6 +3902,10 @@ void ApiWrap::requestSharedMedia(
 	if (prepared.vfilter.type() == mtpc_inputMessagesFilterEmpty) {
 		return;
 	}
+	if (!messageId && slice == SliceType::Before) {
+		// Show the cached slices while the top one is being refreshed.
+		sharedMediaCache()->load(peer, type);
+	}
 
 	auto requestId = request(
 		std::move(prepared)
@@ -3921,6 +3932,7 @@ void ApiWrap::sharedMediaDone(
 		messageId,
 		slice,
 		result);
+	sharedMediaCache()->save(peer, type, messageId, slice, result, parsed);
 	_session->storage().add(Storage::SharedMediaAddSlice(
 		peer->id,
 		type,
@@ -3930,6 +3942,14 @@ void ApiWrap::sharedMediaDone(
 	));
 }
 
+not_null<Data::SharedMediaCache*> ApiWrap::sharedMediaCache() {
+	if (!_sharedMediaCache) {
+		_sharedMediaCache = std::make_unique<Data::SharedMediaCache>(
+			_session);
+	}
+	return _sharedMediaCache.get();
+}
+
 void ApiWrap::requestUserPhotos(
 		not_null<UserData*> user,
 		PhotoId afterId) {
@@ -25,6 +25,7 @@ class mtpFileLoader;
 namespace Data {
 struct UpdatedFileReferences;
 class WallPaper;
+class SharedMediaCache;
 } // namespace Data
 
 namespace InlineBots {
@@ -524,6 +525,7 @@ private:
 		MsgId messageId,
 		SliceType slice,
 		const MTPmessages_Messages &result);
+	not_null<Data::SharedMediaCache*> sharedMediaCache();
 
 	void userPhotosDone(
 		not_null<UserData*> user,
@@ -701,6 +703,7 @@ private:
 		SharedMediaType,
 		MsgId,
 		SliceType>, mtpRequestId> _sharedMediaRequests;
+	std::unique_ptr<Data::SharedMediaCache> _sharedMediaCache;
 
 	base::flat_map<not_null<UserData*>, mtpRequestId> _userPhotosRequests;
 
@@ -14,6 +14,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "data/data_abstract_structure.h"
 #include "data/data_media_types.h"
 #include "data/data_session.h"
+#include "data/data_history_cache.h"
 #include "data/data_document.h"
 #include "history/history.h"
 #include "history/history_location_manager.h"
@@ -173,6 +174,7 @@ namespace App {
 				existing->applyEdition(message);
 			}
 		});
+		Auth().data().historyCache().editMessage(message);
 	}
 
 	void addSavedGif(DocumentData *doc) {
@@ -211,6 +213,7 @@ namespace App {
 				if (type == NewMessageUnread) { // new message, index my forwarded messages to links overview
 					if (checkEntitiesAndViewsUpdate(data)) { // already in blocks
 						LOG(("Skipping message, because it is already in blocks!"));
+						Auth().data().historyCache().newMessage(msg);
 						continue;
 					}
 				}
@@ -0,0 +1,181 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// Delta packages format, written by the Packer and read by the updater.
+namespace base {
+
+constexpr auto DeltaPackageTag = quint32(0x7FFFFFFE);
+
+enum DeltaFileType : quint8 {
+	DeltaFileFull = 0x00,
+	DeltaFilePatch = 0x01,
+	DeltaFileSame = 0x02,
+};
+
+// Patch is a list of operations: copy a part of the previous version file
+// or add new bytes. All the numbers are big-endian, as in QDataStream.
+enum DeltaOperation : quint8 {
+	DeltaEnd = 0x00,
+	DeltaCopy = 0x01, // quint32 offset, quint32 size
+	DeltaAdd = 0x02, // quint32 size, size bytes
+};
+
+namespace details {
+
+// Parts are found by hashes of the aligned blocks
+// of the previous file, like in rsync and VCDIFF encoders.
+constexpr auto kDeltaBlockSize = 32;
+constexpr auto kDeltaMaxCandidates = 16;
+
+inline quint32 DeltaBlockHash(quint32 a, quint32 b) {
+	return (a & 0xFFFF) | (b << 16);
+}
+
+inline void DeltaAppendUint32(QByteArray &delta, quint32 value) {
+	const char data[] = {
+		char((value >> 24) & 0xFF),
+		char((value >> 16) & 0xFF),
+		char((value >> 8) & 0xFF),
+		char(value & 0xFF),
+	};
+	delta.append(data, sizeof(data));
+}
+
+inline void DeltaAppendAdd(QByteArray &delta, const char *data, int size) {
+	if (size > 0) {
+		delta.append(char(DeltaAdd));
+		DeltaAppendUint32(delta, quint32(size));
+		delta.append(data, size);
+	}
+}
+
+inline void DeltaAppendCopy(QByteArray &delta, int offset, int size) {
+	delta.append(char(DeltaCopy));
+	DeltaAppendUint32(delta, quint32(offset));
+	DeltaAppendUint32(delta, quint32(size));
+}
+
+} // namespace details
+
+inline QByteArray CountDelta(const QByteArray &base, const QByteArray &target) {
+	using namespace details;
+
+	const auto from = reinterpret_cast<const uchar*>(base.constData());
+	const auto to = reinterpret_cast<const uchar*>(target.constData());
+	const auto fromSize = base.size();
+	const auto toSize = target.size();
+
+	std::unordered_map<quint32, std::vector<int>> blocks;
+	for (auto offset = 0; offset + kDeltaBlockSize <= fromSize; offset += kDeltaBlockSize) {
+		quint32 a = 0, b = 0;
+		for (auto i = 0; i < kDeltaBlockSize; ++i) {
+			a += from[offset + i];
+			b += a;
+		}
+		auto &list = blocks[DeltaBlockHash(a, b)];
+		if (list.size() < size_t(kDeltaMaxCandidates)) {
+			list.push_back(offset);
+		}
+	}
+
+	QByteArray delta;
+	auto added = 0, position = 0;
+	quint32 a = 0, b = 0;
+	auto hashed = false;
+	while (position + kDeltaBlockSize <= toSize) {
+		if (!hashed) {
+			a = b = 0;
+			for (auto i = 0; i < kDeltaBlockSize; ++i) {
+				a += to[position + i];
+				b += a;
+			}
+			hashed = true;
+		}
+
+		auto bestFrom = 0, bestTo = 0, bestSize = 0;
+		const auto i = blocks.find(DeltaBlockHash(a, b));
+		if (i != blocks.end()) {
+			for (const auto candidate : i->second) {
+				if (memcmp(from + candidate, to + position, kDeltaBlockSize)) {
+					continue;
+				}
+				auto start = 0, end = kDeltaBlockSize;
+				while (candidate + end < fromSize && position + end < toSize && from[candidate + end] == to[position + end]) {
+					++end;
+				}
+				while (candidate - start > 0 && position - start > added && from[candidate - start - 1] == to[position - start - 1]) {
+					++start;
+				}
+				if (start + end > bestSize) {
+					bestFrom = candidate - start;
+					bestTo = position - start;
+					bestSize = start + end;
+				}
+			}
+		}
+
+		if (bestSize) {
+			DeltaAppendAdd(delta, target.constData() + added, bestTo - added);
+			DeltaAppendCopy(delta, bestFrom, bestSize);
+			position = added = bestTo + bestSize;
+			hashed = false;
+		} else {
+			if (position + kDeltaBlockSize < toSize) {
+				const quint32 out = to[position], in = to[position + kDeltaBlockSize];
+				a += in - out;
+				b += a - kDeltaBlockSize * out;
+			}
+			++position;
+		}
+	}
+	DeltaAppendAdd(delta, target.constData() + added, toSize - added);
+	delta.append(char(DeltaEnd));
+	return delta;
+}
+
+// Reads the patch operations from the stream up to DeltaEnd.
+// Calls copy(offset, size) for the base file parts and add(size)
+// for the new bytes, which add() should read from the same stream.
+// Returns false on a bad stream, a bad operation or a failed callback.
+template <typename Copy, typename Add>
+bool ApplyDelta(QDataStream &stream, Copy &&copy, Add &&add) {
+	while (true) {
+		quint8 operation = DeltaEnd;
+		stream >> operation;
+		if (stream.status() != QDataStream::Ok) {
+			return false;
+		}
+		switch (operation) {
+		case DeltaEnd: return true;
+		case DeltaCopy: {
+			quint32 offset = 0, size = 0;
+			stream >> offset >> size;
+			if (stream.status() != QDataStream::Ok || !copy(offset, size)) {
+				return false;
+			}
+		} break;
+		case DeltaAdd: {
+			quint32 size = 0;
+			stream >> size;
+			if (stream.status() != QDataStream::Ok || !add(size)) {
+				return false;
+			}
+		} break;
+		default: return false;
+		}
+	}
+}
+
+} // namespace base
@@ -0,0 +1,157 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "base/binary_delta.h"
+#include <random>
+
+namespace {
+
+constexpr auto kBlockSize = 32;
+
+struct Applied {
+	bool ok = false;
+	QByteArray result;
+	int copies = 0;
+	int added = 0;
+};
+
+QByteArray RandomBytes(int size, unsigned seed) {
+	auto generator = std::mt19937(seed);
+	auto distribution = std::uniform_int_distribution<int>(0, 255);
+	auto result = QByteArray(size, Qt::Uninitialized);
+	for (auto i = 0; i != size; ++i) {
+		result[i] = char(distribution(generator));
+	}
+	return result;
+}
+
+Applied Apply(const QByteArray &base, const QByteArray &patch) {
+	auto result = Applied();
+	QDataStream stream(patch);
+	const auto copy = [&](quint32 offset, quint32 size) {
+		if (quint64(offset) + size > quint64(base.size())) {
+			return false;
+		}
+		result.result.append(base.constData() + offset, int(size));
+		++result.copies;
+		return true;
+	};
+	const auto add = [&](quint32 size) {
+		if (size > quint32(patch.size())) {
+			return false;
+		}
+		auto buffer = QByteArray(int(size), Qt::Uninitialized);
+		if (stream.readRawData(buffer.data(), int(size)) != int(size)) {
+			return false;
+		}
+		result.result.append(buffer);
+		result.added += int(size);
+		return true;
+	};
+	result.ok = base::ApplyDelta(stream, copy, add) && stream.atEnd();
+	return result;
+}
+
+Applied RoundTrip(const QByteArray &base, const QByteArray &target) {
+	auto result = Apply(base, base::CountDelta(base, target));
+	REQUIRE(result.ok);
+	REQUIRE(result.result == target);
+	return result;
+}
+
+} // namespace
+
+TEST_CASE("delta patches restore the target file", "[binary_delta]") {
+	const auto base = RandomBytes(1024, 1);
+
+	SECTION("empty base and empty target") {
+		const auto patch = base::CountDelta(QByteArray(), QByteArray());
+		REQUIRE(patch == QByteArray(1, char(base::DeltaEnd)));
+		const auto result = RoundTrip(QByteArray(), QByteArray());
+		REQUIRE(result.copies == 0);
+		REQUIRE(result.added == 0);
+	}
+	SECTION("empty base") {
+		const auto target = RandomBytes(100, 2);
+		const auto result = RoundTrip(QByteArray(), target);
+		REQUIRE(result.copies == 0);
+		REQUIRE(result.added == target.size());
+	}
+	SECTION("empty target") {
+		const auto result = RoundTrip(base, QByteArray());
+		REQUIRE(result.copies == 0);
+		REQUIRE(result.added == 0);
+	}
+	SECTION("no matches") {
+		const auto target = RandomBytes(1024, 3);
+		const auto result = RoundTrip(base, target);
+		REQUIRE(result.copies == 0);
+		REQUIRE(result.added == target.size());
+	}
+	SECTION("same file") {
+		const auto result = RoundTrip(base, base);
+		REQUIRE(result.copies == 1);
+		REQUIRE(result.added == 0);
+	}
+	SECTION("match at the end of the file") {
+		// The match starts in the middle of a block of the base file.
+		const auto prefix = RandomBytes(100, 4);
+		const auto target = prefix + base.right(3 * kBlockSize - 6);
+		const auto result = RoundTrip(base, target);
+		REQUIRE(result.copies == 1);
+		REQUIRE(result.added <= prefix.size());
+	}
+	SECTION("match in the middle of the file") {
+		const auto target = RandomBytes(50, 5)
+			+ base.mid(300, 200)
+			+ RandomBytes(70, 6);
+		const auto result = RoundTrip(base, target);
+		REQUIRE(result.copies == 1);
+		REQUIRE(result.added <= 120);
+	}
+	SECTION("trailing tail shorter than a block") {
+		const auto tail = RandomBytes(kBlockSize - 22, 7);
+		const auto result = RoundTrip(base, base + tail);
+		REQUIRE(result.copies == 1);
+		REQUIRE(result.added == tail.size());
+	}
+	SECTION("base tail shorter than a block") {
+		// The last bytes of the base are not hashed, still they are copied.
+		const auto shorter = base.left(1000);
+		const auto result = RoundTrip(shorter, shorter);
+		REQUIRE(result.copies == 1);
+		REQUIRE(result.added == 0);
+	}
+	SECTION("target shorter than a block") {
+		const auto result = RoundTrip(base, base.left(kBlockSize - 1));
+		REQUIRE(result.copies == 0);
+		REQUIRE(result.added == kBlockSize - 1);
+	}
+}
+
+TEST_CASE("bad delta patches are rejected", "[binary_delta]") {
+	const auto base = RandomBytes(256, 8);
+	const auto target = RandomBytes(40, 9) + base.mid(64, 128);
+	const auto patch = base::CountDelta(base, target);
+	REQUIRE(Apply(base, patch).ok);
+
+	SECTION("patch without the end operation") {
+		REQUIRE(!Apply(base, patch.left(patch.size() - 1)).ok);
+	}
+	SECTION("truncated patch") {
+		REQUIRE(!Apply(base, patch.left(patch.size() / 2)).ok);
+	}
+	SECTION("unknown operation") {
+		auto bad = patch;
+		bad[0] = char(0x7F);
+		REQUIRE(!Apply(base, bad).ok);
+	}
+	SECTION("copy outside of the base file") {
+		REQUIRE(!Apply(base.left(100), patch).ok);
+	}
+}
@@ -42,6 +42,7 @@ void AbstractRemoteFile::setLink(const QUrl &link)
 
 		_link = link;
 
+		abortDownload();
 		stopDownloadLaterTimer();
 		download();
 		emit linkChanged();
@@ -58,6 +59,16 @@ void AbstractRemoteFile::setLastDownloadTime(QDateTime lastDownloadTime)
 	_lastDownloadTime = lastDownloadTime;
 }
 
+bool AbstractRemoteFile::isDownloadEnabled() const
+{
+	return _isDownloadEnabled;
+}
+
+void AbstractRemoteFile::setIsDownloadEnabled(bool isDownloadEnabled)
+{
+	_isDownloadEnabled = isDownloadEnabled;
+}
+
 bool AbstractRemoteFile::isNeedToDownload() const
 {
 	return customIsNeedToDownload();
@@ -83,7 +94,7 @@ void AbstractRemoteFile::download()
 		return;
 	}
 
-	if (_isDownloading) {
+	if (_isDownloading || !_isDownloadEnabled) {
 		return;
 	}
 
@@ -92,6 +103,7 @@ void AbstractRemoteFile::download()
 	}
 
 	_isDownloading = true;
+	downloadStarted();
 
 	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
 
@@ -100,10 +112,33 @@ void AbstractRemoteFile::download()
 
 	QNetworkReply *reply = networkManager->get(request);
 
+	_reply = reply;
+	_isFinishedEarly = false;
+
+	if (isStreamed()) {
+		connect(reply, &QNetworkReply::readyRead, this, [this, reply]() {
+			if (_reply == reply && !_isFinishedEarly) {
+				dataPartDownloaded(reply->readAll());
+			}
+		});
+	}
+
 	connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+		if (_reply != reply) {
+			// The downloading has been stopped due timeout
+			return;
+		}
+
+		_reply = nullptr;
 		_isDownloading = false;
 
-		if(reply->error() == QNetworkReply::NoError) {
+		if (_isFinishedEarly) {
+			_isFinishedEarly = false;
+			_failedCount = 0;
+			dataDownloaded(QByteArray());
+			_lastDownloadTime = QDateTime::currentDateTime();
+			emit downloaded();
+		} else if(reply->error() == QNetworkReply::NoError) {
 			_failedCount = 0;
 			dataDownloaded(reply->readAll());
 			_lastDownloadTime = QDateTime::currentDateTime();
@@ -138,6 +173,10 @@ void AbstractRemoteFile::download()
 
 	QTimer::singleShot(BettergramService::networkTimeout(), Qt::VeryCoarseTimer, networkManager,
 					   [networkManager, reply, this] {
+		if (_reply == reply) {
+			_reply = nullptr;
+		}
+
 		_isDownloading = false;
 		_failedCount++;
 
@@ -157,6 +196,30 @@ void AbstractRemoteFile::download()
 	});
 }
 
+void AbstractRemoteFile::finishDownloadingEarly()
+{
+	if (_reply && !_isFinishedEarly) {
+		_isFinishedEarly = true;
+
+		// It emits finished() signal
+		_reply->abort();
+	}
+}
+
+void AbstractRemoteFile::abortDownload()
+{
+	if (_reply) {
+		QNetworkReply *reply = _reply;
+
+		_reply = nullptr;
+		_isDownloading = false;
+		_isFinishedEarly = false;
+
+		// It emits finished() signal that is ignored for the old reply
+		reply->abort();
+	}
+}
+
 void AbstractRemoteFile::timerEvent(QTimerEvent *timerEvent)
 {
 	stopDownloadLaterTimer();
@@ -192,4 +255,18 @@ bool AbstractRemoteFile::checkLink(const QUrl &link)
 	return true;
 }
 
+bool AbstractRemoteFile::isStreamed() const
+{
+	return false;
+}
+
+void AbstractRemoteFile::dataPartDownloaded(const QByteArray &data)
+{
+	Q_UNUSED(data);
+}
+
+void AbstractRemoteFile::downloadStarted()
+{
+}
+
 } // namespace Bettergrams
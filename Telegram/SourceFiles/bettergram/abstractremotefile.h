@@ -2,6 +2,8 @@
 
 #include <QObject>
 
+class QNetworkReply;
+
 namespace Bettergram {
 
 /**
@@ -25,6 +27,10 @@ public:
 
 	bool isNeedToDownload() const;
 
+	/// Downloads are not started while it is disabled
+	bool isDownloadEnabled() const;
+	void setIsDownloadEnabled(bool isDownloadEnabled);
+
 	void downloadIfNeeded();
 	void forceDownload();
 
@@ -41,9 +47,22 @@ protected:
 
 	virtual bool checkLink(const QUrl &link);
 
+	/// Return true to get data by parts while it is downloading, see dataPartDownloaded()
+	virtual bool isStreamed() const;
+
+	/// It is called only for streamed files, dataDownloaded() is called after that with the rest of data
+	virtual void dataPartDownloaded(const QByteArray &data);
+
+	/// It is called before each download attempt, including retries and downloads of a changed link
+	virtual void downloadStarted();
+
 	void download();
 	void stopDownloadLaterTimer();
 
+	/// Stop the current downloading if we already have enough data.
+	/// The file is marked as downloaded and dataDownloaded() is called with empty data
+	void finishDownloadingEarly();
+
 	void timerEvent(QTimerEvent *timerEvent) override;
 
 private:
@@ -51,9 +70,13 @@ private:
 	QDateTime _lastDownloadTime;
 	int _failedCount = 0;
 	bool _isDownloading = false;
+	bool _isDownloadEnabled = true;
+	bool _isFinishedEarly = false;
 	int _downloadLaterTimerId = 0;
+	QNetworkReply *_reply = nullptr;
 
 	void downloadLater();
+	void abortDownload();
 };
 
 } // namespace Bettergram
@@ -109,6 +109,16 @@ void BaseArticlePreviewItem::setImageLink(const QUrl &url)
 	_image.setLink(url);
 }
 
+void BaseArticlePreviewItem::setIsImageDownloadEnabled(bool isImageDownloadEnabled)
+{
+	_image.setIsDownloadEnabled(isImageDownloadEnabled);
+}
+
+const QUrl &BaseArticlePreviewItem::imageLink() const
+{
+	return _image.link();
+}
+
 bool BaseArticlePreviewItem::isImageLinkValid() const
 {
 	return _image.link().isValid();
@@ -35,6 +35,7 @@ public:
 	const QString &description() const;
 
 	const QUrl &link() const;
+	const QUrl &imageLink() const;
 
 	const QDateTime &publishDate() const;
 	const QString &publishDateString() const;
@@ -62,6 +63,7 @@ protected:
 	void setLink(const QUrl &link);
 	void setPublishDate(const QDateTime &publishDate);
 	void setImageLink(const QUrl &url);
+	void setIsImageDownloadEnabled(bool isImageDownloadEnabled);
 
 	bool isImageLinkValid() const;
 
@@ -0,0 +1,658 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "catch.hpp"
+
+#include "bettergram/rsschannel.h"
+#include "bettergram/rssitem.h"
+#include "bettergram/imagefromsite.h"
+#include "bettergram/siteimagescanner.h"
+#include "bettergram/remotejsonresource.h"
+#include "bettergram/cryptopricehistory.h"
+#include "bettergram/cryptopricelist.h"
+#include "bettergram/cryptoprice.h"
+#include "bettergram/resourcegrouplist.h"
+#include "bettergram/resourcegroup.h"
+#include "bettergram/resourceitem.h"
+
+#include <atomic>
+#include <iostream>
+#include <new>
+
+// We count allocations of the whole test binary to measure allocations of the data layer
+
+namespace {
+
+std::atomic<quint64> AllocationsCount = { 0 };
+
+} // namespace
+
+void *operator new(std::size_t size) {
+	AllocationsCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (void *result = std::malloc(size ? size : 1)) {
+		return result;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+using namespace Bettergram;
+
+namespace {
+
+constexpr auto kImageWidth = 100;
+constexpr auto kImageHeight = 60;
+constexpr auto kIconSize = 24;
+
+// Fixtures are built from the items recorded from real feeds,
+// the count of items is increased to make the measurements stable.
+
+const auto kRecordedRssItem = QString(
+	"<item>"
+	"<title><![CDATA[Bitcoin Price Analysis: BTC Bulls Target Fresh Highs %1]]></title>"
+	"<link>https://www.newsbtc.com/2018/10/15/bitcoin-price-analysis-%1/</link>"
+	"<comments>https://www.newsbtc.com/2018/10/15/bitcoin-price-analysis-%1/#respond</comments>"
+	"<pubDate>%2</pubDate>"
+	"<dc:creator><![CDATA[Aayush Jindal]]></dc:creator>"
+	"<category><![CDATA[Analysis]]></category>"
+	"<category><![CDATA[Bitcoin]]></category>"
+	"<guid isPermaLink=\"false\">https://www.newsbtc.com/?p=%1</guid>"
+	"<description><![CDATA[<p>Bitcoin price started a decent upward move above the $6,300 "
+	"resistance against the US Dollar. BTC/USD is currently placed nicely above $6,400 and it "
+	"could extend gains above $6,500.</p><p>The post <a rel=\"nofollow\" "
+	"href=\"https://www.newsbtc.com/2018/10/15/bitcoin-price-analysis-%1/\">Bitcoin Price "
+	"Analysis</a> appeared first on <a rel=\"nofollow\" href=\"https://www.newsbtc.com\">"
+	"NewsBTC</a>.</p>]]></description>"
+	"<enclosure url=\"https://www.newsbtc.com/wp-content/uploads/2018/10/bitcoin-%1-600x400.jpg\" "
+	"length=\"52340\" type=\"image/jpeg\" />"
+	"</item>");
+
+const auto kRecordedAtomEntry = QString(
+	"<entry>"
+	"<id>yt:video:dQw4w9WgXcQ%1</id>"
+	"<yt:videoId>dQw4w9WgXcQ%1</yt:videoId>"
+	"<title>Crypto Market Update %1: What Is Next For Bitcoin?</title>"
+	"<link rel=\"alternate\" href=\"https://www.youtube.com/watch?v=dQw4w9WgXcQ%1\"/>"
+	"<author><name>Crypto Channel</name><uri>https://www.youtube.com/channel/UC%1</uri></author>"
+	"<published>%2</published>"
+	"<updated>%2</updated>"
+	"<media:group>"
+	"<media:title>Crypto Market Update %1: What Is Next For Bitcoin?</media:title>"
+	"<media:content url=\"https://www.youtube.com/v/dQw4w9WgXcQ%1\" type=\"application/x-shockwave-flash\" "
+	"width=\"640\" height=\"390\"/>"
+	"<media:thumbnail url=\"https://i4.ytimg.com/vi/dQw4w9WgXcQ%1/hqdefault.jpg\" width=\"480\" height=\"360\"/>"
+	"<media:description>Today we look at the charts of the top cryptocurrencies.</media:description>"
+	"</media:group>"
+	"</entry>");
+
+const auto kRecordedImageTag = QString(
+	"<div class=\"td-module-thumb\"><a href=\"https://www.newsbtc.com/2018/10/15/post-%1/\" "
+	"rel=\"bookmark\" title=\"Post %1\"><img width=\"%2\" height=\"%3\" class=\"entry-thumb\" "
+	"src=\"https://www.newsbtc.com/wp-content/uploads/2018/10/post-%1-%2x%3.jpg\" "
+	"alt=\"\" title=\"Post %1\"/></a></div>\n");
+
+QByteArray createRssFeed(int itemsCount, int firstItem = 0) {
+	QString result = QStringLiteral(
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		"<rss version=\"2.0\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\">"
+		"<channel>"
+		"<title>NewsBTC</title>"
+		"<link>https://www.newsbtc.com</link>"
+		"<description>Bitcoin and Cryptocurrency News</description>"
+		"<language>en-US</language>"
+		"<skipHours><hour>3</hour><hour>4</hour></skipHours>");
+
+	const QDateTime now = QDateTime::currentDateTimeUtc();
+
+	for (int i = firstItem; i < firstItem + itemsCount; ++i) {
+		result += kRecordedRssItem
+			.arg(i)
+			.arg(now.addSecs(-i * 60).toString(Qt::RFC2822Date));
+	}
+
+	result += QStringLiteral("</channel></rss>");
+	return result.toUtf8();
+}
+
+QByteArray createAtomFeed(int itemsCount) {
+	QString result = QStringLiteral(
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		"<feed xmlns:yt=\"http://www.youtube.com/xml/schemas/2015\" "
+		"xmlns:media=\"http://search.yahoo.com/mrss/\" xmlns=\"http://www.w3.org/2005/Atom\">"
+		"<title>Crypto Channel</title>"
+		"<link rel=\"alternate\" href=\"https://www.youtube.com/channel/UC\"/>");
+
+	const QDateTime now = QDateTime::currentDateTimeUtc();
+
+	for (int i = 0; i < itemsCount; ++i) {
+		result += kRecordedAtomEntry
+			.arg(i)
+			.arg(now.addSecs(-i * 60).toString(Qt::ISODate));
+	}
+
+	result += QStringLiteral("</feed>");
+	return result.toUtf8();
+}
+
+QString createSiteHtml(int imagesCount, int largestImage) {
+	QString result = QStringLiteral(
+		"<!DOCTYPE html><html lang=\"en-US\"><head><meta charset=\"UTF-8\" />"
+		"<title>NewsBTC</title></head><body>\n");
+
+	for (int i = 0; i < imagesCount; ++i) {
+		const bool isLargest = (i == largestImage);
+
+		result += kRecordedImageTag
+			.arg(i)
+			.arg(isLargest ? 400 : 100)
+			.arg(isLargest ? 250 : 70);
+	}
+
+	result += QStringLiteral("</body></html>");
+	return result;
+}
+
+// The RSS items remove html tags by QTextDocument, so we need a gui application
+void ensureApplication() {
+	if (QCoreApplication::instance()) {
+		return;
+	}
+
+	static int argc = 1;
+	static char name[] = "tests_bettergram";
+	static char *argv[] = { name, nullptr };
+
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	new QGuiApplication(argc, argv);
+}
+
+// The recorded responses are copied next to the test binary by tests.gyp
+QByteArray readTestData(const QString &name) {
+	ensureApplication();
+
+	QFile file(QCoreApplication::applicationDirPath()
+		+ QStringLiteral("/tests_bettergram_data/")
+		+ name);
+
+	if (!file.open(QIODevice::ReadOnly)) {
+		return QByteArray();
+	}
+
+	return file.readAll();
+}
+
+template <typename Callback>
+void measure(const char *name, int repeats, Callback &&callback) {
+	const quint64 allocationsBefore = AllocationsCount.load();
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for (int i = 0; i < repeats; ++i) {
+		callback();
+	}
+
+	const qint64 elapsed = timer.nsecsElapsed();
+	const quint64 allocations = AllocationsCount.load() - allocationsBefore;
+
+	std::cout
+		<< name << ": "
+		<< (elapsed / repeats / 1000) << " us, "
+		<< (allocations / repeats) << " allocations per run"
+		<< std::endl;
+}
+
+QSharedPointer<RssChannel> parseFeed(const QByteArray &source) {
+	const auto channel = QSharedPointer<RssChannel>(
+		new RssChannel(QUrl("https://www.newsbtc.com/feed/"), kImageWidth, kImageHeight));
+
+	// We do not run an event loop here, so the downloads would never be finished
+	channel->setIsImagesFetchingEnabled(false);
+	channel->fetchingSucceed(source, QByteArray(), QByteArray(), 0);
+	channel->parse();
+
+	return channel;
+}
+
+} // namespace
+
+TEST_CASE("RSS channel parses RSS 2.0 feeds", "[bettergram]") {
+	ensureApplication();
+
+	const QByteArray source = createRssFeed(50);
+	const auto channel = parseFeed(source);
+
+	REQUIRE(channel->title() == "NewsBTC");
+	REQUIRE(channel->language() == "en-US");
+	REQUIRE(channel->skipHours() == "3,4");
+	REQUIRE(channel->count() == 50);
+
+	SECTION("items are sorted from the newest one") {
+		for (int i = 1; i < channel->count(); ++i) {
+			REQUIRE(channel->at(i - 1)->publishDate() >= channel->at(i)->publishDate());
+		}
+	}
+
+	SECTION("html tags are removed from descriptions") {
+		REQUIRE(!channel->at(0)->description().contains('<'));
+		REQUIRE(channel->at(0)->description().startsWith("Bitcoin price started"));
+	}
+
+	SECTION("merging the next feeds keeps existing items and adds new ones") {
+		channel->fetchingSucceed(createRssFeed(50, 10), QByteArray(), QByteArray(), 0);
+		REQUIRE(channel->parse());
+		REQUIRE(channel->count() == 60);
+	}
+
+	SECTION("the same feeds are not parsed twice") {
+		channel->fetchingSucceed(source, QByteArray(), QByteArray(), 0);
+		REQUIRE(!channel->parse());
+		REQUIRE(channel->count() == 50);
+	}
+}
+
+TEST_CASE("RSS channel parses Atom feeds", "[bettergram]") {
+	ensureApplication();
+
+	const auto channel = parseFeed(createAtomFeed(30));
+
+	REQUIRE(channel->title() == "Crypto Channel");
+	REQUIRE(channel->count() == 30);
+	REQUIRE(channel->at(0)->title() == "Crypto Market Update 0: What Is Next For Bitcoin?");
+	REQUIRE(channel->at(0)->link() == QUrl("https://www.youtube.com/watch?v=dQw4w9WgXcQ0"));
+}
+
+TEST_CASE("site image scanner finds the largest image", "[bettergram]") {
+	const QByteArray source = createSiteHtml(20, 7).toUtf8();
+	const QUrl largestImage("https://www.newsbtc.com/wp-content/uploads/2018/10/post-7-400x250.jpg");
+
+	SECTION("in the whole source") {
+		REQUIRE(SiteImageScanner::findImageLink(source) == largestImage);
+		REQUIRE(ImageFromSite::findLargestImageLink(QString::fromUtf8(source)) == largestImage);
+	}
+
+	SECTION("in the source split to small parts") {
+		SiteImageScanner scanner;
+
+		for (int i = 0; i < source.size(); i += 13) {
+			scanner.append(source.mid(i, 13));
+		}
+
+		REQUIRE(!scanner.isFinished());
+
+		scanner.finish();
+
+		REQUIRE(scanner.isFinished());
+		REQUIRE(scanner.imageLink() == largestImage);
+	}
+
+	SECTION("in file names") {
+		const QByteArray links =
+			"<script>var images = [\"https://www.newsbtc.com/uploads/small-100x70.jpg\", "
+			"\"https://www.newsbtc.com/uploads/large-400x250.png\"];</script>";
+
+		REQUIRE(SiteImageScanner::findImageLink(links)
+				== QUrl("https://www.newsbtc.com/uploads/large-400x250.png"));
+	}
+
+	SECTION("at a page without images") {
+		REQUIRE(!SiteImageScanner::findImageLink("<html><body></body></html>").isValid());
+	}
+}
+
+TEST_CASE("site image scanner stops at a good enough image", "[bettergram]") {
+	SECTION("the og:image meta tag is preferred") {
+		const QByteArray head =
+			"<html><head><META property='og:image' content=\"https://www.newsbtc.com/og.jpg?a=1&amp;b=2\">"
+			"</head>";
+
+		SiteImageScanner scanner;
+		scanner.append(head);
+
+		REQUIRE(scanner.isFinished());
+		REQUIRE(scanner.imageLink() == QUrl("https://www.newsbtc.com/og.jpg?a=1&b=2"));
+	}
+
+	SECTION("the rest of the page is not needed after a large image") {
+		SiteImageScanner scanner;
+
+		scanner.append("<body><img src=\"https://www.newsbtc.com/large.jpg\" width=\"800\" ");
+		REQUIRE(!scanner.isFinished());
+
+		scanner.append("height=\"600\"><img src=\"https://www.newsbtc.com/larger.jpg\" width=\"1600\" height=\"1200\">");
+		REQUIRE(scanner.isFinished());
+		REQUIRE(scanner.imageLink() == QUrl("https://www.newsbtc.com/large.jpg"));
+	}
+}
+
+TEST_CASE("remote json resource gives the persisted data to the parser", "[bettergram]") {
+	QTemporaryDir dir;
+	REQUIRE(dir.isValid());
+
+	const QString cachePath = dir.filePath("cache/resources.json");
+	const QString defaultPath = dir.filePath("default-resources.json");
+
+	const auto writeFile = [](const QString &path, const QByteArray &data) {
+		QDir().mkpath(QFileInfo(path).absolutePath());
+
+		QFile file(path);
+		REQUIRE(file.open(QIODevice::WriteOnly));
+		file.write(data);
+	};
+
+	QList<QByteArray> parsed;
+
+	const auto parser = [&parsed](const QByteArray &data) {
+		if (!QJsonDocument::fromJson(data).isObject()) {
+			return false;
+		}
+
+		parsed.push_back(data);
+		return true;
+	};
+
+	writeFile(defaultPath, "{\"groups\":[]}");
+
+	SECTION("the default data is used without the persisted one") {
+		RemoteJsonResource resource(QUrl("https://api.bettergram.io/v1/resources"), cachePath, parser, nullptr);
+		resource.setDefaultPath(defaultPath);
+
+		REQUIRE(resource.load());
+		REQUIRE(parsed == QList<QByteArray>({ "{\"groups\":[]}" }));
+	}
+
+	SECTION("the persisted data is preferred") {
+		writeFile(cachePath, "{\"freq\":60,\"groups\":[]}");
+
+		RemoteJsonResource resource(QUrl("https://api.bettergram.io/v1/resources"), cachePath, parser, nullptr);
+		resource.setDefaultPath(defaultPath);
+
+		REQUIRE(resource.load());
+		REQUIRE(parsed == QList<QByteArray>({ "{\"freq\":60,\"groups\":[]}" }));
+	}
+
+	SECTION("the wrong persisted data is ignored") {
+		writeFile(cachePath, "{\"groups\":");
+
+		RemoteJsonResource resource(QUrl("https://api.bettergram.io/v1/resources"), cachePath, parser, nullptr);
+		resource.setDefaultPath(defaultPath);
+
+		REQUIRE(resource.load());
+		REQUIRE(parsed == QList<QByteArray>({ "{\"groups\":[]}" }));
+	}
+
+	SECTION("there is nothing to load") {
+		RemoteJsonResource resource(QUrl("https://api.bettergram.io/v1/resources"), cachePath, parser, nullptr);
+
+		REQUIRE(!resource.load());
+		REQUIRE(parsed.isEmpty());
+	}
+}
+
+TEST_CASE("crypto price history keeps one sample per interval", "[bettergram]") {
+	CryptoPriceHistory history;
+
+	// The start is aligned to the sample interval, so every 5 samples
+	// one minute apart fall into one interval
+	const quint32 start = 1500000000;
+	const int samplesPerInterval = CryptoPriceHistory::_sampleInterval / 60;
+
+	REQUIRE(start % CryptoPriceHistory::_sampleInterval == 0);
+
+	for (int i = 0; i < 1000; ++i) {
+		history.add("BTC", QDateTime::fromSecsSinceEpoch(start + i * 60, Qt::UTC), 6400.0 + i);
+	}
+
+	const CryptoPriceHistory::Series *series = history.find("BTC");
+
+	REQUIRE(series != nullptr);
+	REQUIRE(series->count() == 1000 / samplesPerInterval);
+	REQUIRE(series->count() <= CryptoPriceHistory::_capacity);
+
+	for (int i = 0; i < series->count(); ++i) {
+		// The latest sample of the interval is kept
+		const int last = (i + 1) * samplesPerInterval - 1;
+
+		REQUIRE(series->timeAt(i) / CryptoPriceHistory::_sampleInterval
+				== start / CryptoPriceHistory::_sampleInterval + i);
+		REQUIRE(series->timeAt(i) == start + last * 60);
+		REQUIRE(series->priceAt(i) == 6400.0f + last);
+	}
+
+	REQUIRE(history.find("ETH") == nullptr);
+}
+
+TEST_CASE("crypto price history prepared in advance is taken by load", "[bettergram]") {
+	QTemporaryDir dir;
+	REQUIRE(dir.isValid());
+
+	const QString filePath = dir.filePath("history.bin");
+
+	CryptoPriceHistory saved;
+	saved.add("BTC", QDateTime::currentDateTimeUtc(), 6400.0);
+	saved.save(filePath);
+
+	CryptoPriceHistory::prepare(filePath);
+
+	CryptoPriceHistory other;
+	other.load(dir.filePath("other.bin"));
+	REQUIRE(other.find("BTC") == nullptr);
+
+	// The file is not read again
+	QFile::remove(filePath);
+
+	CryptoPriceHistory history;
+	history.load(filePath);
+
+	REQUIRE(history.find("BTC") != nullptr);
+	REQUIRE(history.find("BTC")->priceAt(0) == 6400.0f);
+}
+
+TEST_CASE("crypto price list parses the recorded responses", "[bettergram]") {
+	const QByteArray names = readTestData("currencies.json");
+	const QByteArray values = readTestData("coins.json");
+
+	REQUIRE(!names.isEmpty());
+	REQUIRE(!values.isEmpty());
+
+	CryptoPriceList list(kIconSize, nullptr);
+	list.setIsIconsFetchingEnabled(false);
+	list.parseNames(names);
+
+	REQUIRE(list.areNamesFetched());
+
+	SECTION("only coins are taken from the names") {
+		REQUIRE(list.count() == 50);
+		REQUIRE(list.at(0)->shortName() == "BTC");
+		REQUIRE(list.at(3)->url() == QUrl("https://www.livecoinwatch.com/price/BitcoinCash-BCH"));
+		REQUIRE(list.at(3)->iconUrl() == QUrl("https://www.livecoinwatch.com/images/icons32/bch.png"));
+	}
+
+	SECTION("values are set to the coins with the same names") {
+		const QUrl url("https://api.bettergram.io/v1/coins?sort=rank&order=ascending&offset=0&limit=50");
+		QList<QSharedPointer<CryptoPrice>> updated;
+
+		QObject::connect(&list, &CryptoPriceList::valuesUpdated, [&updated](
+				const QUrl &,
+				const QList<QSharedPointer<CryptoPrice>> &prices) {
+			updated = prices;
+		});
+
+		list.parseValues(values, url, "\"5d41402abc4b2a76\"");
+
+		REQUIRE(updated.size() == 50);
+		REQUIRE(updated.at(0) == list.at(0));
+		REQUIRE(updated.at(0)->rank() == 1);
+		REQUIRE(*updated.at(0)->currentPrice() == Approx(6481.42));
+		REQUIRE(*updated.at(0)->changeFor24Hours() == Approx(-0.88));
+		REQUIRE(updated.at(0)->minuteDirection() == CryptoPrice::Direction::Up);
+		REQUIRE(updated.at(1)->minuteDirection() == CryptoPrice::Direction::Down);
+		REQUIRE(updated.at(2)->minuteDirection() == CryptoPrice::Direction::None);
+		REQUIRE(list.valuesETag(url) == "\"5d41402abc4b2a76\"");
+		REQUIRE(list.valuesETag(QUrl("https://api.bettergram.io/v1/coins")).isEmpty());
+	}
+
+	SECTION("merging the same names keeps the coins") {
+		const QSharedPointer<CryptoPrice> bitcoin = list.at(0);
+
+		list.parseNames(names);
+
+		REQUIRE(list.count() == 50);
+		REQUIRE(list.at(0) == bitcoin);
+	}
+
+	SECTION("merging the names removes the absent coins") {
+		QJsonObject json = QJsonDocument::fromJson(names).object();
+		QJsonArray data = json.value("data").toArray();
+
+		data.removeFirst();
+		json.insert("data", data);
+
+		list.parseNames(QJsonDocument(json).toJson(QJsonDocument::Compact));
+
+		REQUIRE(list.count() == 49);
+		REQUIRE(list.at(0)->shortName() == "ETH");
+	}
+
+	SECTION("the names are searched locally") {
+		list.setSearchText("bitcoin");
+
+		REQUIRE(!list.isSearchInProgress());
+		REQUIRE(list.count() == 4);
+		REQUIRE(list.at(0)->shortName() == "BTC");
+	}
+}
+
+TEST_CASE("resource group list parses the recorded resources", "[bettergram]") {
+	ResourceGroupList list(kIconSize, nullptr);
+	list.setIsIconsFetchingEnabled(false);
+
+	int updatedCount = 0;
+
+	QObject::connect(&list, &ResourceGroupList::updated, [&updatedCount] {
+		++updatedCount;
+	});
+
+	SECTION("the default resources") {
+		REQUIRE(list.parse(readTestData("default-resources.json")));
+		REQUIRE(list.count() == 5);
+		REQUIRE(list.at(0)->title() == "Our favorite exchanges");
+		REQUIRE(list.at(0)->count() == 2);
+		REQUIRE(list.at(0)->at(0)->link() == QUrl("https://www.binance.com"));
+		REQUIRE(updatedCount == 1);
+	}
+
+	SECTION("the server response") {
+		const QByteArray resources = readTestData("resources.json");
+
+		REQUIRE(list.parse(resources));
+		REQUIRE(list.count() == 5);
+		REQUIRE(list.freq() == 3600);
+
+		const QSharedPointer<ResourceItem> binance = list.at(0)->at(0);
+
+		SECTION("the same resources do not update the list") {
+			REQUIRE(list.parse(resources));
+			REQUIRE(updatedCount == 1);
+			REQUIRE(list.at(0)->at(0) == binance);
+		}
+
+		SECTION("the changed resources reuse the same items") {
+			QJsonObject json = QJsonDocument::fromJson(resources).object();
+			QJsonObject resourcesJson = json.value("resources").toObject();
+			QJsonArray groups = resourcesJson.value("groups").toArray();
+
+			groups.removeLast();
+			resourcesJson.insert("groups", groups);
+			json.insert("resources", resourcesJson);
+
+			REQUIRE(list.parse(QJsonDocument(json).toJson(QJsonDocument::Compact)));
+			REQUIRE(updatedCount == 2);
+			REQUIRE(list.count() == 4);
+			REQUIRE(list.at(0)->at(0) == binance);
+		}
+	}
+}
+
+// Benchmarks are hidden from the default run, use "tests_bettergram [benchmark]" to run them
+TEST_CASE("benchmarks of the Bettergram data layer", "[.][benchmark]") {
+	ensureApplication();
+
+	const QByteArray largeRssFeed = createRssFeed(500);
+	const QByteArray nextRssFeed = createRssFeed(500, 50);
+	const QByteArray largeAtomFeed = createAtomFeed(500);
+	const QByteArray largeSite = createSiteHtml(2000, 1999).toUtf8();
+
+	measure("RssChannel::parse, RSS 2.0, 500 items", 5, [&] {
+		parseFeed(largeRssFeed);
+	});
+
+	measure("RssChannel::parse, Atom, 500 items", 5, [&] {
+		parseFeed(largeAtomFeed);
+	});
+
+	const auto channel = parseFeed(largeRssFeed);
+
+	measure("RssChannel::parse with merge, 500 items", 5, [&] {
+		channel->fetchingSucceed(nextRssFeed, QByteArray(), QByteArray(), 0);
+		channel->parse();
+		channel->fetchingSucceed(largeRssFeed, QByteArray(), QByteArray(), 0);
+		channel->parse();
+	});
+
+	measure("SiteImageScanner::findImageLink, 2000 images", 20, [&] {
+		SiteImageScanner::findImageLink(largeSite);
+	});
+
+	measure("SiteImageScanner::append by 16 KB parts, 2000 images", 20, [&] {
+		SiteImageScanner scanner;
+
+		for (int i = 0; i < largeSite.size(); i += 16 * 1024) {
+			scanner.append(largeSite.mid(i, 16 * 1024));
+		}
+
+		scanner.finish();
+	});
+
+	const QByteArray names = readTestData("currencies.json");
+	const QByteArray values = readTestData("coins.json");
+	const QByteArray resources = readTestData("resources.json");
+
+	CryptoPriceList priceList(kIconSize, nullptr);
+	priceList.setIsIconsFetchingEnabled(false);
+
+	measure("CryptoPriceList::parseNames, recorded names", 20, [&] {
+		priceList.parseNames(names);
+	});
+
+	measure("CryptoPriceList::parseValues, recorded values", 20, [&] {
+		priceList.parseValues(values, QUrl("https://api.bettergram.io/v1/coins"));
+	});
+
+	measure("ResourceGroupList::parse, recorded resources", 20, [&] {
+		ResourceGroupList resourceGroupList(kIconSize, nullptr);
+		resourceGroupList.setIsIconsFetchingEnabled(false);
+		resourceGroupList.parse(resources);
+	});
+
+	CryptoPriceHistory history;
+	const QDateTime now = QDateTime::currentDateTimeUtc();
+
+	measure("CryptoPriceHistory::add, 1000 coins", 20, [&] {
+		for (int i = 0; i < 1000; ++i) {
+			history.add(QString::number(i), now, 1.0 + i);
+		}
+	});
+}
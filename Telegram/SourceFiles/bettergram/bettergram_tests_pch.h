@@ -0,0 +1,29 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+
+// The data layer sources rely on the same headers as the main precompiled header,
+// but here we do not have generated styles and language files
+
+#include <QtCore/QtCore>
+#include <QtGui/QtGui>
+#include <QtNetwork/QtNetwork>
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <optional>
+
+#include <range/v3/all.hpp>
+#include <crl/crl.h>
+
+#include "base/variant.h"
+#include "base/optional.h"
+#include "base/algorithm.h"
+#include "base/basic_types.h"
+
+#include "logs.h"
+#include "core/utils.h"
@@ -0,0 +1,73 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "bettergram/bettergramservice.h"
+
+#include <iostream>
+
+// The data layer tests are linked without the application,
+// so here we define the few application functions the data layer uses.
+
+namespace Logs {
+
+void writeMain(const QString &v) {
+	std::cout << v.toStdString() << std::endl;
+}
+
+} // namespace Logs
+
+void memset_rand(void *data, uint32 len) {
+	memset_rand_bad(data, len);
+}
+
+namespace Bettergram {
+
+namespace {
+
+// Settings and caches of the tests are not mixed with the application ones
+QString TestsDirPath() {
+	return QDir::tempPath() + QStringLiteral("/tests_bettergram/");
+}
+
+} // namespace
+
+int BettergramService::networkTimeout()
+{
+	return 10000;
+}
+
+const QString &BettergramService::defaultLastUpdateString()
+{
+	static const QString result = QStringLiteral("...");
+	return result;
+}
+
+QString BettergramService::pricesSettingsPath()
+{
+	return TestsDirPath() + QStringLiteral("prices.ini");
+}
+
+QString BettergramService::pricesCacheSettingsPath()
+{
+	return TestsDirPath() + QStringLiteral("prices/prices.ini");
+}
+
+QString BettergramService::pricesIconsCacheDirPath()
+{
+	return TestsDirPath() + QStringLiteral("prices/icons/");
+}
+
+QString BettergramService::pricesHistoryCachePath()
+{
+	return TestsDirPath() + QStringLiteral("prices/history.bin");
+}
+
+QString BettergramService::generateLastUpdateString(const QDateTime &dateTime, bool isShowSeconds)
+{
+	return dateTime.toString(isShowSeconds ? "hh:mm:ss" : "hh:mm");
+}
+
+} // namespace Bettergram
@@ -1,11 +1,14 @@
 #include "bettergramservice.h"
 #include "cryptopricelist.h"
 #include "cryptoprice.h"
+#include "cryptopricehistory.h"
+#include "cryptopricestream.h"
 #include "rsschannellist.h"
 #include "rsschannel.h"
 #include "resourcegrouplist.h"
 #include "pinnednewslist.h"
 #include "aditem.h"
+#include "remotejsonresource.h"
 
 #include <auth_session.h>
 #include <mainwidget.h>
@@ -16,6 +19,7 @@
 #include <platform/platform_specific.h>
 #include <boxes/confirm_box.h>
 #include <data/data_user.h>
+#include <styles/style_chat_helpers.h>
 
 #include <QCoreApplication>
 #include <QTimer>
@@ -55,6 +59,9 @@ const int BettergramService::_updateVideoChannelListPeriod = 2 * 60 * 60 * 1000;
 // We display deprecated API messages no more than once per 2 hours
 const int BettergramService::_deprecatedApiMessagePeriod = 2 * 60 * 60 * 1000;
 
+// Maximum number of RSS and Video feeds which are fetched at the same time
+const int BettergramService::_maxFetchingRssFeedsCount = 4;
+
 BettergramService *BettergramService::init()
 {
 	return instance();
@@ -74,6 +81,21 @@ int BettergramService::networkTimeout()
 	return _networkTimeout;
 }
 
+QString BettergramService::pricesUrl()
+{
+#ifdef _DEBUG
+	// The local stand-in server from gyp/tests/prices_stream_server.py
+	// may be used instead of the real prices API in debug builds only
+	const QByteArray testUrl = qgetenv("BETTERGRAM_PRICES_URL");
+
+	if (!testUrl.isEmpty()) {
+		return QString::fromLatin1(testUrl);
+	}
+#endif // _DEBUG
+
+	return QStringLiteral("https://%1.livecoinwatch.com").arg(_pricesUrlPrefix);
+}
+
 const QString &BettergramService::defaultLastUpdateString()
 {
 	return _defaultLastUpdateString;
@@ -175,17 +197,25 @@ void BettergramService::toggleBettergramTabs()
 	emit _instance->needToToggleBettergramTabs();
 }
 
+void BettergramService::prepareCaches()
+{
+	CryptoPriceHistory::prepare(pricesHistoryCachePath());
+}
+
 Bettergram::BettergramService::BettergramService(QObject *parent) :
 	QObject(parent),
-	_cryptoPriceList(new CryptoPriceList(this)),
+	_cryptoPriceList(new CryptoPriceList(st::pricesPanTableImageSize, this)),
+	_cryptoPriceStream(new CryptoPriceStream(_cryptoPriceList, this)),
 	_rssChannelList(new RssChannelList(RssChannelList::NewsType::News, this)),
 	_videoChannelList(new RssChannelList(RssChannelList::NewsType::Videos, this)),
-	_resourceGroupList(new ResourceGroupList(this)),
+	_resourceGroupList(new ResourceGroupList(st::resourcesPanImageSize, this)),
 	_pinnedNewsList(new PinnedNewsList(this)),
 	_currentAd(new AdItem(this))
 {
 	_instance = this;
 
+	createJsonSources();
+
 	getIsPaid();
 	getNextAd(true);
 
@@ -229,14 +259,6 @@ Bettergram::BettergramService::BettergramService(QObject *parent) :
 	getRssFeedsContent();
 	getVideoFeedsContent();
 
-	if (QFile::exists(resourcesCachePath())) {
-		if (!_resourceGroupList->parseFile(resourcesCachePath())) {
-			_resourceGroupList->parseFile(":/bettergram/default-resources.json");
-		}
-	} else {
-		_resourceGroupList->parseFile(":/bettergram/default-resources.json");
-	}
-
 	getResourceGroupList();
 	getPinnedNewsList();
 
@@ -352,6 +374,11 @@ CryptoPriceList *BettergramService::cryptoPriceList() const
 	return _cryptoPriceList;
 }
 
+CryptoPriceStream *BettergramService::cryptoPriceStream() const
+{
+	return _cryptoPriceStream;
+}
+
 RssChannelList *BettergramService::rssChannelList() const
 {
 	return _rssChannelList;
@@ -403,22 +430,22 @@ base::Observable<void> &BettergramService::billingPlanObservable()
 	return _billingPlanObservable;
 }
 
-QString BettergramService::settingsDirPath() const
+QString BettergramService::settingsDirPath()
 {
 	return cWorkingDir() + QStringLiteral("tdata/bettergram/");
 }
 
-QString BettergramService::cacheDirPath() const
+QString BettergramService::cacheDirPath()
 {
 	return settingsDirPath() + QStringLiteral("cache/");
 }
 
-QString BettergramService::pricesCacheDirPath() const
+QString BettergramService::pricesCacheDirPath()
 {
 	return cacheDirPath() + QStringLiteral("prices/");
 }
 
-QString BettergramService::pricesIconsCacheDirPath() const
+QString BettergramService::pricesIconsCacheDirPath()
 {
 	return pricesCacheDirPath() + QStringLiteral("icons/");
 }
@@ -428,7 +455,17 @@ QString BettergramService::resourcesCachePath() const
 	return cacheDirPath() + QStringLiteral("resources.json");
 }
 
-QString BettergramService::settingsPath(const QString &name) const
+QString BettergramService::pinnedNewsCachePath() const
+{
+	return cacheDirPath() + QStringLiteral("pinned_news.json");
+}
+
+QString BettergramService::adCachePath() const
+{
+	return cacheDirPath() + QStringLiteral("ad.json");
+}
+
+QString BettergramService::settingsPath(const QString &name)
 {
 	return settingsDirPath() + name + QStringLiteral(".ini");
 }
@@ -438,16 +475,21 @@ QString BettergramService::bettergramSettingsPath() const
 	return settingsPath(QStringLiteral("bettergram"));
 }
 
-QString BettergramService::pricesSettingsPath() const
+QString BettergramService::pricesSettingsPath()
 {
 	return settingsPath(QStringLiteral("prices"));
 }
 
-QString BettergramService::pricesCacheSettingsPath() const
+QString BettergramService::pricesCacheSettingsPath()
 {
 	return pricesCacheDirPath() + QStringLiteral("prices.ini");
 }
 
+QString BettergramService::pricesHistoryCachePath()
+{
+	return pricesCacheDirPath() + QStringLiteral("history.bin");
+}
+
 void BettergramService::getIsPaid()
 {
 	//TODO: bettergram: ask server and get know if the instance is paid or not and the current billing plan.
@@ -456,7 +498,7 @@ void BettergramService::getIsPaid()
 
 void BettergramService::getCryptoPriceNames()
 {
-	QUrl url(QStringLiteral("https://%1.livecoinwatch.com/currencies").arg(_pricesUrlPrefix));
+	QUrl url(QStringLiteral("%1/currencies").arg(pricesUrl()));
 
 	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
 
@@ -492,8 +534,8 @@ QUrl BettergramService::getCryptoPriceValues(int offset, int count)
 		return QUrl();
 	}
 
-	QUrl url(QStringLiteral("https://%1.livecoinwatch.com/coins?sort=%2&order=%3&offset=%4&limit=%5")
-			 .arg(_pricesUrlPrefix)
+	QUrl url(QStringLiteral("%1/coins?sort=%2&order=%3&offset=%4&limit=%5")
+			 .arg(pricesUrl())
 			 .arg(_cryptoPriceList->sortString())
 			 .arg(_cryptoPriceList->orderString())
 			 .arg(offset)
@@ -511,8 +553,8 @@ QUrl BettergramService::getCryptoPriceValues(int offset, int count, const QStrin
 		return QUrl();
 	}
 
-	QUrl url(QStringLiteral("https://%1.livecoinwatch.com/coins?sort=%2&order=%3&offset=%4&limit=%5&only=%6")
-			 .arg(_pricesUrlPrefix)
+	QUrl url(QStringLiteral("%1/coins?sort=%2&order=%3&offset=%4&limit=%5&only=%6")
+			 .arg(pricesUrl())
 			 .arg(_cryptoPriceList->sortString())
 			 .arg(_cryptoPriceList->orderString())
 			 .arg(offset)
@@ -536,15 +578,15 @@ QUrl BettergramService::getSearchCryptoPriceValues(int offset, int count)
 	if (_cryptoPriceList->sortOrder() == CryptoPriceList::SortOrder::Rank) {
 		QStringList shortNames = _cryptoPriceList->getSearchListShortNames(offset, count);
 
-		url = QStringLiteral("https://%1.livecoinwatch.com/coins?sort=none&limit=%2&only=%3")
-				.arg(_pricesUrlPrefix)
+		url = QStringLiteral("%1/coins?sort=none&limit=%2&only=%3")
+				.arg(pricesUrl())
 				.arg(shortNames.size())
 				.arg(shortNames.join(QStringLiteral(",")));
 	} else {
 		QStringList shortNames = _cryptoPriceList->getSearchListShortNames();
 
-		url = QStringLiteral("https://%1.livecoinwatch.com/coins?sort=%2&order=%3&offset=%4&limit=%5&only=%6")
-				.arg(_pricesUrlPrefix)
+		url = QStringLiteral("%1/coins?sort=%2&order=%3&offset=%4&limit=%5&only=%6")
+				.arg(pricesUrl())
 				.arg(_cryptoPriceList->sortString())
 				.arg(_cryptoPriceList->orderString())
 				.arg(offset)
@@ -559,14 +601,15 @@ QUrl BettergramService::getSearchCryptoPriceValues(int offset, int count)
 
 void BettergramService::searchCryptoPriceNames()
 {
-	if (!_cryptoPriceList->isSearching()) {
+	// The search is already done locally if the names are fetched
+	if (!_cryptoPriceList->isSearching() || !_cryptoPriceList->isSearchInProgress()) {
 		return;
 	}
 
 	const QString searchText = _cryptoPriceList->searchText();
 
-	const QUrl url(QStringLiteral("https://%1.livecoinwatch.com/currencies?search=%2&type=coin")
-				   .arg(_pricesUrlPrefix)
+	const QUrl url(QStringLiteral("%1/currencies?search=%2&type=coin")
+				   .arg(pricesUrl())
 				   .arg(searchText));
 
 	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
@@ -622,6 +665,13 @@ void BettergramService::getCryptoPriceValues(const QUrl &url)
 	QNetworkRequest request;
 	request.setUrl(url);
 
+	// We ask only for changes since the last response for the same page
+	const QByteArray valuesETag = _cryptoPriceList->valuesETag(url);
+
+	if (!valuesETag.isEmpty()) {
+		request.setRawHeader("If-None-Match", valuesETag);
+	}
+
 	QNetworkReply *reply = networkManager->get(request);
 
 	connect(reply, &QNetworkReply::finished, this, [this, url, reply] {
@@ -629,8 +679,16 @@ void BettergramService::getCryptoPriceValues(const QUrl &url)
 			return;
 		}
 
-		if(reply->error() == QNetworkReply::NoError) {
-			_cryptoPriceList->parseValues(reply->readAll(), url);
+		if (isNotModified(reply)) {
+			_cryptoPriceList->valuesNotModified(url);
+
+			if (_cryptoPriceList->mayFetchStats()) {
+				getCryptoPriceStats();
+			}
+		} else if(reply->error() == QNetworkReply::NoError) {
+			_cryptoPriceList->parseValues(reply->readAll(),
+										  url,
+										  reply->rawHeader("ETag"));
 
 			if (_cryptoPriceList->mayFetchStats()) {
 				getCryptoPriceStats();
@@ -664,7 +722,11 @@ void BettergramService::getCryptoPriceStats()
 	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
 
 	QNetworkRequest request;
-	request.setUrl(QStringLiteral("https://%1.livecoinwatch.com/stats").arg(_pricesUrlPrefix));
+	request.setUrl(QStringLiteral("%1/stats").arg(pricesUrl()));
+
+	if (!_cryptoPriceList->statsETag().isEmpty()) {
+		request.setRawHeader("If-None-Match", _cryptoPriceList->statsETag());
+	}
 
 	QNetworkReply *reply = networkManager->get(request);
 
@@ -673,8 +735,10 @@ void BettergramService::getCryptoPriceStats()
 			return;
 		}
 
-		if(reply->error() == QNetworkReply::NoError) {
-			_cryptoPriceList->parseStats(reply->readAll());
+		if (isNotModified(reply)) {
+			_cryptoPriceList->statsNotModified();
+		} else if(reply->error() == QNetworkReply::NoError) {
+			_cryptoPriceList->parseStats(reply->readAll(), reply->rawHeader("ETag"));
 		} else {
 			LOG(("Can not get crypto price stats. %1 (%2)")
 				.arg(reply->errorString())
@@ -701,37 +765,95 @@ void BettergramService::getCryptoPriceStats()
 
 void BettergramService::getRssFeedsContent()
 {
-	for (const QSharedPointer<RssChannel> &channel : *_rssChannelList) {
-		if (channel->isMayFetchNewData()) {
-			getRssFeeds(_rssChannelList, channel);
+	enqueueRssFeeds(_rssChannelList);
+	getNextRssFeeds();
+}
+
+void BettergramService::getVideoFeedsContent()
+{
+	enqueueRssFeeds(_videoChannelList);
+	getNextRssFeeds();
+}
+
+void BettergramService::enqueueRssFeeds(RssChannelList *rssChannelList)
+{
+	for (const QSharedPointer<RssChannel> &channel : *rssChannelList) {
+		if (channel->isMayFetchNewData()
+				&& !_rssFeedsQueue.contains(qMakePair(rssChannelList, channel))) {
+			_rssFeedsQueue.push_back(qMakePair(rssChannelList, channel));
 		}
 	}
 }
 
-void BettergramService::getVideoFeedsContent()
+void BettergramService::getNextRssFeeds()
 {
-	for (const QSharedPointer<RssChannel> &channel : *_videoChannelList) {
-		if (channel->isMayFetchNewData()) {
-			getRssFeeds(_videoChannelList, channel);
+	while (_fetchingRssFeedsCount < _maxFetchingRssFeedsCount && !_rssFeedsQueue.isEmpty()) {
+		const QPair<RssChannelList*, QSharedPointer<RssChannel>> next = _rssFeedsQueue.takeFirst();
+
+		// The channel may be removed from the list while it was waiting
+		if (next.first->contains(next.second->feedLink()) && !next.second->isFetching()) {
+			getRssFeeds(next.first, next.second);
 		}
 	}
 }
 
+void BettergramService::rssFeedsFetched(RssChannelList *rssChannelList)
+{
+	_fetchingRssFeedsCount--;
+
+	rssChannelList->parseFeeds();
+	getNextRssFeeds();
+}
+
+int BettergramService::getMaxAge(const QNetworkReply *reply)
+{
+	const QList<QByteArray> directives = reply->rawHeader("Cache-Control").split(',');
+
+	for (const QByteArray &directive : directives) {
+		const QByteArray trimmed = directive.trimmed();
+
+		if (trimmed.startsWith("max-age=")) {
+			return qMax(0, trimmed.mid(8).toInt());
+		}
+	}
+
+	return 0;
+}
+
 void BettergramService::getRssFeeds(RssChannelList *rssChannelList,
 									const QSharedPointer<RssChannel> &channel)
 {
 	channel->startFetching();
+	_fetchingRssFeedsCount++;
 
 	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
 
 	QNetworkRequest request;
 	request.setUrl(channel->feedLink());
 
+	if (!channel->eTag().isEmpty()) {
+		request.setRawHeader("If-None-Match", channel->eTag());
+	}
+
+	if (!channel->lastModified().isEmpty()) {
+		request.setRawHeader("If-Modified-Since", channel->lastModified());
+	}
+
 	QNetworkReply *reply = networkManager->get(request);
 
-	connect(reply, &QNetworkReply::finished, this, [rssChannelList, reply, channel] {
-		if(reply->error() == QNetworkReply::NoError) {
-			channel->fetchingSucceed(reply->readAll());
+	connect(reply, &QNetworkReply::finished, this, [this, rssChannelList, reply, channel] {
+		// The fetching may be already finished due timeout
+		if (!channel->isFetching()) {
+			return;
+		}
+
+		if (isNotModified(reply)) {
+			channel->fetchingNotModified(getMaxAge(reply));
+		} else if(reply->error() == QNetworkReply::NoError) {
+			channel->fetchingSucceed(reply->readAll(),
+									 reply->rawHeader("ETag"),
+									 reply->rawHeader("Last-Modified"),
+									 getMaxAge(reply));
 		} else {
 			LOG(("Can not get RSS feeds from the channel %1. %2 (%3)")
 				.arg(channel->feedLink().toString())
@@ -741,7 +863,7 @@ void BettergramService::getRssFeeds(RssChannelList *rssChannelList,
 			channel->fetchingFailed();
 		}
 
-		rssChannelList->parseFeeds();
+		rssFeedsFetched(rssChannelList);
 	});
 
 	connect(reply, &QNetworkReply::finished, [networkManager, reply]() {
@@ -750,14 +872,19 @@ void BettergramService::getRssFeeds(RssChannelList *rssChannelList,
 	});
 
 	QTimer::singleShot(_networkTimeout, Qt::VeryCoarseTimer, networkManager,
-					   [networkManager, reply, channel] {
+					   [this, rssChannelList, networkManager, reply, channel] {
 		reply->deleteLater();
 		networkManager->deleteLater();
 
+		if (!channel->isFetching()) {
+			return;
+		}
+
 		LOG(("Can not get RSS feeds from the channel %1 due timeout")
 			.arg(channel->feedLink().toString()));
 
 		channel->fetchingFailed();
+		rssFeedsFetched(rssChannelList);
 	});
 
 	connect(reply, &QNetworkReply::sslErrors, this, [channel] (QList<QSslError> errors) {
@@ -832,62 +959,65 @@ void BettergramService::getVideoChannelList()
 
 void BettergramService::getResourceGroupList()
 {
-	QUrl url("https://api.bettergram.io/v1/resources");
-
-	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
+	_resourceGroupListSource->revalidate();
+}
 
-	QNetworkRequest request;
-	request.setUrl(url);
+void BettergramService::getPinnedNewsList()
+{
+	_pinnedNewsListSource->revalidate();
+}
 
-	QNetworkReply *reply = networkManager->get(request);
+void BettergramService::createJsonSources()
+{
+	_resourceGroupListSource = new RemoteJsonResource(
+				QUrl("https://api.bettergram.io/v1/resources"),
+				resourcesCachePath(),
+				[this](const QByteArray &data) { return _resourceGroupList->parse(data); },
+				this);
 
-	connect(reply, &QNetworkReply::finished,
-			this, &BettergramService::onGetResourceGroupListFinished);
+	_resourceGroupListSource->setDefaultPath(":/bettergram/default-resources.json");
 
-	connect(reply, &QNetworkReply::finished, [networkManager, reply]() {
-		reply->deleteLater();
-		networkManager->deleteLater();
+	connect(_resourceGroupListSource, &RemoteJsonResource::notModified, this, [this] {
+		_resourceGroupList->setLastUpdate(QDateTime::currentDateTime());
 	});
 
-	QTimer::singleShot(_networkTimeout, Qt::VeryCoarseTimer, networkManager,
-					   [networkManager, reply] {
-		reply->deleteLater();
-		networkManager->deleteLater();
+	_pinnedNewsListSource = new RemoteJsonResource(
+				QUrl("https://api.bettergram.io/v1/pinned_news"),
+				pinnedNewsCachePath(),
+				[this](const QByteArray &data) { return _pinnedNewsList->parse(data); },
+				this);
 
-		LOG(("Can not get resource group list due timeout"));
-	});
+	_nextAdSource = new RemoteJsonResource(
+				QUrl("https://api.bettergram.io/v1/ads/next"),
+				adCachePath(),
+				[this](const QByteArray &data) { return parseNextAd(data); },
+				this);
 
-	connect(reply, &QNetworkReply::sslErrors, this, &BettergramService::onSslFailed);
-}
+	connect(_nextAdSource, &RemoteJsonResource::updated,
+			this, [this] { getNextAdLater(); });
 
-void BettergramService::getPinnedNewsList()
-{
-	QUrl url("https://api.bettergram.io/v1/pinned_news");
+	connect(_nextAdSource, &RemoteJsonResource::notModified,
+			this, [this] { getNextAdLater(); });
 
-	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
-
-	QNetworkRequest request;
-	request.setUrl(url);
-
-	QNetworkReply *reply = networkManager->get(request);
+	connect(_nextAdSource, &RemoteJsonResource::failed,
+			this, [this] { getNextAdLater(); });
 
-	connect(reply, &QNetworkReply::finished,
-			this, &BettergramService::onGetPinnedNewsListFinished);
-
-	connect(reply, &QNetworkReply::finished, [networkManager, reply]() {
-		reply->deleteLater();
-		networkManager->deleteLater();
-	});
+	// Try to get new ad without previous ad id
+	connect(_nextAdSource, &RemoteJsonResource::parsingFailed,
+			this, [this] { getNextAdLater(true); });
 
-	QTimer::singleShot(_networkTimeout, Qt::VeryCoarseTimer, networkManager,
-					   [networkManager, reply] {
-		reply->deleteLater();
-		networkManager->deleteLater();
+	for (RemoteJsonResource *source : { _resourceGroupListSource, _pinnedNewsListSource, _nextAdSource }) {
+		connect(source, &RemoteJsonResource::apiDeprecated,
+				this, &BettergramService::showDeprecatedApiMessage);
+	}
 
-		LOG(("Can not get pinned news list due timeout"));
-	});
+	// Show the persisted data immediately, it is revalidated after that
+	_resourceGroupListSource->load();
+	_pinnedNewsListSource->load();
 
-	connect(reply, &QNetworkReply::sslErrors, this, &BettergramService::onSslFailed);
+	if (!_isPaid) {
+		_nextAdSource->load();
+	}
 }
 
 void BettergramService::onGetCryptoPriceNamesFinished()
@@ -914,40 +1044,6 @@ void BettergramService::onSslFailed(QList<QSslError> errors)
 	}
 }
 
-void BettergramService::onGetResourceGroupListFinished()
-{
-	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-
-	if (isApiDeprecated(reply)) {
-		return;
-	}
-
-	if(reply->error() == QNetworkReply::NoError) {
-		_resourceGroupList->parse(reply->readAll());
-	} else {
-		LOG(("Can not get resource group list. %1 (%2)")
-			.arg(reply->errorString())
-			.arg(reply->error()));
-	}
-}
-
-void BettergramService::onGetPinnedNewsListFinished()
-{
-	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-
-	if (isApiDeprecated(reply)) {
-		return;
-	}
-
-	if(reply->error() == QNetworkReply::NoError) {
-		_pinnedNewsList->parse(reply->readAll());
-	} else {
-		LOG(("Can not get pinned news list. %1 (%2)")
-			.arg(reply->errorString())
-			.arg(reply->error()));
-	}
-}
-
 void BettergramService::onGetRssChannelListFinished()
 {
 	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
@@ -998,36 +1094,8 @@ void BettergramService::getNextAd(bool reset)
 		url += _currentAd->id();
 	}
 
-	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
-
-	QNetworkRequest request;
-	request.setUrl(url);
-
-	QNetworkReply *reply = networkManager->get(request);
-
-	connect(reply, &QNetworkReply::finished,
-			this, &BettergramService::onGetNextAdFinished);
-
-	connect(reply, &QNetworkReply::finished, [networkManager, reply]() {
-		reply->deleteLater();
-		networkManager->deleteLater();
-	});
-
-	connect(this, &BettergramService::destroyed, networkManager, [networkManager, reply] {
-		reply->deleteLater();
-		networkManager->deleteLater();
-	});
-
-	QTimer::singleShot(_networkTimeout, Qt::VeryCoarseTimer, networkManager,
-					   [networkManager, reply, this] {
-		reply->deleteLater();
-		networkManager->deleteLater();
-
-		getNextAdLater();
-	});
-
-	connect(reply, &QNetworkReply::sslErrors,
-			this, &BettergramService::onSslFailed);
+	_nextAdSource->setLink(QUrl(url));
+	_nextAdSource->revalidate();
 }
 
 void BettergramService::getNextAdLater(bool reset)
@@ -1120,30 +1188,6 @@ bool BettergramService::parseNextAd(const QByteArray &byteArray)
 	return true;
 }
 
-void BettergramService::onGetNextAdFinished()
-{
-	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-
-	if (isApiDeprecated(reply)) {
-		return;
-	}
-
-	if(reply->error() == QNetworkReply::NoError) {
-		if (parseNextAd(reply->readAll())) {
-			getNextAdLater();
-		} else {
-			// Try to get new ad without previous ad id
-			getNextAdLater(true);
-		}
-	} else {
-		//	LOG(("Can not get next ad item. %1 (%2)")
-		//				  .arg(reply->errorString())
-		//				  .arg(reply->error()));
-
-		getNextAdLater();
-	}
-}
-
 void BettergramService::onUpdateRssFeedsContent()
 {
 	getRssFeedsContent();
@@ -1170,6 +1214,12 @@ void BettergramService::checkForNewUpdates()
 	checker.start();
 }
 
+bool BettergramService::isNotModified(const QNetworkReply *reply)
+{
+	return reply
+			&& reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304;
+}
+
 bool BettergramService::isApiDeprecated(const QNetworkReply *reply)
 {
 	if (!reply) {
@@ -10,11 +10,13 @@
 namespace Bettergram {
 
 class CryptoPriceList;
+class CryptoPriceStream;
 class RssChannelList;
 class RssChannel;
 class ResourceGroupList;
 class PinnedNewsList;
 class AdItem;
+class RemoteJsonResource;
 
 /**
  * @brief The BettergramService class contains Bettergram specific classes and settings
@@ -43,6 +45,9 @@ public:
 
 	static int networkTimeout();
 
+	/// Base url of the crypto prices API
+	static QString pricesUrl();
+
 	static const QString &defaultLastUpdateString();
 	static QString generateLastUpdateString(const QDateTime &dateTime, bool isShowSeconds);
 
@@ -51,10 +56,24 @@ public:
 	static bool isBettergramTabsShowed();
 	static void toggleBettergramTabs();
 
+	/// Read and parse the large caches before the service is created.
+	/// It does not use Qt objects of the service, so it is called on a worker thread at startup
+	static void prepareCaches();
+
+	static QString settingsDirPath();
+	static QString cacheDirPath();
+	static QString pricesCacheDirPath();
+	static QString pricesHistoryCachePath();
+	static QString pricesIconsCacheDirPath();
+	static QString settingsPath(const QString &name);
+	static QString pricesSettingsPath();
+	static QString pricesCacheSettingsPath();
+
 	bool isPaid() const;
 	BillingPlan billingPlan() const;
 
 	CryptoPriceList *cryptoPriceList() const;
+	CryptoPriceStream *cryptoPriceStream() const;
 	RssChannelList *rssChannelList() const;
 	RssChannelList *videoChannelList() const;
 	ResourceGroupList *resourceGroupList() const;
@@ -67,16 +86,11 @@ public:
 	base::Observable<void> &isPaidObservable();
 	base::Observable<void> &billingPlanObservable();
 
-	QString settingsDirPath() const;
-	QString cacheDirPath() const;
-	QString pricesCacheDirPath() const;
-	QString pricesIconsCacheDirPath() const;
 	QString resourcesCachePath() const;
-	QString settingsPath(const QString &name) const;
+	QString pinnedNewsCachePath() const;
+	QString adCachePath() const;
 
 	QString bettergramSettingsPath() const;
-	QString pricesSettingsPath() const;
-	QString pricesCacheSettingsPath() const;
 
 	/// Port settings files from the first Bettergram version.
 	/// At the first version of the Bettergram we save settings at the QSettings() instance,
@@ -138,22 +152,36 @@ private:
 	/// We display deprecated API messages no more than once per 2 hours
 	static const int _deprecatedApiMessagePeriod;
 
+	/// Maximum number of RSS and Video feeds which are fetched at the same time
+	static const int _maxFetchingRssFeedsCount;
+
 	bool _isSettingsPorted = false;
 	bool _isPaid = false;
 	BillingPlan _billingPlan = BillingPlan::Unknown;
 
 	CryptoPriceList *_cryptoPriceList = nullptr;
+	CryptoPriceStream *_cryptoPriceStream = nullptr;
 	RssChannelList *_rssChannelList = nullptr;
 	RssChannelList *_videoChannelList = nullptr;
 	ResourceGroupList *_resourceGroupList = nullptr;
 	PinnedNewsList *_pinnedNewsList = nullptr;
 	AdItem *_currentAd = nullptr;
+
+	/// Persisted JSON documents which are revalidated in background
+	RemoteJsonResource *_resourceGroupListSource = nullptr;
+	RemoteJsonResource *_pinnedNewsListSource = nullptr;
+	RemoteJsonResource *_nextAdSource = nullptr;
+
 	int _checkForUpdatesTimerId = 0;
 	int _updateCryptoPriceNamesTimerId = 0;
 	int _saveCryptoPricesTimerId = 0;
 	int _updateRssChannelListTimerId = 0;
 	int _updateVideoChannelListTimerId = 0;
 	int _everyDayTimerId = 0;
+
+	/// RSS and Video channels which are waiting for fetching
+	QList<QPair<RssChannelList*, QSharedPointer<RssChannel>>> _rssFeedsQueue;
+	int _fetchingRssFeedsCount = 0;
 	bool _isWindowActive = true;
 	std::function<void()> _isWindowActiveHandler = nullptr;
 
@@ -178,6 +206,9 @@ private:
 	void getNextAd(bool reset);
 	void getNextAdLater(bool reset = false);
 
+	/// Create sources of the persisted JSON documents and give the persisted data to the models
+	void createJsonSources();
+
 	bool parseNextAd(const QByteArray &byteArray);
 
 	/// Download and parse crypto price names, without actual price values.
@@ -197,18 +228,30 @@ private:
 	/// Download and parse Video channel list from Bettergram servers
 	void getVideoChannelList();
 
-	/// Download and parse all RSS feeds
+	/// Download and parse RSS feeds of the channels which next fetch time has come
 	void getRssFeedsContent();
 
-	/// Download and parse all Video feeds
+	/// Download and parse Video feeds of the channels which next fetch time has come
 	void getVideoFeedsContent();
 
+	void enqueueRssFeeds(RssChannelList *rssChannelList);
+
+	/// Start fetching of the queued channels while the fetching count is less than the limit
+	void getNextRssFeeds();
+
 	void getRssFeeds(RssChannelList *rssChannelList, const QSharedPointer<RssChannel> &channel);
+	void rssFeedsFetched(RssChannelList *rssChannelList);
+
+	/// @return max-age value of the Cache-Control header in seconds, 0 if it is absent
+	static int getMaxAge(const QNetworkReply *reply);
 
 	/// Check response for 410 (Gone) HTTP status.
 	/// If the reply has this status we show message box that the user should update the application.
 	/// @return true if the reply has 410 (Gone) HTTP status or when reply is null, false otherwise
 	bool isApiDeprecated(const QNetworkReply *reply);
+
+	/// @return true if the reply has 304 (Not Modified) HTTP status
+	static bool isNotModified(const QNetworkReply *reply);
 	void showDeprecatedApiMessage();
 
 private slots:
@@ -219,9 +262,6 @@ private slots:
 	void onUpdateVideoFeedsContent();
 
 	void onGetCryptoPriceNamesFinished();
-	void onGetNextAdFinished();
-	void onGetResourceGroupListFinished();
-	void onGetPinnedNewsListFinished();
 	void onGetRssChannelListFinished();
 	void onGetVideoChannelListFinished();
 
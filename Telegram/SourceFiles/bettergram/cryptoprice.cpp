@@ -2,8 +2,6 @@
 #include "remoteimage.h"
 #include "bettergramservice.h"
 
-#include <styles/style_chat_helpers.h>
-
 #include <QSettings>
 
 namespace Bettergram {
@@ -13,14 +11,15 @@ const qint64 CryptoPrice::_ageLimitForIconsInSeconds = 3 * 24 * 60 * 60;
 
 CryptoPrice::CryptoPrice(const QUrl &url,
 						 const QUrl &iconUrl,
+						 int iconSize,
 						 const QString &name,
 						 const QString &shortName,
 						 bool isNeedDownloadIcon) :
 	QObject(nullptr),
 	_url(url),
 	_icon(new RemoteImage(iconUrl,
-						  st::pricesPanTableImageSize,
-						  st::pricesPanTableImageSize,
+						  iconSize,
+						  iconSize,
 						  isNeedDownloadIcon,
 						  nullptr)),
 	_name(name),
@@ -34,6 +33,7 @@ CryptoPrice::CryptoPrice(const QUrl &url,
 
 CryptoPrice::CryptoPrice(const QUrl &url,
 						 const QUrl &iconUrl,
+						 int iconSize,
 						 const QString &name,
 						 const QString &shortName,
 						 int rank,
@@ -44,8 +44,8 @@ CryptoPrice::CryptoPrice(const QUrl &url,
 	QObject(nullptr),
 	_url(url),
 	_icon(new RemoteImage(iconUrl,
-						  st::pricesPanTableImageSize,
-						  st::pricesPanTableImageSize,
+						  iconSize,
+						  iconSize,
 						  isNeedDownloadIcon,
 						  nullptr)),
 	_name(name),
@@ -297,7 +297,7 @@ void CryptoPrice::setIsFavorite(bool isFavorite, bool isNeedToSaveToSettings)
 		_isFavorite = isFavorite;
 
 		if (isNeedToSaveToSettings) {
-			QSettings settings(BettergramService::instance()->pricesSettingsPath(), QSettings::IniFormat);
+			QSettings settings(BettergramService::pricesSettingsPath(), QSettings::IniFormat);
 
 			settings.beginGroup(QStringLiteral("favorites"));
 
@@ -316,7 +316,7 @@ void CryptoPrice::setIsFavorite(bool isFavorite, bool isNeedToSaveToSettings)
 
 void CryptoPrice::loadIsFavorite()
 {
-	QSettings settings(BettergramService::instance()->pricesSettingsPath(), QSettings::IniFormat);
+	QSettings settings(BettergramService::pricesSettingsPath(), QSettings::IniFormat);
 
 	settings.beginGroup(QStringLiteral("favorites"));
 
@@ -393,7 +393,7 @@ QString CryptoPrice::nameAndShortName() const
 
 QString CryptoPrice::iconFilePath() const
 {
-	return BettergramService::instance()->pricesIconsCacheDirPath()
+	return BettergramService::pricesIconsCacheDirPath()
 			+ nameAndShortName()
 			+ QStringLiteral(".png");
 }
@@ -404,9 +404,9 @@ void CryptoPrice::saveIcon() const
 		return;
 	}
 
-	if (!QDir().mkpath(BettergramService::instance()->pricesIconsCacheDirPath())) {
+	if (!QDir().mkpath(BettergramService::pricesIconsCacheDirPath())) {
 		LOG(("Unable to create directories at the path %1")
-			.arg(BettergramService::instance()->pricesIconsCacheDirPath()));
+			.arg(BettergramService::pricesIconsCacheDirPath()));
 	}
 
 	QString fileName = iconFilePath();
@@ -419,7 +419,7 @@ void CryptoPrice::saveIcon() const
 	}
 }
 
-QSharedPointer<CryptoPrice> CryptoPrice::load(const QSettings &settings)
+QSharedPointer<CryptoPrice> CryptoPrice::load(const QSettings &settings, int iconSize)
 {
 	QString name = settings.value("name").toString();
 	if (name.isEmpty()) {
@@ -476,6 +476,7 @@ QSharedPointer<CryptoPrice> CryptoPrice::load(const QSettings &settings)
 
 	QSharedPointer<CryptoPrice> cryptoPrice(new CryptoPrice(url,
 															iconUrl,
+															iconSize,
 															name,
 															shortName,
 															rank,
@@ -22,17 +22,19 @@ public:
 		Down
 	};
 
-	static QSharedPointer<CryptoPrice> load(const QSettings &settings);
+	static QSharedPointer<CryptoPrice> load(const QSettings &settings, int iconSize);
 	static Direction countDirection(const std::optional<double> &value);
 
 	explicit CryptoPrice(const QUrl &url,
 						 const QUrl &iconUrl,
+						 int iconSize,
 						 const QString &name,
 						 const QString &shortName,
 						 bool isNeedDownloadIcon);
 
 	explicit CryptoPrice(const QUrl &url,
 						 const QUrl &iconUrl,
+						 int iconSize,
 						 const QString &name,
 						 const QString &shortName,
 						 int rank,
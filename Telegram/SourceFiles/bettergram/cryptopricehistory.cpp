@@ -0,0 +1,299 @@
+#include "cryptopricehistory.h"
+
+#include <logs.h>
+
+#include <QDataStream>
+#include <QMutex>
+
+#include <memory>
+
+namespace Bettergram {
+
+namespace {
+
+/// The history which is read by CryptoPriceHistory::prepare() at a worker thread
+QMutex preparedMutex;
+std::unique_ptr<CryptoPriceHistory> preparedHistory;
+QString preparedPath;
+
+} // namespace
+
+// Period of the stored history in seconds (24 hours by default)
+const int CryptoPriceHistory::_period = 24 * 60 * 60;
+
+// Minimum interval between samples in seconds
+const int CryptoPriceHistory::_sampleInterval = 5 * 60;
+
+// Maximum number of samples for one cryptocurrency
+const int CryptoPriceHistory::_capacity = _period / _sampleInterval + 1;
+
+// Increment it every time when the binary format is changed
+const quint32 CryptoPriceHistory::_version = 1;
+
+int CryptoPriceHistory::Series::count() const
+{
+	return _count;
+}
+
+quint32 CryptoPriceHistory::Series::timeAt(int index) const
+{
+	return _times.at(physicalIndex(index));
+}
+
+float CryptoPriceHistory::Series::priceAt(int index) const
+{
+	return _prices.at(physicalIndex(index));
+}
+
+quint64 CryptoPriceHistory::Series::revision() const
+{
+	return _revision;
+}
+
+int CryptoPriceHistory::Series::physicalIndex(int index) const
+{
+	return (_first + index) % _capacity;
+}
+
+void CryptoPriceHistory::Series::add(quint32 time, float price, quint64 revision)
+{
+	if (_times.isEmpty()) {
+		_times.resize(_capacity);
+		_prices.resize(_capacity);
+	}
+
+	if (_count > 0) {
+		const int last = physicalIndex(_count - 1);
+
+		if (time < _times.at(last)) {
+			// We do not insert samples into the past
+			return;
+		}
+
+		// We keep only the latest price in one interval
+		if (time / _sampleInterval == _times.at(last) / _sampleInterval) {
+			_times[last] = time;
+			_prices[last] = price;
+			_revision = revision;
+			return;
+		}
+	}
+
+	if (_count == _capacity) {
+		_first = physicalIndex(1);
+		_count--;
+	}
+
+	const int index = physicalIndex(_count);
+
+	_times[index] = time;
+	_prices[index] = price;
+	_count++;
+	_revision = revision;
+}
+
+void CryptoPriceHistory::Series::removeOlderThan(quint32 time)
+{
+	while (_count > 0 && _times.at(_first) < time) {
+		_first = physicalIndex(1);
+		_count--;
+	}
+}
+
+void CryptoPriceHistory::add(const QString &shortName, const QDateTime &time, double price)
+{
+	if (shortName.isEmpty() || !time.isValid()) {
+		return;
+	}
+
+	_series[shortName].add(static_cast<quint32>(time.toSecsSinceEpoch()),
+						   static_cast<float>(price),
+						   ++_lastRevision);
+
+	_isChanged = true;
+}
+
+const CryptoPriceHistory::Series *CryptoPriceHistory::find(const QString &shortName) const
+{
+	const auto it = _series.constFind(shortName);
+
+	if (it == _series.constEnd() || it->count() == 0) {
+		return nullptr;
+	}
+
+	return &it.value();
+}
+
+QByteArray CryptoPriceHistory::serialize() const
+{
+	QByteArray byteArray;
+	QDataStream stream(&byteArray, QIODevice::WriteOnly);
+
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+	stream << _version << static_cast<qint32>(_series.size());
+
+	for (auto it = _series.constBegin(); it != _series.constEnd(); ++it) {
+		const Series &series = it.value();
+
+		stream << it.key() << static_cast<qint32>(series.count());
+
+		// Columns are written one after another as they are stored
+		for (int i = 0; i < series.count(); ++i) {
+			stream << series.timeAt(i);
+		}
+
+		for (int i = 0; i < series.count(); ++i) {
+			stream << series.priceAt(i);
+		}
+	}
+
+	return byteArray;
+}
+
+bool CryptoPriceHistory::deserialize(const QByteArray &byteArray)
+{
+	QDataStream stream(byteArray);
+
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+	quint32 version = 0;
+	qint32 seriesCount = 0;
+
+	stream >> version >> seriesCount;
+
+	if (stream.status() != QDataStream::Ok || version != _version || seriesCount < 0) {
+		return false;
+	}
+
+	const quint32 oldestTime = static_cast<quint32>(QDateTime::currentSecsSinceEpoch() - _period);
+
+	QHash<QString, Series> result;
+	QVector<quint32> times;
+	QVector<float> prices;
+
+	for (qint32 i = 0; i < seriesCount; ++i) {
+		QString shortName;
+		qint32 count = 0;
+
+		stream >> shortName >> count;
+
+		if (stream.status() != QDataStream::Ok || count < 0 || count > _capacity) {
+			return false;
+		}
+
+		times.resize(count);
+		prices.resize(count);
+
+		for (qint32 j = 0; j < count; ++j) {
+			stream >> times[j];
+		}
+
+		for (qint32 j = 0; j < count; ++j) {
+			stream >> prices[j];
+		}
+
+		if (stream.status() != QDataStream::Ok) {
+			return false;
+		}
+
+		Series &series = result[shortName];
+
+		for (qint32 j = 0; j < count; ++j) {
+			if (times.at(j) >= oldestTime) {
+				series.add(times.at(j), prices.at(j), _lastRevision + 1);
+			}
+		}
+
+		if (series.count() == 0) {
+			result.remove(shortName);
+		} else {
+			_lastRevision++;
+		}
+	}
+
+	_series = result;
+	return true;
+}
+
+void CryptoPriceHistory::save(const QString &filePath)
+{
+	if (!_isChanged) {
+		return;
+	}
+
+	const quint32 oldestTime = static_cast<quint32>(QDateTime::currentSecsSinceEpoch() - _period);
+
+	for (Series &series : _series) {
+		series.removeOlderThan(oldestTime);
+	}
+
+	if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+		LOG(("Unable to create directories for the file %1").arg(filePath));
+		return;
+	}
+
+	QFile file(filePath);
+
+	if (!file.open(QIODevice::WriteOnly)) {
+		LOG(("Unable to save crypto price history to the file %1. %2")
+			.arg(filePath)
+			.arg(file.errorString()));
+		return;
+	}
+
+	file.write(serialize());
+	_isChanged = false;
+}
+
+void CryptoPriceHistory::load(const QString &filePath)
+{
+	{
+		QMutexLocker lock(&preparedMutex);
+
+		if (preparedHistory && preparedPath == filePath) {
+			*this = std::move(*preparedHistory);
+			preparedHistory.reset();
+			return;
+		}
+	}
+
+	loadFile(filePath);
+}
+
+void CryptoPriceHistory::prepare(const QString &filePath)
+{
+	auto history = std::make_unique<CryptoPriceHistory>();
+	history->loadFile(filePath);
+
+	QMutexLocker lock(&preparedMutex);
+
+	preparedHistory = std::move(history);
+	preparedPath = filePath;
+}
+
+void CryptoPriceHistory::loadFile(const QString &filePath)
+{
+	QFile file(filePath);
+
+	if (!file.exists()) {
+		return;
+	}
+
+	if (!file.open(QIODevice::ReadOnly)) {
+		LOG(("Unable to load crypto price history from the file %1. %2")
+			.arg(filePath)
+			.arg(file.errorString()));
+		return;
+	}
+
+	if (!deserialize(file.readAll())) {
+		LOG(("Crypto price history at the file %1 is broken").arg(filePath));
+	}
+
+	_isChanged = false;
+}
+
+} // namespace Bettergram
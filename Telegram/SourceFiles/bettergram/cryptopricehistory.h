@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QObject>
+
+namespace Bettergram {
+
+/**
+ * @brief The CryptoPriceHistory class keeps recent prices of cryptocurrencies in memory.
+ * Prices of each cryptocurrency are stored in a fixed-size ring buffer
+ * with separated arrays of timestamps and float prices, at most one sample per interval.
+ * It is fed from every price update, so we can show trends without extra requests.
+ */
+class CryptoPriceHistory {
+public:
+	class Series {
+	public:
+		int count() const;
+
+		/// Index 0 is the oldest sample
+		quint32 timeAt(int index) const;
+		float priceAt(int index) const;
+
+		/// It is changed every time when a new sample is added
+		quint64 revision() const;
+
+	private:
+		friend class CryptoPriceHistory;
+
+		/// Seconds since epoch
+		QVector<quint32> _times;
+		QVector<float> _prices;
+
+		int _first = 0;
+		int _count = 0;
+		quint64 _revision = 0;
+
+		int physicalIndex(int index) const;
+		void add(quint32 time, float price, quint64 revision);
+		void removeOlderThan(quint32 time);
+	};
+
+	/// Period of the stored history in seconds (24 hours by default)
+	static const int _period;
+
+	/// Minimum interval between samples in seconds
+	static const int _sampleInterval;
+
+	/// Maximum number of samples for one cryptocurrency
+	static const int _capacity;
+
+	void add(const QString &shortName, const QDateTime &time, double price);
+
+	/// Returns nullptr if there are no samples for the cryptocurrency
+	const Series *find(const QString &shortName) const;
+
+	void save(const QString &filePath);
+
+	/// Takes the history prepared for this file if there is one
+	void load(const QString &filePath);
+
+	/// Read and parse the file in advance, it can be called at any thread.
+	/// The next load() call with the same file path takes the result
+	static void prepare(const QString &filePath);
+
+private:
+	/// Increment it every time when the binary format is changed
+	static const quint32 _version;
+
+	QHash<QString, Series> _series;
+	quint64 _lastRevision = 0;
+	bool _isChanged = false;
+
+	QByteArray serialize() const;
+	bool deserialize(const QByteArray &byteArray);
+
+	void loadFile(const QString &filePath);
+};
+
+} // namespace Bettergram
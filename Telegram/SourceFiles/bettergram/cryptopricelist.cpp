@@ -12,6 +12,9 @@ namespace Bettergram {
 const int CryptoPriceList::_defaultFreq = 60;
 const int CryptoPriceList::_minimumSearchText = 2;
 
+// Maximum number of results of the local search
+const int CryptoPriceList::_maximumSearchResults = 200;
+
 const QString &CryptoPriceList::getSortString(SortOrder sortOrder)
 {
 	static const QString rank = QStringLiteral("rank");
@@ -66,8 +69,9 @@ const QString &CryptoPriceList::getOrderString(SortOrder sortOrder)
 	}
 }
 
-CryptoPriceList::CryptoPriceList(QObject *parent) :
+CryptoPriceList::CryptoPriceList(int iconSize, QObject *parent) :
 	QObject(parent),
+	_iconSize(iconSize),
 	_freq(_defaultFreq),
 	_lastUpdateString(BettergramService::defaultLastUpdateString())
 {
@@ -222,9 +226,27 @@ void CryptoPriceList::addPrivate(const QSharedPointer<CryptoPrice> &price)
 	connect(price.data(), &CryptoPrice::isFavoriteToggled,
 			this, &CryptoPriceList::onIsFavoriteToggled);
 
+	connect(price.data(), &CryptoPrice::currentPriceChanged,
+			this, &CryptoPriceList::onCurrentPriceChanged);
+
 	_list.push_back(price);
 }
 
+bool CryptoPriceList::isIconsFetchingEnabled() const
+{
+	return _isIconsFetchingEnabled;
+}
+
+void CryptoPriceList::setIsIconsFetchingEnabled(bool isIconsFetchingEnabled)
+{
+	_isIconsFetchingEnabled = isIconsFetchingEnabled;
+}
+
+const CryptoPriceHistory &CryptoPriceList::history() const
+{
+	return _history;
+}
+
 QSharedPointer<CryptoPrice> CryptoPriceList::at(int index) const
 {
 	if (index < 0 || index >= count()) {
@@ -275,6 +297,7 @@ void CryptoPriceList::setSortOrder(const SortOrder &sortOrder)
 	if (_sortOrder != sortOrder) {
 		_sortOrder = sortOrder;
 
+		clearLastValues();
 		emit sortOrderChanged();
 	}
 }
@@ -314,15 +337,36 @@ void CryptoPriceList::setSearchText(const QString &searchText)
 		_searchText = trimmedSearchText;
 
 		_isSearchInProgress = isSearching();
+		clearLastValues();
 
 		if (wasSearching != isSearching()) {
 			emit isSearchingChanged();
 		}
 
 		emit searchTextChanged();
+
+		if (_isSearchInProgress && searchLocally()) {
+			_isSearchInProgress = false;
+
+			if (_searchList.isEmpty()) {
+				searchResultsAreEmpty();
+			} else {
+				emit searchNamesUpdated();
+			}
+		}
 	}
 }
 
+bool CryptoPriceList::searchLocally()
+{
+	if (_searchIndex.isEmpty()) {
+		return false;
+	}
+
+	_searchList = _searchIndex.search(_searchText, _maximumSearchResults);
+	return true;
+}
+
 bool CryptoPriceList::isShowOnlyFavorites() const
 {
 	return _isShowOnlyFavorites;
@@ -334,6 +378,7 @@ void CryptoPriceList::setIsShowOnlyFavorites(bool isShowOnlyFavorites)
 		_isShowOnlyFavorites = isShowOnlyFavorites;
 
 		updateFavoriteList();
+		clearLastValues();
 
 		emit isShowOnlyFavoritesChanged();
 	}
@@ -349,6 +394,23 @@ bool CryptoPriceList::areNamesFetched() const
 	return _areNamesFetched;
 }
 
+QByteArray CryptoPriceList::valuesETag(const QUrl &url) const
+{
+	return (_valuesUrl == url) ? _valuesETag : QByteArray();
+}
+
+const QByteArray &CryptoPriceList::statsETag() const
+{
+	return _statsETag;
+}
+
+void CryptoPriceList::clearLastValues()
+{
+	_valuesUrl = QUrl();
+	_valuesETag.clear();
+	_values.clear();
+}
+
 bool CryptoPriceList::mayFetchStats() const
 {
 	return !_statsLastUpdate.isValid()
@@ -490,7 +552,7 @@ void CryptoPriceList::parseNames(const QByteArray &byteArray)
 			iconUrl = coinsIconBase + iconUrl;
 		}
 
-		CryptoPrice cryptoPrice(url, iconUrl, name, shortName, false);
+		CryptoPrice cryptoPrice(url, iconUrl, _iconSize, name, shortName, false);
 
 		priceList.push_back(cryptoPrice);
 
@@ -500,6 +562,8 @@ void CryptoPriceList::parseNames(const QByteArray &byteArray)
 	mergeCryptoPriceList(priceList);
 	updateFavoriteList();
 
+	_searchIndex.build(_list);
+
 	if (!_list.isEmpty() && isAdded) {
 		setAreNamesFetched(true);
 	}
@@ -619,6 +683,7 @@ void CryptoPriceList::parseSearchNames(const QByteArray &byteArray)
 
 			price = QSharedPointer<CryptoPrice>(new CryptoPrice(url,
 																iconUrl,
+																_iconSize,
 																name,
 																shortName,
 																false));
@@ -644,7 +709,9 @@ void CryptoPriceList::searchResultsAreEmpty()
 	emit valuesUpdated(QUrl(), QList<QSharedPointer<CryptoPrice>>());
 }
 
-void CryptoPriceList::parseValues(const QByteArray &byteArray, const QUrl &url)
+void CryptoPriceList::parseValues(const QByteArray &byteArray,
+								  const QUrl &url,
+								  const QByteArray &eTag)
 {
 	if (byteArray.isEmpty()) {
 		LOG(("Can not get crypto price values. Response is emtpy"));
@@ -687,15 +754,88 @@ void CryptoPriceList::parseValues(const QByteArray &byteArray, const QUrl &url)
 		sort(prices);
 	}
 
-	for (const QSharedPointer<CryptoPrice> &price : prices) {
-		price->downloadIconIfNeeded();
+	if (_isIconsFetchingEnabled) {
+		for (const QSharedPointer<CryptoPrice> &price : prices) {
+			price->downloadIconIfNeeded();
+		}
 	}
 
+	_valuesUrl = url;
+	_valuesETag = eTag;
+	_values = prices;
+
 	setLastUpdate(QDateTime::currentDateTime());
 	emit valuesUpdated(url, prices);
 }
 
-void CryptoPriceList::parseStats(const QByteArray &byteArray)
+void CryptoPriceList::valuesNotModified(const QUrl &url)
+{
+	if (_valuesUrl != url) {
+		LOG(("Can not reuse crypto price values, they are received for other url"));
+		return;
+	}
+
+	lastValuesUpdated();
+}
+
+void CryptoPriceList::lastValuesUpdated()
+{
+	if (!isSearching() && _sortOrder != SortOrder::Rank) {
+		sort(_values);
+	}
+
+	setLastUpdate(QDateTime::currentDateTime());
+	emit valuesUpdated(_valuesUrl, _values);
+}
+
+void CryptoPriceList::parseStreamValues(const QByteArray &byteArray)
+{
+	QJsonParseError parseError;
+	QJsonDocument doc = QJsonDocument::fromJson(byteArray, &parseError);
+
+	if (!doc.isObject()) {
+		LOG(("Can not get crypto price values from stream. %1 (%2)")
+			.arg(parseError.errorString())
+			.arg(parseError.error));
+		return;
+	}
+
+	bool isLastValuesChanged = false;
+
+	for (const QJsonValue jsonValue : doc.object().value("data").toArray()) {
+		const QJsonObject priceJson = jsonValue.toObject();
+		const QSharedPointer<CryptoPrice> price = findByShortName(priceJson.value("code").toString());
+
+		if (!price) {
+			continue;
+		}
+
+		if (priceJson.value("price").isDouble()) {
+			price->setCurrentPrice(priceJson.value("price").toDouble());
+		}
+
+		const QJsonObject deltaJson = priceJson.value("delta").toObject();
+
+		if (deltaJson.value("day").isDouble()) {
+			price->setChangeFor24Hours((deltaJson.value("day").toDouble() - 1) * 100);
+		}
+
+		if (deltaJson.value("minute").isDouble()) {
+			const double changeForMinute = (deltaJson.value("minute").toDouble() - 1) * 100;
+			price->setMinuteDirection(CryptoPrice::countDirection(changeForMinute));
+		}
+
+		if (_values.contains(price)) {
+			isLastValuesChanged = true;
+		}
+	}
+
+	if (isLastValuesChanged) {
+		lastValuesUpdated();
+	}
+}
+
+void CryptoPriceList::parseStats(const QByteArray &byteArray, const QByteArray &eTag)
 {
 	if (byteArray.isEmpty()) {
 		LOG(("Can not get crypto price stats. Response is emtpy"));
@@ -741,10 +881,16 @@ void CryptoPriceList::parseStats(const QByteArray &byteArray)
 	setFreq(freq);
 
 	_statsLastUpdate = QDateTime::currentDateTime();
+	_statsETag = eTag;
 
 	emit statsUpdated();
 }
 
+void CryptoPriceList::statsNotModified()
+{
+	_statsLastUpdate = QDateTime::currentDateTime();
+}
+
 void CryptoPriceList::emptyValues()
 {
 	emit valuesUpdated(QUrl(), QList<QSharedPointer<CryptoPrice>>());
@@ -828,9 +974,9 @@ QList<QSharedPointer<CryptoPrice>> CryptoPriceList::parsePriceListValues(const Q
 	return prices;
 }
 
-void CryptoPriceList::save() const
+void CryptoPriceList::save()
 {
-	QSettings settings(BettergramService::instance()->pricesCacheSettingsPath(), QSettings::IniFormat);
+	QSettings settings(BettergramService::pricesCacheSettingsPath(), QSettings::IniFormat);
 
 	settings.beginGroup("metadata");
 
@@ -867,11 +1013,13 @@ void CryptoPriceList::save() const
 
 	settings.endArray();
 	settings.endGroup();
+
+	_history.save(BettergramService::pricesHistoryCachePath());
 }
 
 void CryptoPriceList::load()
 {
-	QSettings settings(BettergramService::instance()->pricesCacheSettingsPath(), QSettings::IniFormat);
+	QSettings settings(BettergramService::pricesCacheSettingsPath(), QSettings::IniFormat);
 
 	settings.beginGroup("metadata");
 
@@ -899,7 +1047,7 @@ void CryptoPriceList::load()
 	for (int i = 0; i < size; ++i) {
 		settings.setArrayIndex(i);
 
-		QSharedPointer<CryptoPrice> price = CryptoPrice::load(settings);
+		QSharedPointer<CryptoPrice> price = CryptoPrice::load(settings, _iconSize);
 
 		if (price) {
 			addPrivate(price);
@@ -910,6 +1058,9 @@ void CryptoPriceList::load()
 	settings.endGroup();
 
 	updateFavoriteList();
+
+	_searchIndex.build(_list);
+	_history.load(BettergramService::pricesHistoryCachePath());
 }
 
 void CryptoPriceList::mergeCryptoPriceList(const QList<CryptoPrice> &priceList)
@@ -1182,6 +1333,7 @@ void CryptoPriceList::addTestData(const QUrl &url,
 {
 	_list.push_back(QSharedPointer<CryptoPrice>(new CryptoPrice(url,
 												   iconUrl,
+												   _iconSize,
 												   name,
 												   shortName,
 												   rank,
@@ -1217,6 +1369,17 @@ void CryptoPriceList::onIsFavoriteToggled()
 	}
 }
 
+void CryptoPriceList::onCurrentPriceChanged()
+{
+	const CryptoPrice *price = qobject_cast<const CryptoPrice*>(sender());
+
+	if (!price || !price->currentPrice()) {
+		return;
+	}
+
+	_history.add(price->shortName(), QDateTime::currentDateTime(), *price->currentPrice());
+}
+
 void CryptoPriceList::clear()
 {
 	_list.clear();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "cryptoprice.h"
+#include "cryptopricehistory.h"
+#include "cryptopricesearchindex.h"
 
 #include <QObject>
 
@@ -31,7 +33,8 @@ public:
 	typedef QList<QSharedPointer<CryptoPrice>>::const_iterator const_iterator;
 	typedef QList<QSharedPointer<CryptoPrice>>::iterator iterator;
 
-	explicit CryptoPriceList(QObject *parent);
+	/// The icon size is given by the owner, so the list does not depend on the styles
+	explicit CryptoPriceList(int iconSize, QObject *parent);
 
 	std::optional<double> marketCap() const;
 	const QString &marketCapString() const;
@@ -71,17 +74,37 @@ public:
 	bool areNamesFetched() const;
 	bool mayFetchStats() const;
 
+	/// Icons are not downloaded after parsing values while it is disabled.
+	/// It is used by tests and benchmarks which do not run an event loop
+	bool isIconsFetchingEnabled() const;
+	void setIsIconsFetchingEnabled(bool isIconsFetchingEnabled);
+
+	/// Recent prices of all cryptocurrencies, it is updated every time when a price is changed
+	const CryptoPriceHistory &history() const;
+
 	QStringList getFavoritesShortNames() const;
 	QStringList getSearchListShortNames() const;
 	QStringList getSearchListShortNames(int offset, int count) const;
 
+	/// ETag of the last values response if it was received for the same url
+	QByteArray valuesETag(const QUrl &url) const;
+	const QByteArray &statsETag() const;
+
 	void parseNames(const QByteArray &byteArray);
 	void parseSearchNames(const QByteArray &byteArray);
-	void parseValues(const QByteArray &byteArray, const QUrl &url);
-	void parseStats(const QByteArray &byteArray);
+	void parseValues(const QByteArray &byteArray, const QUrl &url, const QByteArray &eTag = QByteArray());
+	void parseStats(const QByteArray &byteArray, const QByteArray &eTag = QByteArray());
 	void emptyValues();
 
-	void save() const;
+	/// Server responded with 304 (Not Modified) to a conditional request
+	void valuesNotModified(const QUrl &url);
+	void statsNotModified();
+
+	/// Parse changed values of the subscribed coins received from the stream.
+	/// It contains only the changed fields of the changed coins.
+	void parseStreamValues(const QByteArray &byteArray);
+
+	void save();
 	void load();
 
 	void createTestData();
@@ -109,6 +132,13 @@ private:
 	static const int _defaultFreq;
 	static const int _minimumSearchText;
 
+	/// Maximum number of results of the local search
+	static const int _maximumSearchResults;
+
+	/// Size of the crypto currency icons in pixels
+	const int _iconSize;
+	bool _isIconsFetchingEnabled = true;
+
 	QList<QSharedPointer<CryptoPrice>> _list;
 	QList<QSharedPointer<CryptoPrice>> _searchList;
 	QList<QSharedPointer<CryptoPrice>> _favoriteList;
@@ -129,6 +159,16 @@ private:
 	QString _lastUpdateString;
 
 	QDateTime _statsLastUpdate;
+	QByteArray _statsETag;
+
+	/// The last received values, they are shown again if the server
+	/// responds that they are not modified and they are updated from the stream
+	QUrl _valuesUrl;
+	QByteArray _valuesETag;
+	QList<QSharedPointer<CryptoPrice>> _values;
+
+	CryptoPriceHistory _history;
+	CryptoPriceSearchIndex _searchIndex;
 
 	SortOrder _sortOrder = SortOrder::Rank;
 	QString _searchText;
@@ -194,6 +234,12 @@ private:
 
 	void searchResultsAreEmpty();
 
+	/// Returns false if the names are not fetched yet and we should ask the server
+	bool searchLocally();
+
+	void clearLastValues();
+	void lastValuesUpdated();
+
 	void addPrivate(const QSharedPointer<CryptoPrice> &price);
 
 	QSharedPointer<CryptoPrice> find(const CryptoPrice *pricePointer);
@@ -218,6 +264,7 @@ private:
 private slots:
 	void onIconChanged();
 	void onIsFavoriteToggled();
+	void onCurrentPriceChanged();
 };
 
 } // namespace Bettergram
@@ -0,0 +1,123 @@
+#include "cryptopricesearchindex.h"
+#include "cryptoprice.h"
+
+namespace Bettergram {
+
+void CryptoPriceSearchIndex::build(const QList<QSharedPointer<CryptoPrice>> &list)
+{
+	_entries.clear();
+	_suffixes.clear();
+
+	_entries.reserve(list.size());
+
+	for (const QSharedPointer<CryptoPrice> &price : list) {
+		Entry entry;
+
+		entry.price = price;
+		entry.name = price->name().toCaseFolded();
+		entry.shortName = price->shortName().toCaseFolded();
+		entry.order = _entries.size();
+
+		for (int i = 0; i < entry.name.size(); ++i) {
+			_suffixes.push_back({ entry.order, false, i });
+		}
+
+		for (int i = 0; i < entry.shortName.size(); ++i) {
+			_suffixes.push_back({ entry.order, true, i });
+		}
+
+		_entries.push_back(entry);
+	}
+
+	std::sort(_suffixes.begin(), _suffixes.end(), [this](const Suffix &suffix1, const Suffix &suffix2) {
+		return suffixText(suffix1) < suffixText(suffix2);
+	});
+}
+
+bool CryptoPriceSearchIndex::isEmpty() const
+{
+	return _entries.isEmpty();
+}
+
+QStringRef CryptoPriceSearchIndex::suffixText(const Suffix &suffix) const
+{
+	const Entry &entry = _entries.at(suffix.entry);
+
+	return (suffix.isShortName ? entry.shortName : entry.name).midRef(suffix.offset);
+}
+
+int CryptoPriceSearchIndex::matchQuality(const Entry &entry, const QString &text)
+{
+	if (entry.shortName == text) {
+		return 0;
+	} else if (entry.name == text) {
+		return 1;
+	} else if (entry.shortName.startsWith(text)) {
+		return 2;
+	} else if (entry.name.startsWith(text)) {
+		return 3;
+	} else {
+		return 4;
+	}
+}
+
+QList<QSharedPointer<CryptoPrice>> CryptoPriceSearchIndex::search(const QString &text, int limit) const
+{
+	const QString foldedText = text.trimmed().toCaseFolded();
+
+	if (foldedText.isEmpty() || limit <= 0) {
+		return QList<QSharedPointer<CryptoPrice>>();
+	}
+
+	auto it = std::lower_bound(_suffixes.cbegin(), _suffixes.cend(), foldedText,
+							   [this](const Suffix &suffix, const QString &value) {
+		return suffixText(suffix) < value;
+	});
+
+	std::vector<bool> isFound(_entries.size(), false);
+	std::vector<std::pair<int, const Entry*>> found;
+
+	for (; it != _suffixes.cend() && suffixText(*it).startsWith(foldedText); ++it) {
+		if (!isFound[it->entry]) {
+			isFound[it->entry] = true;
+
+			const Entry &entry = _entries.at(it->entry);
+			found.emplace_back(matchQuality(entry, foldedText), &entry);
+		}
+	}
+
+	const auto rankOf = [](const Entry *entry) {
+		const int rank = entry->price->rank();
+		return (rank > 0) ? rank : std::numeric_limits<int>::max();
+	};
+
+	const auto isBetter = [&rankOf](const std::pair<int, const Entry*> &match1,
+									 const std::pair<int, const Entry*> &match2) {
+		if (match1.first != match2.first) {
+			return match1.first < match2.first;
+		}
+
+		const int rank1 = rankOf(match1.second);
+		const int rank2 = rankOf(match2.second);
+
+		return (rank1 != rank2) ? (rank1 < rank2) : (match1.second->order < match2.second->order);
+	};
+
+	if (static_cast<int>(found.size()) > limit) {
+		std::partial_sort(found.begin(), found.begin() + limit, found.end(), isBetter);
+		found.resize(limit);
+	} else {
+		std::sort(found.begin(), found.end(), isBetter);
+	}
+
+	QList<QSharedPointer<CryptoPrice>> result;
+	result.reserve(static_cast<int>(found.size()));
+
+	for (const std::pair<int, const Entry*> &match : found) {
+		result.push_back(match.second->price);
+	}
+
+	return result;
+}
+
+} // namespace Bettergram
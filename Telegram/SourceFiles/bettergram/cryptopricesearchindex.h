@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QObject>
+
+namespace Bettergram {
+
+class CryptoPrice;
+
+/**
+ * @brief The CryptoPriceSearchIndex class searches cryptocurrencies by names and short names locally.
+ * It is a sorted list of all suffixes of case folded names and short names,
+ * so both prefixes and substrings are found by binary search.
+ * It is built from the full list of names which we fetch anyway.
+ */
+class CryptoPriceSearchIndex {
+public:
+	void build(const QList<QSharedPointer<CryptoPrice>> &list);
+	bool isEmpty() const;
+
+	/// Exact matches go first, then prefix matches and then substring matches.
+	/// Matches with the same quality are ordered by rank
+	QList<QSharedPointer<CryptoPrice>> search(const QString &text, int limit) const;
+
+private:
+	struct Entry {
+		QSharedPointer<CryptoPrice> price;
+		QString name;
+		QString shortName;
+
+		/// Position at the source list, it is used when a rank is unknown
+		int order = 0;
+	};
+
+	struct Suffix {
+		int entry = 0;
+		bool isShortName = false;
+		int offset = 0;
+	};
+
+	QVector<Entry> _entries;
+	std::vector<Suffix> _suffixes;
+
+	QStringRef suffixText(const Suffix &suffix) const;
+
+	static int matchQuality(const Entry &entry, const QString &text);
+};
+
+} // namespace Bettergram
@@ -0,0 +1,284 @@
+#include "cryptopricestream.h"
+#include "cryptopricelist.h"
+#include "bettergramservice.h"
+
+#include <logs.h>
+
+#include <QTimerEvent>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkReply>
+
+namespace Bettergram {
+
+// We try to reconnect in 5 seconds at first and double the delay after each failure
+const int CryptoPriceStream::_minReconnectDelay = 5 * 1000;
+
+// We try to reconnect at least every 5 minutes
+const int CryptoPriceStream::_maxReconnectDelay = 5 * 60 * 1000;
+
+const int CryptoPriceStream::_idleTimeout = 45 * 1000;
+
+const int CryptoPriceStream::_maxEventSize = 1024 * 1024;
+
+CryptoPriceStream::CryptoPriceStream(CryptoPriceList *priceList, QObject *parent) :
+	QObject(parent),
+	_priceList(priceList),
+	_networkManager(new QNetworkAccessManager(this)),
+	_reconnectDelay(_minReconnectDelay)
+{
+}
+
+CryptoPriceStream::~CryptoPriceStream()
+{
+	disconnectFromStream();
+}
+
+bool CryptoPriceStream::isActive() const
+{
+	return _isActive;
+}
+
+void CryptoPriceStream::subscribe(QStringList shortNames)
+{
+	shortNames.removeDuplicates();
+	shortNames.sort();
+
+	if (_shortNames == shortNames && (_reply || _reconnectTimerId)) {
+		return;
+	}
+
+	_shortNames = shortNames;
+
+	if (_shortNames.isEmpty()) {
+		unsubscribe();
+		return;
+	}
+
+	// The stream is reopened right away only if it was working
+	if (!_reconnectTimerId) {
+		connectToStream();
+	}
+}
+
+void CryptoPriceStream::unsubscribe()
+{
+	_shortNames.clear();
+
+	stopReconnectTimer();
+	disconnectFromStream();
+	setIsActive(false);
+}
+
+void CryptoPriceStream::connectToStream()
+{
+	disconnectFromStream();
+
+	QNetworkRequest request;
+	request.setUrl(QStringLiteral("%1/stream?only=%2")
+				   .arg(BettergramService::pricesUrl())
+				   .arg(_shortNames.join(QStringLiteral(","))));
+
+	request.setRawHeader("Accept", "text/event-stream");
+	request.setRawHeader("Cache-Control", "no-cache");
+
+	_reply = _networkManager->get(request);
+
+	connect(_reply, &QNetworkReply::readyRead, this, &CryptoPriceStream::onReadyRead);
+	connect(_reply, &QNetworkReply::finished, this, &CryptoPriceStream::onFinished);
+
+	startIdleTimer();
+}
+
+void CryptoPriceStream::disconnectFromStream()
+{
+	stopIdleTimer();
+
+	if (_reply) {
+		QNetworkReply *reply = _reply;
+		_reply = nullptr;
+
+		reply->disconnect(this);
+		reply->abort();
+		reply->deleteLater();
+	}
+
+	_buffer.clear();
+	_eventName.clear();
+	_eventData.clear();
+}
+
+void CryptoPriceStream::reconnectLater()
+{
+	disconnectFromStream();
+	setIsActive(false);
+
+	if (_shortNames.isEmpty() || _reconnectTimerId) {
+		return;
+	}
+
+	_reconnectTimerId = startTimer(_reconnectDelay, Qt::VeryCoarseTimer);
+	_reconnectDelay = qMin(_reconnectDelay * 2, _maxReconnectDelay);
+}
+
+void CryptoPriceStream::setIsActive(bool isActive)
+{
+	if (_isActive != isActive) {
+		_isActive = isActive;
+
+		emit isActiveChanged();
+	}
+}
+
+void CryptoPriceStream::startIdleTimer()
+{
+	stopIdleTimer();
+	_idleTimerId = startTimer(_idleTimeout, Qt::VeryCoarseTimer);
+}
+
+void CryptoPriceStream::stopIdleTimer()
+{
+	if (_idleTimerId) {
+		killTimer(_idleTimerId);
+		_idleTimerId = 0;
+	}
+}
+
+void CryptoPriceStream::stopReconnectTimer()
+{
+	if (_reconnectTimerId) {
+		killTimer(_reconnectTimerId);
+		_reconnectTimerId = 0;
+	}
+}
+
+void CryptoPriceStream::timerEvent(QTimerEvent *timerEvent)
+{
+	if (timerEvent->timerId() == _reconnectTimerId) {
+		stopReconnectTimer();
+		connectToStream();
+	} else if (timerEvent->timerId() == _idleTimerId) {
+		LOG(("Crypto price stream is idle, reconnecting"));
+		reconnectLater();
+	}
+}
+
+void CryptoPriceStream::onReadyRead()
+{
+	if (!_isActive) {
+		const int statusCode = _reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		const QString contentType = _reply->header(QNetworkRequest::ContentTypeHeader).toString();
+
+		if (statusCode != 200 || !contentType.startsWith(QStringLiteral("text/event-stream"))) {
+			LOG(("Crypto price stream is not available. Status: %1, content type: '%2'")
+				.arg(statusCode)
+				.arg(contentType));
+
+			reconnectLater();
+			return;
+		}
+
+		_reconnectDelay = _minReconnectDelay;
+		setIsActive(true);
+	}
+
+	startIdleTimer();
+	_buffer.append(_reply->readAll());
+
+	int start = 0;
+
+	while (true) {
+		const int end = _buffer.indexOf('\n', start);
+
+		if (end < 0) {
+			break;
+		}
+
+		const int length = (end > start && _buffer.at(end - 1) == '\r')
+				? (end - start - 1)
+				: (end - start);
+
+		parseLine(_buffer.mid(start, length));
+
+		// The stream may be closed while the event is handled
+		if (!_reply) {
+			return;
+		}
+
+		start = end + 1;
+	}
+
+	_buffer.remove(0, start);
+
+	if (_buffer.size() > _maxEventSize || _eventData.size() > _maxEventSize) {
+		LOG(("Crypto price stream event is too long, reconnecting"));
+		reconnectLater();
+	}
+}
+
+void CryptoPriceStream::parseLine(const QByteArray &line)
+{
+	if (line.isEmpty()) {
+		dispatchEvent();
+		return;
+	}
+
+	if (line.startsWith(':')) {
+		// It is a comment that is sent to keep the connection alive
+		return;
+	}
+
+	const int colon = line.indexOf(':');
+	const QByteArray field = (colon < 0) ? line : line.left(colon);
+	QByteArray value = (colon < 0) ? QByteArray() : line.mid(colon + 1);
+
+	if (value.startsWith(' ')) {
+		value.remove(0, 1);
+	}
+
+	if (field == "event") {
+		_eventName = value;
+	} else if (field == "data") {
+		if (!_eventData.isEmpty()) {
+			_eventData.append('\n');
+		}
+
+		_eventData.append(value);
+	}
+}
+
+void CryptoPriceStream::dispatchEvent()
+{
+	// Events without a name have the "message" type by the server-sent events spec,
+	// we do not receive such events from the prices server
+	const QByteArray eventName = _eventName.isEmpty() ? QByteArray("message") : _eventName;
+	const QByteArray eventData = _eventData;
+
+	_eventName.clear();
+	_eventData.clear();
+
+	if (eventData.isEmpty()) {
+		return;
+	}
+
+	if (eventName == "prices") {
+		_priceList->parseStreamValues(eventData);
+	} else if (eventName == "stats") {
+		_priceList->parseStats(eventData);
+	} else {
+		LOG(("Unsupported crypto price stream event '%1'").arg(QString::fromUtf8(eventName)));
+	}
+}
+
+void CryptoPriceStream::onFinished()
+{
+	if (_reply && _reply->error() != QNetworkReply::NoError) {
+		LOG(("Crypto price stream is closed. %1 (%2)")
+			.arg(_reply->errorString())
+			.arg(_reply->error()));
+	}
+
+	reconnectLater();
+}
+
+} // namespace Bettergram
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+namespace Bettergram {
+
+class CryptoPriceList;
+
+/**
+ * @brief The CryptoPriceStream class receives server-sent events with changed values
+ * of the subscribed crypto coins only (the coins on the current page and favorites).
+ * While the stream is not active the prices are polled by conditional requests
+ * and we try to reconnect later with growing delays.
+ */
+class CryptoPriceStream : public QObject {
+	Q_OBJECT
+
+public:
+	explicit CryptoPriceStream(CryptoPriceList *priceList, QObject *parent);
+	~CryptoPriceStream();
+
+	/// @return true if the stream is connected and the prices should not be polled
+	bool isActive() const;
+
+	/// Receive changes of these coins only, it reconnects if the list is changed
+	void subscribe(QStringList shortNames);
+	void unsubscribe();
+
+signals:
+	void isActiveChanged();
+
+protected:
+	void timerEvent(QTimerEvent *timerEvent) override;
+
+private:
+	static const int _minReconnectDelay;
+	static const int _maxReconnectDelay;
+
+	/// The server sends comments at least every 15 seconds,
+	/// so we reconnect if nothing is received for a longer time
+	static const int _idleTimeout;
+
+	/// Events are much shorter, we reconnect if a line or an event is longer,
+	/// so a broken server can not make the buffers grow without bound
+	static const int _maxEventSize;
+
+	CryptoPriceList *_priceList = nullptr;
+	QNetworkAccessManager *_networkManager = nullptr;
+	QNetworkReply *_reply = nullptr;
+
+	QStringList _shortNames;
+	QByteArray _buffer;
+	QByteArray _eventName;
+	QByteArray _eventData;
+
+	bool _isActive = false;
+	int _reconnectDelay = 0;
+	int _reconnectTimerId = 0;
+	int _idleTimerId = 0;
+
+	void connectToStream();
+	void disconnectFromStream();
+	void reconnectLater();
+	void setIsActive(bool isActive);
+
+	void startIdleTimer();
+	void stopIdleTimer();
+	void stopReconnectTimer();
+
+	void parseLine(const QByteArray &line);
+	void dispatchEvent();
+
+private slots:
+	void onReadyRead();
+	void onFinished();
+};
+
+} // namespace Bettergram
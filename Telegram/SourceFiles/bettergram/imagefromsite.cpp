@@ -1,23 +1,17 @@
 #include "imagefromsite.h"
+#include "siteimagescanner.h"
 
 #include <QUrl>
-#include <QRegExp>
+#include <QPointer>
 
 namespace Bettergram {
 
-const int ImageFromSite::DEFAULT_WIDTH = 550;
-const int ImageFromSite::DEFAULT_HEIGHT = 310;
-
 ImageFromSite::ImageFromSite(QObject *parent) :
 	QObject(parent),
 	_siteContent(nullptr),
 	_image(nullptr)
 {
-	connect(&_siteContent, &RemoteTempData::downloaded,
-			this, &ImageFromSite::onSiteContentDownloaded);
-
-	connect(&_image, &RemoteImage::imageChanged,
-			this, &ImageFromSite::imageChanged);
+	connectSignals();
 }
 
 ImageFromSite::ImageFromSite(const QUrl &link, QObject *parent) :
@@ -25,11 +19,7 @@ ImageFromSite::ImageFromSite(const QUrl &link, QObject *parent) :
 	_siteContent(link, nullptr),
 	_image(nullptr)
 {
-	connect(&_siteContent, &RemoteTempData::downloaded,
-			this, &ImageFromSite::onSiteContentDownloaded);
-
-	connect(&_image, &RemoteImage::imageChanged,
-			this, &ImageFromSite::imageChanged);
+	connectSignals();
 }
 
 ImageFromSite::ImageFromSite(int scaledWidth, int scaledHeight, QObject *parent) :
@@ -37,11 +27,7 @@ ImageFromSite::ImageFromSite(int scaledWidth, int scaledHeight, QObject *parent)
 	_siteContent(nullptr),
 	_image(scaledWidth, scaledHeight, nullptr)
 {
-	connect(&_siteContent, &RemoteTempData::downloaded,
-			this, &ImageFromSite::onSiteContentDownloaded);
-
-	connect(&_image, &RemoteImage::imageChanged,
-			this, &ImageFromSite::imageChanged);
+	connectSignals();
 }
 
 const QUrl &ImageFromSite::link() const
@@ -51,6 +37,9 @@ const QUrl &ImageFromSite::link() const
 
 void Bettergram::ImageFromSite::setLink(const QUrl &link)
 {
+	if (link != _siteContent.link()) {
+		resetScanning();
+	}
 	_siteContent.setLink(link);
 }
 
@@ -99,227 +88,142 @@ bool ImageFromSite::isNull() const
 	return _image.isNull();
 }
 
-int ImageFromSite::parseIntAttribute(const QStringRef &source,
-									 const QString &startAttribute,
-									 const QString &endAttribute)
+bool ImageFromSite::isDownloadEnabled() const
 {
-	int startAttributeIndex = source.indexOf(startAttribute, 0, Qt::CaseInsensitive);
-
-	if (startAttributeIndex != -1) {
-		startAttributeIndex += startAttribute.size();
-
-		int endAttributeIndex = source.indexOf(endAttribute,
-											   startAttributeIndex,
-											   Qt::CaseInsensitive);
-
-		if (endAttributeIndex != -1) {
-			return source.mid(startAttributeIndex, endAttributeIndex - startAttributeIndex).toInt();
-		}
-	}
-
-	return 0;
+	return _siteContent.isDownloadEnabled();
 }
 
-QStringRef ImageFromSite::parseStringAttribute(const QStringRef &source,
-											   const QString &startAttribute,
-											   const QString &endAttribute)
+void ImageFromSite::setIsDownloadEnabled(bool isDownloadEnabled)
 {
-	int startAttributeIndex = source.indexOf(startAttribute, 0, Qt::CaseInsensitive);
-
-	if (startAttributeIndex != -1) {
-		startAttributeIndex += startAttribute.size();
-
-		int endAttributeIndex = source.indexOf(endAttribute,
-											   startAttributeIndex,
-											   Qt::CaseInsensitive);
-
-		if (endAttributeIndex != -1) {
-			return source.mid(startAttributeIndex, endAttributeIndex - startAttributeIndex);
-		}
-	}
-
-	return QStringRef();
+	_siteContent.setIsDownloadEnabled(isDownloadEnabled);
+	_image.setIsDownloadEnabled(isDownloadEnabled);
 }
 
-QStringRef ImageFromSite::getLargestImageInImageTags(const QString &source,
-													 int &maxWidth,
-													 int &maxHeight,
-													 int &position)
+QUrl ImageFromSite::findLargestImageLink(const QString &source)
 {
-	QStringRef imageLink;
+	return SiteImageScanner::findImageLink(source.toUtf8());
+}
 
-	const QString startImageTag = QStringLiteral("<img");
-	const QString endImageTag = QStringLiteral(">");
+void ImageFromSite::connectSignals()
+{
+	_siteContent.setIsStreamed(true);
 
-	const QString startSourceAttribute = QStringLiteral("src=\"");
-	const QString endSourceAttribute = QStringLiteral("\"");
+	connect(&_siteContent, &RemoteTempData::started,
+			this, &ImageFromSite::resetScanning);
 
-	const QString startWidthAttribute = QStringLiteral("width=\"");
-	const QString endWidthAttribute = QStringLiteral("\"");
+	connect(&_siteContent, &RemoteTempData::partDownloaded,
+			this, &ImageFromSite::onSiteContentPartDownloaded);
 
-	const QString startHeightAttribute = QStringLiteral("height=\"");
-	const QString endHeightAttribute = QStringLiteral("\"");
+	connect(&_siteContent, &RemoteTempData::downloaded,
+			this, &ImageFromSite::onSiteContentDownloaded);
 
-	int startIndex = 0;
+	connect(&_image, &RemoteImage::imageChanged,
+			this, &ImageFromSite::imageChanged);
+}
 
-	while (true) {
-		int startImageTagIndex = source.indexOf(startImageTag, startIndex, Qt::CaseInsensitive);
+void ImageFromSite::resetScanning()
+{
+	// A running scan task keeps its own scanner and its result is dropped
+	_scanGeneration++;
+	_scanner.reset();
+	_pendingSiteContent.clear();
+	_isPendingLastPart = false;
+	_isScanning = false;
+	_isSiteContentScanned = false;
+}
 
-		if (startImageTagIndex == -1) {
-			break;
+void ImageFromSite::scanSiteContent(const QByteArray &data, bool isLastPart)
+{
+	if (_isSiteContentScanned) {
+		// We have already found the image and just wait the end of the downloading
+		if (isLastPart) {
+			_isSiteContentScanned = false;
 		}
 
-		startImageTagIndex += startImageTag.size();
-		startIndex = startImageTagIndex;
+		return;
+	}
 
-		int endImageTagIndex = source.indexOf(endImageTag, startImageTagIndex, Qt::CaseInsensitive);
+	_pendingSiteContent.append(data);
+	_isPendingLastPart = _isPendingLastPart || isLastPart;
 
-		if (endImageTagIndex == -1) {
-			endImageTagIndex = source.size();
-		}
+	if (!_isScanning) {
+		startScanning();
+	}
+}
 
-		startIndex = endImageTagIndex;
+void ImageFromSite::startScanning()
+{
+	if (!_scanner) {
+		_scanner = std::make_shared<SiteImageScanner>();
+	}
 
-		QStringRef imageTag = source.midRef(startImageTagIndex,
-											endImageTagIndex - startImageTagIndex);
+	_isScanning = true;
 
-		QStringRef currentImage = parseStringAttribute(imageTag,
-													   startSourceAttribute,
-													   endSourceAttribute);
+	const QPointer<ImageFromSite> weak = this;
+	const std::shared_ptr<SiteImageScanner> scanner = _scanner;
+	const QByteArray data = _pendingSiteContent;
+	const bool isLastPart = _isPendingLastPart;
+	const int generation = _scanGeneration;
 
-		if (currentImage.isEmpty()) {
-			continue;
-		}
+	_pendingSiteContent.clear();
+	_isPendingLastPart = false;
 
-		int currentWidth = parseIntAttribute(imageTag,
-											 startWidthAttribute,
-											 endWidthAttribute);
-
-		int currentHeight = parseIntAttribute(imageTag,
-											  startHeightAttribute,
-											  endHeightAttribute);
-
-		if (currentHeight > maxHeight) {
-			maxHeight = currentHeight;
-			maxWidth = currentWidth;
-			position = startImageTagIndex;
-
-			imageLink = currentImage;
-		} else if (currentHeight == maxHeight && currentWidth > maxWidth) {
-			maxHeight = currentHeight;
-			maxWidth = currentWidth;
-			position = startImageTagIndex;
-
-			imageLink = currentImage;
-		} else if (maxWidth == 0 && maxHeight == 0) {
-			position = startImageTagIndex;
-			imageLink = currentImage;
-		}
+	crl::async([weak, scanner, data, isLastPart, generation] {
+		scanner->append(data);
 
-		// We do not need to continue parsing the site content
-		// if we have already got a big enough image
-		if (currentWidth >= DEFAULT_WIDTH && currentHeight >= DEFAULT_HEIGHT) {
-			break;
+		if (isLastPart) {
+			scanner->finish();
 		}
-	}
 
-	return imageLink;
+		crl::on_main(weak, [weak, isLastPart, generation] {
+			weak->onSiteContentScanned(generation, isLastPart);
+		});
+	});
 }
 
-QString ImageFromSite::getLargestImageInFileNames(const QString &source,
-												  int &maxWidth,
-												  int &maxHeight,
-												  int &position)
+void ImageFromSite::onSiteContentScanned(int generation, bool isLastPart)
 {
-	QRegExp regExp("(http://|https://)([\\w]|[0-9]|_|-|/|\\.)+(-|_)(\\d+)(x)(\\d+)(.jpg|.png|.jpeg)");
-	int pos = 0;
+	if (generation != _scanGeneration) {
+		// The content was scanned for an older download
+		return;
+	}
 
-	int tempMaxWidth = 0;
-	int tempMaxHeight = 0;
+	_isScanning = false;
 
-	QString imageLink;
+	if (!_scanner->isFinished()) {
+		if (!_pendingSiteContent.isEmpty() || _isPendingLastPart) {
+			startScanning();
+		}
 
-	while((pos = regExp.indexIn(source, pos)) != -1) {
-		int currentWidth = regExp.cap(4).toInt();
-		int currentHeight = regExp.cap(6).toInt();
+		return;
+	}
 
-		if (currentHeight > tempMaxHeight) {
-			tempMaxHeight = currentHeight;
-			tempMaxWidth = currentWidth;
-			position = pos;
+	const QUrl imageUrl = _scanner->imageLink();
 
-			imageLink = regExp.cap(0);
-		} else if (currentHeight == tempMaxHeight && currentWidth > tempMaxWidth) {
-			tempMaxHeight = currentHeight;
-			tempMaxWidth = currentWidth;
-			position = pos;
+	_scanner.reset();
+	_pendingSiteContent.clear();
 
-			imageLink = regExp.cap(0);
-		} else if (tempMaxWidth == 0 && tempMaxHeight == 0) {
-			position = pos;
-			imageLink = regExp.cap(0);
-		}
+	if (!isLastPart && !_isPendingLastPart) {
+		// We do not need the rest of the site content
+		_isSiteContentScanned = true;
+		_siteContent.finishEarly();
+	}
 
-		pos += regExp.matchedLength();
+	_isPendingLastPart = false;
 
-		// We do not need to continue parsing the site content
-		// if we have already got a big enough image
-		if (currentWidth >= DEFAULT_WIDTH && currentHeight >= DEFAULT_HEIGHT) {
-			break;
-		}
+	if (imageUrl.isValid()) {
+		_image.setLink(link().resolved(imageUrl));
 	}
+}
 
-	maxWidth = tempMaxWidth;
-	maxHeight = tempMaxHeight;
-
-	return imageLink;
+void Bettergram::ImageFromSite::onSiteContentPartDownloaded(QByteArray data)
+{
+	scanSiteContent(data, false);
 }
 
 void Bettergram::ImageFromSite::onSiteContentDownloaded(QByteArray data)
 {
-	// Here we should find all images with sizes and find the largest one
-
-	const QString source = QString::fromUtf8(data);
-
-	int maxWidthInImageTags = 0;
-	int maxHeightInImageTags = 0;
-	int positionInImageTags = 0;
-
-	QStringRef imageLinkInImageTags = getLargestImageInImageTags(source,
-																 maxWidthInImageTags,
-																 maxHeightInImageTags,
-																 positionInImageTags);
-
-	int maxWidthInFileNames = 0;
-	int maxHeightInFileNames = 0;
-	int positionInFileNames = 0;
-
-	QString imageLinkInFileName = getLargestImageInFileNames(source,
-															 maxWidthInFileNames,
-															 maxHeightInFileNames,
-															 positionInFileNames);
-
-	QUrl imageUrl;
-
-	if (maxHeightInImageTags >= DEFAULT_HEIGHT && maxWidthInFileNames >= DEFAULT_WIDTH
-			&& maxHeightInFileNames >= DEFAULT_HEIGHT && maxWidthInFileNames >= DEFAULT_WIDTH) {
-		if (positionInImageTags <= positionInFileNames) {
-			imageUrl = imageLinkInImageTags.toString();
-		} else {
-			imageUrl = imageLinkInFileName;
-		}
-	} else if (maxHeightInFileNames > maxHeightInImageTags) {
-		imageUrl = imageLinkInFileName;
-	} else if (maxHeightInFileNames == maxHeightInImageTags
-			   && maxWidthInFileNames > maxWidthInImageTags) {
-		imageUrl = imageLinkInFileName;
-	} else {
-		imageUrl = imageLinkInImageTags.toString();
-	}
-
-	if (imageUrl.isValid()) {
-		_image.setLink(imageUrl);
-	}
+	scanSiteContent(data, true);
 }
 
 } // namespace Bettergrams
@@ -3,11 +3,17 @@
 #include "remotetempdata.h"
 #include "remoteimage.h"
 
+#include <memory>
+
 namespace Bettergram {
 
+class SiteImageScanner;
+
 /**
  * @brief The ImageFromSite class is used to download the biggest image from a site.
  * We use this class to fetch RSS thumbnail if all other ways are broken.
+ * The site content is scanned by parts at a background thread while it is downloading,
+ * and the downloading is stopped as soon as we find a good enough image.
  */
 class ImageFromSite : public QObject {
 	Q_OBJECT
@@ -35,6 +41,13 @@ public:
 
 	bool isNull() const;
 
+	/// Neither the site nor the image is downloaded while it is disabled
+	bool isDownloadEnabled() const;
+	void setIsDownloadEnabled(bool isDownloadEnabled);
+
+	/// Find the largest image at the html source of a site, it does not use network
+	static QUrl findLargestImageLink(const QString &source);
+
 public slots:
 
 signals:
@@ -43,32 +56,31 @@ signals:
 protected:
 
 private:
-	/// We use these values to break searching images if we have already found big enough image
-	static const int DEFAULT_WIDTH;
-	static const int DEFAULT_HEIGHT;
-
 	RemoteTempData _siteContent;
 	RemoteImage _image;
 
-	int parseIntAttribute(const QStringRef &source,
-						  const QString &startAttribute,
-						  const QString &endAttribute);
+	/// It is used only by one background task at the same time
+	std::shared_ptr<SiteImageScanner> _scanner;
+
+	/// Site content parts which are downloaded while the scanner is busy
+	QByteArray _pendingSiteContent;
+	bool _isPendingLastPart = false;
+	bool _isScanning = false;
 
-	QStringRef parseStringAttribute(const QStringRef &source,
-									const QString &startAttribute,
-									const QString &endAttribute);
+	/// It is true if the image is found, but the site content is still downloading
+	bool _isSiteContentScanned = false;
 
-	QStringRef getLargestImageInImageTags(const QString &source,
-										  int &maxWidth,
-										  int &maxHeight,
-										  int &position);
+	/// It is increased for each download, results of older scan tasks are ignored
+	int _scanGeneration = 0;
 
-	QString getLargestImageInFileNames(const QString &source,
-									   int &maxWidth,
-									   int &maxHeight,
-									   int &position);
+	void connectSignals();
+	void resetScanning();
+	void scanSiteContent(const QByteArray &data, bool isLastPart);
+	void startScanning();
+	void onSiteContentScanned(int generation, bool isLastPart);
 
 private slots:
+	void onSiteContentPartDownloaded(QByteArray data);
 	void onSiteContentDownloaded(QByteArray data);
 };
 
@@ -24,6 +24,11 @@ PinnedNewsItem::PinnedNewsItem(const QString &title,
 {
 }
 
+const QDateTime &PinnedNewsItem::endDate() const
+{
+	return _endDate;
+}
+
 int PinnedNewsItem::position() const
 {
 	return _position;
@@ -21,6 +21,7 @@ public:
 	                        int iconWidth,
 	                        int iconHeight);
 
+	const QDateTime &endDate() const;
 	int position() const;
 
 private:
@@ -44,14 +44,6 @@ QList<QSharedPointer<PinnedNewsItem>> PinnedNewsList::videos() const
 
 bool PinnedNewsList::parse(const QByteArray &byteArray)
 {
-	// Update only if it has been changed
-	QByteArray hash = QCryptographicHash::hash(byteArray, QCryptographicHash::Sha256);
-
-	if (hash == _lastSourceHash) {
-		_lastUpdate = QDateTime::currentDateTime();
-		return false;
-	}
-
 	QJsonParseError parseError;
 	QJsonDocument doc = QJsonDocument::fromJson(byteArray, &parseError);
 
@@ -71,13 +63,7 @@ bool PinnedNewsList::parse(const QByteArray &byteArray)
 		return false;
 	}
 
-	if (!parse(json)) {
-		return false;
-	}
-
-	_lastSourceHash = hash;
-
-	return true;
+	return parse(json);
 }
 
 bool PinnedNewsList::parse(const QJsonObject &json)
@@ -96,22 +82,27 @@ bool PinnedNewsList::parse(const QJsonObject &json)
 		setFreq(json.value("freq").toInt());
 	}
 
+	bool isChanged = false;
+
 	if (json.contains("news")) {
-		parseItemList(json.value("news").toArray(),
-					  _news,
-					  st::newsPanImageWidth,
-					  st::newsPanImageHeight);
+		isChanged = parseItemList(json.value("news").toArray(),
+								  _news,
+								  st::newsPanImageWidth,
+								  st::newsPanImageHeight) || isChanged;
 	}
 
 	if (json.contains("videos")) {
-		parseItemList(json.value("videos").toArray(),
-					  _videos,
-					  st::videosPanImageWidth,
-					  st::videosPanImageHeight);
+		isChanged = parseItemList(json.value("videos").toArray(),
+								  _videos,
+								  st::videosPanImageWidth,
+								  st::videosPanImageHeight) || isChanged;
 	}
 
 	_lastUpdate = QDateTime::currentDateTime();
-	emit updated();
+
+	if (isChanged) {
+		emit updated();
+	}
 
 	return true;
 }
@@ -121,7 +112,7 @@ bool PinnedNewsList::parseItemList(const QJsonArray &jsonArray,
 									   int iconWidth,
 									   int iconHeight)
 {
-	list.clear();
+	QList<QSharedPointer<PinnedNewsItem>> newList;
 
 	for (const QJsonValue jsonValue : jsonArray) {
 		if (!jsonValue.isObject()) {
@@ -147,6 +138,22 @@ bool PinnedNewsList::parseItemList(const QJsonArray &jsonArray,
 			continue;
 		}
 
+		const auto sameItem = std::find_if(list.cbegin(), list.cend(),
+										   [&](const QSharedPointer<PinnedNewsItem> &item) {
+			return item->title() == title
+					&& item->description() == description
+					&& item->link() == url
+					&& item->imageLink() == imageUrl
+					&& item->publishDate() == date
+					&& item->endDate() == endDate
+					&& item->position() == position;
+		});
+
+		if (sameItem != list.cend()) {
+			newList.push_back(*sameItem);
+			continue;
+		}
+
 		QSharedPointer<PinnedNewsItem> item(new PinnedNewsItem(title,
 															   description,
 															   url,
@@ -159,9 +166,14 @@ bool PinnedNewsList::parseItemList(const QJsonArray &jsonArray,
 
 		connect(item.data(), &PinnedNewsItem::imageChanged, this, &PinnedNewsList::imageChanged);
 
-		list.push_back(item);
+		newList.push_back(item);
+	}
+
+	if (newList == list) {
+		return false;
 	}
 
+	list = newList;
 	return true;
 }
 
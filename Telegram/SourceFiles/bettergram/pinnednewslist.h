@@ -21,6 +21,7 @@ public:
 	QList<QSharedPointer<PinnedNewsItem>> news() const;
 	QList<QSharedPointer<PinnedNewsItem>> videos() const;
 
+	/// Parse the data and emit updated() signal only if the news or videos have been changed
 	bool parse(const QByteArray &byteArray);
 
 signals:
@@ -40,9 +41,12 @@ private:
 	/// Frequency of updates in seconds
 	int _freq;
 	QDateTime _lastUpdate;
-	QByteArray _lastSourceHash;
 
 	bool parse(const QJsonObject &json);
+
+	/// Items from the old list are reused if they have the same data,
+	/// so we do not download their images again.
+	/// @return true if the list has been changed
 	bool parseItemList(const QJsonArray &jsonArray,
 					   QList<QSharedPointer<PinnedNewsItem>> &list,
 					   int iconWidth,
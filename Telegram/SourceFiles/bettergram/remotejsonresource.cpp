@@ -0,0 +1,264 @@
+#include "remotejsonresource.h"
+#include "bettergramservice.h"
+
+#include <logs.h>
+
+#include <QTimer>
+#include <QSettings>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkReply>
+
+namespace Bettergram {
+
+RemoteJsonResource::RemoteJsonResource(const QUrl &link,
+									   const QString &cachePath,
+									   const Parser &parser,
+									   QObject *parent) :
+	QObject(parent),
+	_link(link),
+	_cachePath(cachePath),
+	_parser(parser)
+{
+}
+
+const QUrl &RemoteJsonResource::link() const
+{
+	return _link;
+}
+
+void RemoteJsonResource::setLink(const QUrl &link)
+{
+	_link = link;
+}
+
+void RemoteJsonResource::setDefaultPath(const QString &defaultPath)
+{
+	_defaultPath = defaultPath;
+}
+
+const QDateTime &RemoteJsonResource::lastDownloadTime() const
+{
+	return _lastDownloadTime;
+}
+
+bool RemoteJsonResource::isRevalidating() const
+{
+	return _reply != nullptr;
+}
+
+QString RemoteJsonResource::headersPath() const
+{
+	return _cachePath + QStringLiteral(".ini");
+}
+
+bool RemoteJsonResource::load()
+{
+	if (QFile::exists(_cachePath) && loadFile(_cachePath)) {
+		loadHeaders();
+		return true;
+	}
+
+	if (!_defaultPath.isEmpty()) {
+		return loadFile(_defaultPath);
+	}
+
+	return false;
+}
+
+bool RemoteJsonResource::loadFile(const QString &filePath)
+{
+	QFile file(filePath);
+
+	if (!file.open(QIODevice::ReadOnly)) {
+		LOG(("Unable to open file '%1'. %2").arg(filePath).arg(file.errorString()));
+		return false;
+	}
+
+	const QByteArray data = file.readAll();
+
+	if (data.isEmpty()) {
+		return false;
+	}
+
+	return accept(data);
+}
+
+void RemoteJsonResource::loadHeaders()
+{
+	QSettings settings(headersPath(), QSettings::IniFormat);
+
+	_cachedLink = settings.value("link").toUrl();
+	_eTag = settings.value("eTag").toByteArray();
+	_lastModified = settings.value("lastModified").toByteArray();
+	_lastDownloadTime = settings.value("lastDownloadTime").toDateTime();
+}
+
+bool RemoteJsonResource::accept(const QByteArray &data)
+{
+	const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+
+	if (hash == _lastSourceHash) {
+		return true;
+	}
+
+	if (!_parser(data)) {
+		return false;
+	}
+
+	_lastSourceHash = hash;
+	return true;
+}
+
+void RemoteJsonResource::save(const QByteArray &data) const
+{
+	if (!QDir().mkpath(QFileInfo(_cachePath).absolutePath())) {
+		LOG(("Unable to create directories for the file %1").arg(_cachePath));
+		return;
+	}
+
+	QFile file(_cachePath);
+
+	if (!file.open(QIODevice::WriteOnly)) {
+		LOG(("Unable to open file '%1' for writing. %2").arg(_cachePath).arg(file.errorString()));
+		return;
+	}
+
+	if (file.write(data) != data.size()) {
+		LOG(("Unable to write all data to file '%1'").arg(_cachePath));
+	}
+
+	file.close();
+
+	QSettings settings(headersPath(), QSettings::IniFormat);
+
+	settings.setValue("link", _cachedLink);
+	settings.setValue("eTag", _eTag);
+	settings.setValue("lastModified", _lastModified);
+	settings.setValue("lastDownloadTime", _lastDownloadTime);
+}
+
+void RemoteJsonResource::revalidate()
+{
+	if (_reply || !_link.isValid()) {
+		return;
+	}
+
+	QNetworkAccessManager *networkManager = new QNetworkAccessManager();
+
+	QNetworkRequest request;
+	request.setUrl(_link);
+
+	// We have the persisted data for this link, so the server may answer 304 (Not Modified)
+	if (_cachedLink == _link && !_lastSourceHash.isEmpty()) {
+		if (!_eTag.isEmpty()) {
+			request.setRawHeader("If-None-Match", _eTag);
+		}
+
+		if (!_lastModified.isEmpty()) {
+			request.setRawHeader("If-Modified-Since", _lastModified);
+		}
+	}
+
+	QNetworkReply *reply = networkManager->get(request);
+
+	_reply = reply;
+
+	connect(reply, &QNetworkReply::finished, this, [this, reply] {
+		// The request may be already finished due timeout
+		if (_reply != reply) {
+			return;
+		}
+
+		_reply = nullptr;
+		onFinished(reply);
+	});
+
+	connect(reply, &QNetworkReply::finished, [networkManager, reply]() {
+		reply->deleteLater();
+		networkManager->deleteLater();
+	});
+
+	connect(this, &RemoteJsonResource::destroyed, networkManager, [networkManager, reply] {
+		reply->deleteLater();
+		networkManager->deleteLater();
+	});
+
+	QTimer::singleShot(BettergramService::networkTimeout(), Qt::VeryCoarseTimer, networkManager,
+					   [this, networkManager, reply] {
+		reply->deleteLater();
+		networkManager->deleteLater();
+
+		if (_reply != reply) {
+			return;
+		}
+
+		_reply = nullptr;
+
+		LOG(("Can not get %1 due timeout").arg(_link.toString()));
+		emit failed();
+	});
+
+	connect(reply, &QNetworkReply::sslErrors, this, [this](QList<QSslError> errors) {
+		LOG(("Got SSL errors in during getting %1").arg(_link.toString()));
+
+		for(const QSslError &error : errors) {
+			LOG(("%1").arg(error.errorString()));
+		}
+	});
+}
+
+void RemoteJsonResource::onFinished(QNetworkReply *reply)
+{
+	const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+	if (statusCode == 410 || reply->error() == QNetworkReply::ContentGoneError) {
+		emit apiDeprecated();
+		return;
+	}
+
+	if (statusCode == 304) {
+		_lastDownloadTime = QDateTime::currentDateTime();
+		emit notModified();
+		return;
+	}
+
+	if (reply->error() != QNetworkReply::NoError) {
+		LOG(("Can not get %1. %2 (%3)")
+			.arg(_link.toString())
+			.arg(reply->errorString())
+			.arg(reply->error()));
+
+		emit failed();
+		return;
+	}
+
+	const QByteArray data = reply->readAll();
+	const QByteArray eTag = reply->rawHeader("ETag");
+	const QByteArray lastModified = reply->rawHeader("Last-Modified");
+	const bool isSameData = (QCryptographicHash::hash(data, QCryptographicHash::Sha256) == _lastSourceHash);
+
+	_lastDownloadTime = QDateTime::currentDateTime();
+
+	if (!isSameData && !accept(data)) {
+		emit parsingFailed();
+		return;
+	}
+
+	// Persist the data only if it or its headers have been changed
+	if (!isSameData || _cachedLink != _link || _eTag != eTag || _lastModified != lastModified) {
+		_cachedLink = _link;
+		_eTag = eTag;
+		_lastModified = lastModified;
+
+		save(data);
+	}
+
+	if (isSameData) {
+		emit notModified();
+	} else {
+		emit updated();
+	}
+}
+
+} // namespace Bettergram
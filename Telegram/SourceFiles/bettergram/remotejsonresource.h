@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QObject>
+#include <QUrl>
+
+#include <functional>
+
+class QNetworkReply;
+
+namespace Bettergram {
+
+/**
+ * @brief The RemoteJsonResource class keeps a JSON document from Bettergram servers.
+ * At startup it gives the last persisted version to the parser immediately,
+ * so the UI does not wait for the network. After that revalidate() asks the server
+ * with If-None-Match and If-Modified-Since headers and gives the data to the parser
+ * only if the server returns something new. The data is persisted only when
+ * the parser accepts it.
+ * The parser should compare the parsed model with the current one and emit only changes.
+ */
+class RemoteJsonResource : public QObject {
+	Q_OBJECT
+
+public:
+	/// Returns false if the data is wrong
+	typedef std::function<bool(const QByteArray &data)> Parser;
+
+	explicit RemoteJsonResource(const QUrl &link,
+								const QString &cachePath,
+								const Parser &parser,
+								QObject *parent);
+
+	const QUrl &link() const;
+
+	/// The link may be changed before each request, for example to add query parameters.
+	/// The conditional headers are sent only if the link is the same as the persisted one
+	void setLink(const QUrl &link);
+
+	/// This file is used if there is no persisted data, for example a file from resources
+	void setDefaultPath(const QString &defaultPath);
+
+	const QDateTime &lastDownloadTime() const;
+
+	bool isRevalidating() const;
+
+	/// Give the persisted data to the parser.
+	/// @return false if there is no valid persisted or default data
+	bool load();
+
+	/// Ask the server for a new version of the data in background
+	void revalidate();
+
+public slots:
+
+signals:
+	/// The parser has accepted new data
+	void updated();
+
+	/// The server has the same data as we have
+	void notModified();
+
+	/// The server has returned wrong data which the parser has not accepted
+	void parsingFailed();
+
+	/// Network error or timeout
+	void failed();
+
+	/// The server has returned 410 (Gone) HTTP status
+	void apiDeprecated();
+
+protected:
+
+private:
+	QUrl _link;
+	QString _cachePath;
+	QString _defaultPath;
+	Parser _parser;
+
+	/// Link, ETag and Last-Modified header values of the persisted data
+	QUrl _cachedLink;
+	QByteArray _eTag;
+	QByteArray _lastModified;
+
+	QByteArray _lastSourceHash;
+	QDateTime _lastDownloadTime;
+
+	QNetworkReply *_reply = nullptr;
+
+	QString headersPath() const;
+
+	bool loadFile(const QString &filePath);
+	void loadHeaders();
+
+	/// @return true if the parser has accepted the data
+	bool accept(const QByteArray &data);
+
+	void save(const QByteArray &data) const;
+
+	void onFinished(QNetworkReply *reply);
+};
+
+} // namespace Bettergram
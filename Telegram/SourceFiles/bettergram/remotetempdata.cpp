@@ -12,10 +12,35 @@ RemoteTempData::RemoteTempData(const QUrl &link, QObject *parent) :
 {
 }
 
+bool RemoteTempData::isStreamed() const
+{
+	return _isStreamed;
+}
+
+void RemoteTempData::setIsStreamed(bool isStreamed)
+{
+	_isStreamed = isStreamed;
+}
+
+void RemoteTempData::finishEarly()
+{
+	finishDownloadingEarly();
+}
+
 bool RemoteTempData::customIsNeedToDownload() const {
 	return true;
 }
 
+void RemoteTempData::dataPartDownloaded(const QByteArray &data)
+{
+	emit partDownloaded(data);
+}
+
+void RemoteTempData::downloadStarted()
+{
+	emit started();
+}
+
 void RemoteTempData::dataDownloaded(const QByteArray &data)
 {
 	emit downloaded(data);
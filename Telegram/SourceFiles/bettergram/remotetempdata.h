@@ -16,17 +16,30 @@ public:
 
 	explicit RemoteTempData(const QUrl &link, QObject *parent);
 
+	/// If it is true the data is emitted by parts with partDownloaded() signal while it is downloading,
+	/// and downloaded() signal contains only the last part
+	bool isStreamed() const override;
+	void setIsStreamed(bool isStreamed);
+
+	/// Stop downloading if we do not need the rest of data
+	void finishEarly();
+
 public slots:
 
 signals:
+	void started();
+	void partDownloaded(QByteArray data);
 	void downloaded(QByteArray data);
 
 protected:
 	bool customIsNeedToDownload() const override;
+	void dataPartDownloaded(const QByteArray &data) override;
+	void downloadStarted() override;
 	void dataDownloaded(const QByteArray &data) override;
 	void resetData() override;
 
 private:
+	bool _isStreamed = false;
 };
 
 } // namespace Bettergram
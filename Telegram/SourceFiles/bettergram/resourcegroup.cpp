@@ -2,12 +2,13 @@
 #include "resourceitem.h"
 
 #include <logs.h>
-#include <styles/style_chat_helpers.h>
 
 namespace Bettergram {
 
-ResourceGroup::ResourceGroup() :
-	QObject(nullptr)
+ResourceGroup::ResourceGroup(int iconSize, bool isNeedDownloadIcons) :
+	QObject(nullptr),
+	_iconSize(iconSize),
+	_isNeedDownloadIcons(isNeedDownloadIcons)
 {
 }
 
@@ -50,7 +51,13 @@ const QList<QSharedPointer<ResourceItem> > &ResourceGroup::items() const
 	return _list;
 }
 
-void ResourceGroup::parse(const QJsonObject &json)
+bool ResourceGroup::isEqual(const ResourceGroup &group) const
+{
+	return _title == group._title && _list == group._list;
+}
+
+void ResourceGroup::parse(const QJsonObject &json,
+						  const QList<QSharedPointer<ResourceItem>> &oldItems)
 {
 	if (json.isEmpty()) {
 		return;
@@ -64,13 +71,46 @@ void ResourceGroup::parse(const QJsonObject &json)
 			continue;
 		}
 
-		QSharedPointer<ResourceItem> item(new ResourceItem());
+		const QJsonObject itemJson = value.toObject();
+
+		const QString title = itemJson.value("title").toString();
+		const QString description = itemJson.value("description").toString();
+		const QUrl link = itemJson.value("url").toString();
+		const QUrl iconLink = itemJson.value("iconUrl").toString();
+
+		QSharedPointer<ResourceItem> item = findItem(oldItems, title, description, link, iconLink);
+
+		if (!item) {
+			item.reset(new ResourceItem(title,
+										description,
+										link,
+										iconLink,
+										_iconSize,
+										_isNeedDownloadIcons));
+		}
 
 		connect(item.data(), &ResourceItem::iconChanged, this, &ResourceGroup::iconChanged);
 
-		item->parse(value.toObject());
 		_list.push_back(item);
 	}
 }
 
+QSharedPointer<ResourceItem> ResourceGroup::findItem(const QList<QSharedPointer<ResourceItem>> &items,
+													 const QString &title,
+													 const QString &description,
+													 const QUrl &link,
+													 const QUrl &iconLink)
+{
+	for (const QSharedPointer<ResourceItem> &item : items) {
+		if (item->title() == title
+				&& item->description() == description
+				&& item->link() == link
+				&& item->iconLink() == iconLink) {
+			return item;
+		}
+	}
+
+	return QSharedPointer<ResourceItem>();
+}
+
 } // namespace Bettergrams
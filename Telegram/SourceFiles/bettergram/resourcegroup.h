@@ -16,7 +16,7 @@ public:
 	typedef QList<QSharedPointer<ResourceItem>>::const_iterator const_iterator;
 	typedef QList<QSharedPointer<ResourceItem>>::iterator iterator;
 
-	explicit ResourceGroup();
+	explicit ResourceGroup(int iconSize, bool isNeedDownloadIcons);
 
 	const QString &title() const;
 
@@ -30,7 +30,12 @@ public:
 
 	const QList<QSharedPointer<ResourceItem>> &items() const;
 
-	void parse(const QJsonObject &json);
+	/// Groups are equal if they have the same title and the same item instances
+	bool isEqual(const ResourceGroup &group) const;
+
+	/// Items from the old list are reused if they have the same data,
+	/// so we do not download their icons again
+	void parse(const QJsonObject &json, const QList<QSharedPointer<ResourceItem>> &oldItems);
 
 public slots:
 
@@ -40,8 +45,17 @@ signals:
 protected:
 
 private:
+	const int _iconSize;
+	const bool _isNeedDownloadIcons;
+
 	QString _title;
 	QList<QSharedPointer<ResourceItem>> _list;
+
+	static QSharedPointer<ResourceItem> findItem(const QList<QSharedPointer<ResourceItem>> &items,
+												 const QString &title,
+												 const QString &description,
+												 const QUrl &link,
+												 const QUrl &iconLink);
 };
 
 } // namespace Bettergram
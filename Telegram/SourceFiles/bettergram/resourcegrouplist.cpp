@@ -1,5 +1,6 @@
 #include "resourcegrouplist.h"
 #include "resourcegroup.h"
+#include "resourceitem.h"
 
 #include <bettergram/bettergramservice.h>
 #include <logs.h>
@@ -8,8 +9,9 @@
 
 namespace Bettergram {
 
-ResourceGroupList::ResourceGroupList(QObject *parent) :
+ResourceGroupList::ResourceGroupList(int iconSize, QObject *parent) :
 	QObject(parent),
+	_iconSize(iconSize),
 	_freq(_defaultFreq),
 	_lastUpdateString(BettergramService::defaultLastUpdateString())
 {
@@ -77,33 +79,23 @@ bool ResourceGroupList::isEmpty() const
 	return _list.isEmpty();
 }
 
-int ResourceGroupList::count() const
+bool ResourceGroupList::isIconsFetchingEnabled() const
 {
-	return _list.count();
+	return _isIconsFetchingEnabled;
 }
 
-bool ResourceGroupList::parseFile(const QString &filePath)
+void ResourceGroupList::setIsIconsFetchingEnabled(bool isIconsFetchingEnabled)
 {
-	QFile file(filePath);
-
-	if (!file.open(QIODevice::ReadOnly)) {
-		LOG(("Unable to open file '%1' with resource group list").arg(filePath));
-		return false;
-	}
+	_isIconsFetchingEnabled = isIconsFetchingEnabled;
+}
 
-	return parse(file.readAll());
+int ResourceGroupList::count() const
+{
+	return _list.count();
 }
 
 bool ResourceGroupList::parse(const QByteArray &byteArray)
 {
-	// Update only if it has been changed
-	QByteArray hash = QCryptographicHash::hash(byteArray, QCryptographicHash::Sha256);
-
-	if (hash == _lastSourceHash) {
-		setLastUpdate(QDateTime::currentDateTime());
-		return false;
-	}
-
 	QJsonParseError parseError;
 	QJsonDocument doc = QJsonDocument::fromJson(byteArray, &parseError);
 
@@ -123,15 +115,7 @@ bool ResourceGroupList::parse(const QByteArray &byteArray)
 		return false;
 	}
 
-	if (!parse(json)) {
-		return false;
-	}
-
-	save(byteArray);
-
-	_lastSourceHash = hash;
-
-	return true;
+	return parse(json);
 }
 
 bool ResourceGroupList::parse(const QJsonObject &json)
@@ -156,7 +140,14 @@ bool ResourceGroupList::parse(const QJsonObject &json)
 		groupsJson = json.value("groups").toArray();
 	}
 
-	_list.clear();
+	// Reuse the current items, so their icons are not downloaded again
+	QList<QSharedPointer<ResourceItem>> oldItems;
+
+	for (const QSharedPointer<ResourceGroup> &group : _list) {
+		oldItems.append(group->items());
+	}
+
+	QList<QSharedPointer<ResourceGroup>> list;
 
 	for (const QJsonValue value : groupsJson) {
 		if (!value.isObject()) {
@@ -164,38 +155,41 @@ bool ResourceGroupList::parse(const QJsonObject &json)
 			continue;
 		}
 
-		QSharedPointer<ResourceGroup> group(new ResourceGroup());
-
-		connect(group.data(), &ResourceGroup::iconChanged, this, &ResourceGroupList::iconChanged);
+		QSharedPointer<ResourceGroup> group(new ResourceGroup(_iconSize, _isIconsFetchingEnabled));
 
-		group->parse(value.toObject());
-		_list.push_back(group);
+		group->parse(value.toObject(), oldItems);
+		list.push_back(group);
 	}
 
 	setLastUpdate(QDateTime::currentDateTime());
+
+	if (isEqual(list)) {
+		return true;
+	}
+
+	for (const QSharedPointer<ResourceGroup> &group : list) {
+		connect(group.data(), &ResourceGroup::iconChanged, this, &ResourceGroupList::iconChanged);
+	}
+
+	_list = list;
 	emit updated();
 
 	return true;
 }
 
-void ResourceGroupList::save(const QByteArray &byteArray)
+bool ResourceGroupList::isEqual(const QList<QSharedPointer<ResourceGroup>> &list) const
 {
-	const QString filePath = BettergramService::instance()->resourcesCachePath();
-
-	QFile file(filePath);
-
-	if (!file.open(QIODevice::WriteOnly)) {
-		LOG(("Unable to open file '%1' for writing").arg(filePath));
-		return;
+	if (_list.size() != list.size()) {
+		return false;
 	}
 
-	int count = file.write(byteArray);
-
-	if (count != byteArray.size()) {
-		LOG(("Unable to write all data to file '%1'").arg(filePath));
+	for (int i = 0; i < _list.size(); ++i) {
+		if (!_list.at(i)->isEqual(*list.at(i))) {
+			return false;
+		}
 	}
 
-	file.close();
+	return true;
 }
 
 } // namespace Bettergrams
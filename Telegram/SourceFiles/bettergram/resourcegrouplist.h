@@ -16,13 +16,15 @@ class ResourceGroupList : public QObject {
 public:
 	typedef QList<QSharedPointer<ResourceGroup>>::const_iterator const_iterator;
 
-	explicit ResourceGroupList(QObject *parent);
+	/// The icon size is given by the owner, so the list does not depend on the styles
+	explicit ResourceGroupList(int iconSize, QObject *parent);
 
 	int freq() const;
 	void setFreq(int freq);
 
 	QDateTime lastUpdate() const;
 	QString lastUpdateString() const;
+	void setLastUpdate(const QDateTime &lastUpdate);
 
 	const_iterator begin() const;
 	const_iterator end() const;
@@ -33,7 +35,12 @@ public:
 	bool isEmpty() const;
 	int count() const;
 
-	bool parseFile(const QString &filePath);
+	/// Icons of the items created after it is disabled are not downloaded.
+	/// It is used by tests and benchmarks which do not run an event loop
+	bool isIconsFetchingEnabled() const;
+	void setIsIconsFetchingEnabled(bool isIconsFetchingEnabled);
+
+	/// Parse the data and emit updated() signal only if the groups have been changed
 	bool parse(const QByteArray &byteArray);
 
 public slots:
@@ -52,6 +59,10 @@ private:
 	/// Default value is 1 hour
 	static const int _defaultFreq = 60 * 60;
 
+	/// Size of the resource icons in pixels
+	const int _iconSize;
+	bool _isIconsFetchingEnabled = true;
+
 	QList<QSharedPointer<ResourceGroup>> _list;
 
 	/// Frequency of updates in seconds
@@ -60,12 +71,8 @@ private:
 	QDateTime _lastUpdate;
 	QString _lastUpdateString;
 
-	QByteArray _lastSourceHash;
-
-	void setLastUpdate(const QDateTime &lastUpdate);
-
 	bool parse(const QJsonObject &json);
-	void save(const QByteArray &byteArray);
+	bool isEqual(const QList<QSharedPointer<ResourceGroup>> &list) const;
 };
 
 } // namespace Bettergram
@@ -1,12 +1,10 @@
 #include "resourceitem.h"
 
-#include <styles/style_chat_helpers.h>
-
 namespace Bettergram {
 
-ResourceItem::ResourceItem() :
+ResourceItem::ResourceItem(int iconSize) :
 	QObject(nullptr),
-	_icon(st::resourcesPanImageSize, st::resourcesPanImageSize, nullptr)
+	_icon(iconSize, iconSize, nullptr)
 {
 	connect(&_icon, &RemoteImage::imageChanged, this, &ResourceItem::iconChanged);
 }
@@ -14,12 +12,14 @@ ResourceItem::ResourceItem() :
 ResourceItem::ResourceItem(const QString &title,
 						   const QString &description,
 						   const QUrl &link,
-						   const QUrl &iconLink) :
+						   const QUrl &iconLink,
+						   int iconSize,
+						   bool isNeedDownloadIcon) :
 	QObject(nullptr),
 	_title(title),
 	_description(description),
 	_link(link),
-	_icon(iconLink, st::resourcesPanImageSize, st::resourcesPanImageSize, true, nullptr)
+	_icon(iconLink, iconSize, iconSize, isNeedDownloadIcon, nullptr)
 {
 	connect(&_icon, &RemoteImage::imageChanged, this, &ResourceItem::iconChanged);
 }
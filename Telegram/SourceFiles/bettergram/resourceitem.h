@@ -13,12 +13,14 @@ class ResourceItem : public QObject {
 	Q_OBJECT
 
 public:
-	explicit ResourceItem();
+	explicit ResourceItem(int iconSize);
 
 	explicit ResourceItem(const QString &title,
 						  const QString &description,
 						  const QUrl &link,
-						  const QUrl &iconLink);
+						  const QUrl &iconLink,
+						  int iconSize,
+						  bool isNeedDownloadIcon);
 
 	const QString &title() const;
 	const QString &description() const;
@@ -9,6 +9,21 @@
 
 namespace Bettergram {
 
+// Minimum interval between fetches in seconds
+const int RssChannel::_minFetchInterval = 60;
+
+// Interval between fetches in seconds while the publish interval is unknown
+const int RssChannel::_defaultFetchInterval = 15 * 60;
+
+// Maximum interval between fetches in seconds of successfully fetched channels
+const int RssChannel::_maxFetchInterval = 2 * 60 * 60;
+
+// Maximum interval between fetches in seconds of failed channels
+const int RssChannel::_maxFailedFetchInterval = 6 * 60 * 60;
+
+// Number of the latest items which we use to count the publish interval
+const int RssChannel::_publishIntervalItemsCount = 10;
+
 void RssChannel::sort(QList<QSharedPointer<RssItem>> &items)
 {
 	std::sort(items.begin(), items.end(), &RssChannel::compare);
@@ -108,6 +123,16 @@ const QString &RssChannel::skipHours() const
 void RssChannel::setSkipHours(const QString &skipHours)
 {
 	_skipHours = skipHours;
+	_skipHoursList.clear();
+
+	for (const QString &hour : _skipHours.split(',', QString::SkipEmptyParts)) {
+		bool ok = false;
+		const int value = hour.trimmed().toInt(&ok);
+
+		if (ok && value >= 0 && value <= 23) {
+			_skipHoursList.push_back(value);
+		}
+	}
 }
 
 const QString &RssChannel::skipDays() const
@@ -118,6 +143,27 @@ const QString &RssChannel::skipDays() const
 void RssChannel::setSkipDays(const QString &skipDays)
 {
 	_skipDays = skipDays;
+	_skipDaysList.clear();
+
+	for (const QString &day : _skipDays.split(',', QString::SkipEmptyParts)) {
+		// Days are always in English in RSS feeds, so we do not use QLocale here
+		static const QStringList days = {
+			QStringLiteral("monday"),
+			QStringLiteral("tuesday"),
+			QStringLiteral("wednesday"),
+			QStringLiteral("thursday"),
+			QStringLiteral("friday"),
+			QStringLiteral("saturday"),
+			QStringLiteral("sunday")
+		};
+
+		const int index = days.indexOf(day.trimmed().toLower());
+
+		if (index != -1) {
+			// Qt::DayOfWeek starts from Monday = 1
+			_skipDaysList.push_back(index + 1);
+		}
+	}
 }
 const QUrl &RssChannel::feedLink() const
 {
@@ -149,6 +195,31 @@ void RssChannel::setIsFailed(bool isFailed)
 	_isFailed = isFailed;
 }
 
+bool RssChannel::isImagesFetchingEnabled() const
+{
+	return _isImagesFetchingEnabled;
+}
+
+void RssChannel::setIsImagesFetchingEnabled(bool isImagesFetchingEnabled)
+{
+	_isImagesFetchingEnabled = isImagesFetchingEnabled;
+}
+
+const QByteArray &RssChannel::eTag() const
+{
+	return _eTag;
+}
+
+const QByteArray &RssChannel::lastModified() const
+{
+	return _lastModified;
+}
+
+const QDateTime &RssChannel::nextFetchTime() const
+{
+	return _nextFetchTime;
+}
+
 QByteArray RssChannel::countSourceHash(const QByteArray &source) const
 {
 	return QCryptographicHash::hash(source, QCryptographicHash::Sha256);
@@ -211,7 +282,8 @@ int RssChannel::countUnread() const
 
 bool RssChannel::isMayFetchNewData() const
 {
-	return !_isFetching;
+	return !_isFetching
+			&& (!_nextFetchTime.isValid() || _nextFetchTime <= QDateTime::currentDateTimeUtc());
 }
 
 void RssChannel::markAsRead()
@@ -232,23 +304,120 @@ void RssChannel::startFetching()
 	setIsFetching(true);
 }
 
-void RssChannel::fetchingSucceed(const QByteArray &source)
+void RssChannel::fetchingSucceed(const QByteArray &source,
+								 const QByteArray &eTag,
+								 const QByteArray &lastModified,
+								 int maxAge)
 {
 	// Update source only if it has been changed
 	if (countSourceHash(source) != _lastSourceHash) {
 		_source = source;
 	}
 
+	_eTag = eTag;
+	_lastModified = lastModified;
+	_failedCount = 0;
+
 	setIsFetching(false);
 	setIsFailed(false);
+
+	scheduleNextFetch(maxAge);
+	emit fetchStateChanged();
+}
+
+void RssChannel::fetchingNotModified(int maxAge)
+{
+	_source.clear();
+	_failedCount = 0;
+
+	setIsFetching(false);
+	setIsFailed(false);
+
+	scheduleNextFetch(maxAge);
+	emit fetchStateChanged();
 }
 
 void RssChannel::fetchingFailed()
 {
 	LOG(("Fetching failed for %1").arg(_feedLink.toString()));
 	_source.clear();
+	_failedCount++;
+
 	setIsFetching(false);
 	setIsFailed(true);
+
+	scheduleNextFetch(0);
+	emit fetchStateChanged();
+}
+
+void RssChannel::countPublishInterval()
+{
+	// Items are sorted from the newest one
+	QList<qint64> intervals;
+
+	for (int i = 1; i < qMin(_list.size(), _publishIntervalItemsCount); ++i) {
+		const QDateTime &newer = _list.at(i - 1)->publishDate();
+		const QDateTime &older = _list.at(i)->publishDate();
+
+		if (newer.isValid() && older.isValid()) {
+			intervals.push_back(older.secsTo(newer));
+		}
+	}
+
+	if (intervals.isEmpty()) {
+		_publishInterval = 0;
+		return;
+	}
+
+	std::sort(intervals.begin(), intervals.end());
+
+	_publishInterval = static_cast<int>(qMin<qint64>(intervals.at(intervals.size() / 2),
+													 std::numeric_limits<int>::max()));
+}
+
+void RssChannel::scheduleNextFetch(int maxAge)
+{
+	int interval = 0;
+
+	if (_isFailed) {
+		// Exponential backoff for failed channels
+		interval = _minFetchInterval;
+
+		for (int i = 1; i < _failedCount && interval < _maxFailedFetchInterval; ++i) {
+			interval *= 2;
+		}
+
+		interval = qMin(interval, _maxFailedFetchInterval);
+	} else {
+		// We fetch a channel a few times per its usual publish interval,
+		// so active channels stay fresh and quiet ones are not fetched in vain
+		interval = (_publishInterval > 0)
+				? qBound(_minFetchInterval, _publishInterval / 4, _maxFetchInterval)
+				: _defaultFetchInterval;
+
+		interval = qMax(interval, qMin(maxAge, _maxFetchInterval));
+	}
+
+	// Random jitter up to 10% spreads fetches of different channels over time
+	interval += static_cast<int>(rand_value<quint32>() % static_cast<quint32>(interval / 10 + 1));
+
+	QDateTime nextFetchTime = QDateTime::currentDateTimeUtc().addSecs(interval);
+
+	// Move the fetch time to the next hour that is not skipped, a week at most
+	for (int i = 0; i < 7 * 24 && isSkipped(nextFetchTime); ++i) {
+		const QTime time = nextFetchTime.time();
+		nextFetchTime = nextFetchTime.addSecs(60 * 60 - time.minute() * 60 - time.second());
+	}
+
+	_nextFetchTime = nextFetchTime;
+}
+
+bool RssChannel::isSkipped(const QDateTime &dateTime) const
+{
+	const QDateTime utc = dateTime.toUTC();
+
+	return _skipHoursList.contains(utc.time().hour())
+			|| _skipDaysList.contains(utc.date().dayOfWeek());
 }
 
 void RssChannel::removeOldItems()
@@ -311,6 +480,7 @@ bool RssChannel::parse()
 	_source.clear();
 
 	sort(_list);
+	countPublishInterval();
 
 	return true;
 }
@@ -399,9 +569,9 @@ void RssChannel::parseChannel(QXmlStreamReader &xml)
 		} else if (xmlName == QLatin1String("lastBuildDate")) {
 			setLastBuildDate(QDateTime::fromString(xml.readElementText(), Qt::RFC2822Date));
 		} else if (xmlName == QLatin1String("skipHours")) {
-			setSkipHours(xml.readElementText());
+			parseSkipHours(xml);
 		} else if (xmlName == QLatin1String("skipDays")) {
-			setSkipDays(xml.readElementText());
+			parseSkipDays(xml);
 		} else if (xmlName == QLatin1String("category")) {
 			_categoryList.push_back(xml.readElementText());
 		} else {
@@ -410,6 +580,36 @@ void RssChannel::parseChannel(QXmlStreamReader &xml)
 	}
 }
 
+void RssChannel::parseSkipHours(QXmlStreamReader &xml)
+{
+	QStringList hours;
+
+	while (xml.readNextStartElement()) {
+		if (xml.name() == QLatin1String("hour")) {
+			hours.push_back(xml.readElementText().trimmed());
+		} else {
+			xml.skipCurrentElement();
+		}
+	}
+
+	setSkipHours(hours.join(','));
+}
+
+void RssChannel::parseSkipDays(QXmlStreamReader &xml)
+{
+	QStringList days;
+
+	while (xml.readNextStartElement()) {
+		if (xml.name() == QLatin1String("day")) {
+			days.push_back(xml.readElementText().trimmed());
+		} else {
+			xml.skipCurrentElement();
+		}
+	}
+
+	setSkipDays(days.join(','));
+}
+
 void RssChannel::parseChannelImage(QXmlStreamReader &xml)
 {
 	while (xml.readNextStartElement()) {
@@ -474,6 +674,10 @@ void RssChannel::load(QSettings &settings)
 	setSkipDays(settings.value("skipDays").toString());
 	setCategoryList(settings.value("categoryList").toStringList());
 
+	_eTag = settings.value("eTag").toByteArray();
+	_lastModified = settings.value("lastModified").toByteArray();
+	_nextFetchTime = settings.value("nextFetchTime").toDateTime();
+
 	int size = settings.beginReadArray("items");
 
 	for (int i = 0; i < size; i++) {
@@ -485,6 +689,8 @@ void RssChannel::load(QSettings &settings)
 	}
 
 	settings.endArray();
+
+	countPublishInterval();
 }
 
 void RssChannel::save(QSettings &settings)
@@ -505,6 +711,9 @@ void RssChannel::save(QSettings &settings)
 	settings.setValue("skipHours", skipHours());
 	settings.setValue("skipDays", skipDays());
 	settings.setValue("categoryList", categoryList());
+	settings.setValue("eTag", eTag());
+	settings.setValue("lastModified", lastModified());
+	settings.setValue("nextFetchTime", nextFetchTime());
 
 	settings.beginWriteArray("items", _list.size());
 
@@ -44,9 +44,11 @@ public:
 	const QDateTime &lastBuildDate() const;
 	void setLastBuildDate(const QDateTime &lastBuildDate);
 
+	/// Comma separated list of hours in GMT (0-23) when the channel should not be fetched
 	const QString &skipHours() const;
 	void setSkipHours(const QString &skipHours);
 
+	/// Comma separated list of days (Monday-Sunday) when the channel should not be fetched
 	const QString &skipDays() const;
 	void setSkipDays(const QString &skipDays);
 
@@ -56,6 +58,17 @@ public:
 	bool isFetching() const;
 	bool isFailed() const;
 
+	/// Images of the items created after it is disabled are not downloaded.
+	/// It is used by tests and benchmarks which do not run an event loop
+	bool isImagesFetchingEnabled() const;
+	void setIsImagesFetchingEnabled(bool isImagesFetchingEnabled);
+
+	/// HTTP cache validators of the last fetched feeds
+	const QByteArray &eTag() const;
+	const QByteArray &lastModified() const;
+
+	const QDateTime &nextFetchTime() const;
+
 	const_iterator begin() const;
 	const_iterator end() const;
 
@@ -67,12 +80,19 @@ public:
 	int count() const;
 	int countUnread() const;
 
+	/// Returns true if the channel is not fetching now and its next fetch time has come
 	bool isMayFetchNewData() const;
 
 	void markAsRead() override;
 
 	void startFetching();
-	void fetchingSucceed(const QByteArray &source);
+
+	/// The maxAge is taken from the Cache-Control header in seconds, 0 if it is absent
+	void fetchingSucceed(const QByteArray &source,
+						 const QByteArray &eTag,
+						 const QByteArray &lastModified,
+						 int maxAge);
+	void fetchingNotModified(int maxAge);
 	void fetchingFailed();
 
 	/// Parse fetched source xml data and return true only when the data is changed
@@ -87,6 +107,9 @@ signals:
 	void isReadChanged();
 	void updated();
 
+	/// HTTP cache validators or the next fetch time are changed, they should be saved
+	void fetchStateChanged();
+
 protected:
 
 private:
@@ -96,13 +119,13 @@ private:
 	QString _webMasterEmail;
 	QStringList _categoryList;
 
-	//TODO: bettergram: use publish date and last build date properties
 	QDateTime _publishDate;
 	QDateTime _lastBuildDate;
 
-	//TODO: bettergram: use skip hours and skip days properties
 	QString _skipHours;
 	QString _skipDays;
+	QList<int> _skipHoursList;
+	QList<int> _skipDaysList;
 
 	QUrl _feedLink;
 
@@ -110,6 +133,33 @@ private:
 	QByteArray _lastSourceHash;
 	bool _isFetching = false;
 	bool _isFailed = false;
+	bool _isImagesFetchingEnabled = true;
+
+	QByteArray _eTag;
+	QByteArray _lastModified;
+
+	/// Number of fetches failed in a row
+	int _failedCount = 0;
+
+	/// Median interval between the latest items in seconds, 0 if it is unknown
+	int _publishInterval = 0;
+
+	QDateTime _nextFetchTime;
+
+	/// Minimum interval between fetches in seconds
+	static const int _minFetchInterval;
+
+	/// Interval between fetches in seconds while the publish interval is unknown
+	static const int _defaultFetchInterval;
+
+	/// Maximum interval between fetches in seconds of successfully fetched channels
+	static const int _maxFetchInterval;
+
+	/// Maximum interval between fetches in seconds of failed channels
+	static const int _maxFailedFetchInterval;
+
+	/// Number of the latest items which we use to count the publish interval
+	static const int _publishIntervalItemsCount;
 
 	QList<QSharedPointer<RssItem>> _list;
 
@@ -122,6 +172,13 @@ private:
 
 	void removeOldItems();
 
+	void countPublishInterval();
+	void scheduleNextFetch(int maxAge);
+	bool isSkipped(const QDateTime &dateTime) const;
+
+	void parseSkipHours(QXmlStreamReader &xml);
+	void parseSkipDays(QXmlStreamReader &xml);
+
 	void parseRss(QXmlStreamReader &xml);
 	void parseAtomFeed(QXmlStreamReader &xml);
 	void parseChannel(QXmlStreamReader &xml);
@@ -7,10 +7,12 @@
 
 #include <QCryptographicHash>
 #include <QJsonDocument>
+#include <QTimerEvent>
 
 namespace Bettergram {
 
 const int RssChannelList::_defaultFreq = 60;
+const int RssChannelList::_saveDelay = 5 * 1000;
 
 QString RssChannelList::getName(NewsType newsType)
 {
@@ -186,6 +188,7 @@ void RssChannelList::add(QSharedPointer<RssChannel> &channel)
 {
 	connect(channel.data(), &RssChannel::iconChanged, this, &RssChannelList::iconChanged);
 	connect(channel.data(), &RssChannel::isReadChanged, this, &RssChannelList::onIsReadChanged);
+	connect(channel.data(), &RssChannel::fetchStateChanged, this, &RssChannelList::onFetchStateChanged);
 
 	_list.push_back(channel);
 }
@@ -318,6 +321,11 @@ void RssChannelList::parseChannelList(const QJsonObject &json)
 
 void RssChannelList::save()
 {
+	if (_saveTimerId) {
+		killTimer(_saveTimerId);
+		_saveTimerId = 0;
+	}
+
 	QSettings settings(BettergramService::instance()->settingsPath(_name), QSettings::IniFormat);
 
 	settings.beginGroup(_name);
@@ -366,4 +374,18 @@ void RssChannelList::onIsReadChanged()
 	save();
 }
 
+void RssChannelList::onFetchStateChanged()
+{
+	if (!_saveTimerId) {
+		_saveTimerId = startTimer(_saveDelay, Qt::VeryCoarseTimer);
+	}
+}
+
+void RssChannelList::timerEvent(QTimerEvent *timerEvent)
+{
+	if (timerEvent->timerId() == _saveTimerId) {
+		save();
+	}
+}
+
 } // namespace Bettergrams
@@ -69,11 +69,16 @@ signals:
 	void updated();
 
 protected:
+	void timerEvent(QTimerEvent *timerEvent) override;
 
 private:
 	/// Default frequency of updates in seconds
 	static const int _defaultFreq;
 
+	/// Delay of saving fetch states of the channels in milliseconds,
+	/// so states of channels fetched together are saved at once
+	static const int _saveDelay;
+
 	QList<QSharedPointer<RssChannel>> _list;
 
 	const NewsType _newsType;
@@ -90,6 +95,7 @@ private:
 	QDateTime _lastUpdate;
 	QString _lastUpdateString;
 	QByteArray _lastSourceHash;
+	int _saveTimerId = 0;
 
 	static QString getName(NewsType newsType);
 
@@ -102,6 +108,7 @@ private:
 
 private slots:
 	void onIsReadChanged();
+	void onFetchStateChanged();
 };
 
 } // namespace Bettergram
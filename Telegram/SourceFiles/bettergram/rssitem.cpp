@@ -18,6 +18,8 @@ RssItem::RssItem(RssChannel *channel) :
 		throw std::invalid_argument("RSS Channel is null");
 	}
 
+	setIsImageDownloadEnabled(_channel->isImagesFetchingEnabled());
+
 	connect(_channel, &RssChannel::destroyed, this, &RssItem::onChannelDestroyed);
 }
 
@@ -46,6 +48,8 @@ RssItem::RssItem(const QString &guid,
 		throw std::invalid_argument("RSS Channel is null");
 	}
 
+	setIsImageDownloadEnabled(_channel->isImagesFetchingEnabled());
+
 	connect(_channel, &RssChannel::destroyed, this, &RssItem::onChannelDestroyed);
 }
 
@@ -357,6 +361,7 @@ void RssItem::createImageFromSite()
 	}
 
 	_imageFromSite = new ImageFromSite(_channel->iconWidth(), _channel->iconHeight(), this);
+	_imageFromSite->setIsDownloadEnabled(_channel->isImagesFetchingEnabled());
 
 	connect(_imageFromSite, &ImageFromSite::imageChanged, this, &RssItem::imageChanged);
 }
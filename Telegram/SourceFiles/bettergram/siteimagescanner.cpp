@@ -0,0 +1,451 @@
+#include "siteimagescanner.h"
+
+#include <cstring>
+
+namespace Bettergram {
+
+namespace {
+
+bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+/// Characters which may be at image links inside file names, like in the previous regular expression
+bool isFileNameChar(char c)
+{
+	return (c >= 'a' && c <= 'z')
+			|| (c >= 'A' && c <= 'Z')
+			|| isDigit(c)
+			|| c == '_'
+			|| c == '-'
+			|| c == '/'
+			|| c == '.';
+}
+
+bool startsWith(const char *begin, const char *end, const char *prefix)
+{
+	const int size = static_cast<int>(std::strlen(prefix));
+	return (end - begin) >= size && std::memcmp(begin, prefix, size) == 0;
+}
+
+bool isTagName(const char *tag, int size, const char *name)
+{
+	const int nameSize = static_cast<int>(std::strlen(name));
+
+	return size >= nameSize
+			&& qstrnicmp(tag, name, nameSize) == 0
+			&& (size == nameSize || isSpace(tag[nameSize]) || tag[nameSize] == '/');
+}
+
+QUrl toUrl(QByteArray link)
+{
+	link.replace("&amp;", "&");
+	return QUrl(QString::fromUtf8(link.trimmed()));
+}
+
+} // namespace
+
+// We stop scanning if we have already found an image with this size or larger
+const int SiteImageScanner::_goodEnoughWidth = 550;
+const int SiteImageScanner::_goodEnoughHeight = 310;
+
+// Useful tags are usually at the top of a page, so we do not download the whole large pages
+const int SiteImageScanner::_maxScannedSize = 512 * 1024;
+
+// We skip broken tags and links which are longer than this size
+static const int kMaxTagSize = 16 * 1024;
+
+bool SiteImageScanner::Image::isGoodEnough() const
+{
+	return width >= _goodEnoughWidth && height >= _goodEnoughHeight;
+}
+
+void SiteImageScanner::append(const QByteArray &data)
+{
+	if (_isFinished || data.isEmpty()) {
+		return;
+	}
+
+	_buffer.append(data);
+	_scannedSize += data.size();
+
+	scan(false);
+
+	if (!_isFinished && _scannedSize >= _maxScannedSize) {
+		finish();
+	}
+}
+
+void SiteImageScanner::finish()
+{
+	if (!_isFinished) {
+		scan(true);
+	}
+
+	_isFinished = true;
+	_buffer.clear();
+}
+
+bool SiteImageScanner::isFinished() const
+{
+	return _isFinished;
+}
+
+QUrl SiteImageScanner::imageLink() const
+{
+	if (!_metaImage.isEmpty()) {
+		return toUrl(_metaImage);
+	}
+
+	if (_tagImage.isGoodEnough() && _fileNameImage.isGoodEnough()) {
+		return toUrl(_tagImage.position <= _fileNameImage.position
+					 ? _tagImage.link
+					 : _fileNameImage.link);
+	} else if (_fileNameImage.height > _tagImage.height) {
+		return toUrl(_fileNameImage.link);
+	} else if (_fileNameImage.height == _tagImage.height
+			   && _fileNameImage.width > _tagImage.width) {
+		return toUrl(_fileNameImage.link);
+	} else if (!_tagImage.link.isEmpty()) {
+		return toUrl(_tagImage.link);
+	}
+
+	return QUrl();
+}
+
+QUrl SiteImageScanner::findImageLink(const QByteArray &source)
+{
+	SiteImageScanner scanner;
+
+	scanner.append(source);
+	scanner.finish();
+
+	return scanner.imageLink();
+}
+
+void SiteImageScanner::scan(bool isLastPart)
+{
+	scanTags(isLastPart);
+
+	if (!_metaImage.isEmpty() || _tagImage.isGoodEnough()) {
+		_isFinished = true;
+		_buffer.clear();
+		return;
+	}
+
+	scanFileNames(isLastPart);
+
+	if (_fileNameImage.isGoodEnough()) {
+		_isFinished = true;
+		_buffer.clear();
+		return;
+	}
+
+	removeScannedData();
+}
+
+void SiteImageScanner::scanTags(bool isLastPart)
+{
+	const char *data = _buffer.constData();
+	const int size = _buffer.size();
+
+	while (_tagPosition < size) {
+		const char *tagBegin = static_cast<const char*>(
+					std::memchr(data + _tagPosition, '<', size - _tagPosition));
+
+		if (!tagBegin) {
+			_tagPosition = size;
+			break;
+		}
+
+		const int tagStart = static_cast<int>(tagBegin - data) + 1;
+		const char *tagEnd = static_cast<const char*>(
+					std::memchr(data + tagStart, '>', size - tagStart));
+
+		if (!tagEnd) {
+			if (isLastPart) {
+				parseTag(data + tagStart, size - tagStart, _bufferOffset + tagStart);
+				_tagPosition = size;
+			} else if (size - tagStart > kMaxTagSize) {
+				_tagPosition = tagStart;
+				continue;
+			} else {
+				// Wait the rest of the tag
+				_tagPosition = tagStart - 1;
+			}
+
+			break;
+		}
+
+		parseTag(data + tagStart, static_cast<int>(tagEnd - data) - tagStart, _bufferOffset + tagStart);
+		_tagPosition = static_cast<int>(tagEnd - data) + 1;
+
+		if (!_metaImage.isEmpty() || _tagImage.isGoodEnough()) {
+			break;
+		}
+	}
+}
+
+void SiteImageScanner::scanFileNames(bool isLastPart)
+{
+	const char *data = _buffer.constData();
+	const int size = _buffer.size();
+
+	while (_fileNamePosition < size) {
+		const int linkStart = _buffer.indexOf("http", _fileNamePosition);
+
+		if (linkStart == -1) {
+			// Keep the end of the buffer because it can be a start of a link
+			_fileNamePosition = isLastPart ? size : qMax(_fileNamePosition, size - 7);
+			break;
+		}
+
+		const char *begin = data + linkStart;
+		const char *end = data + size;
+		const char *bodyBegin = nullptr;
+
+		if (startsWith(begin, end, "http://")) {
+			bodyBegin = begin + 7;
+		} else if (startsWith(begin, end, "https://")) {
+			bodyBegin = begin + 8;
+		} else if (!isLastPart && (end - begin) < 8) {
+			// Wait the rest of the link
+			_fileNamePosition = linkStart;
+			break;
+		} else {
+			_fileNamePosition = linkStart + 4;
+			continue;
+		}
+
+		const char *bodyEnd = bodyBegin;
+
+		while (bodyEnd < end && isFileNameChar(*bodyEnd)) {
+			++bodyEnd;
+		}
+
+		if (bodyEnd == end && !isLastPart && (bodyEnd - begin) <= kMaxTagSize) {
+			// Wait the rest of the link
+			_fileNamePosition = linkStart;
+			break;
+		}
+
+		parseFileName(begin, bodyEnd, _bufferOffset + linkStart);
+		_fileNamePosition = static_cast<int>(bodyEnd - data);
+
+		if (_fileNameImage.isGoodEnough()) {
+			break;
+		}
+	}
+}
+
+void SiteImageScanner::removeScannedData()
+{
+	const int scanned = qMin(_tagPosition, _fileNamePosition);
+
+	if (scanned > 0) {
+		_buffer.remove(0, scanned);
+		_bufferOffset += scanned;
+		_tagPosition -= scanned;
+		_fileNamePosition -= scanned;
+	}
+}
+
+void SiteImageScanner::parseTag(const char *tag, int size, qint64 position)
+{
+	if (isTagName(tag, size, "meta")) {
+		parseMetaTag(tag, size);
+	} else if (isTagName(tag, size, "img")) {
+		parseImageTag(tag, size, position);
+	}
+}
+
+void SiteImageScanner::parseMetaTag(const char *tag, int size)
+{
+	if (!_metaImage.isEmpty()) {
+		return;
+	}
+
+	QByteArray key = attributeValue(tag, size, "property");
+
+	if (key.isEmpty()) {
+		key = attributeValue(tag, size, "name");
+	}
+
+	key = key.trimmed().toLower();
+
+	if (key == "og:image"
+			|| key == "og:image:url"
+			|| key == "og:image:secure_url"
+			|| key == "twitter:image"
+			|| key == "twitter:image:src") {
+		_metaImage = attributeValue(tag, size, "content").trimmed();
+	}
+}
+
+void SiteImageScanner::parseImageTag(const char *tag, int size, qint64 position)
+{
+	const QByteArray link = attributeValue(tag, size, "src");
+
+	if (link.isEmpty()) {
+		return;
+	}
+
+	addImage(_tagImage,
+			 link,
+			 attributeValue(tag, size, "width").toInt(),
+			 attributeValue(tag, size, "height").toInt(),
+			 position);
+}
+
+void SiteImageScanner::parseFileName(const char *begin, const char *end, qint64 position)
+{
+	// Look for the last "-640x480.jpg" like suffix at the link,
+	// the extension may be jpg, png or jpeg after any character
+
+	for (const char *extension = end - 3; extension - 2 > begin; --extension) {
+		const char *extensionEnd = nullptr;
+
+		if (startsWith(extension, end, "jpeg")) {
+			extensionEnd = extension + 4;
+		} else if (startsWith(extension, end, "jpg") || startsWith(extension, end, "png")) {
+			extensionEnd = extension + 3;
+		} else {
+			continue;
+		}
+
+		const char *heightEnd = extension - 1;
+		const char *heightBegin = heightEnd;
+
+		while (heightBegin > begin && isDigit(*(heightBegin - 1))) {
+			--heightBegin;
+		}
+
+		if (heightBegin == heightEnd || heightBegin - 1 <= begin || *(heightBegin - 1) != 'x') {
+			continue;
+		}
+
+		const char *widthEnd = heightBegin - 1;
+		const char *widthBegin = widthEnd;
+
+		while (widthBegin > begin && isDigit(*(widthBegin - 1))) {
+			--widthBegin;
+		}
+
+		if (widthBegin == widthEnd || widthBegin - 1 <= begin) {
+			continue;
+		}
+
+		const char separator = *(widthBegin - 1);
+
+		if (separator != '-' && separator != '_') {
+			continue;
+		}
+
+		addImage(_fileNameImage,
+				 QByteArray(begin, static_cast<int>(extensionEnd - begin)),
+				 QByteArray(widthBegin, static_cast<int>(widthEnd - widthBegin)).toInt(),
+				 QByteArray(heightBegin, static_cast<int>(heightEnd - heightBegin)).toInt(),
+				 position);
+		return;
+	}
+}
+
+void SiteImageScanner::addImage(Image &largest,
+								const QByteArray &link,
+								int width,
+								int height,
+								qint64 position)
+{
+	if (height > largest.height
+			|| (height == largest.height && width > largest.width)
+			|| (largest.width == 0 && largest.height == 0)) {
+		largest.link = link;
+		largest.width = width;
+		largest.height = height;
+		largest.position = position;
+	}
+}
+
+QByteArray SiteImageScanner::attributeValue(const char *tag, int size, const char *name)
+{
+	const int nameSize = static_cast<int>(std::strlen(name));
+	int i = 0;
+
+	// Skip the tag name
+	while (i < size && !isSpace(tag[i])) {
+		++i;
+	}
+
+	while (i < size) {
+		const int iterationStart = i;
+
+		while (i < size && (isSpace(tag[i]) || tag[i] == '/')) {
+			++i;
+		}
+
+		const int attributeNameStart = i;
+
+		while (i < size && !isSpace(tag[i]) && tag[i] != '=' && tag[i] != '/') {
+			++i;
+		}
+
+		const int attributeNameEnd = i;
+
+		while (i < size && isSpace(tag[i])) {
+			++i;
+		}
+
+		int valueStart = i;
+		int valueEnd = i;
+
+		if (i < size && tag[i] == '=') {
+			++i;
+
+			while (i < size && isSpace(tag[i])) {
+				++i;
+			}
+
+			if (i < size && (tag[i] == '"' || tag[i] == '\'')) {
+				const char quote = tag[i];
+				valueStart = ++i;
+
+				while (i < size && tag[i] != quote) {
+					++i;
+				}
+
+				valueEnd = i;
+
+				if (i < size) {
+					++i;
+				}
+			} else {
+				valueStart = i;
+
+				while (i < size && !isSpace(tag[i])) {
+					++i;
+				}
+
+				valueEnd = i;
+			}
+		}
+
+		if (attributeNameEnd - attributeNameStart == nameSize
+				&& qstrnicmp(tag + attributeNameStart, name, nameSize) == 0) {
+			return QByteArray(tag + valueStart, valueEnd - valueStart);
+		}
+
+		if (i == iterationStart) {
+			++i;
+		}
+	}
+
+	return QByteArray();
+}
+
+} // namespace Bettergram
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QByteArray>
+#include <QUrl>
+
+namespace Bettergram {
+
+/**
+ * @brief The SiteImageScanner class looks for the largest image at html source of a site.
+ * It takes the source by parts while it is downloading and works with bytes,
+ * so we do not need to wait the whole page and convert it to a string.
+ * The og:image and twitter:image meta tags are preferred, then image tags
+ * and image file names with sizes like image-640x480.jpg.
+ * It does not use Qt objects, so it can be used at any thread.
+ */
+class SiteImageScanner {
+public:
+	/// We stop scanning if we have already found an image with this size or larger
+	static const int _goodEnoughWidth;
+	static const int _goodEnoughHeight;
+
+	/// We do not scan sites larger than this size in bytes
+	static const int _maxScannedSize;
+
+	/// Scan the next part of the site source
+	void append(const QByteArray &data);
+
+	/// There is no more data, scan the rest of the source
+	void finish();
+
+	/// Returns true if a good enough image is found or the whole source is scanned,
+	/// we do not need the rest of the site source after that
+	bool isFinished() const;
+
+	QUrl imageLink() const;
+
+	/// Scan the whole site source at once
+	static QUrl findImageLink(const QByteArray &source);
+
+private:
+	struct Image {
+		QByteArray link;
+		int width = 0;
+		int height = 0;
+		qint64 position = 0;
+
+		bool isGoodEnough() const;
+	};
+
+	QByteArray _buffer;
+
+	/// Position of the buffer start at the whole source
+	qint64 _bufferOffset = 0;
+
+	/// Positions at the buffer where we should continue scanning
+	int _tagPosition = 0;
+	int _fileNamePosition = 0;
+
+	qint64 _scannedSize = 0;
+	bool _isFinished = false;
+
+	QByteArray _metaImage;
+	Image _tagImage;
+	Image _fileNameImage;
+
+	void scan(bool isLastPart);
+	void scanTags(bool isLastPart);
+	void scanFileNames(bool isLastPart);
+	void removeScannedData();
+
+	void parseTag(const char *tag, int size, qint64 position);
+	void parseMetaTag(const char *tag, int size);
+	void parseImageTag(const char *tag, int size, qint64 position);
+	void parseFileName(const char *begin, const char *end, qint64 position);
+
+	static void addImage(Image &largest, const QByteArray &link, int width, int height, qint64 position);
+
+	/// Returns value of the html attribute or empty string if there is no such attribute
+	static QByteArray attributeValue(const char *tag, int size, const char *name);
+};
+
+} // namespace Bettergram
@@ -70,32 +70,32 @@ public:
 
 	bool contains(int y) const
 	{
-		if (y >= top() && y <= bottom()) {
-			//TODO: bettergram: we can optimize this by using dichotomy for example
-			for (const Row &row : _list) {
-				if (row.contains(y)) {
-					return true;
-				}
-			}
-		}
-
-		return false;
+		return findRowIndex(y) != -1;
 	}
 
 	int findRowIndex(int y) const
 	{
-		if (y >= top() && y <= bottom()) {
-			//TODO: bettergram: we can optimize this by using dichotomy for example
-			for (int i = 0; i < _list.count(); i++) {
-				if (_list.at(i).contains(y)) {
-					return i;
-				}
-			}
+		const int index = findFirstRowIndex(y);
+
+		if (index < _list.count() && _list.at(index).contains(y)) {
+			return index;
 		}
 
 		return -1;
 	}
 
+	/// Returns index of the first row which bottom is not above the y coordinate
+	/// or count() if there are no such rows.
+	/// Rows are sorted by their top, so we can use binary search here
+	int findFirstRowIndex(int y) const
+	{
+		const auto it = std::lower_bound(_list.cbegin(), _list.cend(), y, [](const Row &row, int value) {
+			return row.bottom() < value;
+		});
+
+		return static_cast<int>(it - _list.cbegin());
+	}
+
 	const_iterator begin() const
 	{
 		return _list.cbegin();
@@ -132,8 +132,18 @@ public:
 
 	void insert(int index, const TUserData &userData, int height)
 	{
-		_list.insert(index, Row(userData, bottomAt(index) + _spacing, height));
-		updateGeometry();
+		_list.insert(index, Row(userData, bottomAt(index - 1) + _spacing, height));
+		updateGeometry(index);
+	}
+
+	void removeAt(int index)
+	{
+		if (index < 0 || index >= _list.count()) {
+			return;
+		}
+
+		_list.removeAt(index);
+		updateGeometry(index);
 	}
 
 private:
@@ -142,13 +152,20 @@ private:
 	
 	QList<Row> _list;
 
-	void updateGeometry()
+	/// Rows before the from index are not changed
+	void updateGeometry(int from = 0)
 	{
-		int rowTop = _top;
+		if (from < 0) {
+			from = 0;
+		} else if (from >= _list.count()) {
+			return;
+		}
+
+		int rowTop = (from == 0) ? _top : (_list.at(from - 1).bottom() + _spacing);
 
-		for (Row &row : _list) {
-			row.setTop(rowTop);
-			rowTop += row.height() + _spacing;
+		for (int i = from; i < _list.count(); i++) {
+			_list[i].setTop(rowTop);
+			rowTop += _list.at(i).height() + _spacing;
 		}
 	}
 };
@@ -0,0 +1,67 @@
+#include "list_row_cache.h"
+
+namespace ChatHelpers {
+
+ListRowCache::ListRowCache(int maxSize) : _cache(maxSize)
+{
+}
+
+const QPixmap &ListRowCache::get(const void *key,
+								 const QSize &size,
+								 quint64 state,
+								 const PaintCallback &paint)
+{
+	const Entry *entry = _cache.object(key);
+
+	if (entry && entry->size == size && entry->state == state) {
+		return entry->pixmap;
+	}
+
+	QImage image(size * cIntRetinaFactor(), QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(cRetinaFactor());
+	image.fill(Qt::transparent);
+
+	{
+		Painter painter(&image);
+		paint(painter, size.width(), size.height());
+	}
+
+	const int cost = image.byteCount();
+
+	if (cost > _cache.maxCost()) {
+		_cache.remove(key);
+		_uncachedPixmap = App::pixmapFromImageInPlace(std::move(image));
+
+		return _uncachedPixmap;
+	}
+
+	Entry *newEntry = new Entry();
+
+	newEntry->size = size;
+	newEntry->state = state;
+	newEntry->pixmap = App::pixmapFromImageInPlace(std::move(image));
+
+	// QCache takes ownership of the entry and replaces the previous one
+	_cache.insert(key, newEntry, cost);
+
+	return newEntry->pixmap;
+}
+
+void ListRowCache::remove(const void *key)
+{
+	_cache.remove(key);
+}
+
+void ListRowCache::clear()
+{
+	_cache.clear();
+	_uncachedPixmap = QPixmap();
+}
+
+quint64 ListRowCache::combineState(quint64 state, quint64 value)
+{
+	// The same mixing as in boost::hash_combine
+	return state ^ (value + 0x9e3779b97f4a7c15ULL + (state << 6) + (state >> 2));
+}
+
+} // namespace ChatHelpers
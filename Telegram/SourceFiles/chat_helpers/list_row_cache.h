@@ -0,0 +1,43 @@
+#pragma once
+
+namespace ChatHelpers {
+
+/**
+ * @brief ListRowCache keeps rendered contents of the recently painted list rows.
+ * Rows are laid out and painted again only when their size or state is changed,
+ * the least recently used pixmaps are removed when the cache is full.
+ * The size of the cache is limited by the memory used by pixmaps, not by the count of rows.
+ */
+class ListRowCache
+{
+public:
+	typedef std::function<void(Painter &painter, int width, int height)> PaintCallback;
+
+	/// Maximum size of all cached pixmaps in bytes
+	explicit ListRowCache(int maxSize);
+
+	/// The key identifies a row and the state should be changed every time when the row should be repainted.
+	/// The paint callback is called only if there is no cached pixmap for the same key, size and state.
+	/// The returned pixmap is valid only until the next call of this method
+	const QPixmap &get(const void *key, const QSize &size, quint64 state, const PaintCallback &paint);
+
+	void remove(const void *key);
+	void clear();
+
+	/// Combine a new value with the state of a row
+	static quint64 combineState(quint64 state, quint64 value);
+
+private:
+	struct Entry {
+		QSize size;
+		quint64 state = 0;
+		QPixmap pixmap;
+	};
+
+	QCache<const void*, Entry> _cache;
+
+	/// It is used for pixmaps that are larger than the whole cache
+	QPixmap _uncachedPixmap;
+};
+
+} // namespace ChatHelpers
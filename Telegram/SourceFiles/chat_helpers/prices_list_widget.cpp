@@ -4,6 +4,7 @@
 
 #include <bettergram/bettergramservice.h>
 #include <bettergram/cryptopricelist.h>
+#include <bettergram/cryptopricestream.h>
 #include <bettergram/cryptoprice.h>
 
 #include <ui/widgets/buttons.h>
@@ -23,6 +24,69 @@ namespace ChatHelpers {
 
 using namespace Bettergram;
 
+namespace {
+
+QPixmap createSparkline(const CryptoPriceHistory::Series &series)
+{
+	const int width = st::pricesPanTableSparklineWidth;
+	const int height = st::pricesPanTableSparklineHeight;
+	const quint32 now = static_cast<quint32>(QDateTime::currentSecsSinceEpoch());
+	const quint32 from = now - static_cast<quint32>(CryptoPriceHistory::_period);
+
+	int first = 0;
+
+	while (first < series.count() && series.timeAt(first) < from) {
+		first++;
+	}
+
+	if (series.count() - first < 2) {
+		return QPixmap();
+	}
+
+	float minPrice = series.priceAt(first);
+	float maxPrice = minPrice;
+
+	for (int i = first + 1; i < series.count(); ++i) {
+		minPrice = qMin(minPrice, series.priceAt(i));
+		maxPrice = qMax(maxPrice, series.priceAt(i));
+	}
+
+	const float priceRange = maxPrice - minPrice;
+	const qreal stroke = st::lineWidth;
+
+	QPolygonF line;
+	line.reserve(series.count() - first);
+
+	for (int i = first; i < series.count(); ++i) {
+		const qreal x = (width - stroke) * (series.timeAt(i) - from) / CryptoPriceHistory::_period;
+
+		// A flat line is drawn in the middle
+		const qreal y = priceRange > 0.0f
+				? (height - stroke) * (maxPrice - series.priceAt(i)) / priceRange
+				: (height - stroke) / 2.0;
+
+		line.push_back(QPointF(x + stroke / 2.0, y + stroke / 2.0));
+	}
+
+	const bool isUp = series.priceAt(series.count() - 1) >= series.priceAt(first);
+
+	QImage image(QSize(width, height) * cIntRetinaFactor(), QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(cRetinaFactor());
+	image.fill(Qt::transparent);
+
+	{
+		Painter painter(&image);
+		PainterHighQualityEnabler hq(painter);
+
+		painter.setPen(QPen(isUp ? st::pricesPanTableUpFg->c : st::pricesPanTableDownFg->c, stroke));
+		painter.drawPolyline(line);
+	}
+
+	return App::pixmapFromImageInPlace(std::move(image));
+}
+
+} // namespace
+
 class PricesListWidget::Footer : public TabbedSelector::InnerFooter
 {
 public:
@@ -159,6 +223,9 @@ PricesListWidget::PricesListWidget(QWidget* parent, not_null<Window::Controller*
 	connect(priceList, &CryptoPriceList::isShowOnlyFavoritesChanged,
 			this, &PricesListWidget::onIsShowOnlyFavoritesChanged);
 
+	connect(BettergramService::instance()->cryptoPriceStream(), &CryptoPriceStream::isActiveChanged,
+			this, &PricesListWidget::onCryptoPriceStreamIsActiveChanged);
+
 	setMouseTracking(true);
 
 	onIsShowOnlyFavoritesChanged();
@@ -222,13 +289,52 @@ object_ptr<TabbedSelector::InnerFooter> PricesListWidget::createFooter()
 
 void PricesListWidget::afterShown()
 {
-	startPriceListTimer();
+	_isShown = true;
+
+	// We poll prices only while the price stream is not active
+	if (!BettergramService::instance()->cryptoPriceStream()->isActive()) {
+		startPriceListTimer();
+	}
+
 	getCryptoPriceValues();
 }
 
 void PricesListWidget::beforeHiding()
 {
+	_isShown = false;
+
 	stopPriceListTimer();
+	BettergramService::instance()->cryptoPriceStream()->unsubscribe();
+}
+
+void PricesListWidget::updatePriceStreamSubscription()
+{
+	if (!_isShown) {
+		return;
+	}
+
+	QStringList shortNames = BettergramService::instance()->cryptoPriceList()->getFavoritesShortNames();
+
+	for (const QSharedPointer<CryptoPrice> &price : _pricesAtCurrentPage) {
+		shortNames.push_back(price->shortName());
+	}
+
+	BettergramService::instance()->cryptoPriceStream()->subscribe(shortNames);
+}
+
+void PricesListWidget::onCryptoPriceStreamIsActiveChanged()
+{
+	if (!_isShown) {
+		return;
+	}
+
+	if (BettergramService::instance()->cryptoPriceStream()->isActive()) {
+		stopPriceListTimer();
+	} else {
+		// We may miss some changes while the stream was reconnecting
+		startPriceListTimer();
+		getCryptoPriceValues();
+	}
 }
 
 void PricesListWidget::timerEvent(QTimerEvent *event)
@@ -237,7 +343,15 @@ void PricesListWidget::timerEvent(QTimerEvent *event)
 		getCryptoPriceValues();
 	} else if (event->timerId() == _searchTimerId) {
 		stopSearchPriceListTimer();
-		searchCryptoPriceNames();
+
+		CryptoPriceList *const priceList = BettergramService::instance()->cryptoPriceList();
+
+		if (priceList->isSearchInProgress()) {
+			searchCryptoPriceNames();
+		} else if (priceList->isSearching()) {
+			// Search results are already shown, we fetch values only for the current page
+			getCryptoPriceValues();
+		}
 	}
 }
 
@@ -288,6 +402,7 @@ void PricesListWidget::stopSearchPriceListTimer()
 void PricesListWidget::setSelectedRow(int selectedRow)
 {
 	if (_selectedRow != selectedRow) {
+		const int previousSelectedRow = _selectedRow;
 		_selectedRow = selectedRow;
 
 		if (_selectedRow >= 0) {
@@ -296,7 +411,14 @@ void PricesListWidget::setSelectedRow(int selectedRow)
 			setCursor(style::cur_default);
 		}
 
-		update();
+		// Repaint only rows which hover state is changed
+		if (previousSelectedRow >= 0) {
+			update(getRowRectangle(previousSelectedRow));
+		}
+
+		if (_selectedRow >= 0) {
+			update(getRowRectangle(_selectedRow));
+		}
 	}
 }
 
@@ -513,6 +635,8 @@ void PricesListWidget::paintEvent(QPaintEvent *event) {
 			- _coinHeader->contentsMargins().right()
 			- st::pricesPanTableFavoriteImageSize
 			- st::pricesPanTableImageSize
+			- st::pricesPanTablePadding
+			- st::pricesPanTableSparklineWidth
 			- st::pricesPanTablePadding;
 
 	int columnPriceWidth = _priceHeader->width()
@@ -535,6 +659,10 @@ void PricesListWidget::paintEvent(QPaintEvent *event) {
 			+ st::pricesPanTableImageSize
 			+ st::pricesPanTablePadding;
 
+	int columnCoinSparklineLeft = columnCoinTextLeft
+			+ columnCoinWidth
+			+ st::pricesPanTablePadding;
+
 	int favoriteButtonHovered = -1;
 
 	// Draw rows
@@ -556,6 +684,17 @@ void PricesListWidget::paintEvent(QPaintEvent *event) {
 	painter.setFont(st::semiboldFont);
 
 	for (int i = 0; i < _pricesAtCurrentPage.count(); ++i) {
+		// Skip rows outside of the updated area
+
+		if (top > r.bottom()) {
+			break;
+		}
+
+		if (top + st::pricesPanTableRowHeight <= r.top()) {
+			top += st::pricesPanTableRowHeight;
+			continue;
+		}
+
 		const QSharedPointer<CryptoPrice> &price = _pricesAtCurrentPage.at(i);
 
 		const style::icon *favoriteIcon = nullptr;
@@ -611,6 +750,14 @@ void PricesListWidget::paintEvent(QPaintEvent *event) {
 						 Qt::AlignLeft | Qt::AlignTop,
 						 price->shortName());
 
+		const QPixmap &sparkline = getSparkline(price);
+
+		if (!sparkline.isNull()) {
+			painter.drawPixmap(columnCoinSparklineLeft,
+							   top + (st::pricesPanTableRowHeight - st::pricesPanTableSparklineHeight) / 2,
+							   sparkline);
+		}
+
 		switch (price->minuteDirection()) {
 		case(CryptoPrice::Direction::Up): {
 			painter.setPen(st::pricesPanTableUpFg);
@@ -649,6 +796,46 @@ void PricesListWidget::paintEvent(QPaintEvent *event) {
 	}
 }
 
+const QPixmap &PricesListWidget::getSparkline(const QSharedPointer<CryptoPrice> &price)
+{
+	static const QPixmap empty;
+
+	const CryptoPriceHistory::Series *series =
+			BettergramService::instance()->cryptoPriceList()->history().find(price->shortName());
+
+	if (!series) {
+		return empty;
+	}
+
+	Sparkline &sparkline = _sparklines[price->shortName()];
+
+	if (sparkline.revision != series->revision()) {
+		sparkline.revision = series->revision();
+		sparkline.pixmap = createSparkline(*series);
+	}
+
+	return sparkline.pixmap;
+}
+
+void PricesListWidget::removeUnusedSparklines()
+{
+	for (auto it = _sparklines.begin(); it != _sparklines.end();) {
+		const QString &shortName = it.key();
+
+		const bool isUsed = std::any_of(_pricesAtCurrentPage.cbegin(),
+										_pricesAtCurrentPage.cend(),
+										[&shortName](const QSharedPointer<CryptoPrice> &price) {
+			return price->shortName() == shortName;
+		});
+
+		if (isUsed) {
+			++it;
+		} else {
+			it = _sparklines.erase(it);
+		}
+	}
+}
+
 void PricesListWidget::resizeEvent(QResizeEvent *e)
 {
 	updateControlsGeometry();
@@ -895,9 +1082,19 @@ void PricesListWidget::onSearchCryptoPriceNamesUpdated()
 
 	_pageIndicator->setCurrentPage(0);
 
-	_urlForFetchingCurrentPage =
-			service->getSearchCryptoPriceValues(startRowIndexInCurrentPage(),
-												_numberOfRowsInOnePage);
+	// We show found coins with the last known values right away
+	_pricesAtCurrentPage = priceList->searchList().mid(startRowIndexInCurrentPage(), _numberOfRowsInOnePage);
+
+	updatePagesCount();
+	updateListIsEmptyLabel();
+	update();
+
+	// While a user types search text we fetch values when the search timer is fired
+	if (!_searchTimerId) {
+		_urlForFetchingCurrentPage =
+				service->getSearchCryptoPriceValues(startRowIndexInCurrentPage(),
+													_numberOfRowsInOnePage);
+	}
 }
 
 void PricesListWidget::onCryptoPriceValuesUpdated(const QUrl &url,
@@ -911,6 +1108,9 @@ void PricesListWidget::onCryptoPriceValuesUpdated(const QUrl &url,
 		_pricesAtCurrentPage = QList<QSharedPointer<CryptoPrice>>();
 	}
 
+	updatePriceStreamSubscription();
+	removeUnusedSparklines();
+
 	updatePagesCount();
 	updateLastUpdateLabel();
 	updateListIsEmptyLabel();
@@ -941,13 +1141,15 @@ void PricesListWidget::onSearchTextChanged()
 
 	CryptoPriceList *const priceList = BettergramService::instance()->cryptoPriceList();
 
+	// We start timer here in order to decrease number of requests to servers when a user types search text.
+	// If names are fetched we search them locally right away and fetch values when the timer is fired,
+	// otherwise we ask servers to search names when the timer is fired
+	startSearchPriceListTimer();
+
 	priceList->setSearchText(_searchTextEdit->getLastText());
 
-	if (priceList->isSearching()) {
-		// We start timer here instead of just call searchCryptoPriceValues()
-		// in order to decrease number of requests to servers when a user types search text
-		startSearchPriceListTimer();
-	} else {
+	if (!priceList->isSearching()) {
+		stopSearchPriceListTimer();
 		getCryptoPriceValues();
 	}
 
@@ -62,8 +62,16 @@ protected:
 private:
 	class Footer;
 
+	/// Cached sparkline of the latest 24 hours prices of one cryptocurrency
+	struct Sparkline {
+		/// Revision of the price history when the pixmap was created
+		quint64 revision = 0;
+		QPixmap pixmap;
+	};
+
 	int _timerId = 0;
 	int _searchTimerId = 0;
+	bool _isShown = false;
 	int _selectedRow = -1;
 	int _pressedRow = -1;
 	int _pressedFavoriteIcon = -1;
@@ -78,6 +86,9 @@ private:
 	QUrl _urlForFetchingCurrentPage;
 	QList<QSharedPointer<Bettergram::CryptoPrice>> _pricesAtCurrentPage;
 
+	/// Sparklines of the prices at the current page by short names
+	QHash<QString, Sparkline> _sparklines;
+
 	Ui::FlatLabel *_lastUpdateLabel = nullptr;
 	Ui::IconButton *_siteName = nullptr;
 	Ui::FlatLabel *_marketCap = nullptr;
@@ -94,6 +105,11 @@ private:
 	TableColumnHeaderWidget *_24hHeader = nullptr;
 	Footer *_footer = nullptr;
 
+	/// Returns null pixmap if there are not enough samples.
+	/// It is regenerated only when new samples are added to the price history
+	const QPixmap &getSparkline(const QSharedPointer<Bettergram::CryptoPrice> &price);
+	void removeUnusedSparklines();
+
 	void getCryptoPriceValues();
 	void searchCryptoPriceNames();
 
@@ -127,6 +143,9 @@ private:
 	void startPriceListTimer();
 	void stopPriceListTimer();
 
+	/// Subscribe the price stream to the coins at the current page and favorites
+	void updatePriceStreamSubscription();
+
 	void startSearchPriceListTimer();
 	void stopSearchPriceListTimer();
 
@@ -135,6 +154,7 @@ private slots:
 	void onPriceColumnSortOrderChanged();
 	void on24hColumnSortOrderChanged();
 
+	void onCryptoPriceStreamIsActiveChanged();
 	void onCryptoPriceNamesUpdated();
 	void onSearchCryptoPriceNamesUpdated();
 
@@ -22,6 +22,9 @@ namespace ChatHelpers {
 
 using namespace Bettergram;
 
+// Maximum size of rendered rows kept in memory, in bytes
+const int ResourcesWidget::_rowCacheSize = 8 * 1024 * 1024;
+
 class ResourcesWidget::Footer : public TabbedSelector::InnerFooter
 {
 public:
@@ -61,7 +64,8 @@ void ResourcesWidget::Footer::onFooterClicked()
 }
 
 ResourcesWidget::ResourcesWidget(QWidget* parent, not_null<Window::Controller*> controller)
-	: Inner(parent, controller)
+	: Inner(parent, controller),
+	  _rowCache(_rowCacheSize)
 {
 	_lastUpdateLabel = new Ui::FlatLabel(this, st::resourcesPanLastUpdateLabel);
 
@@ -146,6 +150,7 @@ void ResourcesWidget::stopResourcesTimer()
 void ResourcesWidget::setSelectedRow(int selectedRow)
 {
 	if (_selectedRow != selectedRow) {
+		const int previousSelectedRow = _selectedRow;
 		_selectedRow = selectedRow;
 
 		if (_selectedRow >= 0) {
@@ -154,7 +159,9 @@ void ResourcesWidget::setSelectedRow(int selectedRow)
 			setCursor(style::cur_default);
 		}
 
-		update();
+		// Repaint only rows which hover state is changed
+		updateRow(previousSelectedRow);
+		updateRow(_selectedRow);
 	}
 }
 
@@ -290,81 +297,131 @@ void ResourcesWidget::paintEvent(QPaintEvent *event) {
 
 	painter.fillRect(r, st::resourcesPanBg);
 
-	const int iconLeft = st::resourcesPanPadding;
-	const int iconSize = st::resourcesPanImageSize;
+	// Draw only visible rows, each row is rendered once and then is taken from the cache
 
-	const int textLeft = iconLeft + iconSize + st::resourcesPanPadding;
-	const int textRight = width();
-	const int textWidth = textRight - textLeft;
+	for (int i = _rows.findFirstRowIndex(r.top()); i < _rows.count(); i++) {
+		const ListRow<Row> &row = _rows.at(i);
 
-	// Draw rows
+		if (row.top() > r.bottom()) {
+			break;
+		}
 
-	for (int i = 0; i < _rows.count(); i++) {
-		const ListRow<Row> &row = _rows.at(i);
+		const Row &data = row.userData();
+		const void *key = nullptr;
 
-		if (row.bottom() < r.top()) {
+		if (data.isItem()) {
+			key = data.item().data();
+		} else if (data.isGroup()) {
+			key = data.group().data();
+		} else {
+			LOG(("Unable to recognize row content"));
 			continue;
 		}
 
-		if (row.top() > r.bottom()) {
-			break;
-		}
+		const bool isSelected = (i == _selectedRow);
 
-		if (row.userData().isItem()) {
-			if (i == _selectedRow) {
-				QRect rowRectangle(0, row.top(), width(), row.height());
-				App::roundRect(painter, rowRectangle, st::resourcesPanHover, StickerHoverCorners);
-			}
+		const QPixmap &pixmap = _rowCache.get(key,
+											  QSize(width(), row.height()),
+											  countRowState(data, isSelected),
+											  [&data, isSelected](Painter &rowPainter, int rowWidth, int rowHeight) {
+			paintRow(rowPainter, data, isSelected, rowWidth, rowHeight);
+		});
 
-			QRect rowRect(textLeft,
-						  row.top() + st::resourcesPanRowVerticalPadding,
-						  textWidth,
-						  row.height() - 2 * st::resourcesPanRowVerticalPadding);
+		painter.drawPixmap(0, row.top(), pixmap);
+	}
+}
 
-			painter.setFont(st::semiboldFont);
-			painter.setPen(st::resourcesPanItemTitleFg);
+quint64 ResourcesWidget::countRowState(const Row &row, bool isSelected)
+{
+	quint64 state = ListRowCache::combineState(0, st::resourcesPanBg->c.rgba());
 
-			int titleFlags = Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap;
-			const QString &title = row.userData().item()->title();
+	if (row.isItem()) {
+		const QSharedPointer<ResourceItem> &item = row.item();
 
-			QRect boundingRect = painter.boundingRect(rowRect, titleFlags, title);
+		state = ListRowCache::combineState(state, isSelected ? 1 : 0);
+		state = ListRowCache::combineState(state, st::resourcesPanHover->c.rgba());
+		state = ListRowCache::combineState(state, st::resourcesPanItemTitleFg->c.rgba());
+		state = ListRowCache::combineState(state, st::resourcesPanItemDescriptionFg->c.rgba());
+		state = ListRowCache::combineState(state, qHash(item->title()));
+		state = ListRowCache::combineState(state, qHash(item->description()));
+		state = ListRowCache::combineState(state, item->icon().cacheKey());
+	} else if (row.isGroup()) {
+		state = ListRowCache::combineState(state, st::resourcesPanGroupFg->c.rgba());
+		state = ListRowCache::combineState(state, qHash(row.group()->title()));
+	}
 
-			if (boundingRect.height() >= rowRect.height()) {
-				boundingRect.setHeight(rowRect.height());
-				TextHelper::drawElidedText(painter, rowRect, title);
-			} else {
-				painter.drawText(boundingRect, titleFlags, title, &boundingRect);
+	return state;
+}
 
-				painter.setFont(st::normalFont);
-				painter.setPen(st::resourcesPanItemDescriptionFg);
+void ResourcesWidget::paintRow(Painter &painter, const Row &row, bool isSelected, int rowWidth, int rowHeight)
+{
+	painter.fillRect(0, 0, rowWidth, rowHeight, st::resourcesPanBg);
 
-				QRect descriptionRect(textLeft, boundingRect.bottom(),
-									  textWidth, rowRect.bottom() - boundingRect.bottom());
+	const int iconLeft = st::resourcesPanPadding;
+	const int iconSize = st::resourcesPanImageSize;
 
-				TextHelper::drawElidedText(painter,
-										   descriptionRect,
-										   row.userData().item()->description());
-			}
+	const int textLeft = iconLeft + iconSize + st::resourcesPanPadding;
+	const int textRight = rowWidth;
+	const int textWidth = textRight - textLeft;
 
-			if (!row.userData().item()->icon().isNull()) {
-				QRect targetRect(iconLeft,
-								 rowRect.top() + (rowRect.height() - st::resourcesPanImageSize) / 2,
-								 st::resourcesPanImageSize,
-								 st::resourcesPanImageSize);
+	if (row.isItem()) {
+		if (isSelected) {
+			App::roundRect(painter, QRect(0, 0, rowWidth, rowHeight), st::resourcesPanHover, StickerHoverCorners);
+		}
 
-				painter.drawPixmap(targetRect, row.userData().item()->icon());
-			}
-		} else if (row.userData().isGroup()) {
-			painter.setFont(st::semiboldFont);
-			painter.setPen(st::resourcesPanGroupFg);
+		QRect rowRect(textLeft,
+					  st::resourcesPanRowVerticalPadding,
+					  textWidth,
+					  rowHeight - 2 * st::resourcesPanRowVerticalPadding);
 
-			painter.drawText(iconLeft, row.top(), width(), row.height(),
-							 Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWordWrap,
-							 row.userData().group()->title());
+		painter.setFont(st::semiboldFont);
+		painter.setPen(st::resourcesPanItemTitleFg);
+
+		int titleFlags = Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap;
+		const QString &title = row.item()->title();
+
+		QRect boundingRect = painter.boundingRect(rowRect, titleFlags, title);
+
+		if (boundingRect.height() >= rowRect.height()) {
+			boundingRect.setHeight(rowRect.height());
+			TextHelper::drawElidedText(painter, rowRect, title);
 		} else {
-			LOG(("Unable to recognize row content"));
-			continue;
+			painter.drawText(boundingRect, titleFlags, title, &boundingRect);
+
+			painter.setFont(st::normalFont);
+			painter.setPen(st::resourcesPanItemDescriptionFg);
+
+			QRect descriptionRect(textLeft, boundingRect.bottom(),
+								  textWidth, rowRect.bottom() - boundingRect.bottom());
+
+			TextHelper::drawElidedText(painter,
+									   descriptionRect,
+									   row.item()->description());
+		}
+
+		if (!row.item()->icon().isNull()) {
+			QRect targetRect(iconLeft,
+							 rowRect.top() + (rowRect.height() - st::resourcesPanImageSize) / 2,
+							 st::resourcesPanImageSize,
+							 st::resourcesPanImageSize);
+
+			painter.drawPixmap(targetRect, row.item()->icon());
 		}
+	} else if (row.isGroup()) {
+		painter.setFont(st::semiboldFont);
+		painter.setPen(st::resourcesPanGroupFg);
+
+		painter.drawText(iconLeft, 0, rowWidth, rowHeight,
+						 Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWordWrap,
+						 row.group()->title());
+	}
+}
+
+void ResourcesWidget::updateRow(int index)
+{
+	if (index >= 0 && index < _rows.count()) {
+		const ListRow<Row> &row = _rows.at(index);
+		update(0, row.top(), width(), row.height());
 	}
 }
 
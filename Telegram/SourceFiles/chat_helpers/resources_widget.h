@@ -2,6 +2,7 @@
 
 #include "tabbed_selector.h"
 #include "list_row_array.h"
+#include "list_row_cache.h"
 
 namespace Window {
 class Controller;
@@ -93,6 +94,7 @@ private:
 	};
 
 	ListRowArray<Row> _rows;
+	ListRowCache _rowCache;
 
 	int _timerId = 0;
 	int _selectedRow = -1;
@@ -102,6 +104,8 @@ private:
 	Footer *_footer = nullptr;
 	base::unique_qptr<Ui::PopupMenu> _menu = nullptr;
 
+	static const int _rowCacheSize;
+
 	void setSelectedRow(int selectedRow);
 
 	int getListAreaTop() const;
@@ -114,6 +118,10 @@ private:
 	void startResourcesTimer();
 	void stopResourcesTimer();
 
+	static quint64 countRowState(const Row &row, bool isSelected);
+	static void paintRow(Painter &painter, const Row &row, bool isSelected, int rowWidth, int rowHeight);
+	void updateRow(int index);
+
 	void updateRows();
 
 private slots:
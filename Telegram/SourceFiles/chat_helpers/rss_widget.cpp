@@ -24,6 +24,9 @@ namespace ChatHelpers {
 
 using namespace Bettergram;
 
+// Maximum size of rendered rows kept in memory, in bytes
+const int RssWidget::_rowCacheSize = 16 * 1024 * 1024;
+
 class RssWidget::Footer : public TabbedSelector::InnerFooter
 {
 public:
@@ -147,7 +150,8 @@ RssWidget::RssWidget(QWidget* parent,
 	  _channelRowHeight(channelRowHeight),
 	  _dateTimeHeight(dateTimeHeight),
 	  _isShowDescriptions(isShowDescriptions),
-	  _isShowChannelIcons(isShowChannelIcons)
+	  _isShowChannelIcons(isShowChannelIcons),
+	  _rowCache(_rowCacheSize)
 {
 	_lastUpdateLabel = new Ui::FlatLabel(this, st::newsPanLastUpdateLabel);
 	_sortModeLabel = new Ui::FlatLabel(this, st::newsPanSortModeLabel);
@@ -328,6 +332,7 @@ void RssWidget::stopPinnedNewsTimer()
 void RssWidget::setSelectedRow(int selectedRow)
 {
 	if (_selectedRow != selectedRow) {
+		const int previousSelectedRow = _selectedRow;
 		_selectedRow = selectedRow;
 
 		if (_selectedRow >= 0) {
@@ -336,7 +341,9 @@ void RssWidget::setSelectedRow(int selectedRow)
 			setCursor(style::cur_default);
 		}
 
-		update();
+		// Repaint only rows which hover state is changed
+		updateRow(previousSelectedRow);
+		updateRow(_selectedRow);
 	}
 }
 
@@ -408,7 +415,9 @@ void RssWidget::mouseReleaseEvent(QMouseEvent *e)
 			row.item()->markAsRead();
 
 			if (!_isShowRead) {
-				updateRows();
+				removeReadRow(_pressedRow);
+			} else {
+				updateRow(_pressedRow);
 			}
 		} else if(row.isChannel()) {
 			link = row.channel()->link();
@@ -510,6 +519,9 @@ void RssWidget::contextMenuEvent(QContextMenuEvent *e)
 
 	connect(_menu.get(), &QObject::destroyed, [this] {
 		leaveEventHook(nullptr);
+
+		// Menu actions may change many rows, cached rows are repainted only if they are changed
+		update();
 	});
 
 	_menu->popup(e->globalPos());
@@ -526,154 +538,211 @@ void RssWidget::paintEvent(QPaintEvent *event) {
 
 	painter.fillRect(r, _bg);
 
-	const int iconLeft = _padding;
-
-	const int textLeft = iconLeft + _imageWidth + _padding / 2;
-	const int textRight = width();
-	const int textWidth = textRight - textLeft;
-
-	const int channelTextLeft = _isShowChannelIcons ? textLeft : iconLeft;
-
-	// Draw rows
+	// Draw only visible rows, each row is rendered once and then is taken from the cache
 
-	for (int i = 0; i < _rows.count(); i++) {
+	for (int i = _rows.findFirstRowIndex(r.top()); i < _rows.count(); i++) {
 		const ListRow<Row> &row = _rows.at(i);
 
-		if (row.bottom() < r.top()) {
-			continue;
-		}
-
 		if (row.top() > r.bottom()) {
 			break;
 		}
 
-		if (i == _selectedRow) {
-			QRect rowRectangle(0, row.top(), width(), row.height());
-			App::roundRect(painter, rowRectangle, _hover, StickerHoverCorners);
+		const Row &data = row.userData();
+		const void *key = nullptr;
+
+		if (data.isItem()) {
+			key = data.item().data();
+		} else if (data.isChannel()) {
+			key = data.channel().data();
+		} else {
+			LOG(("Unable to recognize row content"));
+			continue;
 		}
 
-		if (row.userData().isItem()) {
-			QRect rowRect(textLeft,
-						  row.top() + _rowVerticalPadding,
-						  textWidth,
-						  row.height() - _dateTimeHeight - 2 * _rowVerticalPadding);
+		const bool isSelected = (i == _selectedRow);
 
-			painter.setFont(st::semiboldFont);
-			painter.setPen(getNewsHeaderColor(row.userData().item()));
+		const QPixmap &pixmap = _rowCache.get(key,
+											  QSize(width(), row.height()),
+											  countRowState(data, isSelected),
+											  [this, &data, isSelected](Painter &rowPainter, int rowWidth, int rowHeight) {
+			paintRow(rowPainter, data, isSelected, rowWidth, rowHeight);
+		});
 
-			int titleFlags = Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap;
-			const QString &title = row.userData().item()->title();
+		painter.drawPixmap(0, row.top(), pixmap);
+	}
+}
+
+quint64 RssWidget::countRowState(const Row &row, bool isSelected) const
+{
+	quint64 state = ListRowCache::combineState(0, isSelected ? 1 : 0);
 
-			QRect boundingRect = painter.boundingRect(rowRect, titleFlags, title);
+	state = ListRowCache::combineState(state, row.isImportant() ? 1 : 0);
+	state = ListRowCache::combineState(state, _bg->c.rgba());
+	state = ListRowCache::combineState(state, _hover->c.rgba());
 
-			if (_isShowDescriptions) {
-				if (boundingRect.height() >= rowRect.height()) {
-					TextHelper::drawElidedText(painter, rowRect, title);
+	if (row.isItem()) {
+		const QSharedPointer<BaseArticlePreviewItem> &item = row.item();
 
-					painter.setFont(st::normalFont);
-					painter.setPen(getNewsBodyColor(row.userData().item()));
-				} else {
-					painter.drawText(boundingRect, titleFlags, title, &boundingRect);
+		state = ListRowCache::combineState(state, item->isRead() ? 1 : 0);
+		state = ListRowCache::combineState(state, getNewsHeaderColor(item)->c.rgba());
+		state = ListRowCache::combineState(state, getNewsBodyColor(item)->c.rgba());
+		state = ListRowCache::combineState(state, qHash(item->title()));
+		state = ListRowCache::combineState(state, qHash(item->description()));
+		state = ListRowCache::combineState(state, qHash(item->publishDateString()));
+		state = ListRowCache::combineState(state, item->image().cacheKey());
+	} else if (row.isChannel()) {
+		const QSharedPointer<BaseArticleGroupPreviewItem> &channel = row.channel();
 
-					painter.setFont(st::normalFont);
-					painter.setPen(getNewsBodyColor(row.userData().item()));
+		state = ListRowCache::combineState(state, _siteNameFg->c.rgba());
+		state = ListRowCache::combineState(state, qHash(channel->title()));
+		state = ListRowCache::combineState(state, channel->icon().cacheKey());
+	}
 
-					int descriptionHeight = rowRect.bottom() - boundingRect.bottom();
+	return state;
+}
 
-					if (descriptionHeight >= _dateTimeHeight / 2) {
-						QRect descriptionRect(textLeft, boundingRect.bottom(),
-											  textWidth, descriptionHeight);
+void RssWidget::paintRow(Painter &painter, const Row &row, bool isSelected, int rowWidth, int rowHeight) const
+{
+	painter.fillRect(0, 0, rowWidth, rowHeight, _bg);
 
-						TextHelper::drawElidedText(painter,
-												   descriptionRect,
-												   row.userData().item()->description());
-					}
-				}
-			} else {
+	if (isSelected) {
+		App::roundRect(painter, QRect(0, 0, rowWidth, rowHeight), _hover, StickerHoverCorners);
+	}
+
+	const int iconLeft = _padding;
+
+	const int textLeft = iconLeft + _imageWidth + _padding / 2;
+	const int textRight = rowWidth;
+	const int textWidth = textRight - textLeft;
+
+	const int channelTextLeft = _isShowChannelIcons ? textLeft : iconLeft;
+
+	if (row.isItem()) {
+		QRect rowRect(textLeft,
+					  _rowVerticalPadding,
+					  textWidth,
+					  rowHeight - _dateTimeHeight - 2 * _rowVerticalPadding);
+
+		painter.setFont(st::semiboldFont);
+		painter.setPen(getNewsHeaderColor(row.item()));
+
+		int titleFlags = Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap;
+		const QString &title = row.item()->title();
+
+		QRect boundingRect = painter.boundingRect(rowRect, titleFlags, title);
+
+		if (_isShowDescriptions) {
+			if (boundingRect.height() >= rowRect.height()) {
 				TextHelper::drawElidedText(painter, rowRect, title);
 
 				painter.setFont(st::normalFont);
-				painter.setPen(getNewsBodyColor(row.userData().item()));
+				painter.setPen(getNewsBodyColor(row.item()));
+			} else {
+				painter.drawText(boundingRect, titleFlags, title, &boundingRect);
+
+				painter.setFont(st::normalFont);
+				painter.setPen(getNewsBodyColor(row.item()));
+
+				int descriptionHeight = rowRect.bottom() - boundingRect.bottom();
+
+				if (descriptionHeight >= _dateTimeHeight / 2) {
+					QRect descriptionRect(textLeft, boundingRect.bottom(),
+										  textWidth, descriptionHeight);
+
+					TextHelper::drawElidedText(painter,
+											   descriptionRect,
+											   row.item()->description());
+				}
 			}
+		} else {
+			TextHelper::drawElidedText(painter, rowRect, title);
 
-			painter.drawText(textLeft,
-							 row.bottom() - _dateTimeHeight - _rowVerticalPadding,
-							 textWidth,
-							 _dateTimeHeight,
-							 Qt::AlignLeft | Qt::AlignBottom,
-							 row.userData().item()->publishDateString());
+			painter.setFont(st::normalFont);
+			painter.setPen(getNewsBodyColor(row.item()));
+		}
 
-			const QPixmap &image = row.userData().item()->image();
+		painter.drawText(textLeft,
+						 rowHeight - _dateTimeHeight - _rowVerticalPadding,
+						 textWidth,
+						 _dateTimeHeight,
+						 Qt::AlignLeft | Qt::AlignBottom,
+						 row.item()->publishDateString());
 
-			if (!image.isNull()) {
-				const int imageTop = row.top() + (row.height() - (image.height() >= _imageHeight ? _imageHeight : image.height())) / 2;
+		const QPixmap &image = row.item()->image();
 
-				QRect targetRect(iconLeft,
-								 imageTop,
-								 _imageWidth,
-								 _imageHeight);
+		if (!image.isNull()) {
+			const int imageTop = (rowHeight - (image.height() >= _imageHeight ? _imageHeight : image.height())) / 2;
 
-				QRect sourceRect(image.width() > _imageWidth ? (image.width() - _imageWidth) / 2 : 0,
-								 image.height() > _imageHeight ? (image.height() - _imageHeight) / 2 : 0,
-								 _imageWidth,
-								 _imageHeight);
+			QRect targetRect(iconLeft,
+							 imageTop,
+							 _imageWidth,
+							 _imageHeight);
 
-				painter.drawPixmap(targetRect, image, sourceRect);
+			QRect sourceRect(image.width() > _imageWidth ? (image.width() - _imageWidth) / 2 : 0,
+							 image.height() > _imageHeight ? (image.height() - _imageHeight) / 2 : 0,
+							 _imageWidth,
+							 _imageHeight);
 
-				if (row.userData().isImportant()) {
-					// Draw important tag
+			painter.drawPixmap(targetRect, image, sourceRect);
 
-					const int importantTagSize = _imageHeight / 2;
+			if (row.isImportant()) {
+				// Draw important tag
 
-					QPainterPath path;
-					path.moveTo(iconLeft, imageTop);
-					path.lineTo(iconLeft, imageTop + importantTagSize);
-					path.lineTo(iconLeft + importantTagSize, imageTop);
-					path.lineTo(iconLeft, imageTop);
+				const int importantTagSize = _imageHeight / 2;
 
-					painter.fillPath(path, _importantBg);
+				QPainterPath path;
+				path.moveTo(iconLeft, imageTop);
+				path.lineTo(iconLeft, imageTop + importantTagSize);
+				path.lineTo(iconLeft + importantTagSize, imageTop);
+				path.lineTo(iconLeft, imageTop);
 
-					painter.setPen(_importantFg);
-					painter.setFont(st::semiboldFont);
-					painter.drawTextLeft(iconLeft + importantTagSize / 4,
-										 imageTop + (_imageWidth == _imageHeight ? 0 : importantTagSize / 6),
-										 0,
-										 "!");
+				painter.fillPath(path, _importantBg);
 
-					painter.setPen(_importantBg);
-					painter.drawRect(0, row.top(), width() - 1, row.height() - 1);
-				}
+				painter.setPen(_importantFg);
+				painter.setFont(st::semiboldFont);
+				painter.drawTextLeft(iconLeft + importantTagSize / 4,
+									 imageTop + (_imageWidth == _imageHeight ? 0 : importantTagSize / 6),
+									 0,
+									 "!");
+
+				painter.setPen(_importantBg);
+				painter.drawRect(0, 0, rowWidth - 1, rowHeight - 1);
 			}
-		} else if (row.userData().isChannel()) {
-			painter.setFont(st::semiboldFont);
-			painter.setPen(_siteNameFg);
+		}
+	} else if (row.isChannel()) {
+		painter.setFont(st::semiboldFont);
+		painter.setPen(_siteNameFg);
 
-			painter.drawText(channelTextLeft, row.top(), textWidth, row.height(),
-							 Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWordWrap,
-							 row.userData().channel()->title());
+		painter.drawText(channelTextLeft, 0, textWidth, rowHeight,
+						 Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWordWrap,
+						 row.channel()->title());
 
-			const QPixmap &image = row.userData().channel()->icon();
+		const QPixmap &image = row.channel()->icon();
 
-			if (!image.isNull()) {
-				QRect targetRect(iconLeft,
-								 row.top() + (row.height() - (image.height() >= _imageHeight ? _imageHeight : image.height())) / 2,
-								 _imageWidth,
-								 _imageHeight);
+		if (!image.isNull()) {
+			QRect targetRect(iconLeft,
+							 (rowHeight - (image.height() >= _imageHeight ? _imageHeight : image.height())) / 2,
+							 _imageWidth,
+							 _imageHeight);
 
-				QRect sourceRect(image.width() > _imageWidth ? (image.width() - _imageWidth) / 2 : 0,
-								 image.height() > _imageHeight ? (image.height() - _imageHeight) / 2 : 0,
-								 _imageWidth,
-								 _imageHeight);
+			QRect sourceRect(image.width() > _imageWidth ? (image.width() - _imageWidth) / 2 : 0,
+							 image.height() > _imageHeight ? (image.height() - _imageHeight) / 2 : 0,
+							 _imageWidth,
+							 _imageHeight);
 
-				painter.drawPixmap(targetRect, image, sourceRect);
-			}
-		} else {
-			LOG(("Unable to recognize row content"));
-			continue;
+			painter.drawPixmap(targetRect, image, sourceRect);
 		}
 	}
 }
 
+void RssWidget::updateRow(int index)
+{
+	if (index >= 0 && index < _rows.count()) {
+		const ListRow<Row> &row = _rows.at(index);
+		update(0, row.top(), width(), row.height());
+	}
+}
+
 void RssWidget::resizeEvent(QResizeEvent *e)
 {
 	updateControlsGeometry();
@@ -814,6 +883,32 @@ void RssWidget::addPinnedNews(const QList<QSharedPointer<PinnedNewsItem>> &news)
 	}
 }
 
+void RssWidget::removeReadRow(int index)
+{
+	if (index < 0 || index >= _rows.count()) {
+		return;
+	}
+
+	// Pinned news are shown even if they are read
+	if (_rows.at(index).userData().isImportant()) {
+		updateRow(index);
+		return;
+	}
+
+	_rows.removeAt(index);
+
+	// Remove the site header if it does not have news anymore
+	if (_isSortBySite && index > 0 && _rows.at(index - 1).userData().isChannel()
+			&& (index == _rows.count() || !_rows.at(index).userData().isItem())) {
+		_rows.removeAt(index - 1);
+	}
+
+	_selectedRow = -1;
+	_pressedRow = -1;
+
+	update();
+}
+
 void RssWidget::updateRows()
 {
 	_rows.clear();
@@ -2,6 +2,7 @@
 
 #include "tabbed_selector.h"
 #include "list_row_array.h"
+#include "list_row_cache.h"
 #include "bettergram/bettergramservice.h"
 
 namespace Window {
@@ -169,7 +170,10 @@ private:
 	const bool _isShowDescriptions;
 	const bool _isShowChannelIcons;
 
+	static const int _rowCacheSize;
+
 	ListRowArray<Row> _rows;
+	ListRowCache _rowCache;
 
 	int _timerId = 0;
 	int _pinnedNewsTimerId = 0;
@@ -219,6 +223,13 @@ private:
 	void addPinnedNews();
 	void addPinnedNews(const QList<QSharedPointer<Bettergram::PinnedNewsItem>> &news);
 
+	quint64 countRowState(const Row &row, bool isSelected) const;
+	void paintRow(Painter &painter, const Row &row, bool isSelected, int rowWidth, int rowHeight) const;
+	void updateRow(int index);
+
+	/// Remove the row without rebuilding the whole list
+	void removeReadRow(int index);
+
 	void updateRows();
 	void createPinnedNewsGroupItem();
 
@@ -423,6 +423,7 @@ void SetPackAndEmoji(
 	set.stickers = std::move(pack);
 	set.dates = std::move(dates);
 	set.emoji.clear();
+	Auth().data().stickersEmojiIndex().markSetChanged(set.id);
 	for_const (auto &mtpPack, packs) {
 		Assert(mtpPack.type() == mtpc_stickerPack);
 		auto &pack = mtpPack.c_stickerPack();
@@ -707,13 +708,16 @@ std::vector<not_null<DocumentData*>> GetListByEmoji(
 		TimeId date = 0;
 	};
 	auto result = std::vector<StickerWithDate>();
-	auto &sets = Auth().data().stickerSetsRef();
-	auto setsToRequest = base::flat_map<uint64, uint64>();
+	auto added = base::flat_set<not_null<DocumentData*>>();
+	const auto &sets = Auth().data().stickerSets();
+	auto &index = Auth().data().stickersEmojiIndex();
+	const auto matches = index.lookup(
+		sets,
+		Auth().data().stickerSetsOrder(),
+		original);
 
 	const auto add = [&](not_null<DocumentData*> document, TimeId date) {
-		if (ranges::find(result, document, [](const StickerWithDate &data) {
-			return data.document;
-		}) == result.end()) {
+		if (added.emplace(document).second) {
 			result.push_back({ document, date });
 		}
 	};
@@ -751,71 +755,52 @@ std::vector<not_null<DocumentData*>> GetListByEmoji(
 		return TimeId(0);
 	};
 
-	auto recentIt = sets.find(Stickers::CloudRecentSetId);
-	if (recentIt != sets.cend()) {
-		auto i = recentIt->emoji.constFind(original);
-		if (i != recentIt->emoji.cend()) {
-			result.reserve(i->size());
-			for (const auto document : *i) {
-				const auto usageDate = [&] {
-					if (recentIt->dates.empty()) {
-						return TimeId(0);
-					}
-					const auto index = recentIt->stickers.indexOf(document);
-					if (index < 0) {
-						return TimeId(0);
-					}
-					Assert(index < recentIt->dates.size());
-					return recentIt->dates[index];
-				}();
-				const auto date = usageDate
-					? usageDate
-					: InstallDate(document);
-				result.push_back({
-					document,
-					date ? date : CreateRecentSortKey(document) });
-			}
+	result.reserve(matches.size());
+	added.reserve(matches.size());
+	for (const auto &match : matches) {
+		const auto document = match.document;
+		const auto it = sets.constFind(match.setId);
+		Assert(it != sets.cend());
+
+		if (it->id == Stickers::CloudRecentSetId) {
+			const auto usageDate = [&] {
+				if (it->dates.empty()) {
+					return TimeId(0);
+				}
+				const auto index = it->stickers.indexOf(document);
+				if (index < 0) {
+					return TimeId(0);
+				}
+				Assert(index < it->dates.size());
+				return it->dates[index];
+			}();
+			const auto date = usageDate
+				? usageDate
+				: InstallDate(document);
+			add(document, date ? date : CreateRecentSortKey(document));
+			continue;
 		}
+		const auto my = (it->flags & MTPDstickerSet::Flag::f_installed_date);
+		const auto installDate = my ? it->installDate : TimeId(0);
+		const auto date = (installDate > 1)
+			? installDate
+			: my
+			? CreateMySortKey()
+			: CreateFeaturedSortKey(document);
+		add(document, date);
 	}
-	const auto addList = [&](const Order &order, MTPDstickerSet::Flag skip) {
-		for (const auto setId : order) {
-			auto it = sets.find(setId);
-			if (it == sets.cend() || (it->flags & skip)) {
-				continue;
-			}
-			if (it->emoji.isEmpty()) {
-				setsToRequest.emplace(it->id, it->access);
-				it->flags |= MTPDstickerSet_ClientFlag::f_not_loaded;
-				continue;
-			}
-			auto i = it->emoji.constFind(original);
-			if (i == it->emoji.cend()) {
-				continue;
-			}
-			const auto my = (it->flags & MTPDstickerSet::Flag::f_installed_date);
-			result.reserve(result.size() + i->size());
-			for (const auto document : *i) {
-				const auto installDate = my ? it->installDate : TimeId(0);
-				const auto date = (installDate > 1)
-					? installDate
-					: my
-					? CreateMySortKey()
-					: CreateFeaturedSortKey(document);
-				add(document, date);
-			}
-		}
-	};
 
-	addList(
-		Auth().data().stickerSetsOrder(),
-		MTPDstickerSet::Flag::f_archived);
-	//addList(
-	//	Auth().data().featuredStickerSetsOrder(),
-	//	MTPDstickerSet::Flag::f_installed_date);
+	const auto &notLoaded = index.notLoadedSets();
+	if (!notLoaded.empty()) {
+		for (const auto setId : notLoaded) {
+			const auto it = sets.constFind(setId);
+			Assert(it != sets.cend());
 
-	if (!setsToRequest.empty()) {
-		for (const auto [setId, accessHash] : setsToRequest) {
-			Auth().api().scheduleStickerSetRequest(setId, accessHash);
+			if (!(it->flags & MTPDstickerSet_ClientFlag::f_not_loaded)) {
+				Auth().data().stickerSetsRef()[setId].flags
+					|= MTPDstickerSet_ClientFlag::f_not_loaded;
+			}
+			Auth().api().scheduleStickerSetRequest(setId, it->access);
 		}
 		Auth().api().requestStickerSets();
 	}
@@ -986,6 +971,7 @@ Set *FeedSetFull(const MTPmessages_StickerSet &data) {
 	} else {
 		set->stickers = pack;
 		set->emoji.clear();
+		Auth().data().stickersEmojiIndex().markSetChanged(set->id);
 		auto &v = d.vpacks.v;
 		for (auto i = 0, l = v.size(); i != l; ++i) {
 			if (v[i].type() != mtpc_stickerPack) continue;
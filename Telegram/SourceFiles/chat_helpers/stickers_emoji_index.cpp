@@ -0,0 +1,270 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "chat_helpers/stickers_emoji_index.h"
+
+#include "data/data_session.h"
+#include "data/data_document.h"
+#include "ui/emoji_config.h"
+#include "auth_session.h"
+
+#include <QtCore/QElapsedTimer>
+
+namespace Stickers {
+namespace {
+
+constexpr auto kBenchmarkSets = 300;
+constexpr auto kBenchmarkStickersInSet = 100;
+constexpr auto kBenchmarkEmoji = 200;
+constexpr auto kBenchmarkLookups = 10000;
+
+} // namespace
+
+bool EmojiIndex::Summary::operator==(const Summary &other) const {
+	return (flags == other.flags)
+		&& (installDate == other.installDate)
+		&& (first == other.first)
+		&& (stickers == other.stickers)
+		&& (dates == other.dates)
+		&& (emoji == other.emoji);
+}
+
+void EmojiIndex::markCheckNeeded() {
+	_checkNeeded = true;
+}
+
+void EmojiIndex::markSetChanged(uint64 setId) {
+	_changedSets.emplace(setId);
+	_checkNeeded = true;
+}
+
+auto EmojiIndex::Summarize(const Set &set) -> Summary {
+	auto result = Summary();
+	result.flags = set.flags;
+	result.installDate = set.installDate;
+	result.first = set.stickers.isEmpty() ? nullptr : set.stickers.front();
+	result.stickers = set.stickers.size();
+	result.dates = int(set.dates.size());
+	result.emoji = set.emoji.size();
+	return result;
+}
+
+void EmojiIndex::check(const Sets &sets, const Order &order) {
+	if (!_checkNeeded) {
+		return;
+	}
+	_checkNeeded = false;
+
+	auto positions = base::flat_map<uint64, int>();
+	positions.reserve(order.size() + 1);
+	if (sets.contains(CloudRecentSetId)) {
+		positions.emplace(CloudRecentSetId, -1);
+	}
+	auto counter = 0;
+	for (const auto setId : order) {
+		const auto i = sets.constFind(setId);
+		if (i != sets.cend()
+			&& !(i->flags & MTPDstickerSet::Flag::f_archived)) {
+			positions.emplace(setId, counter++);
+		}
+	}
+
+	for (auto i = _indexed.begin(); i != _indexed.end();) {
+		if (!positions.contains(i->first)) {
+			remove(i->first, i->second);
+			i = _indexed.erase(i);
+		} else {
+			++i;
+		}
+	}
+
+	_notLoaded.clear();
+	for (const auto &[setId, position] : positions) {
+		const auto &set = *sets.constFind(setId);
+		if (set.emoji.isEmpty() && setId != CloudRecentSetId) {
+			_notLoaded.emplace(setId);
+		}
+		const auto i = _indexed.find(setId);
+		if (i == _indexed.end()) {
+			add(set);
+		} else if (_changedSets.contains(setId)
+			|| i->second.summary != Summarize(set)) {
+			remove(setId, i->second);
+			_indexed.erase(i);
+			add(set);
+		}
+	}
+	_positions = std::move(positions);
+	_changedSets.clear();
+}
+
+void EmojiIndex::add(const Set &set) {
+	auto indexed = Indexed();
+	indexed.summary = Summarize(set);
+	indexed.emoji.reserve(set.emoji.size());
+	for (auto i = set.emoji.cbegin(), e = set.emoji.cend(); i != e; ++i) {
+		if (i->isEmpty()) {
+			continue;
+		}
+		auto &list = _entries[i.key()];
+		list.reserve(list.size() + i->size());
+		auto index = 0;
+		for (const auto document : *i) {
+			list.push_back({ document, set.id, index++ });
+		}
+		indexed.emoji.push_back(i.key());
+	}
+	_indexed.emplace(set.id, std::move(indexed));
+}
+
+void EmojiIndex::remove(uint64 setId, const Indexed &indexed) {
+	for (const auto emoji : indexed.emoji) {
+		const auto i = _entries.find(emoji);
+		if (i == _entries.end()) {
+			continue;
+		}
+		auto &list = i->second;
+		list.erase(ranges::remove(list, setId, &Entry::setId), end(list));
+		if (list.empty()) {
+			_entries.erase(i);
+		}
+	}
+}
+
+auto EmojiIndex::lookup(
+	const Sets &sets,
+	const Order &order,
+	EmojiPtr original)
+-> std::vector<Match> {
+	check(sets, order);
+
+	const auto i = _entries.find(original);
+	if (i == _entries.end()) {
+		return {};
+	}
+	auto list = i->second;
+	const auto position = [&](const Entry &entry) {
+		const auto j = _positions.find(entry.setId);
+		Assert(j != _positions.end());
+		return j->second;
+	};
+	ranges::sort(list, std::less<>(), [&](const Entry &entry) {
+		return std::make_pair(position(entry), entry.index);
+	});
+	return ranges::view::all(
+		list
+	) | ranges::view::transform([](const Entry &entry) {
+		return Match{ entry.document, entry.setId };
+	}) | ranges::to_vector;
+}
+
+const base::flat_set<uint64> &EmojiIndex::notLoadedSets() const {
+	return _notLoaded;
+}
+
+QString BenchmarkEmojiIndex() {
+	const auto emojiCount = std::min(
+		Ui::Emoji::internal::FullCount(),
+		kBenchmarkEmoji);
+	if (emojiCount <= 0) {
+		return QString();
+	}
+	auto emoji = std::vector<EmojiPtr>();
+	for (auto i = 0; i != emojiCount; ++i) {
+		emoji.push_back(Ui::Emoji::internal::ByIndex(i)->original());
+	}
+
+	auto documents = std::vector<std::unique_ptr<DocumentData>>();
+	auto sets = Sets();
+	auto order = Order();
+	auto random = uint32(0x2545F491U);
+	const auto next = [&] {
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return random;
+	};
+	for (auto s = 0; s != kBenchmarkSets; ++s) {
+		const auto setId = uint64(s + 1);
+		auto set = Set(
+			setId,
+			0,
+			QString(),
+			QString(),
+			kBenchmarkStickersInSet,
+			0,
+			MTPDstickerSet::Flag::f_installed_date,
+			TimeId(s + 2),
+			ImagePtr());
+		for (auto d = 0; d != kBenchmarkStickersInSet; ++d) {
+			documents.push_back(std::make_unique<DocumentData>(
+				&Auth().data(),
+				DocumentId(setId * kBenchmarkStickersInSet + d)));
+			const auto document = documents.back().get();
+			set.stickers.push_back(document);
+			set.emoji[emoji[next() % emoji.size()]].push_back(document);
+			if (next() % 3 == 0) {
+				set.emoji[emoji[next() % emoji.size()]].push_back(document);
+			}
+		}
+		sets.insert(setId, set);
+		order.push_back(setId);
+	}
+
+	const auto elapsed = [](auto &&method) {
+		auto timer = QElapsedTimer();
+		timer.start();
+		method();
+		return timer.nsecsElapsed() / 1000000.;
+	};
+	auto index = EmojiIndex();
+	auto found = 0;
+	const auto build = elapsed([&] {
+		found += index.lookup(sets, order, emoji.front()).size();
+	});
+	const auto lookups = elapsed([&] {
+		for (auto i = 0; i != kBenchmarkLookups; ++i) {
+			found += index.lookup(
+				sets,
+				order,
+				emoji[i % emoji.size()]).size();
+		}
+	});
+	const auto scan = elapsed([&] {
+		for (auto i = 0; i != kBenchmarkLookups; ++i) {
+			const auto original = emoji[i % emoji.size()];
+			for (const auto setId : order) {
+				const auto j = sets.constFind(setId);
+				const auto k = j->emoji.constFind(original);
+				if (k != j->emoji.cend()) {
+					found += k->size();
+				}
+			}
+		}
+	});
+	const auto update = elapsed([&] {
+		order.push_back(order.front());
+		order.pop_front();
+		index.markSetChanged(order.back());
+		index.markCheckNeeded();
+		found += index.lookup(sets, order, emoji.front()).size();
+	});
+	return qsl("Sets: %1, stickers: %2, emoji: %3, matches: %4\n"
+		"Build: %5 ms\n"
+		"Index lookup: %6 ms\n"
+		"Sets scan: %7 ms\n"
+		"Reorder and update one set: %8 ms"
+	).arg(kBenchmarkSets
+	).arg(kBenchmarkSets * kBenchmarkStickersInSet
+	).arg(emojiCount
+	).arg(found
+	).arg(build, 0, 'f', 3
+	).arg(lookups / kBenchmarkLookups, 0, 'f', 4
+	).arg(scan / kBenchmarkLookups, 0, 'f', 4
+	).arg(update, 0, 'f', 3);
+}
+
+} // namespace Stickers
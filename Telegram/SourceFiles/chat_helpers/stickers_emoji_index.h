@@ -0,0 +1,83 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+#include "chat_helpers/stickers.h"
+
+namespace Stickers {
+
+// Maps original emoji to stickers of the cloud recent set and installed
+// (not archived) sets, so that suggestions don't walk all the sets.
+//
+// Sets are reindexed lazily on the next lookup: only those that were
+// added, removed, changed their flags, dates or contents are touched.
+class EmojiIndex final {
+public:
+	struct Match {
+		not_null<DocumentData*> document;
+		uint64 setId = 0;
+	};
+
+	// Some set or the sets order may have been changed.
+	void markCheckNeeded();
+
+	// Set contents were replaced, even if counts stayed the same.
+	void markSetChanged(uint64 setId);
+
+	// Matches are ordered like the sets are: cloud recent first,
+	// then installed sets in the order, then stickers in their packs.
+	[[nodiscard]] std::vector<Match> lookup(
+		const Sets &sets,
+		const Order &order,
+		EmojiPtr original);
+
+	// Installed sets without emoji information, valid after lookup().
+	[[nodiscard]] const base::flat_set<uint64> &notLoadedSets() const;
+
+private:
+	struct Entry {
+		not_null<DocumentData*> document;
+		uint64 setId = 0;
+		int index = 0;
+	};
+	struct Summary {
+		MTPDstickerSet::Flags flags;
+		TimeId installDate = 0;
+		DocumentData *first = nullptr;
+		int stickers = 0;
+		int dates = 0;
+		int emoji = 0;
+
+		bool operator==(const Summary &other) const;
+		bool operator!=(const Summary &other) const {
+			return !(*this == other);
+		}
+	};
+	struct Indexed {
+		Summary summary;
+		std::vector<EmojiPtr> emoji;
+	};
+
+	[[nodiscard]] static Summary Summarize(const Set &set);
+
+	void check(const Sets &sets, const Order &order);
+	void add(const Set &set);
+	void remove(uint64 setId, const Indexed &indexed);
+
+	bool _checkNeeded = true;
+	base::flat_set<uint64> _changedSets;
+	base::flat_map<uint64, int> _positions;
+	base::flat_map<uint64, Indexed> _indexed;
+	base::flat_map<EmojiPtr, std::vector<Entry>> _entries;
+	base::flat_set<uint64> _notLoaded;
+
+};
+
+// Builds a large synthetic sets collection and returns a timings report.
+[[nodiscard]] QString BenchmarkEmojiIndex();
+
+} // namespace Stickers
@@ -17,6 +17,8 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "core/sandbox.h"
 #include "core/local_url_handlers.h"
 #include "core/launcher.h"
+#include "core/startup_scheduler.h"
+#include "core/startup_trace.h"
 #include "storage/localstorage.h"
 #include "platform/platform_specific.h"
 #include "mainwindow.h"
@@ -55,6 +57,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "boxes/confirm_phone_box.h"
 #include "boxes/confirm_box.h"
 #include "boxes/share_box.h"
+#include "bettergram/bettergramservice.h"
 
 namespace Core {
 namespace {
@@ -93,13 +96,18 @@ Application::Application(not_null<Launcher*> launcher)
 }
 
 void Application::run() {
-	Fonts::Start();
+	{
+		const auto phase = StartupTrace::Phase("third party");
+		Fonts::Start();
 
-	ThirdParty::start();
-	Global::start();
-	refreshGlobalProxy(); // Depends on Global::started().
-
-	startLocalStorage();
+		ThirdParty::start();
+		Global::start();
+		refreshGlobalProxy(); // Depends on Global::started().
+	}
+	{
+		const auto phase = StartupTrace::Phase("local storage");
+		startLocalStorage();
+	}
 
 	if (Local::oldSettingsVersion() < AppVersion) {
 		psNewVersion();
@@ -111,14 +119,39 @@ void Application::run() {
 		return;
 	}
 
-	_translator = std::make_unique<Lang::Translator>();
-	QCoreApplication::instance()->installTranslator(_translator.get());
+	using Thread = StartupScheduler::Thread;
+	auto scheduler = StartupScheduler();
+	scheduler.add("translator", {}, Thread::Main, [=] {
+		_translator = std::make_unique<Lang::Translator>();
+		QCoreApplication::instance()->installTranslator(_translator.get());
+	});
+	scheduler.add("style", {}, Thread::Main, [] {
+		style::startManager();
+	});
+	scheduler.add("animations", { "style" }, Thread::Main, [] {
+		anim::startManager();
+		Ui::InitTextOptions();
+	});
+	scheduler.add("audio player", {}, Thread::Main, [=] {
+		Media::Player::start(_audio.get());
+	});
 
-	style::startManager();
-	anim::startManager();
-	Ui::InitTextOptions();
-	Ui::Emoji::Init();
-	Media::Player::start(_audio.get());
+	// Emoji sizes depend on the interface scale checked by the style.
+	scheduler.add("emoji sprites", { "style" }, Thread::Worker, [] {
+		Ui::Emoji::Prepare();
+	});
+	scheduler.add("emoji", { "emoji sprites" }, Thread::Main, [] {
+		Ui::Emoji::Init();
+	});
+	scheduler.add("bettergram caches", {}, Thread::Worker, [] {
+		Bettergram::BettergramService::prepareCaches();
+	});
+
+	// Create mime database, so it won't be slow later.
+	scheduler.add("mime database", {}, Thread::Worker, [] {
+		QMimeDatabase().mimeTypeForName(qsl("text/plain"));
+	});
+	scheduler.run();
 
 	DEBUG_LOG(("Application Info: inited..."));
 
@@ -129,15 +162,15 @@ void Application::run() {
 
 	DEBUG_LOG(("Application Info: starting app..."));
 
-	// Create mime database, so it won't be slow later.
-	QMimeDatabase().mimeTypeForName(qsl("text/plain"));
+	{
+		const auto phase = StartupTrace::Phase("main window");
+		_window = std::make_unique<MainWindow>();
+		_window->init();
 
-	_window = std::make_unique<MainWindow>();
-	_window->init();
-
-	auto currentGeometry = _window->geometry();
-	_mediaView = std::make_unique<Media::View::OverlayWidget>();
-	_window->setGeometry(currentGeometry);
+		auto currentGeometry = _window->geometry();
+		_mediaView = std::make_unique<Media::View::OverlayWidget>();
+		_window->setGeometry(currentGeometry);
+	}
 
 	QCoreApplication::instance()->installEventFilter(this);
 	connect(
@@ -151,7 +184,10 @@ void Application::run() {
 	startShortcuts();
 	App::initMedia();
 
-	Local::ReadMapState state = Local::readMap(QByteArray());
+	const auto state = [] {
+		const auto phase = StartupTrace::Phase("local map");
+		return Local::readMap(QByteArray());
+	}();
 	if (state == Local::ReadMapPassNeeded) {
 		Global::SetLocalPasscode(true);
 		Global::RefLocalPasscodeChanged().notify();
@@ -159,8 +195,13 @@ void Application::run() {
 		DEBUG_LOG(("Application Info: passcode needed..."));
 	} else {
 		DEBUG_LOG(("Application Info: local map read..."));
-		startMtp();
+		{
+			const auto phase = StartupTrace::Phase("mtp");
+			startMtp();
+		}
 		DEBUG_LOG(("Application Info: MTP started..."));
+
+		const auto phase = StartupTrace::Phase("main widget");
 		if (AuthSession::Exists()) {
 			_window->setupMain();
 		} else {
@@ -179,6 +220,8 @@ void Application::run() {
 	for (const auto &error : Shortcuts::Errors()) {
 		LOG(("Shortcuts Error: %1").arg(error));
 	}
+
+	StartupTrace::Finish();
 }
 
 bool Application::hideMediaView() {
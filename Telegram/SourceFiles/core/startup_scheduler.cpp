@@ -0,0 +1,113 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "core/startup_scheduler.h"
+
+#include "core/startup_trace.h"
+
+namespace Core {
+
+void StartupScheduler::add(
+		const char *name,
+		std::vector<const char*> dependencies,
+		Thread thread,
+		Fn<void()> callback) {
+	Expects(callback != nullptr);
+
+	auto task = Task();
+	task.name = name;
+	task.dependencies = std::move(dependencies);
+	task.thread = thread;
+	task.callback = std::move(callback);
+	_tasks.push_back(std::move(task));
+}
+
+void StartupScheduler::resolveDependencies() {
+	const auto count = int(_tasks.size());
+	for (auto i = 0; i != count; ++i) {
+		auto &task = _tasks[i];
+		for (const auto dependency : task.dependencies) {
+			const auto j = ranges::find_if(_tasks, [&](const Task &other) {
+				return !qstrcmp(other.name, dependency);
+			});
+			if (j == end(_tasks)) {
+				Unexpected("Unknown dependency in StartupScheduler.");
+			}
+			j->dependent.push_back(i);
+			++task.waiting;
+		}
+	}
+}
+
+void StartupScheduler::run() {
+	resolveDependencies();
+
+	auto lock = std::unique_lock<std::mutex>(_mutex);
+	while (_finishedCount < int(_tasks.size())) {
+		startWorkers();
+
+		const auto index = takeMainTask();
+		if (index >= 0) {
+			lock.unlock();
+			{
+				const auto phase = StartupTrace::Phase(_tasks[index].name);
+				_tasks[index].callback();
+			}
+			lock.lock();
+			finished(index);
+			continue;
+		} else if (!_runningWorkers) {
+			Unexpected("Dependencies cycle in StartupScheduler.");
+		}
+		_changed.wait(lock);
+	}
+}
+
+void StartupScheduler::startWorkers() {
+	const auto count = int(_tasks.size());
+	for (auto i = 0; i != count; ++i) {
+		auto &task = _tasks[i];
+		if (task.started || task.waiting || task.thread != Thread::Worker) {
+			continue;
+		}
+		task.started = true;
+		++_runningWorkers;
+		crl::async([=] {
+			{
+				const auto phase = StartupTrace::Phase(_tasks[i].name);
+				_tasks[i].callback();
+			}
+
+			// Notify under the lock, run() may return and destroy
+			// the scheduler right after the mutex is released.
+			auto lock = std::unique_lock<std::mutex>(_mutex);
+			--_runningWorkers;
+			finished(i);
+			_changed.notify_one();
+		});
+	}
+}
+
+int StartupScheduler::takeMainTask() {
+	const auto count = int(_tasks.size());
+	for (auto i = 0; i != count; ++i) {
+		auto &task = _tasks[i];
+		if (!task.started && !task.waiting && task.thread == Thread::Main) {
+			task.started = true;
+			return i;
+		}
+	}
+	return -1;
+}
+
+void StartupScheduler::finished(int index) {
+	++_finishedCount;
+	for (const auto dependent : _tasks[index].dependent) {
+		--_tasks[dependent].waiting;
+	}
+}
+
+} // namespace Core
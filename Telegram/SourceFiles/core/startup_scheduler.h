@@ -0,0 +1,61 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+namespace Core {
+
+// Runs the startup phases in the order of their dependencies.
+// Main thread phases run on the thread calling run(), worker phases
+// run in crl::async() concurrently with everything they do not depend on.
+// Worker phases must not use widgets or wait for the main thread.
+// Each phase is measured by StartupTrace::Phase.
+class StartupScheduler {
+public:
+	enum class Thread {
+		Main,
+		Worker,
+	};
+
+	void add(
+		const char *name,
+		std::vector<const char*> dependencies,
+		Thread thread,
+		Fn<void()> callback);
+
+	// Returns when all the phases are finished.
+	void run();
+
+private:
+	struct Task {
+		const char *name = nullptr;
+		std::vector<const char*> dependencies;
+		Thread thread = Thread::Main;
+		Fn<void()> callback;
+
+		std::vector<int> dependent;
+		int waiting = 0;
+		bool started = false;
+	};
+
+	void resolveDependencies();
+	void startWorkers();
+	int takeMainTask();
+	void finished(int index);
+
+	std::vector<Task> _tasks;
+	int _finishedCount = 0;
+	int _runningWorkers = 0;
+
+	std::mutex _mutex;
+	std::condition_variable _changed;
+
+};
+
+} // namespace Core
@@ -0,0 +1,182 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "core/startup_trace.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <chrono>
+#include <mutex>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#elif defined Q_OS_MAC
+#include <mach/mach.h>
+#else
+#include <time.h>
+#endif
+
+namespace Core {
+namespace StartupTrace {
+namespace {
+
+struct Event {
+	const char *name = nullptr;
+	int thread = 0;
+	int64 wallStarted = 0;
+	int64 wallDuration = 0;
+	int64 cpuDuration = 0;
+	int64 readBytes = 0;
+};
+
+std::mutex EventsMutex;
+std::vector<Event> Events;
+bool Finished = false;
+
+std::atomic<int> ThreadsCount = 0;
+thread_local int ThreadIndex = -1;
+thread_local int64 ThreadReadBytes = 0;
+
+int CurrentThreadIndex() {
+	if (ThreadIndex < 0) {
+		ThreadIndex = ThreadsCount++;
+	}
+	return ThreadIndex;
+}
+
+// Microseconds since the first phase was started.
+int64 WallTime() {
+	using namespace std::chrono;
+	static const auto started = steady_clock::now();
+	return duration_cast<microseconds>(steady_clock::now() - started).count();
+}
+
+// Microseconds of CPU time spent by the current thread.
+int64 ThreadCpuTime() {
+#ifdef Q_OS_WIN
+	FILETIME creation, exit, kernel, user;
+	if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+		return 0;
+	}
+	const auto value = [](const FILETIME &time) {
+		return (int64(time.dwHighDateTime) << 32) | int64(time.dwLowDateTime);
+	};
+	return (value(kernel) + value(user)) / 10; // 100ns intervals.
+#elif defined Q_OS_MAC
+	auto info = thread_basic_info_data_t();
+	auto count = mach_msg_type_number_t(THREAD_BASIC_INFO_COUNT);
+	const auto thread = mach_thread_self();
+	const auto result = thread_info(
+		thread,
+		THREAD_BASIC_INFO,
+		reinterpret_cast<thread_info_t>(&info),
+		&count);
+	mach_port_deallocate(mach_task_self(), thread);
+	if (result != KERN_SUCCESS) {
+		return 0;
+	}
+	return (int64(info.user_time.seconds) + info.system_time.seconds) * 1000000
+		+ info.user_time.microseconds
+		+ info.system_time.microseconds;
+#else
+	timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+		return 0;
+	}
+	return int64(ts.tv_sec) * 1000000 + int64(ts.tv_nsec) / 1000;
+#endif
+}
+
+void WriteChromeTrace(const std::vector<Event> &events) {
+	auto list = QJsonArray();
+	for (const auto &event : events) {
+		auto args = QJsonObject();
+		args.insert("cpu_us", double(event.cpuDuration));
+		args.insert("read_bytes", double(event.readBytes));
+
+		auto object = QJsonObject();
+		object.insert("name", QString::fromLatin1(event.name));
+		object.insert("cat", "startup");
+		object.insert("ph", "X");
+		object.insert("ts", double(event.wallStarted));
+		object.insert("dur", double(event.wallDuration));
+		object.insert("pid", 1);
+		object.insert("tid", event.thread);
+		object.insert("args", args);
+		list.append(object);
+	}
+	auto document = QJsonObject();
+	document.insert("traceEvents", list);
+	document.insert("displayTimeUnit", "ms");
+
+	const auto path = cWorkingDir() + qsl("DebugLogs/startup_trace.json");
+	auto f = QFile(path);
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG(("Startup Trace Error: could not open '%1' for writing."
+			).arg(path));
+		return;
+	}
+	f.write(QJsonDocument(document).toJson(QJsonDocument::Compact));
+}
+
+} // namespace
+
+Phase::Phase(const char *name)
+: _name(name)
+, _thread(CurrentThreadIndex())
+, _wallStarted(WallTime())
+, _cpuStarted(ThreadCpuTime())
+, _readStarted(ThreadReadBytes) {
+}
+
+Phase::~Phase() {
+	auto event = Event();
+	event.name = _name;
+	event.thread = _thread;
+	event.wallStarted = _wallStarted;
+	event.wallDuration = WallTime() - _wallStarted;
+	event.cpuDuration = ThreadCpuTime() - _cpuStarted;
+	event.readBytes = ThreadReadBytes - _readStarted;
+
+	std::lock_guard<std::mutex> lock(EventsMutex);
+	if (!Finished) {
+		Events.push_back(event);
+	}
+}
+
+void AddReadBytes(int64 bytes) {
+	ThreadReadBytes += bytes;
+}
+
+void Finish() {
+	auto events = std::vector<Event>();
+	{
+		std::lock_guard<std::mutex> lock(EventsMutex);
+		if (Finished) {
+			return;
+		}
+		Finished = true;
+		events = base::take(Events);
+	}
+	ranges::sort(events, ranges::less(), &Event::wallStarted);
+
+	for (const auto &event : events) {
+		LOG(("Startup Trace: %1 on thread %2 took %3 ms, cpu %4 ms, read %5 bytes"
+			).arg(event.name
+			).arg(event.thread
+			).arg(event.wallDuration / 1000.
+			).arg(event.cpuDuration / 1000.
+			).arg(event.readBytes));
+	}
+	if (Logs::DebugEnabled()) {
+		WriteChromeTrace(events);
+	}
+}
+
+} // namespace StartupTrace
+} // namespace Core
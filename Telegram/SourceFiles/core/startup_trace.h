@@ -0,0 +1,41 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Core {
+namespace StartupTrace {
+
+// Measures a named startup phase from construction till destruction:
+// wall time, CPU time of the current thread and bytes read from disk.
+// Thread safe, phases may run on worker threads and may be nested.
+class Phase {
+public:
+	explicit Phase(const char *name);
+	Phase(const Phase &other) = delete;
+	Phase &operator=(const Phase &other) = delete;
+	~Phase();
+
+private:
+	const char *_name = nullptr;
+	int _thread = 0;
+	int64 _wallStarted = 0;
+	int64 _cpuStarted = 0;
+	int64 _readStarted = 0;
+
+};
+
+// Local storage readers report the bytes they read from disk,
+// the bytes are counted for the phases running on the same thread.
+void AddReadBytes(int64 bytes);
+
+// Writes all the recorded phases to the log and, with debug logs
+// enabled, to DebugLogs/startup_trace.json in the Chrome trace format
+// (it can be opened in chrome://tracing). Later phases are ignored.
+void Finish();
+
+} // namespace StartupTrace
+} // namespace Core
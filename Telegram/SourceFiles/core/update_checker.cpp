@@ -9,6 +9,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "platform/platform_specific.h"
 #include "base/timer.h"
 #include "base/bytes.h"
+#include "base/binary_delta.h"
 #include "storage/localstorage.h"
 #include "core/application.h"
 #include "mainwindow.h"
@@ -23,10 +24,12 @@ extern "C" {
 #include <openssl/pem.h>
 #include <openssl/bio.h>
 #include <openssl/err.h>
+#include <openssl/sha.h>
 } // extern "C"
 
 #ifdef Q_OS_WIN // use Lzma SDK for win
 #include <LzmaLib.h>
+#include <LzmaDec.h>
 #else // Q_OS_WIN
 #include <lzma.h>
 #endif // else of Q_OS_WIN
@@ -46,6 +49,7 @@ namespace {
 
 constexpr auto kUpdaterTimeout = 10 * crl::time(1000);
 constexpr auto kMaxResponseSize = 1024 * 1024;
+constexpr auto kUnpackChunkSize = 64 * 1024;
 
 #ifdef TDESKTOP_DISABLE_AUTOUPDATE
 bool UpdaterIsDisabled = true;
@@ -107,7 +111,7 @@ struct Implementation {
 
 class HttpChecker : public Checker {
 public:
-	HttpChecker(bool testing);
+	HttpChecker(bool testing, bool allowDelta);
 
 	void start() override;
 
@@ -126,6 +130,7 @@ private:
 		bool isAvailableAlpha,
 		QString url) const;
 
+	bool _allowDelta = false;
 	std::unique_ptr<QNetworkAccessManager> _manager;
 	QNetworkReply *_reply = nullptr;
 
@@ -198,6 +203,39 @@ private:
 };
 #endif // #if MTP_UPDATES
 
+// Decompresses the update package from the file by chunks.
+class PackageReader : public QIODevice {
+public:
+	PackageReader(QFile &input, int64 uncompressedSize);
+
+	bool start(const QByteArray &props);
+	bool isSequential() const override;
+
+	~PackageReader();
+
+protected:
+	qint64 readData(char *data, qint64 maxSize) override;
+	qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+	bool fillBuffer();
+
+	QFile &_input;
+	int64 _left = 0;
+	QByteArray _buffer;
+	int _bufferOffset = 0;
+	int _bufferSize = 0;
+	bool _inputFinished = false;
+#ifdef Q_OS_WIN // use Lzma SDK for win
+	CLzmaDec _decoder;
+	bool _decoderAllocated = false;
+#else // Q_OS_WIN
+	lzma_stream _stream = LZMA_STREAM_INIT;
+	bool _streamInitialized = false;
+#endif // Q_OS_WIN
+
+};
+
 std::shared_ptr<Updater> GetUpdaterInstance() {
 	if (const auto result = UpdaterInstance.lock()) {
 		return result;
@@ -248,9 +286,253 @@ QString ExtractFilename(const QString &url) {
 	return QString();
 }
 
+bool IsDeltaPackage(const QString &filepath) {
+	return QRegularExpression(
+		qsl("_from\\d+$")
+	).match(QFileInfo(filepath).fileName()).hasMatch();
+}
+
+#ifdef Q_OS_WIN // use Lzma SDK for win
+void *LzmaAlloc(void *p, size_t size) {
+	return malloc(size);
+}
+
+void LzmaFree(void *p, void *address) {
+	free(address);
+}
+
+ISzAlloc LzmaAllocator = { LzmaAlloc, LzmaFree };
+#endif // Q_OS_WIN
+
+PackageReader::PackageReader(QFile &input, int64 uncompressedSize)
+: _input(input)
+, _left(uncompressedSize)
+, _buffer(kUnpackChunkSize, Qt::Uninitialized) {
+}
+
+bool PackageReader::start(const QByteArray &props) {
+#ifdef Q_OS_WIN // use Lzma SDK for win
+	LzmaDec_Construct(&_decoder);
+	const auto res = LzmaDec_Allocate(
+		&_decoder,
+		reinterpret_cast<const Byte*>(props.constData()),
+		props.size(),
+		&LzmaAllocator);
+	if (res != SZ_OK) {
+		LOG(("Update Error: could not init lzma decoder, code: %1").arg(res));
+		return false;
+	}
+	_decoderAllocated = true;
+	LzmaDec_Init(&_decoder);
+#else // Q_OS_WIN
+	const auto ret = lzma_stream_decoder(
+		&_stream,
+		UINT64_MAX,
+		LZMA_CONCATENATED);
+	if (ret != LZMA_OK) {
+		const char *msg;
+		switch (ret) {
+		case LZMA_MEM_ERROR: msg = "Memory allocation failed"; break;
+		case LZMA_OPTIONS_ERROR: msg = "Specified preset is not supported"; break;
+		case LZMA_UNSUPPORTED_CHECK: msg = "Specified integrity check is not supported"; break;
+		default: msg = "Unknown error, possibly a bug"; break;
+		}
+		LOG(("Error initializing the decoder: %1 (error code %2)").arg(msg).arg(ret));
+		return false;
+	}
+	_streamInitialized = true;
+#endif // Q_OS_WIN
+	return open(QIODevice::ReadOnly);
+}
+
+bool PackageReader::isSequential() const {
+	return true;
+}
+
+bool PackageReader::fillBuffer() {
+	if (_bufferOffset < _bufferSize || _inputFinished) {
+		return true;
+	}
+	const auto read = _input.read(_buffer.data(), _buffer.size());
+	if (read < 0) {
+		LOG(("Update Error: could not read the update file."));
+		return false;
+	}
+	_bufferOffset = 0;
+	_bufferSize = int(read);
+	_inputFinished = !read;
+	return true;
+}
+
+qint64 PackageReader::readData(char *data, qint64 maxSize) {
+	const auto size = std::min(maxSize, qint64(_left));
+	auto written = qint64(0);
+	while (written < size) {
+		if (!fillBuffer()) {
+			return -1;
+		}
+#ifdef Q_OS_WIN // use Lzma SDK for win
+		auto outSize = SizeT(size - written);
+		auto inSize = SizeT(_bufferSize - _bufferOffset);
+		auto status = ELzmaStatus();
+		const auto res = LzmaDec_DecodeToBuf(
+			&_decoder,
+			reinterpret_cast<Byte*>(data + written),
+			&outSize,
+			reinterpret_cast<const Byte*>(_buffer.constData() + _bufferOffset),
+			&inSize,
+			LZMA_FINISH_ANY,
+			&status);
+		if (res != SZ_OK) {
+			LOG(("Update Error: could not uncompress lzma, code: %1").arg(res));
+			return -1;
+		}
+		_bufferOffset += int(inSize);
+		written += qint64(outSize);
+		if (!outSize && !inSize && (_inputFinished || status == LZMA_STATUS_FINISHED_WITH_MARK)) {
+			break;
+		}
+#else // Q_OS_WIN
+		_stream.next_in = reinterpret_cast<const uint8_t*>(_buffer.constData() + _bufferOffset);
+		_stream.avail_in = _bufferSize - _bufferOffset;
+		_stream.next_out = reinterpret_cast<uint8_t*>(data + written);
+		_stream.avail_out = size - written;
+		const auto res = lzma_code(&_stream, _inputFinished ? LZMA_FINISH : LZMA_RUN);
+		_bufferOffset = _bufferSize - int(_stream.avail_in);
+		written = size - qint64(_stream.avail_out);
+		if (res == LZMA_STREAM_END) {
+			break;
+		} else if (res != LZMA_OK) {
+			const char *msg;
+			switch (res) {
+			case LZMA_MEM_ERROR: msg = "Memory allocation failed"; break;
+			case LZMA_FORMAT_ERROR: msg = "The input data is not in the .xz format"; break;
+			case LZMA_OPTIONS_ERROR: msg = "Unsupported compression options"; break;
+			case LZMA_DATA_ERROR: msg = "Compressed file is corrupt"; break;
+			case LZMA_BUF_ERROR: msg = "Compressed data is truncated or otherwise corrupt"; break;
+			default: msg = "Unknown error, possibly a bug"; break;
+			}
+			LOG(("Error in decompression: %1 (error code %2)").arg(msg).arg(res));
+			return -1;
+		}
+#endif // Q_OS_WIN
+	}
+	if (written < size) {
+		LOG(("Error in decompression, %1 bytes left of %2 whole."
+			).arg(_left - written
+			).arg(_left));
+		return -1;
+	}
+	_left -= written;
+	return written;
+}
+
+qint64 PackageReader::writeData(const char *data, qint64 maxSize) {
+	return -1;
+}
+
+PackageReader::~PackageReader() {
+#ifdef Q_OS_WIN // use Lzma SDK for win
+	if (_decoderAllocated) {
+		LzmaDec_Free(&_decoder, &LzmaAllocator);
+	}
+#else // Q_OS_WIN
+	if (_streamInitialized) {
+		lzma_end(&_stream);
+	}
+#endif // Q_OS_WIN
+}
+
+bool CopyFromStream(
+		QDataStream &stream,
+		QFile &to,
+		quint32 size,
+		SHA_CTX *sha) {
+	auto buffer = QByteArray(kUnpackChunkSize, Qt::Uninitialized);
+	while (size > 0) {
+		const auto part = int(std::min(size, quint32(buffer.size())));
+		if (stream.readRawData(buffer.data(), part) != part) {
+			LOG(("Update Error: cant read file data from downloaded stream, status: %1").arg(stream.status()));
+			return false;
+		} else if (to.write(buffer.constData(), part) != part) {
+			LOG(("Update Error: cant write file '%1'").arg(to.fileName()));
+			return false;
+		}
+		SHA1_Update(sha, buffer.constData(), part);
+		size -= part;
+	}
+	return true;
+}
+
+bool CopyFromBase(
+		QFile &from,
+		QFile &to,
+		quint32 offset,
+		quint32 size,
+		SHA_CTX *sha) {
+	if (quint64(offset) + size > quint64(from.size())) {
+		LOG(("Update Error: bad delta copy %1 + %2 of '%3' with size %4"
+			).arg(offset
+			).arg(size
+			).arg(from.fileName()
+			).arg(from.size()));
+		return false;
+	} else if (!from.seek(offset)) {
+		LOG(("Update Error: cant seek in file '%1'").arg(from.fileName()));
+		return false;
+	}
+	auto buffer = QByteArray(kUnpackChunkSize, Qt::Uninitialized);
+	while (size > 0) {
+		const auto part = int(std::min(size, quint32(buffer.size())));
+		if (from.read(buffer.data(), part) != part) {
+			LOG(("Update Error: cant read file '%1'").arg(from.fileName()));
+			return false;
+		} else if (to.write(buffer.constData(), part) != part) {
+			LOG(("Update Error: cant write file '%1'").arg(to.fileName()));
+			return false;
+		}
+		SHA1_Update(sha, buffer.constData(), part);
+		size -= part;
+	}
+	return true;
+}
+
+bool ApplyDeltaPatch(QDataStream &stream, QFile &from, QFile &to, SHA_CTX *sha) {
+	const auto copy = [&](quint32 offset, quint32 size) {
+		return CopyFromBase(from, to, offset, size, sha);
+	};
+	const auto add = [&](quint32 size) {
+		return CopyFromStream(stream, to, size, sha);
+	};
+	if (!base::ApplyDelta(stream, copy, add)) {
+		LOG(("Update Error: cant apply delta patch for '%1', stream status: %2").arg(to.fileName()).arg(stream.status()));
+		return false;
+	}
+	return true;
+}
+
+bool CountFileSha1(QFile &file, uchar *result) {
+	if (!file.seek(0)) {
+		return false;
+	}
+	auto sha = SHA_CTX();
+	SHA1_Init(&sha);
+	auto buffer = QByteArray(kUnpackChunkSize, Qt::Uninitialized);
+	while (true) {
+		const auto read = file.read(buffer.data(), buffer.size());
+		if (read < 0) {
+			return false;
+		} else if (!read) {
+			break;
+		}
+		SHA1_Update(&sha, buffer.constData(), size_t(read));
+	}
+	SHA1_Final(result, &sha);
+	return true;
+}
+
 bool UnpackUpdate(const QString &filepath) {
 	QFile input(filepath);
-	QByteArray packed;
 	if (!input.open(QIODevice::ReadOnly)) {
 		LOG(("Update Error: cant read updates file!"));
 		return false;
@@ -262,13 +544,16 @@ bool UnpackUpdate(const QString &filepath) {
 	const int32 hSigLen = 128, hShaLen = 20, hPropsLen = 0, hOriginalSizeLen = sizeof(int32), hSize = hSigLen + hShaLen + hOriginalSizeLen; // header
 #endif // Q_OS_WIN
 
-	QByteArray compressed = input.readAll();
-	int32 compressedLen = compressed.size() - hSize;
+	const auto compressedLen = input.size() - hSize;
 	if (compressedLen <= 0) {
-		LOG(("Update Error: bad compressed size: %1").arg(compressed.size()));
+		LOG(("Update Error: bad compressed size: %1").arg(input.size()));
+		return false;
+	}
+	const auto header = input.read(hSize);
+	if (header.size() != hSize) {
+		LOG(("Update Error: cant read update file header!"));
 		return false;
 	}
-	input.close();
 
 	QString tempDirPath = cWorkingDir() + qsl("tupdates/temp"), readyFilePath = cWorkingDir() + qsl("tupdates/temp/ready");
 	psDeleteDir(tempDirPath);
@@ -279,11 +564,29 @@ bool UnpackUpdate(const QString &filepath) {
 		return false;
 	}
 
-	uchar sha1Buffer[20];
-	bool goodSha1 = !memcmp(compressed.constData() + hSigLen, hashSha1(compressed.constData() + hSigLen + hShaLen, compressedLen + hPropsLen + hOriginalSizeLen, sha1Buffer), hShaLen);
-	if (!goodSha1) {
-		LOG(("Update Error: bad SHA1 hash of update file!"));
-		return false;
+	// The package is hashed and unpacked by chunks,
+	// so that it is never held in memory as a whole.
+	{
+		auto sha = SHA_CTX();
+		SHA1_Init(&sha);
+		SHA1_Update(&sha, header.constData() + hSigLen + hShaLen, hPropsLen + hOriginalSizeLen);
+		auto buffer = QByteArray(kUnpackChunkSize, Qt::Uninitialized);
+		while (true) {
+			const auto read = input.read(buffer.data(), buffer.size());
+			if (read < 0) {
+				LOG(("Update Error: cant read updates file!"));
+				return false;
+			} else if (!read) {
+				break;
+			}
+			SHA1_Update(&sha, buffer.constData(), size_t(read));
+		}
+		uchar sha1Buffer[20];
+		SHA1_Final(sha1Buffer, &sha);
+		if (memcmp(header.constData() + hSigLen, sha1Buffer, hShaLen)) {
+			LOG(("Update Error: bad SHA1 hash of update file!"));
+			return false;
+		}
 	}
 
 	RSA *pbKey = PEM_read_bio_RSAPublicKey(BIO_new_mem_buf(const_cast<char*>(AppBetaVersion ? UpdatesPublicBetaKey : UpdatesPublicKey), -1), 0, 0, 0);
@@ -291,7 +594,7 @@ bool UnpackUpdate(const QString &filepath) {
 		LOG(("Update Error: cant read public rsa key!"));
 		return false;
 	}
-	if (RSA_verify(NID_sha1, (const uchar*)(compressed.constData() + hSigLen), hShaLen, (const uchar*)(compressed.constData()), hSigLen, pbKey) != 1) { // verify signature
+	if (RSA_verify(NID_sha1, (const uchar*)(header.constData() + hSigLen), hShaLen, (const uchar*)(header.constData()), hSigLen, pbKey) != 1) { // verify signature
 		RSA_free(pbKey);
 
 		// try other public key, if we update from beta to stable or vice versa
@@ -300,7 +603,7 @@ bool UnpackUpdate(const QString &filepath) {
 			LOG(("Update Error: cant read public rsa key!"));
 			return false;
 		}
-		if (RSA_verify(NID_sha1, (const uchar*)(compressed.constData() + hSigLen), hShaLen, (const uchar*)(compressed.constData()), hSigLen, pbKey) != 1) { // verify signature
+		if (RSA_verify(NID_sha1, (const uchar*)(header.constData() + hSigLen), hShaLen, (const uchar*)(header.constData()), hSigLen, pbKey) != 1) { // verify signature
 			RSA_free(pbKey);
 			LOG(("Update Error: bad RSA signature of update file!"));
 			return false;
@@ -308,70 +611,26 @@ bool UnpackUpdate(const QString &filepath) {
 	}
 	RSA_free(pbKey);
 
-	QByteArray uncompressed;
-
 	int32 uncompressedLen;
-	memcpy(&uncompressedLen, compressed.constData() + hSigLen + hShaLen + hPropsLen, hOriginalSizeLen);
-	uncompressed.resize(uncompressedLen);
-
-	size_t resultLen = uncompressed.size();
-#ifdef Q_OS_WIN // use Lzma SDK for win
-	SizeT srcLen = compressedLen;
-	int uncompressRes = LzmaUncompress((uchar*)uncompressed.data(), &resultLen, (const uchar*)(compressed.constData() + hSize), &srcLen, (const uchar*)(compressed.constData() + hSigLen + hShaLen), LZMA_PROPS_SIZE);
-	if (uncompressRes != SZ_OK) {
-		LOG(("Update Error: could not uncompress lzma, code: %1").arg(uncompressRes));
+	memcpy(&uncompressedLen, header.constData() + hSigLen + hShaLen + hPropsLen, hOriginalSizeLen);
+	if (uncompressedLen <= 0) {
+		LOG(("Update Error: bad uncompressed size: %1").arg(uncompressedLen));
 		return false;
-	}
-#else // Q_OS_WIN
-	lzma_stream stream = LZMA_STREAM_INIT;
-
-	lzma_ret ret = lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED);
-	if (ret != LZMA_OK) {
-		const char *msg;
-		switch (ret) {
-		case LZMA_MEM_ERROR: msg = "Memory allocation failed"; break;
-		case LZMA_OPTIONS_ERROR: msg = "Specified preset is not supported"; break;
-		case LZMA_UNSUPPORTED_CHECK: msg = "Specified integrity check is not supported"; break;
-		default: msg = "Unknown error, possibly a bug"; break;
-		}
-		LOG(("Error initializing the decoder: %1 (error code %2)").arg(msg).arg(ret));
+	} else if (!input.seek(hSize)) {
+		LOG(("Update Error: cant seek in updates file!"));
 		return false;
 	}
 
-	stream.avail_in = compressedLen;
-	stream.next_in = (uint8_t*)(compressed.constData() + hSize);
-	stream.avail_out = resultLen;
-	stream.next_out = (uint8_t*)uncompressed.data();
-
-	lzma_ret res = lzma_code(&stream, LZMA_FINISH);
-	if (stream.avail_in) {
-		LOG(("Error in decompression, %1 bytes left in _in of %2 whole.").arg(stream.avail_in).arg(compressedLen));
-		return false;
-	} else if (stream.avail_out) {
-		LOG(("Error in decompression, %1 bytes free left in _out of %2 whole.").arg(stream.avail_out).arg(resultLen));
+	PackageReader reader(input, uncompressedLen);
+	if (!reader.start(header.mid(hSigLen + hShaLen, hPropsLen))) {
 		return false;
 	}
-	lzma_end(&stream);
-	if (res != LZMA_OK && res != LZMA_STREAM_END) {
-		const char *msg;
-		switch (res) {
-		case LZMA_MEM_ERROR: msg = "Memory allocation failed"; break;
-		case LZMA_FORMAT_ERROR: msg = "The input data is not in the .xz format"; break;
-		case LZMA_OPTIONS_ERROR: msg = "Unsupported compression options"; break;
-		case LZMA_DATA_ERROR: msg = "Compressed file is corrupt"; break;
-		case LZMA_BUF_ERROR: msg = "Compressed data is truncated or otherwise corrupt"; break;
-		default: msg = "Unknown error, possibly a bug"; break;
-		}
-		LOG(("Error in decompression: %1 (error code %2)").arg(msg).arg(res));
-		return false;
-	}
-#endif // Q_OS_WIN
 
 	tempDir.mkdir(tempDir.absolutePath());
 
 	quint32 version;
 	{
-		QDataStream stream(uncompressed);
+		QDataStream stream(&reader);
 		stream.setVersion(QDataStream::Qt_5_1);
 
 		stream >> version;
@@ -380,8 +639,22 @@ bool UnpackUpdate(const QString &filepath) {
 			return false;
 		}
 
+		auto delta = false;
 		quint64 alphaVersion = 0;
-		if (version == 0x7FFFFFFF) { // alpha version
+		if (version == base::DeltaPackageTag) {
+			quint32 baseVersion = 0;
+			stream >> baseVersion >> version;
+			if (stream.status() != QDataStream::Ok) {
+				LOG(("Update Error: cant read delta versions from downloaded stream, status: %1").arg(stream.status()));
+				return false;
+			}
+			if (cAlphaVersion() || int32(baseVersion) != AppVersion) {
+				LOG(("Update Error: downloaded delta from version %1 can't be applied to mine %2").arg(baseVersion).arg(AppVersion));
+				return false;
+			}
+			delta = true;
+		}
+		if (!delta && version == 0x7FFFFFFF) { // alpha version
 			stream >> alphaVersion;
 			if (stream.status() != QDataStream::Ok) {
 				LOG(("Update Error: cant read alpha version from downloaded stream, status: %1").arg(stream.status()));
@@ -408,20 +681,44 @@ bool UnpackUpdate(const QString &filepath) {
 		}
 		for (uint32 i = 0; i < filesCount; ++i) {
 			QString relativeName;
-			quint32 fileSize;
-			QByteArray fileInnerData;
+			quint8 type = base::DeltaFileFull;
+			QByteArray fileSha1;
 			bool executable = false;
 
-			stream >> relativeName >> fileSize >> fileInnerData;
-#if defined Q_OS_MAC || defined Q_OS_LINUX
-			stream >> executable;
-#endif // Q_OS_MAC || Q_OS_LINUX
+			stream >> relativeName;
+			if (delta) {
+				stream >> type >> fileSha1;
+			}
 			if (stream.status() != QDataStream::Ok) {
 				LOG(("Update Error: cant read file from downloaded stream, status: %1").arg(stream.status()));
 				return false;
 			}
-			if (fileSize != quint32(fileInnerData.size())) {
-				LOG(("Update Error: bad file size %1 not matching data size %2").arg(fileSize).arg(fileInnerData.size()));
+			if (delta && fileSha1.size() != hShaLen) {
+				LOG(("Update Error: bad file hash size %1").arg(fileSha1.size()));
+				return false;
+			}
+
+			// Unchanged files are checked in place and left as they are.
+			QFile baseFile(cExeDir() + relativeName);
+			if (type == base::DeltaFileSame) {
+				uchar sha1Buffer[20];
+				if (!baseFile.open(QIODevice::ReadOnly)
+					|| !CountFileSha1(baseFile, sha1Buffer)
+					|| memcmp(fileSha1.constData(), sha1Buffer, hShaLen)) {
+					LOG(("Update Error: local file '%1' does not match the delta").arg(baseFile.fileName()));
+					return false;
+				}
+#if defined Q_OS_MAC || defined Q_OS_LINUX
+				stream >> executable;
+#endif // Q_OS_MAC || Q_OS_LINUX
+				continue;
+			} else if (type == base::DeltaFilePatch) {
+				if (!baseFile.open(QIODevice::ReadOnly)) {
+					LOG(("Update Error: cant open local file '%1' for the delta").arg(baseFile.fileName()));
+					return false;
+				}
+			} else if (type != base::DeltaFileFull) {
+				LOG(("Update Error: bad delta file type %1").arg(int(type)));
 				return false;
 			}
 
@@ -434,13 +731,51 @@ bool UnpackUpdate(const QString &filepath) {
 				LOG(("Update Error: cant open file '%1' for writing").arg(tempDirPath + '/' + relativeName));
 				return false;
 			}
-			auto writtenBytes = f.write(fileInnerData);
-			if (writtenBytes != fileSize) {
-				f.close();
-				LOG(("Update Error: cant write file '%1', desiredSize: %2, write result: %3").arg(tempDirPath + '/' + relativeName).arg(fileSize).arg(writtenBytes));
+
+			auto sha = SHA_CTX();
+			SHA1_Init(&sha);
+			if (type == base::DeltaFilePatch) {
+				if (!ApplyDeltaPatch(stream, baseFile, f, &sha)) {
+					return false;
+				}
+			} else {
+				// The file data is serialized as a QByteArray,
+				// it is written to disk without reading it whole.
+				quint32 fileSize = 0, fileDataSize = 0;
+				if (!delta) {
+					stream >> fileSize;
+				}
+				stream >> fileDataSize;
+				if (stream.status() != QDataStream::Ok) {
+					LOG(("Update Error: cant read file size from downloaded stream, status: %1").arg(stream.status()));
+					return false;
+				}
+				if (fileDataSize == 0xFFFFFFFFU) { // null QByteArray
+					fileDataSize = 0;
+				}
+				if (!delta && fileSize != fileDataSize) {
+					LOG(("Update Error: bad file size %1 not matching data size %2").arg(fileSize).arg(fileDataSize));
+					return false;
+				}
+				if (!CopyFromStream(stream, f, fileDataSize, &sha)) {
+					return false;
+				}
+			}
+#if defined Q_OS_MAC || defined Q_OS_LINUX
+			stream >> executable;
+#endif // Q_OS_MAC || Q_OS_LINUX
+			if (stream.status() != QDataStream::Ok) {
+				LOG(("Update Error: cant read file from downloaded stream, status: %1").arg(stream.status()));
 				return false;
 			}
 			f.close();
+
+			uchar sha1Buffer[20];
+			SHA1_Final(sha1Buffer, &sha);
+			if (delta && memcmp(fileSha1.constData(), sha1Buffer, hShaLen)) {
+				LOG(("Update Error: bad SHA1 hash of '%1' from the delta").arg(relativeName));
+				return false;
+			}
 			if (executable) {
 				QFileDevice::Permissions p = f.permissions();
 				p |= QFileDevice::ExeOwner | QFileDevice::ExeUser | QFileDevice::ExeGroup | QFileDevice::ExeOther;
@@ -618,7 +953,9 @@ rpl::lifetime &Checker::lifetime() {
 	return _lifetime;
 }
 
-HttpChecker::HttpChecker(bool testing) : Checker(testing) {
+HttpChecker::HttpChecker(bool testing, bool allowDelta)
+: Checker(testing)
+, _allowDelta(allowDelta) {
 }
 
 void HttpChecker::start() {
@@ -725,6 +1062,21 @@ std::optional<QString> HttpChecker::parseResponse(
 			return false;
 		}
 		bestLink = (*link).toString();
+
+		// Delta packages are listed by the version they apply to.
+		const auto delta = map.constFind("delta");
+		if (!_allowDelta
+			|| isAlpha
+			|| cAlphaVersion()
+			|| delta == map.constEnd()
+			|| !(*delta).isObject()) {
+			return true;
+		}
+		const auto links = (*delta).toObject();
+		const auto from = links.constFind(QString::number(AppVersion));
+		if (from != links.constEnd() && (*from).isString()) {
+			bestLink = (*from).toString();
+		}
 		return true;
 	};
 	const auto result = ParseCommonMap(response, testing(), accumulate);
@@ -1068,7 +1420,7 @@ private:
 	void checkerFail(not_null<Implementation*> which);
 
 	void finalize(QString filepath);
-	void unpackDone(bool ready);
+	void unpackDone(bool ready, bool delta);
 	void handleChecking();
 	void handleProgress();
 	void handleLatest();
@@ -1077,6 +1429,7 @@ private:
 	void scheduleNext();
 
 	bool _testing = false;
+	bool _deltaFailed = false;
 	Action _action = Action::Waiting;
 	base::Timer _timer;
 	base::Timer _retryTimer;
@@ -1242,7 +1595,7 @@ void Updater::start(bool forceWait) {
 	if (sendRequest) {
 		startImplementation(
 			&_httpImplementation,
-			std::make_unique<HttpChecker>(_testing));
+			std::make_unique<HttpChecker>(_testing, !_deltaFailed));
 
 #if MTP_UPDATES
 		startImplementation(
@@ -1407,15 +1760,24 @@ void Updater::finalize(QString filepath) {
 	_action = Action::Unpacking;
 	crl::async([=] {
 		const auto ready = UnpackUpdate(filepath);
+		const auto delta = IsDeltaPackage(filepath);
 		crl::on_main([=] {
-			GetUpdaterInstance()->unpackDone(ready);
+			GetUpdaterInstance()->unpackDone(ready, delta);
 		});
 	});
 }
 
-void Updater::unpackDone(bool ready) {
+void Updater::unpackDone(bool ready, bool delta) {
 	if (ready) {
 		_ready.fire({});
+	} else if (delta && !_deltaFailed) {
+		LOG(("Update Info: could not apply the delta update, "
+			"requesting the full package."));
+		ClearAll();
+		_deltaFailed = true;
+		stop();
+		cSetLastUpdateCheck(0);
+		start(false);
 	} else {
 		ClearAll();
 		_failed.fire({});
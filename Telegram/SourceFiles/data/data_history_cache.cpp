@@ -0,0 +1,472 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "data/data_history_cache.h"
+
+#include "data/data_session.h"
+#include "history/history.h"
+#include "history/history_item.h"
+#include "storage/cache/storage_cache_database.h"
+#include "apiwrap.h"
+#include "auth_session.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kSerializeVersion = 1;
+constexpr auto kMaxMessages = 100;
+constexpr auto kWriteDelay = crl::time(1000);
+
+template <typename Type>
+[[nodiscard]] QVector<Type> Values(const std::map<PeerId, Type> &map) {
+	auto result = QVector<Type>();
+	result.reserve(map.size());
+	for (const auto &[peerId, value] : map) {
+		result.push_back(value);
+	}
+	return result;
+}
+
+} // namespace
+
+HistoryCache::HistoryCache(not_null<Session*> owner)
+: _owner(owner)
+, _writeTimer([=] { writeChanged(); }) {
+	_owner->cache().get(MessagesSearchIndexCacheKey(), [=](
+			QByteArray &&value) {
+		crl::on_main(this, [=, value = std::move(value)]() mutable {
+			indexLoaded(std::move(value));
+		});
+	});
+}
+
+void HistoryCache::load(
+		not_null<History*> history,
+		Fn<void(QVector<MTPMessage>&&)> done) {
+	const auto peerId = history->peer->id;
+	loadEntry(peerId, [=] {
+		done(Messages(_entries[peerId]));
+	});
+}
+
+void HistoryCache::loadEntry(PeerId peerId, Fn<void()> done) {
+	auto &entry = _entries[peerId];
+	if (entry.loaded) {
+		crl::on_main(this, std::move(done));
+		return;
+	}
+	entry.callbacks.push_back(std::move(done));
+	if (entry.loading) {
+		return;
+	}
+	entry.loading = true;
+	_owner->cache().get(HistoryCacheKey(peerId), [=](QByteArray &&value) {
+		crl::on_main(this, [=, value = std::move(value)]() mutable {
+			loaded(peerId, std::move(value));
+		});
+	});
+}
+
+void HistoryCache::loaded(PeerId peerId, QByteArray &&serialized) {
+	auto &entry = _entries[peerId];
+	entry.loading = false;
+	if (!entry.loaded && !serialized.isEmpty()) {
+		if (auto parsed = Deserialize(serialized)) {
+			entry.messages = std::move(parsed->messages);
+			entry.users = std::move(parsed->users);
+			entry.chats = std::move(parsed->chats);
+			apply(entry);
+		} else {
+			_owner->cache().remove(HistoryCacheKey(peerId));
+			withIndex([=] {
+				_index.removePeer(peerId);
+				indexChanged();
+			});
+		}
+	}
+	entry.loaded = true;
+
+	for (const auto &callback : base::take(entry.callbacks)) {
+		callback();
+	}
+}
+
+void HistoryCache::apply(const Entry &entry) {
+	// Don't overwrite anything we already know with cached data.
+	auto users = QVector<MTPUser>();
+	for (const auto &[peerId, user] : entry.users) {
+		if (!_owner->peerLoaded(peerId)) {
+			users.push_back(user);
+		}
+	}
+	auto chats = QVector<MTPChat>();
+	for (const auto &[peerId, chat] : entry.chats) {
+		if (!_owner->peerLoaded(peerId)) {
+			chats.push_back(chat);
+		}
+	}
+	if (!users.isEmpty()) {
+		_owner->processUsers(MTP_vector<MTPUser>(users));
+	}
+	if (!chats.isEmpty()) {
+		_owner->processChats(MTP_vector<MTPChat>(chats));
+	}
+}
+
+int32 HistoryCache::hash(not_null<History*> history) const {
+	const auto i = _entries.find(history->peer->id);
+	if (i == end(_entries) || i->second.messages.empty()) {
+		return 0;
+	}
+	auto ids = std::vector<MsgId>();
+	ids.reserve(i->second.messages.size());
+	const auto &messages = i->second.messages;
+	for (auto j = messages.rbegin(); j != messages.rend(); ++j) {
+		ids.push_back(j->first);
+	}
+	return Api::CountHash(ids);
+}
+
+void HistoryCache::save(
+		not_null<History*> history,
+		const MTPmessages_Messages &result) {
+	const auto [messages, users, chats] = [&] {
+		using Result = std::tuple<
+			const QVector<MTPMessage>*,
+			const QVector<MTPUser>*,
+			const QVector<MTPChat>*>;
+		switch (result.type()) {
+		case mtpc_messages_messages: {
+			const auto &data = result.c_messages_messages();
+			return Result(&data.vmessages.v, &data.vusers.v, &data.vchats.v);
+		} break;
+		case mtpc_messages_messagesSlice: {
+			const auto &data = result.c_messages_messagesSlice();
+			return Result(&data.vmessages.v, &data.vusers.v, &data.vchats.v);
+		} break;
+		case mtpc_messages_channelMessages: {
+			const auto &data = result.c_messages_channelMessages();
+			return Result(&data.vmessages.v, &data.vusers.v, &data.vchats.v);
+		} break;
+		}
+		return Result(nullptr, nullptr, nullptr);
+	}();
+	if (!messages) {
+		return;
+	}
+
+	const auto peerId = history->peer->id;
+	auto &entry = _entries[peerId];
+	entry.messages.clear();
+	entry.users.clear();
+	entry.chats.clear();
+	for (const auto &message : *messages) {
+		if (const auto id = IdFromMessage(message); IsServerMsgId(id)) {
+			entry.messages.emplace(id, message);
+		}
+	}
+	for (const auto &user : *users) {
+		entry.users.emplace(PeerFromUser(user), user);
+	}
+	for (const auto &chat : *chats) {
+		entry.chats.emplace(PeerFromChat(chat), chat);
+	}
+	entry.loaded = entry.fresh = true;
+	trim(peerId, entry);
+
+	withIndex([=, list = Messages(entry)] {
+		_index.removePeer(peerId);
+		indexChanged();
+		for (const auto &message : list) {
+			indexMessage(peerId, message);
+		}
+	});
+	scheduleWrite(peerId);
+}
+
+HistoryCache::~HistoryCache() {
+	// Don't lose the changes made since the last delayed write,
+	// the background index serialization won't finish in time.
+	if (_indexChanged || _indexWriteId != _indexWrittenId) {
+		_indexChanged = false;
+		_owner->cache().put(MessagesSearchIndexCacheKey(), _index.serialize());
+	}
+	writeChanged();
+}
+
+void HistoryCache::newMessage(const MTPMessage &message) {
+	const auto peerId = PeerFromMessage(message);
+	const auto id = IdFromMessage(message);
+	const auto i = _entries.find(peerId);
+
+	// Only a slice that we know reaches the bottom may grow without gaps,
+	// older messages (like loaded reply previews) are not added to it.
+	if (i == end(_entries) || !i->second.fresh || !IsServerMsgId(id)) {
+		return;
+	}
+	auto &messages = i->second.messages;
+	if (!messages.empty() && id < begin(messages)->first) {
+		return;
+	} else if (messages.find(id) != end(messages)) {
+		// Search results and other known messages are added once again,
+		// edits come in editMessage(), so don't reindex and rewrite them.
+		return;
+	}
+	messages.emplace(id, message);
+	trim(peerId, i->second);
+	withIndex([=] { indexMessage(peerId, message); });
+	scheduleWrite(peerId);
+}
+
+void HistoryCache::editMessage(const MTPMessage &message) {
+	const auto peerId = PeerFromMessage(message);
+	const auto i = _entries.find(peerId);
+	if (i == end(_entries)) {
+		return;
+	}
+	const auto j = i->second.messages.find(IdFromMessage(message));
+	if (j != end(i->second.messages)) {
+		j->second = message;
+		withIndex([=] { indexMessage(peerId, message); });
+		scheduleWrite(peerId);
+	}
+}
+
+void HistoryCache::sentMessage(
+		not_null<HistoryItem*> item,
+		const MTPDupdateShortSentMessage &data,
+		const QString &text) {
+	using Flag = MTPDmessage::Flag;
+	const auto replyTo = item->replyToId();
+	const auto post = item->isPost();
+	const auto flags = Flag::f_out
+		| (post ? Flag::f_post : Flag::f_from_id)
+		| (replyTo ? Flag::f_reply_to_msg_id : Flag(0))
+		| (data.has_media() ? Flag::f_media : Flag(0))
+		| (data.has_entities() ? Flag::f_entities : Flag(0));
+	newMessage(MTP_message(
+		MTP_flags(flags),
+		data.vid,
+		MTP_int(post ? 0 : _owner->session().userId()),
+		peerToMTP(item->history()->peer->id),
+		MTPMessageFwdHeader(),
+		MTPint(),
+		MTP_int(replyTo),
+		data.vdate,
+		MTP_string(text),
+		data.has_media() ? data.vmedia : MTP_messageMediaEmpty(),
+		MTPReplyMarkup(),
+		data.has_entities() ? data.ventities : MTPnullEntities,
+		MTPint(),
+		MTPint(),
+		MTPstring(),
+		MTPlong()));
+}
+
+void HistoryCache::removeMessage(PeerId peerId, MsgId messageId) {
+	const auto i = _entries.find(peerId);
+	if (i != end(_entries) && i->second.messages.erase(messageId)) {
+		withIndex([=] {
+			_index.remove(peerId, messageId);
+			indexChanged();
+		});
+		scheduleWrite(peerId);
+	}
+}
+
+void HistoryCache::scheduleWrite(PeerId peerId) {
+	_changed.emplace(peerId);
+	if (!_writeTimer.isActive()) {
+		_writeTimer.callOnce(kWriteDelay);
+	}
+}
+
+void HistoryCache::indexChanged() {
+	_indexChanged = true;
+	if (!_writeTimer.isActive()) {
+		_writeTimer.callOnce(kWriteDelay);
+	}
+}
+
+void HistoryCache::writeChanged() {
+	if (base::take(_indexChanged)) {
+		writeIndex();
+	}
+	for (const auto peerId : base::take(_changed)) {
+		const auto i = _entries.find(peerId);
+		if (i == end(_entries)) {
+			continue;
+		} else if (i->second.messages.empty()) {
+			_owner->cache().remove(HistoryCacheKey(peerId));
+		} else {
+			_owner->cache().put(
+				HistoryCacheKey(peerId),
+				Serialize(i->second));
+		}
+	}
+}
+
+void HistoryCache::writeIndex() {
+	// The whole index is serialized at once, so do it in the background
+	// with a copy and put the result only if no newer one was put already.
+	const auto id = ++_indexWriteId;
+	crl::async([=, index = _index] {
+		auto serialized = index.serialize();
+		crl::on_main(this, [=, serialized = std::move(serialized)]() mutable {
+			if (id > _indexWrittenId) {
+				_indexWrittenId = id;
+				_owner->cache().put(
+					MessagesSearchIndexCacheKey(),
+					std::move(serialized));
+			}
+		});
+	});
+}
+
+QVector<MTPMessage> HistoryCache::Messages(const Entry &entry) {
+	auto result = QVector<MTPMessage>();
+	result.reserve(entry.messages.size());
+	const auto &messages = entry.messages;
+	for (auto i = messages.rbegin(); i != messages.rend(); ++i) {
+		result.push_back(i->second);
+	}
+	return result;
+}
+
+void HistoryCache::trim(PeerId peerId, Entry &entry) {
+	while (int(entry.messages.size()) > kMaxMessages) {
+		const auto messageId = begin(entry.messages)->first;
+		entry.messages.erase(begin(entry.messages));
+		withIndex([=] {
+			_index.remove(peerId, messageId);
+			indexChanged();
+		});
+	}
+}
+
+void HistoryCache::indexLoaded(QByteArray &&serialized) {
+	if (auto parsed = MessagesSearchIndex::FromSerialized(serialized)) {
+		_index = std::move(*parsed);
+	} else if (!serialized.isEmpty()) {
+		_owner->cache().remove(MessagesSearchIndexCacheKey());
+	}
+	_indexLoaded = true;
+	for (const auto &callback : base::take(_indexCallbacks)) {
+		callback();
+	}
+}
+
+void HistoryCache::withIndex(Fn<void()> callback) {
+	if (_indexLoaded) {
+		callback();
+	} else {
+		_indexCallbacks.push_back(std::move(callback));
+	}
+}
+
+void HistoryCache::indexMessage(PeerId peerId, const MTPMessage &message) {
+	message.match([&](const MTPDmessage &data) {
+		_index.add(peerId, data.vid.v, data.vdate.v, qs(data.vmessage));
+		indexChanged();
+	}, [](const auto &data) {
+	});
+}
+
+void HistoryCache::search(
+		const QString &query,
+		PeerId peerId,
+		int limit,
+		Fn<void(QVector<MTPMessage>&&)> done) {
+	withIndex([=] {
+		auto found = _index.search(query, peerId, limit);
+		auto peers = base::flat_set<PeerId>();
+		for (const auto &result : found) {
+			peers.emplace(result.peerId);
+		}
+		if (peers.empty()) {
+			done({});
+			return;
+		}
+
+		// Read all the found chats before returning any of the messages.
+		const auto waiting = std::make_shared<int>(int(peers.size()));
+		const auto finish = [=, found = std::move(found)] {
+			if (!--*waiting) {
+				finishSearch(found, done);
+			}
+		};
+		for (const auto peerId : peers) {
+			loadEntry(peerId, finish);
+		}
+	});
+}
+
+void HistoryCache::finishSearch(
+		const std::vector<MessagesSearchIndex::Result> &found,
+		Fn<void(QVector<MTPMessage>&&)> done) {
+	auto result = QVector<MTPMessage>();
+	result.reserve(found.size());
+	for (const auto &hit : found) {
+		const auto &messages = _entries[hit.peerId].messages;
+		const auto i = messages.find(hit.messageId);
+		if (i != end(messages)) {
+			result.push_back(i->second);
+		} else {
+			// The chat was evicted from the cache or changed meanwhile.
+			_index.remove(hit.peerId, hit.messageId);
+			indexChanged();
+		}
+	}
+	done(std::move(result));
+}
+
+QByteArray HistoryCache::Serialize(const Entry &entry) {
+	auto buffer = mtpBuffer();
+	MTP_int(kSerializeVersion).write(buffer);
+	MTP_vector<MTPMessage>(Messages(entry)).write(buffer);
+	MTP_vector<MTPUser>(Values(entry.users)).write(buffer);
+	MTP_vector<MTPChat>(Values(entry.chats)).write(buffer);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.constData()),
+		buffer.size() * sizeof(mtpPrime));
+}
+
+auto HistoryCache::Deserialize(const QByteArray &serialized)
+-> std::optional<Entry> {
+	if (serialized.size() % sizeof(mtpPrime)) {
+		return std::nullopt;
+	}
+	auto from = reinterpret_cast<const mtpPrime*>(serialized.constData());
+	const auto end = from + (serialized.size() / sizeof(mtpPrime));
+	auto result = Entry();
+	try {
+		auto version = MTPint();
+		version.read(from, end);
+		if (version.v != kSerializeVersion) {
+			return std::nullopt;
+		}
+		auto messages = MTPVector<MTPMessage>();
+		auto users = MTPVector<MTPUser>();
+		auto chats = MTPVector<MTPChat>();
+		messages.read(from, end);
+		users.read(from, end);
+		chats.read(from, end);
+		for (const auto &message : messages.v) {
+			result.messages.emplace(IdFromMessage(message), message);
+		}
+		for (const auto &user : users.v) {
+			result.users.emplace(PeerFromUser(user), user);
+		}
+		for (const auto &chat : chats.v) {
+			result.chats.emplace(PeerFromChat(chat), chat);
+		}
+	} catch (Exception &) {
+		return std::nullopt;
+	}
+	return (from == end) ? std::make_optional(std::move(result)) : std::nullopt;
+}
+
+} // namespace Data
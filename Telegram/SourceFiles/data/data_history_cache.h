@@ -0,0 +1,112 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+#include "data/data_messages_search_index.h"
+#include "base/timer.h"
+#include "base/weak_ptr.h"
+
+class History;
+class HistoryItem;
+
+namespace Data {
+
+class Session;
+
+// Keeps the newest messages of opened chats in the local cache database,
+// so that a chat shows them right away before the server answers.
+//
+// The slice of a chat is replaced by each fresh bottom slice received from
+// the server and follows new, edited and deleted messages until the next
+// one. The disk usage is bounded by the local storage limits of the cache.
+//
+// Texts of the cached messages are kept in a search index, stored in the
+// cache database as well, so that they're found without the network.
+class HistoryCache final : public base::has_weak_ptr {
+public:
+	explicit HistoryCache(not_null<Session*> owner);
+	~HistoryCache();
+
+	// Calls done with cached messages ordered from the newest one, users
+	// and chats that were not known yet are already applied by then.
+	void load(
+		not_null<History*> history,
+		Fn<void(QVector<MTPMessage>&&)> done);
+
+	// Hash of the cached message ids for messages.getHistory.
+	[[nodiscard]] int32 hash(not_null<History*> history) const;
+
+	// Replaces the cached slice with the newest messages from the server.
+	void save(
+		not_null<History*> history,
+		const MTPmessages_Messages &result);
+
+	void newMessage(const MTPMessage &message);
+	void editMessage(const MTPMessage &message);
+	void removeMessage(PeerId peerId, MsgId messageId);
+
+	// Sent messages confirmed by updateShortSentMessage have no full data.
+	void sentMessage(
+		not_null<HistoryItem*> item,
+		const MTPDupdateShortSentMessage &data,
+		const QString &text);
+
+	// Calls done with cached messages containing all the query words
+	// (as prefixes) ordered from the newest one, peerId == 0 for all.
+	void search(
+		const QString &query,
+		PeerId peerId,
+		int limit,
+		Fn<void(QVector<MTPMessage>&&)> done);
+
+private:
+	struct Entry {
+		std::map<MsgId, MTPMessage> messages;
+		std::map<PeerId, MTPUser> users;
+		std::map<PeerId, MTPChat> chats;
+		std::vector<Fn<void()>> callbacks;
+		bool loading = false;
+		bool loaded = false;
+		bool fresh = false;
+	};
+
+	void loadEntry(PeerId peerId, Fn<void()> done);
+	void loaded(PeerId peerId, QByteArray &&serialized);
+	void apply(const Entry &entry);
+	void trim(PeerId peerId, Entry &entry);
+	void scheduleWrite(PeerId peerId);
+	void writeChanged();
+	void writeIndex();
+
+	void indexLoaded(QByteArray &&serialized);
+	void withIndex(Fn<void()> callback);
+	void indexChanged();
+	void indexMessage(PeerId peerId, const MTPMessage &message);
+	void finishSearch(
+		const std::vector<MessagesSearchIndex::Result> &found,
+		Fn<void(QVector<MTPMessage>&&)> done);
+
+	[[nodiscard]] static QVector<MTPMessage> Messages(const Entry &entry);
+	[[nodiscard]] static QByteArray Serialize(const Entry &entry);
+	[[nodiscard]] static std::optional<Entry> Deserialize(
+		const QByteArray &serialized);
+
+	const not_null<Session*> _owner;
+	std::map<PeerId, Entry> _entries;
+	base::flat_set<PeerId> _changed;
+	base::Timer _writeTimer;
+
+	MessagesSearchIndex _index;
+	std::vector<Fn<void()>> _indexCallbacks;
+	bool _indexLoaded = false;
+	bool _indexChanged = false;
+	int _indexWriteId = 0;
+	int _indexWrittenId = 0;
+
+};
+
+} // namespace Data
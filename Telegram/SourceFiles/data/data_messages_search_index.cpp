@@ -0,0 +1,334 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "data/data_messages_search_index.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kSerializeVersion = 1;
+constexpr auto kMaxDocuments = 20000;
+constexpr auto kTrimDocuments = kMaxDocuments / 10;
+constexpr auto kMaxWordsInMessage = 256;
+constexpr auto kMaxWordLength = 64;
+
+void WriteVarint(QByteArray &to, uint32 value) {
+	while (value >= 0x80U) {
+		to.append(char((value & 0x7FU) | 0x80U));
+		value >>= 7;
+	}
+	to.append(char(value));
+}
+
+[[nodiscard]] std::optional<uint32> ReadVarint(
+		const QByteArray &from,
+		int &offset) {
+	auto result = uint32(0);
+	for (auto shift = 0; shift < 32; shift += 7) {
+		if (offset >= from.size()) {
+			return std::nullopt;
+		}
+		const auto byte = uchar(from[offset++]);
+		result |= uint32(byte & 0x7FU) << shift;
+		if (!(byte & 0x80U)) {
+			return result;
+		}
+	}
+	return std::nullopt;
+}
+
+} // namespace
+
+std::vector<QString> MessagesSearchIndex::Words(const QString &text) {
+	auto list = TextUtilities::PrepareSearchWords(text);
+	auto result = std::vector<QString>();
+	result.reserve(std::min(int(list.size()), kMaxWordsInMessage));
+	for (auto &word : list) {
+		result.push_back((word.size() > kMaxWordLength)
+			? word.mid(0, kMaxWordLength)
+			: std::move(word));
+	}
+	ranges::sort(result);
+	result.erase(ranges::unique(result), end(result));
+	if (int(result.size()) > kMaxWordsInMessage) {
+		result.resize(kMaxWordsInMessage);
+	}
+	return result;
+}
+
+void MessagesSearchIndex::add(
+		PeerId peerId,
+		MsgId messageId,
+		TimeId date,
+		const QString &text) {
+	remove(peerId, messageId);
+
+	auto words = Words(text);
+	if (words.empty()) {
+		return;
+	}
+	addDocument({ peerId, messageId, date, std::move(words) });
+	trim();
+}
+
+void MessagesSearchIndex::addDocument(Document &&document) {
+	const auto index = _freeDocuments.empty()
+		? int(_documents.size())
+		: _freeDocuments.back();
+	if (index == int(_documents.size())) {
+		_documents.emplace_back();
+	} else {
+		_freeDocuments.pop_back();
+	}
+	for (const auto &word : document.words) {
+		auto &list = _postings[word];
+		list.insert(ranges::lower_bound(list, index), index);
+	}
+	_documentByKey.emplace(
+		Key{ document.peerId, document.messageId },
+		index);
+	_documents[index] = std::move(document);
+}
+
+void MessagesSearchIndex::remove(PeerId peerId, MsgId messageId) {
+	const auto i = _documentByKey.find({ peerId, messageId });
+	if (i != end(_documentByKey)) {
+		removeDocument(i);
+	}
+}
+
+void MessagesSearchIndex::removePeer(PeerId peerId) {
+	auto i = _documentByKey.lower_bound({ peerId, MsgId(0) });
+	while (i != end(_documentByKey) && i->first.first == peerId) {
+		removeDocument(i++);
+	}
+}
+
+void MessagesSearchIndex::removeDocument(std::map<Key, int>::iterator i) {
+	const auto index = i->second;
+	_documentByKey.erase(i);
+
+	auto &document = _documents[index];
+	for (const auto &word : document.words) {
+		const auto j = _postings.find(word);
+		if (j == end(_postings)) {
+			continue;
+		}
+		auto &list = j->second;
+		const auto k = ranges::lower_bound(list, index);
+		if (k != end(list) && *k == index) {
+			list.erase(k);
+		}
+		if (list.empty()) {
+			_postings.erase(j);
+		}
+	}
+	document = Document();
+	_freeDocuments.push_back(index);
+}
+
+void MessagesSearchIndex::trim() {
+	if (int(_documentByKey.size()) <= kMaxDocuments) {
+		return;
+	}
+	auto dates = std::vector<std::pair<TimeId, Key>>();
+	dates.reserve(_documentByKey.size());
+	for (const auto &[key, index] : _documentByKey) {
+		dates.emplace_back(_documents[index].date, key);
+	}
+	const auto remove = int(dates.size()) - kMaxDocuments + kTrimDocuments;
+	std::nth_element(begin(dates), begin(dates) + remove, end(dates));
+	for (auto i = 0; i != remove; ++i) {
+		this->remove(dates[i].second.first, dates[i].second.second);
+	}
+}
+
+auto MessagesSearchIndex::search(
+	const QString &query,
+	PeerId peerId,
+	int limit) const
+-> std::vector<Result> {
+	auto words = TextUtilities::PrepareSearchWords(query);
+	if (words.isEmpty() || limit <= 0) {
+		return {};
+	}
+	words.removeDuplicates();
+
+	auto found = std::vector<int>();
+	auto first = true;
+	for (const auto &word : words) {
+		auto matched = std::vector<int>();
+		for (auto i = _postings.lower_bound(word)
+			; i != end(_postings) && i->first.startsWith(word)
+			; ++i) {
+			matched.insert(end(matched), begin(i->second), end(i->second));
+		}
+		ranges::sort(matched);
+		matched.erase(ranges::unique(matched), end(matched));
+		if (first) {
+			found = std::move(matched);
+			first = false;
+		} else {
+			auto intersection = std::vector<int>();
+			std::set_intersection(
+				begin(found),
+				end(found),
+				begin(matched),
+				end(matched),
+				std::back_inserter(intersection));
+			found = std::move(intersection);
+		}
+		if (found.empty()) {
+			return {};
+		}
+	}
+
+	auto result = std::vector<Result>();
+	result.reserve(found.size());
+	for (const auto index : found) {
+		const auto &document = _documents[index];
+		if (!peerId || document.peerId == peerId) {
+			result.push_back({
+				document.peerId,
+				document.messageId,
+				document.date });
+		}
+	}
+	const auto newer = [](const Result &a, const Result &b) {
+		return (a.date != b.date)
+			? (a.date > b.date)
+			: (a.messageId > b.messageId);
+	};
+	if (int(result.size()) > limit) {
+		std::partial_sort(
+			begin(result),
+			begin(result) + limit,
+			end(result),
+			newer);
+		result.resize(limit);
+	} else {
+		ranges::sort(result, newer);
+	}
+	return result;
+}
+
+int MessagesSearchIndex::size() const {
+	return int(_documentByKey.size());
+}
+
+QByteArray MessagesSearchIndex::serialize() const {
+	auto renumbered = std::vector<int>(_documents.size(), -1);
+	auto count = 0;
+	for (auto i = 0, till = int(_documents.size()); i != till; ++i) {
+		if (_documents[i].peerId) {
+			renumbered[i] = count++;
+		}
+	}
+
+	auto result = QByteArray();
+	{
+		auto buffer = QBuffer(&result);
+		buffer.open(QIODevice::WriteOnly);
+		auto stream = QDataStream(&buffer);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << qint32(kSerializeVersion) << qint32(count);
+		for (const auto &document : _documents) {
+			if (document.peerId) {
+				stream
+					<< quint64(document.peerId)
+					<< qint32(document.messageId)
+					<< qint32(document.date);
+			}
+		}
+		stream << qint32(_postings.size());
+		for (const auto &[word, list] : _postings) {
+			auto encoded = QByteArray();
+			encoded.reserve(list.size() * 2);
+			auto previous = 0;
+			for (const auto index : list) {
+				const auto value = renumbered[index];
+				WriteVarint(encoded, uint32(value - previous));
+				previous = value;
+			}
+			stream << word << encoded;
+		}
+	}
+	return result;
+}
+
+auto MessagesSearchIndex::FromSerialized(const QByteArray &serialized)
+-> std::optional<MessagesSearchIndex> {
+	if (serialized.isEmpty()) {
+		return std::nullopt;
+	}
+	auto stream = QDataStream(serialized);
+	stream.setVersion(QDataStream::Qt_5_1);
+	auto version = qint32();
+	auto count = qint32();
+	stream >> version >> count;
+	if (stream.status() != QDataStream::Ok
+		|| version != kSerializeVersion
+		|| count < 0
+		|| count > kMaxDocuments) {
+		return std::nullopt;
+	}
+	auto result = MessagesSearchIndex();
+	result._documents.resize(count);
+	for (auto i = 0; i != count; ++i) {
+		auto peerId = quint64();
+		auto messageId = qint32();
+		auto date = qint32();
+		stream >> peerId >> messageId >> date;
+		if (stream.status() != QDataStream::Ok || !peerId) {
+			return std::nullopt;
+		}
+		auto &document = result._documents[i];
+		document.peerId = PeerId(peerId);
+		document.messageId = messageId;
+		document.date = date;
+		if (!result._documentByKey.emplace(
+				Key{ document.peerId, document.messageId },
+				i).second) {
+			return std::nullopt;
+		}
+	}
+	auto words = qint32();
+	stream >> words;
+	if (stream.status() != QDataStream::Ok || words < 0) {
+		return std::nullopt;
+	}
+	for (auto i = 0; i != words; ++i) {
+		auto word = QString();
+		auto encoded = QByteArray();
+		stream >> word >> encoded;
+		if (stream.status() != QDataStream::Ok || word.isEmpty()) {
+			return std::nullopt;
+		}
+		auto &list = result._postings[word];
+		auto offset = 0;
+		auto index = 0;
+		while (offset < encoded.size()) {
+			const auto delta = ReadVarint(encoded, offset);
+			if (!delta || (!list.empty() && !*delta)) {
+				return std::nullopt;
+			}
+			index += int(*delta);
+			if (index < 0 || index >= count) {
+				return std::nullopt;
+			}
+			list.push_back(index);
+			result._documents[index].words.push_back(word);
+		}
+		if (list.empty()) {
+			return std::nullopt;
+		}
+	}
+	return stream.atEnd()
+		? std::make_optional(std::move(result))
+		: std::nullopt;
+}
+
+} // namespace Data
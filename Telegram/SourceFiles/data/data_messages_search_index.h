@@ -0,0 +1,63 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Data {
+
+// Inverted index of message texts: words prepared the same way as in all
+// the other local searches (lowercase, without accents) map to sorted
+// lists of documents. Every query word is matched as a prefix.
+class MessagesSearchIndex final {
+public:
+	struct Result {
+		PeerId peerId = 0;
+		MsgId messageId = 0;
+		TimeId date = 0;
+	};
+
+	// Replaces the previously indexed text of the same message.
+	void add(PeerId peerId, MsgId messageId, TimeId date, const QString &text);
+	void remove(PeerId peerId, MsgId messageId);
+	void removePeer(PeerId peerId);
+
+	// All query words should be found, peerId == 0 searches everywhere.
+	// Results are ordered from the newest one.
+	[[nodiscard]] std::vector<Result> search(
+		const QString &query,
+		PeerId peerId,
+		int limit) const;
+
+	[[nodiscard]] int size() const;
+
+	// Documents are renumbered and posting lists are delta encoded.
+	[[nodiscard]] QByteArray serialize() const;
+	[[nodiscard]] static std::optional<MessagesSearchIndex> FromSerialized(
+		const QByteArray &serialized);
+
+private:
+	using Key = std::pair<PeerId, MsgId>;
+	struct Document {
+		PeerId peerId = 0;
+		MsgId messageId = 0;
+		TimeId date = 0;
+		std::vector<QString> words;
+	};
+
+	[[nodiscard]] static std::vector<QString> Words(const QString &text);
+
+	void addDocument(Document &&document);
+	void removeDocument(std::map<Key, int>::iterator i);
+	void trim();
+
+	std::vector<Document> _documents;
+	std::vector<int> _freeDocuments;
+	std::map<Key, int> _documentByKey;
+	std::map<QString, std::vector<int>> _postings;
+
+};
+
+} // namespace Data
@@ -39,6 +39,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "data/data_game.h"
 #include "mainwidget.h"
 #include "data/data_poll.h"
+#include "data/data_history_cache.h"
 #include "styles/style_boxes.h" // for st::backgroundSize
 
 namespace Data {
@@ -154,6 +155,7 @@ Session::Session(not_null<AuthSession*> session)
 , _unmuteByFinishedTimer([=] { unmuteByFinished(); }) {
 	_cache->open(Local::cacheKey());
 	_bigFileCache->open(Local::cacheBigFileKey());
+	_historyCache = std::make_unique<HistoryCache>(this);
 
 	setupContactViewsViewer();
 	setupChannelLeavingViewer();
@@ -754,6 +756,10 @@ Storage::Cache::Database &Session::cacheBigFile() {
 	return *_bigFileCache;
 }
 
+HistoryCache &Session::historyCache() {
+	return *_historyCache;
+}
+
 void Session::startExport(PeerData *peer) {
 	startExport(peer ? peer->input : MTP_inputPeerEmpty());
 }
@@ -1128,11 +1134,43 @@ rpl::producer<not_null<History*>> Session::historyChanged() const {
 }
 
 void Session::sendHistoryChangeNotifications() {
+	if (_updatesBatchLevel > 0) {
+		return;
+	}
 	for (const auto history : base::take(_historiesChanged)) {
 		_historyChanged.fire_copy(history);
 	}
 }
 
+void Session::startUpdatesBatch() {
+	++_updatesBatchLevel;
+}
+
+void Session::finishUpdatesBatch() {
+	Expects(_updatesBatchLevel > 0);
+
+	if (--_updatesBatchLevel > 0) {
+		return;
+	}
+	for (const auto &[key, exists] : base::take(_chatListExistenceDelayed)) {
+		key.entry()->setChatListExistence(exists);
+	}
+	if (base::take(_unreadCounterUpdateDelayed)) {
+		Notify::unreadCounterUpdated();
+	}
+	sendHistoryChangeNotifications();
+}
+
+bool Session::updatesBatched() const {
+	return (_updatesBatchLevel > 0);
+}
+
+void Session::setChatListExistenceDelayed(Dialogs::Key key, bool exists) {
+	Expects(_updatesBatchLevel > 0);
+
+	_chatListExistenceDelayed[key] = exists;
+}
+
 void Session::removeMegagroupParticipant(
 		not_null<ChannelData*> channel,
 		not_null<UserData*> user) {
@@ -1466,6 +1504,9 @@ HistoryItem *Session::addNewMessage(
 	if (result && type == NewMessageUnread) {
 		CheckForSwitchInlineButton(result);
 	}
+	if (result) {
+		_historyCache->newMessage(data);
+	}
 	return result;
 }
 
@@ -1567,7 +1608,7 @@ void Session::unreadIncrement(int count, bool muted) {
 	}
 	if (_session->settings().countUnreadMessages()) {
 		if (!muted || _session->settings().includeMutedCounter()) {
-			Notify::unreadCounterUpdated();
+			notifyUnreadCounterUpdated();
 		}
 	}
 }
@@ -1584,7 +1625,7 @@ void Session::unreadMuteChanged(int count, bool muted) {
 		const auto changed = !_session->settings().includeMutedCounter()
 			|| (wasAll != nowAll);
 		if (changed) {
-			Notify::unreadCounterUpdated();
+			notifyUnreadCounterUpdated();
 		}
 	}
 }
@@ -1606,11 +1647,19 @@ void Session::unreadEntriesChanged(
 		const auto withoutMutedChanged = !withMuted
 			&& (withUnreadDelta != mutedWithUnreadDelta);
 		if (withMutedChanged || withoutMutedChanged) {
-			Notify::unreadCounterUpdated();
+			notifyUnreadCounterUpdated();
 		}
 	}
 }
 
+void Session::notifyUnreadCounterUpdated() {
+	if (_updatesBatchLevel > 0) {
+		_unreadCounterUpdateDelayed = true;
+	} else {
+		Notify::unreadCounterUpdated();
+	}
+}
+
 void Session::selfDestructIn(not_null<HistoryItem*> item, crl::time delay) {
 	_selfDestructItems.push_back(item->fullId());
 	if (!_selfDestructTimer.isActive()
@@ -8,6 +8,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 
 #include "storage/storage_databases.h"
 #include "chat_helpers/stickers.h"
+#include "chat_helpers/stickers_emoji_index.h"
 #include "dialogs/dialogs_key.h"
 #include "data/data_groups.h"
 #include "data/data_notify_settings.h"
@@ -49,6 +50,7 @@ namespace Data {
 class Feed;
 enum class FeedUpdateFlag;
 struct FeedUpdate;
+class HistoryCache;
 
 class WallPaper;
 
@@ -84,6 +86,7 @@ public:
 
 	[[nodiscard]] Storage::Cache::Database &cache();
 	[[nodiscard]] Storage::Cache::Database &cacheBigFile();
+	[[nodiscard]] HistoryCache &historyCache();
 
 	[[nodiscard]] not_null<PeerData*> peer(PeerId id);
 	[[nodiscard]] not_null<PeerData*> peer(UserId id) = delete;
@@ -183,6 +186,13 @@ public:
 	[[nodiscard]] rpl::producer<not_null<History*>> historyChanged() const;
 	void sendHistoryChangeNotifications();
 
+	// Chats list positions, the unread counter and history changes are
+	// applied once for everything fed between these two calls.
+	void startUpdatesBatch();
+	void finishUpdatesBatch();
+	[[nodiscard]] bool updatesBatched() const;
+	void setChatListExistenceDelayed(Dialogs::Key key, bool exists);
+
 	using MegagroupParticipant = std::tuple<
 		not_null<ChannelData*>,
 		not_null<UserData*>>;
@@ -250,14 +260,20 @@ public:
 		return _stickerSets;
 	}
 	Stickers::Sets &stickerSetsRef() {
+		// The caller may change any set, let the index validate them.
+		_stickersEmojiIndex.markCheckNeeded();
 		return _stickerSets;
 	}
 	const Stickers::Order &stickerSetsOrder() const {
 		return _stickerSetsOrder;
 	}
 	Stickers::Order &stickerSetsOrderRef() {
+		_stickersEmojiIndex.markCheckNeeded();
 		return _stickerSetsOrder;
 	}
+	Stickers::EmojiIndex &stickersEmojiIndex() {
+		return _stickersEmojiIndex;
+	}
 	const Stickers::Order &featuredStickerSetsOrder() const {
 		return _featuredStickerSetsOrder;
 	}
@@ -334,6 +350,7 @@ public:
 	void unreadEntriesChanged(
 		int withUnreadDelta,
 		int mutedWithUnreadDelta);
+	void notifyUnreadCounterUpdated();
 
 	void selfDestructIn(not_null<HistoryItem*> item, crl::time delay);
 
@@ -677,6 +694,7 @@ private:
 
 	Storage::DatabasePointer _cache;
 	Storage::DatabasePointer _bigFileCache;
+	std::unique_ptr<HistoryCache> _historyCache;
 
 	std::unique_ptr<Export::Controller> _export;
 	std::unique_ptr<Export::View::PanelController> _exportPanel;
@@ -704,6 +722,9 @@ private:
 	rpl::event_stream<not_null<const History*>> _historyCleared;
 	base::flat_set<not_null<History*>> _historiesChanged;
 	rpl::event_stream<not_null<History*>> _historyChanged;
+	int _updatesBatchLevel = 0;
+	base::flat_map<Dialogs::Key, bool> _chatListExistenceDelayed;
+	bool _unreadCounterUpdateDelayed = false;
 	rpl::event_stream<MegagroupParticipant> _megagroupParticipantRemoved;
 	rpl::event_stream<MegagroupParticipant> _megagroupParticipantAdded;
 	rpl::event_stream<FeedUpdate> _feedUpdates;
@@ -718,6 +739,7 @@ private:
 	rpl::variable<int> _featuredStickerSetsUnreadCount = 0;
 	Stickers::Sets _stickerSets;
 	Stickers::Order _stickerSetsOrder;
+	Stickers::EmojiIndex _stickersEmojiIndex;
 	Stickers::Order _featuredStickerSetsOrder;
 	Stickers::Order _archivedStickerSetsOrder;
 	Stickers::SavedGifs _savedGifs;
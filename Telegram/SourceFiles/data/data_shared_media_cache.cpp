@@ -0,0 +1,369 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "data/data_shared_media_cache.h"
+
+#include "data/data_session.h"
+#include "data/data_search_controller.h"
+#include "data/data_peer.h"
+#include "history/history_item.h"
+#include "storage/storage_facade.h"
+#include "storage/cache/storage_cache_database.h"
+#include "auth_session.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kSerializeVersion = 1;
+constexpr auto kMaxMessages = 500;
+constexpr auto kMaxPeers = 500;
+
+template <typename Type>
+[[nodiscard]] QVector<Type> Values(const std::map<PeerId, Type> &map) {
+	auto result = QVector<Type>();
+	result.reserve(map.size());
+	for (const auto &[peerId, value] : map) {
+		result.push_back(value);
+	}
+	return result;
+}
+
+} // namespace
+
+SharedMediaCache::SharedMediaCache(not_null<AuthSession*> session)
+: _session(session) {
+	_session->storage().sharedMediaOneRemoved(
+	) | rpl::start_with_next([=](const Storage::SharedMediaRemoveOne &update) {
+		removeMessage(update.peerId, update.types, update.messageId);
+	}, _lifetime);
+
+	_session->storage().sharedMediaAllRemoved(
+	) | rpl::start_with_next([=](const Storage::SharedMediaRemoveAll &update) {
+		removeAll(update.peerId);
+	}, _lifetime);
+}
+
+void SharedMediaCache::load(
+		not_null<PeerData*> peer,
+		Storage::SharedMediaType type) {
+	const auto key = Key{ peer->id, type };
+	auto &entry = _entries[key];
+	if (entry.loading || entry.loaded || entry.received) {
+		return;
+	}
+	entry.loading = true;
+	_session->data().cache().get(
+		SharedMediaCacheKey(peer->id, type),
+		[=](QByteArray &&value) {
+			crl::on_main(this, [=, value = std::move(value)]() mutable {
+				loaded(key, std::move(value));
+			});
+		});
+}
+
+void SharedMediaCache::loaded(Key key, QByteArray &&serialized) {
+	auto &entry = _entries[key];
+	entry.loading = false;
+	entry.loaded = true;
+	if (serialized.isEmpty() || entry.received) {
+		// Fresh data is already here, it will overwrite the cache.
+		return;
+	}
+	auto parsed = Deserialize(serialized);
+	if (!parsed) {
+		_session->data().cache().remove(
+			SharedMediaCacheKey(key.first, key.second));
+		return;
+	}
+	parsed->loaded = true;
+	entry = std::move(*parsed);
+	apply(_session->data().peer(key.first), key, entry);
+}
+
+void SharedMediaCache::apply(
+		not_null<PeerData*> peer,
+		Key key,
+		const Entry &entry) {
+	auto &owner = _session->data();
+
+	// Don't overwrite anything we already know with cached data.
+	auto users = QVector<MTPUser>();
+	for (const auto &[peerId, user] : entry.users) {
+		if (!owner.peerLoaded(peerId)) {
+			users.push_back(user);
+		}
+	}
+	auto chats = QVector<MTPChat>();
+	for (const auto &[peerId, chat] : entry.chats) {
+		if (!owner.peerLoaded(peerId)) {
+			chats.push_back(chat);
+		}
+	}
+	if (!users.isEmpty()) {
+		owner.processUsers(MTP_vector<MTPUser>(users));
+	}
+	if (!chats.isEmpty()) {
+		owner.processChats(MTP_vector<MTPChat>(chats));
+	}
+
+	const auto type = key.second;
+	const auto channel = peerToChannel(peer->id);
+	auto ids = std::vector<MsgId>();
+	ids.reserve(entry.messages.size());
+	for (const auto &[messageId, message] : entry.messages) {
+		auto item = App::histItemById(channel, messageId);
+		if (!item) {
+			item = owner.addNewMessage(message, NewMessageExisting);
+		}
+		if (item && item->sharedMediaTypes().test(type)) {
+			ids.push_back(messageId);
+		}
+	}
+	for (const auto range : entry.ranges) {
+		const auto from = ranges::lower_bound(ids, range.from);
+		const auto till = ranges::upper_bound(ids, range.till);
+		_session->storage().add(Storage::SharedMediaAddSlice(
+			peer->id,
+			type,
+			std::vector<MsgId>(from, till),
+			range,
+			entry.count));
+	}
+}
+
+void SharedMediaCache::save(
+		not_null<PeerData*> peer,
+		Storage::SharedMediaType type,
+		MsgId messageId,
+		LoadDirection direction,
+		const MTPmessages_Messages &result,
+		const Api::SearchResult &parsed) {
+	const auto key = Key{ peer->id, type };
+	auto &entry = _entries[key];
+	entry.received = true;
+
+	const auto [messages, users, chats] = [&] {
+		using Result = std::tuple<
+			const QVector<MTPMessage>*,
+			const QVector<MTPUser>*,
+			const QVector<MTPChat>*>;
+		switch (result.type()) {
+		case mtpc_messages_messages: {
+			const auto &data = result.c_messages_messages();
+			return Result(&data.vmessages.v, &data.vusers.v, &data.vchats.v);
+		} break;
+		case mtpc_messages_messagesSlice: {
+			const auto &data = result.c_messages_messagesSlice();
+			return Result(&data.vmessages.v, &data.vusers.v, &data.vchats.v);
+		} break;
+		case mtpc_messages_channelMessages: {
+			const auto &data = result.c_messages_channelMessages();
+			return Result(&data.vmessages.v, &data.vusers.v, &data.vchats.v);
+		} break;
+		}
+		return Result(nullptr, nullptr, nullptr);
+	}();
+	if (!messages) {
+		return;
+	}
+
+	// Messages that we had between the received ones (or newer than all
+	// of them for the top slice) were deleted or changed their media.
+	const auto fresh = base::flat_set<MsgId>{
+		begin(parsed.messageIds),
+		end(parsed.messageIds)
+	};
+	const auto top = !messageId && (direction == LoadDirection::Before);
+	const auto checkFrom = fresh.empty() ? MsgId(0) : fresh.front();
+	const auto checkTill = top
+		? ServerMaxMsgId
+		: fresh.empty()
+		? MsgId(-1)
+		: fresh.back();
+	auto removed = std::vector<MsgId>();
+	for (auto i = entry.messages.lower_bound(checkFrom)
+		; i != end(entry.messages) && i->first <= checkTill
+		;) {
+		if (!fresh.contains(i->first)) {
+			removed.push_back(i->first);
+			i = entry.messages.erase(i);
+		} else {
+			++i;
+		}
+	}
+	for (const auto id : removed) {
+		_session->storage().remove(Storage::SharedMediaRemoveOne(
+			peer->id,
+			type,
+			id));
+	}
+
+	for (const auto &message : *messages) {
+		const auto id = IdFromMessage(message);
+		if (fresh.contains(id)) {
+			entry.messages.insert_or_assign(id, message);
+		}
+	}
+	for (const auto &user : *users) {
+		entry.users.insert_or_assign(PeerFromUser(user), user);
+	}
+	for (const auto &chat : *chats) {
+		entry.chats.insert_or_assign(PeerFromChat(chat), chat);
+	}
+	AddRange(entry, parsed.noSkipRange);
+	entry.count = parsed.fullCount;
+	Trim(entry);
+	write(key, entry);
+}
+
+void SharedMediaCache::removeMessage(
+		PeerId peerId,
+		Storage::SharedMediaTypesMask types,
+		MsgId messageId) {
+	for (auto i = 0; i != Storage::kSharedMediaTypeCount; ++i) {
+		const auto type = static_cast<Storage::SharedMediaType>(i);
+		if (!types.test(type)) {
+			continue;
+		}
+		const auto key = Key{ peerId, type };
+		const auto j = _entries.find(key);
+		if (j == end(_entries) || !j->second.messages.erase(messageId)) {
+			continue;
+		}
+		if (j->second.count) {
+			*j->second.count = std::max(*j->second.count - 1, 0);
+		}
+		write(key, j->second);
+	}
+}
+
+void SharedMediaCache::removeAll(PeerId peerId) {
+	for (auto i = 0; i != Storage::kSharedMediaTypeCount; ++i) {
+		const auto type = static_cast<Storage::SharedMediaType>(i);
+		_entries.erase(Key{ peerId, type });
+		_session->data().cache().remove(SharedMediaCacheKey(peerId, type));
+	}
+}
+
+void SharedMediaCache::write(Key key, const Entry &entry) {
+	_session->data().cache().put(
+		SharedMediaCacheKey(key.first, key.second),
+		Serialize(entry));
+}
+
+void SharedMediaCache::AddRange(Entry &entry, MsgRange range) {
+	auto &list = entry.ranges;
+	for (auto i = begin(list); i != end(list);) {
+		if (i->from <= range.till && range.from <= i->till) {
+			range.from = std::min(range.from, i->from);
+			range.till = std::max(range.till, i->till);
+			i = list.erase(i);
+		} else {
+			++i;
+		}
+	}
+	list.insert(
+		ranges::upper_bound(list, range.from, std::less<>(), &MsgRange::from),
+		range);
+}
+
+void SharedMediaCache::Trim(Entry &entry) {
+	if (int(entry.messages.size()) > kMaxMessages) {
+		const auto remove = int(entry.messages.size()) - kMaxMessages;
+		entry.messages.erase(
+			begin(entry.messages),
+			std::next(begin(entry.messages), remove));
+		const auto from = begin(entry.messages)->first;
+		auto &list = entry.ranges;
+		list.erase(ranges::remove_if(list, [&](const MsgRange &range) {
+			return (range.till < from);
+		}), end(list));
+		for (auto &range : list) {
+			accumulate_max(range.from, from);
+		}
+	}
+	if (int(entry.users.size() + entry.chats.size()) > kMaxPeers) {
+		// Older messages senders may be lost, they're requested anyway.
+		entry.users.clear();
+		entry.chats.clear();
+	}
+}
+
+QByteArray SharedMediaCache::Serialize(const Entry &entry) {
+	auto buffer = mtpBuffer();
+	MTP_int(kSerializeVersion).write(buffer);
+	MTP_int(entry.count.value_or(-1)).write(buffer);
+	MTP_int(entry.ranges.size()).write(buffer);
+	for (const auto range : entry.ranges) {
+		MTP_int(range.from).write(buffer);
+		MTP_int(range.till).write(buffer);
+	}
+	auto messages = QVector<MTPMessage>();
+	messages.reserve(entry.messages.size());
+	for (const auto &[messageId, message] : entry.messages) {
+		messages.push_back(message);
+	}
+	MTP_vector<MTPMessage>(messages).write(buffer);
+	MTP_vector<MTPUser>(Values(entry.users)).write(buffer);
+	MTP_vector<MTPChat>(Values(entry.chats)).write(buffer);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.constData()),
+		buffer.size() * sizeof(mtpPrime));
+}
+
+auto SharedMediaCache::Deserialize(const QByteArray &serialized)
+-> std::optional<Entry> {
+	if (serialized.size() % sizeof(mtpPrime)) {
+		return std::nullopt;
+	}
+	auto from = reinterpret_cast<const mtpPrime*>(serialized.constData());
+	const auto end = from + (serialized.size() / sizeof(mtpPrime));
+	auto result = Entry();
+	try {
+		auto version = MTPint();
+		version.read(from, end);
+		if (version.v != kSerializeVersion) {
+			return std::nullopt;
+		}
+		auto count = MTPint();
+		count.read(from, end);
+		if (count.v >= 0) {
+			result.count = count.v;
+		}
+		auto rangesCount = MTPint();
+		rangesCount.read(from, end);
+		if (rangesCount.v < 0 || rangesCount.v > kMaxMessages) {
+			return std::nullopt;
+		}
+		for (auto i = 0; i != rangesCount.v; ++i) {
+			auto rangeFrom = MTPint();
+			auto rangeTill = MTPint();
+			rangeFrom.read(from, end);
+			rangeTill.read(from, end);
+			result.ranges.push_back({ rangeFrom.v, rangeTill.v });
+		}
+		auto messages = MTPVector<MTPMessage>();
+		auto users = MTPVector<MTPUser>();
+		auto chats = MTPVector<MTPChat>();
+		messages.read(from, end);
+		users.read(from, end);
+		chats.read(from, end);
+		for (const auto &message : messages.v) {
+			result.messages.emplace(IdFromMessage(message), message);
+		}
+		for (const auto &user : users.v) {
+			result.users.emplace(PeerFromUser(user), user);
+		}
+		for (const auto &chat : chats.v) {
+			result.chats.emplace(PeerFromChat(chat), chat);
+		}
+	} catch (Exception &) {
+		return std::nullopt;
+	}
+	return (from == end) ? std::make_optional(std::move(result)) : std::nullopt;
+}
+
+} // namespace Data
@@ -0,0 +1,80 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+#include "storage/storage_shared_media.h"
+#include "base/weak_ptr.h"
+
+class AuthSession;
+
+namespace Api {
+struct SearchResult;
+} // namespace Api
+
+namespace Data {
+
+enum class LoadDirection : char;
+
+// Keeps received shared media slices in the local cache database,
+// so that the media of a peer is shown right away in the next launch.
+//
+// Cached messages are fed as existing ones and only the users and chats
+// that are not known yet are taken from the cache. The top slice is still
+// requested once per session and the messages it doesn't have any more
+// are removed from both the cache and the shared media storage.
+class SharedMediaCache final : public base::has_weak_ptr {
+public:
+	explicit SharedMediaCache(not_null<AuthSession*> session);
+
+	// Reads the cached slices once per session for the peer and type.
+	void load(not_null<PeerData*> peer, Storage::SharedMediaType type);
+
+	// Should be called before the parsed slice is added to the storage.
+	void save(
+		not_null<PeerData*> peer,
+		Storage::SharedMediaType type,
+		MsgId messageId,
+		LoadDirection direction,
+		const MTPmessages_Messages &result,
+		const Api::SearchResult &parsed);
+
+private:
+	struct Entry {
+		std::optional<int> count;
+		std::vector<MsgRange> ranges;
+		std::map<MsgId, MTPMessage> messages;
+		std::map<PeerId, MTPUser> users;
+		std::map<PeerId, MTPChat> chats;
+		bool loading = false;
+		bool loaded = false;
+		bool received = false;
+	};
+	using Key = std::pair<PeerId, Storage::SharedMediaType>;
+
+	void loaded(Key key, QByteArray &&serialized);
+	void apply(not_null<PeerData*> peer, Key key, const Entry &entry);
+	void write(Key key, const Entry &entry);
+	void removeMessage(
+		PeerId peerId,
+		Storage::SharedMediaTypesMask types,
+		MsgId messageId);
+	void removeAll(PeerId peerId);
+
+	[[nodiscard]] static QByteArray Serialize(const Entry &entry);
+	[[nodiscard]] static std::optional<Entry> Deserialize(
+		const QByteArray &serialized);
+	static void AddRange(Entry &entry, MsgRange range);
+	static void Trim(Entry &entry);
+
+	const not_null<AuthSession*> _session;
+	std::map<Key, Entry> _entries;
+
+	rpl::lifetime _lifetime;
+
+};
+
+} // namespace Data
@@ -28,6 +28,10 @@ constexpr auto kUrlCacheTag = 0x0000030000000000ULL;
 constexpr auto kUrlCacheMask = 0x000000FFFFFFFFFFULL;
 constexpr auto kGeoPointCacheTag = 0x0000040000000000ULL;
 constexpr auto kGeoPointCacheMask = 0x000000FFFFFFFFFFULL;
+constexpr auto kSharedMediaCacheTag = 0x0000050000000000ULL;
+constexpr auto kSharedMediaCacheMask = 0x00000000000000FFULL;
+constexpr auto kHistoryCacheTag = 0x0000060000000000ULL;
+constexpr auto kMessagesSearchIndexCacheTag = 0x0000070000000000ULL;
 
 } // namespace
 
@@ -113,6 +117,24 @@ Storage::Cache::Key GeoPointCacheKey(const GeoPointLocation &location) {
 	};
 }
 
+Storage::Cache::Key SharedMediaCacheKey(
+		PeerId peerId,
+		Storage::SharedMediaType type) {
+	return Storage::Cache::Key{
+		Data::kSharedMediaCacheTag
+			| (uint64(type) & Data::kSharedMediaCacheMask),
+		uint64(peerId)
+	};
+}
+
+Storage::Cache::Key HistoryCacheKey(PeerId peerId) {
+	return Storage::Cache::Key{ Data::kHistoryCacheTag, uint64(peerId) };
+}
+
+Storage::Cache::Key MessagesSearchIndexCacheKey() {
+	return Storage::Cache::Key{ Data::kMessagesSearchIndexCacheTag, 0 };
+}
+
 ReplyPreview::ReplyPreview() = default;
 
 ReplyPreview::ReplyPreview(ReplyPreview &&other) = default;
@@ -252,3 +274,19 @@ TimeId DateFromMessage(const MTPmessage &message) {
 		return message.vdate.v;
 	});
 }
+
+PeerId PeerFromUser(const MTPUser &user) {
+	return user.match([](const auto &data) {
+		return peerFromUser(data.vid);
+	});
+}
+
+PeerId PeerFromChat(const MTPChat &chat) {
+	return chat.match([](const MTPDchannel &data) {
+		return peerFromChannel(data.vid);
+	}, [](const MTPDchannelForbidden &data) {
+		return peerFromChannel(data.vid);
+	}, [](const auto &data) {
+		return peerFromChat(data.vid);
+	});
+}
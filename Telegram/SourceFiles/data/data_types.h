@@ -13,6 +13,7 @@ namespace Storage {
 namespace Cache {
 struct Key;
 } // namespace Cache
+enum class SharedMediaType : signed char;
 } // namespace Storage
 
 class HistoryItem;
@@ -277,6 +278,18 @@ PeerId PeerFromMessage(const MTPmessage &message);
 MTPDmessage::Flags FlagsFromMessage(const MTPmessage &message);
 MsgId IdFromMessage(const MTPmessage &message);
 TimeId DateFromMessage(const MTPmessage &message);
+PeerId PeerFromUser(const MTPUser &user);
+PeerId PeerFromChat(const MTPChat &chat);
+
+namespace Data {
+
+Storage::Cache::Key SharedMediaCacheKey(
+	PeerId peerId,
+	Storage::SharedMediaType type);
+Storage::Cache::Key HistoryCacheKey(PeerId peerId);
+Storage::Cache::Key MessagesSearchIndexCacheKey();
+
+} // namespace Data
 
 class DocumentData;
 class PhotoData;
@@ -106,6 +106,10 @@ void Entry::updateChatListExistence() {
 }
 
 void Entry::setChatListExistence(bool exists) {
+	if (Auth().data().updatesBatched()) {
+		Auth().data().setChatListExistenceDelayed(_key, exists);
+		return;
+	}
 	if (const auto main = App::main()) {
 		if (exists && _sortKeyInChatList) {
 			main->createDialog(_key);
@@ -93,6 +93,9 @@ public:
 	virtual void updateChatListExistence();
 	bool needUpdateInChatList() const;
 
+	// Delayed by Data::Session while a batch of updates is applied.
+	void setChatListExistence(bool exists);
+
 	virtual EntryTypes getEntryType() const { return _isFavorite ? EntryType::Favorite : EntryType::None; }
 	virtual bool toImportant() const = 0;
 	virtual bool shouldBeInChatList() const = 0;
@@ -136,7 +139,6 @@ private:
 	virtual void changedInChatListHook(Dialogs::Mode list, bool added);
 	virtual void changedChatListPinHook();
 
-	void setChatListExistence(bool exists);
 	RowsByLetter &chatListLinks(Mode list);
 	const RowsByLetter &chatListLinks(Mode list) const;
 	Row *mainChatListLink(Mode list) const;
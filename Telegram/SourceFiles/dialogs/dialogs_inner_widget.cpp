@@ -1869,6 +1869,12 @@ void DialogsInner::visibleTopBottomUpdated(
 }
 
 void DialogsInner::itemRemoved(not_null<const HistoryItem*> item) {
+	_localSearchResults.erase(
+		ranges::remove_if(_localSearchResults, [&](auto local) {
+			return (local == item);
+		}),
+		end(_localSearchResults));
+
 	int wasCount = _searchResults.size();
 	for (auto i = _searchResults.begin(); i != _searchResults.end();) {
 		if ((*i)->item() == item) {
@@ -2043,6 +2049,7 @@ bool DialogsInner::searchReceived(
 	} else {
 		_searchedCount = fullCount;
 	}
+	mergeLocalSearchResults();
 	if (_waitingForSearch
 		&& (!_searchResults.empty()
 			|| !_searchInMigrated
@@ -2056,6 +2063,71 @@ bool DialogsInner::searchReceived(
 	return lastDateFound != 0;
 }
 
+void DialogsInner::localSearchReceived(
+		const QVector<MTPMessage> &result,
+		bool serverPending) {
+	if (_state != State::Filtered) {
+		return;
+	}
+	_localSearchResults.clear();
+	_localSearchResults.reserve(result.size());
+	for (const auto &message : result) {
+		if (Auth().data().peerLoaded(PeerFromMessage(message))) {
+			const auto item = Auth().data().addNewMessage(
+				message,
+				NewMessageExisting);
+			if (item) {
+				_localSearchResults.push_back(item);
+			}
+		}
+	}
+	if (_localSearchResults.empty()) {
+		return;
+	} else if (serverPending) {
+		// Replace the results of the previous query right away.
+		clearSearchResults(false);
+	}
+	mergeLocalSearchResults();
+	if (!_searchResults.empty()) {
+		_waitingForSearch = false;
+	}
+	refresh();
+}
+
+void DialogsInner::clearLocalSearchResults() {
+	_localSearchResults.clear();
+}
+
+void DialogsInner::mergeLocalSearchResults() {
+	if (_localSearchResults.empty() || uniqueSearchResults()) {
+		return;
+	}
+
+	// Older local results will come with the next server pages.
+	const auto complete = (_searchedCount <= int(_searchResults.size()));
+	const auto oldest = _searchResults.empty()
+		? TimeId(0)
+		: _searchResults.back()->item()->date();
+	for (const auto item : _localSearchResults) {
+		const auto already = ranges::find(
+			_searchResults,
+			item,
+			[](const auto &row) { return row->item(); }
+		) != end(_searchResults);
+		if (already || (!complete && item->date() < oldest)) {
+			continue;
+		}
+		const auto position = ranges::find_if(
+			_searchResults,
+			[&](const auto &row) {
+				return (row->item()->date() < item->date());
+			});
+		_searchResults.insert(
+			position,
+			std::make_unique<Dialogs::FakeRow>(_searchInChat, item));
+	}
+}
+
 void DialogsInner::peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -40,6 +40,14 @@ public:
 		const QVector<MTPMessage> &result,
 		DialogsSearchRequestType type,
 		int fullCount);
+
+	// Messages found in the local cache are shown until the server answers
+	// and then only those that the received server pages should include.
+	void localSearchReceived(
+		const QVector<MTPMessage> &result,
+		bool serverPending);
+	void clearLocalSearchResults();
+
 	void peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -192,6 +200,7 @@ private:
 		const base::flat_set<QChar> &oldLetters);
 	bool uniqueSearchResults() const;
 	bool hasHistoryInResults(not_null<History*> history) const;
+	void mergeLocalSearchResults();
 
 	void setupShortcuts();
 	Dialogs::RowDescriptor computeJump(
@@ -353,6 +362,7 @@ private:
 	int _peerSearchPressed = -1;
 
 	std::vector<std::unique_ptr<Dialogs::FakeRow>> _searchResults;
+	std::vector<not_null<HistoryItem*>> _localSearchResults;
 	int _searchedCount = 0;
 	int _searchedMigratedCount = 0;
 	int _searchedSelected = -1;
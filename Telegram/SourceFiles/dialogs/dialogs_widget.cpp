@@ -33,6 +33,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "storage/storage_media_prepare.h"
 #include "storage/localstorage.h"
 #include "data/data_session.h"
+#include "data/data_history_cache.h"
 #include "data/data_channel.h"
 #include "data/data_chat.h"
 #include "data/data_user.h"
@@ -689,6 +690,7 @@ bool DialogsWidget::onSearchMessages(bool searchCache) {
 			_searchQueryFrom = _searchFromUser;
 			_searchFull = _searchFullMigrated = false;
 			MTP::cancel(base::take(_searchRequest));
+			searchLocalMessages();
 			searchReceived(
 				_searchInChat
 					? DialogsSearchPeerFromStart
@@ -748,6 +750,7 @@ bool DialogsWidget::onSearchMessages(bool searchCache) {
 				rpcFail(&DialogsWidget::searchFailed, DialogsSearchFromStart));
 		}
 		_searchQueries.insert(_searchRequest, _searchQuery);
+		searchLocalMessages();
 	}
 	if (searchForPeersRequired(q)) {
 		if (searchCache) {
@@ -1064,6 +1067,28 @@ void DialogsWidget::searchReceived(
 	}
 }
 
+void DialogsWidget::searchLocalMessages() {
+	_inner->clearLocalSearchResults();
+	if (_searchQuery.isEmpty() || _searchQueryFrom || _searchInChat.feed()) {
+		return;
+	}
+	const auto query = _searchQuery;
+	const auto inChat = _searchInChat;
+	const auto peer = inChat.peer();
+	const auto done = [=](QVector<MTPMessage> &&result) {
+		if (_searchQuery == query
+			&& !_searchQueryFrom
+			&& _searchInChat == inChat) {
+			_inner->localSearchReceived(result, _searchRequest != 0);
+		}
+	};
+	Auth().data().historyCache().search(
+		query,
+		peer ? peer->id : PeerId(0),
+		SearchPerPage,
+		crl::guard(this, done));
+}
+
 void DialogsWidget::peerSearchReceived(
 		const MTPcontacts_Found &result,
 		mtpRequestId requestId) {
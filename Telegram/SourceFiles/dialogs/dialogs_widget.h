@@ -144,6 +144,7 @@ private:
 		DialogsSearchRequestType type,
 		const MTPmessages_Messages &result,
 		mtpRequestId requestId);
+	void searchLocalMessages();
 	void peerSearchReceived(
 		const MTPcontacts_Found &result,
 		mtpRequestId requestId);
@@ -57,6 +57,11 @@ constexpr auto kStatusShowClientsideChooseContact = 6000;
 constexpr auto kStatusShowClientsidePlayGame = 10000;
 constexpr auto kSetMyActionForMs = 10000;
 constexpr auto kNewBlockEachMessage = 50;
+
+// How much of the history around the scroll position is laid out
+// exactly after a width change, in visible area heights.
+constexpr auto kExactLayoutScreensAbove = 1;
+constexpr auto kExactLayoutScreensBelow = 2;
 constexpr auto kSkipCloudDraftsFor = TimeId(3);
 
 } // namespace
@@ -2576,7 +2581,7 @@ HistoryItem *History::lastSentMessage() const {
 	return nullptr;
 }
 
-void History::resizeToWidth(int newWidth) {
+void History::resizeToWidth(int newWidth, int visibleHeight) {
 	const auto resizeAllItems = (_width != newWidth);
 
 	if (!resizeAllItems && !hasPendingResizedItems()) {
@@ -2585,14 +2590,120 @@ void History::resizeToWidth(int newWidth) {
 	_flags &= ~(Flag::f_has_pending_resized_items);
 
 	_width = newWidth;
-	int y = 0;
+	if (resizeAllItems) {
+		for (const auto &block : blocks) {
+			block->setResizePending();
+		}
+	}
+	const auto count = int(blocks.size());
+	const auto layoutExactly = [&](int index) {
+		const auto block = blocks[index].get();
+		return block->resizeGetHeight(newWidth, block->resizePending());
+	};
+	if (visibleHeight > 0 && count > 0) {
+		// scrollTopItem == nullptr means we're at the bottom.
+		const auto anchor = scrollTopItem
+			? scrollTopItem->block()->indexInHistory()
+			: (count - 1);
+		const auto above = scrollTopItem
+			? (kExactLayoutScreensAbove * visibleHeight)
+			: (kExactLayoutScreensBelow * visibleHeight);
+		const auto below = scrollTopItem
+			? (kExactLayoutScreensBelow * visibleHeight)
+			: 0;
+		auto height = 0;
+		for (auto i = anchor; i >= 0 && height < above; --i) {
+			height += layoutExactly(i);
+		}
+		height = 0;
+		for (auto i = anchor; i < count && height < below; ++i) {
+			height += layoutExactly(i);
+		}
+	}
+
+	// Blocks that were never laid out get height by the average
+	// message height of the exact ones.
+	auto exactHeight = 0;
+	auto exactMessages = 0;
 	for (const auto &block : blocks) {
+		if (!block->resizePending()) {
+			exactHeight += block->height();
+			exactMessages += int(block->messages.size());
+		}
+	}
+	const auto averageMessageHeight = exactMessages
+		? std::max(exactHeight / exactMessages, 1)
+		: (st::msgMargin.top()
+			+ st::msgPadding.top()
+			+ st::msgFont->height
+			+ st::msgPadding.bottom()
+			+ st::msgMargin.bottom());
+
+	auto y = 0;
+	for (auto i = 0; i != count; ++i) {
+		const auto block = blocks[i].get();
 		block->setY(y);
-		y += block->resizeGetHeight(newWidth, resizeAllItems);
+		if (visibleHeight <= 0 || !block->resizePending()) {
+			y += layoutExactly(i);
+		} else {
+			if (!block->height()) {
+				block->setEstimatedHeight(
+					int(block->messages.size()) * averageMessageHeight);
+			}
+			y += block->height();
+		}
 	}
 	_height = y;
 }
 
+bool History::hasPendingBlocks(int top, int bottom) const {
+	for (const auto &block : blocks) {
+		const auto blockTop = block->y();
+		if (blockTop >= bottom) {
+			break;
+		} else if (block->resizePending()
+			&& blockTop + block->height() >= top) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void History::resizePendingBlocks(int top, int bottom) {
+	for (const auto &block : blocks) {
+		const auto blockTop = block->y();
+		if (blockTop >= bottom) {
+			break;
+		} else if (block->resizePending()
+			&& blockTop + block->height() >= top) {
+			// Heights will be fixed in the next resizeToWidth() call.
+			setHasPendingResizedItems();
+			block->resizeGetHeight(_width, true);
+		}
+	}
+}
+
+bool History::resizePendingBlock(not_null<const HistoryBlock*> block) {
+	if (!block->resizePending()) {
+		return false;
+	}
+	const auto index = block->indexInHistory();
+	Assert(index >= 0 && index < int(blocks.size()));
+
+	const auto changing = blocks[index].get();
+	const auto was = changing->height();
+	const auto delta = changing->resizeGetHeight(_width, true) - was;
+	if (!delta) {
+		return false;
+	}
+	for (auto i = index + 1, count = int(blocks.size()); i != count; ++i) {
+		blocks[i]->setY(blocks[i]->y() + delta);
+	}
+	_height += delta;
+	setHasPendingResizedItems();
+	return true;
+}
+
 PeerId History::peerId() const {
 	return peer->id;
 }
@@ -3050,6 +3161,7 @@ int HistoryBlock::resizeGetHeight(int newWidth, bool resizeAllItems) {
 		}
 	}
 	_height = y;
+	_resizePending = false;
 	return _height;
 }
 
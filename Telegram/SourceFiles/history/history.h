@@ -201,8 +201,17 @@ public:
 	MsgId msgIdForRead() const;
 	HistoryItem *lastSentMessage() const;
 
-	void resizeToWidth(int newWidth);
+	// With visibleHeight > 0 only blocks around the scroll position are
+	// laid out exactly, other blocks keep estimated heights until
+	// resizePendingBlocks() is called for their range.
+	void resizeToWidth(int newWidth, int visibleHeight = 0);
 	int height() const;
+	bool hasPendingBlocks(int top, int bottom) const;
+	void resizePendingBlocks(int top, int bottom);
+
+	// Lays out the block exactly if it has an estimated height.
+	// Returns true if the history height has changed.
+	bool resizePendingBlock(not_null<const HistoryBlock*> block);
 
 	void itemRemoved(not_null<HistoryItem*> item);
 	void itemVanished(not_null<HistoryItem*> item);
@@ -529,6 +538,19 @@ public:
 	int height() const {
 		return _height;
 	}
+
+	// While the resize is pending the height is only an estimate.
+	bool resizePending() const {
+		return _resizePending;
+	}
+	void setResizePending() {
+		_resizePending = true;
+	}
+	void setEstimatedHeight(int height) {
+		Expects(_resizePending);
+
+		_height = height;
+	}
 	not_null<History*> history() const {
 		return _history;
 	}
@@ -564,5 +586,6 @@ protected:
 	int _y = 0;
 	int _height = 0;
 	int _indexInHistory = -1;
+	bool _resizePending = false;
 
 };
@@ -1978,9 +1978,9 @@ void HistoryInner::recountHistoryGeometry() {
 		accumulate_max(oldHistoryPaddingTop, st::msgMargin.top() + st::msgMargin.bottom() + st::msgPadding.top() + st::msgPadding.bottom() + st::msgNameFont->height + st::botDescSkip + _botAbout->height);
 	}
 
-	_history->resizeToWidth(_contentWidth);
+	_history->resizeToWidth(_contentWidth, visibleHeight);
 	if (_migrated) {
-		_migrated->resizeToWidth(_contentWidth);
+		_migrated->resizeToWidth(_contentWidth, visibleHeight);
 	}
 
 	// With migrated history we perhaps do not need to display
@@ -2081,6 +2081,36 @@ void HistoryInner::updateBotInfo(bool recount) {
 	}
 }
 
+bool HistoryInner::resizePendingBlocks(int top, int bottom) {
+	const auto margin = bottom - top;
+	auto result = false;
+	const auto resize = [&](History *history, int historyTop) {
+		if (!history || historyTop < 0) {
+			return;
+		}
+		const auto from = top - margin - historyTop;
+		const auto till = bottom + margin - historyTop;
+		if (history->hasPendingBlocks(from, till)) {
+			history->resizePendingBlocks(from, till);
+			result = true;
+		}
+	};
+	resize(_history, historyTop());
+	resize(_migrated, migratedTop());
+	return result;
+}
+
+bool HistoryInner::ensureBlockLaidOut(const Element *view) const {
+	if (!view || view->data()->mainView() != view || !view->block()) {
+		return false;
+	}
+	const auto history = view->data()->history();
+	if (history != _history && history != _migrated) {
+		return false;
+	}
+	return history->resizePendingBlock(view->block());
+}
+
 bool HistoryInner::wasSelectedText() const {
 	return _wasSelectedText;
 }
@@ -2768,6 +2798,10 @@ int HistoryInner::itemTop(const Element *view) const {
 		return -1;
 	}
 
+	// Blocks far from the scroll position keep an estimated height
+	// and stale elements geometry after a width change.
+	ensureBlockLaidOut(view);
+
 	auto top = (view->data()->history() == _history)
 		? historyTop()
 		: (view->data()->history() == _migrated
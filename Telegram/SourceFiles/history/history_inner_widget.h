@@ -80,6 +80,15 @@ public:
 	// updates history->scrollTopItem/scrollTopOffset
 	void visibleAreaUpdated(int top, int bottom);
 
+	// Lays out blocks with estimated heights near the visible area.
+	// Returns true if the history geometry should be updated.
+	bool resizePendingBlocks(int top, int bottom);
+
+	// Lays out the block of the element if it has an estimated height,
+	// itemTop() does that as well. Returns true if the history geometry
+	// should be updated before scrolling to the element.
+	bool ensureBlockLaidOut(const Element *view) const;
+
 	int historyHeight() const;
 	int historyScrollTop() const;
 	int migratedTop() const;
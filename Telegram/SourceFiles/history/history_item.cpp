@@ -31,6 +31,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "window/window_controller.h"
 #include "core/crash_reports.h"
 #include "data/data_session.h"
+#include "data/data_history_cache.h"
 #include "data/data_messages.h"
 #include "data/data_media_types.h"
 #include "data/data_feed.h"
@@ -344,6 +345,9 @@ void HistoryItem::destroy() {
 					types,
 					id));
 			}
+			_history->owner().historyCache().removeMessage(
+				_history->peer->id,
+				id);
 		} else {
 			_history->session().api().cancelLocalItem(this);
 		}
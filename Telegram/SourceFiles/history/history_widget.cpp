@@ -25,6 +25,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "inline_bots/inline_bot_result.h"
 #include "data/data_drafts.h"
 #include "data/data_session.h"
+#include "data/data_history_cache.h"
 #include "data/data_web_page.h"
 #include "data/data_document.h"
 #include "data/data_photo.h"
@@ -660,6 +661,9 @@ void HistoryWidget::animatedScrollToItem(MsgId msgId) {
 	}
 
 	auto to = App::histItemById(_channel, msgId);
+	if (to && _list->ensureBlockLaidOut(to->mainView())) {
+		updateListSize();
+	}
 	if (_list->itemTop(to) < 0) {
 		return;
 	}
@@ -1772,7 +1776,15 @@ void HistoryWidget::clearAllLoadRequests() {
 	if (_firstLoadRequest) MTP::cancel(_firstLoadRequest);
 	if (_preloadRequest) MTP::cancel(_preloadRequest);
 	if (_preloadDownRequest) MTP::cancel(_preloadDownRequest);
+	if (_cacheRefreshRequest) MTP::cancel(_cacheRefreshRequest);
 	_preloadRequest = _preloadDownRequest = _firstLoadRequest = 0;
+	_cacheRefreshRequest = 0;
+	_firstLoadFromCache = false;
+	_cachedMessageIds.clear();
+}
+
+bool HistoryWidget::firstLoadInProgress() const {
+	return _firstLoadRequest || _firstLoadFromCache;
 }
 
 void HistoryWidget::updateFieldSubmitSettings() {
@@ -1824,7 +1836,7 @@ void HistoryWidget::updateReportSpamStatus() {
 		|| (_peer->isUser() && _peer->asUser()->isBot())) {
 		setReportSpamStatus(dbiprsHidden);
 		return;
-	} else if (!_firstLoadRequest && _history->isEmpty()) {
+	} else if (!firstLoadInProgress() && _history->isEmpty()) {
 		setReportSpamStatus(dbiprsNoButton);
 		if (cReportSpamStatuses().contains(_peer->id)) {
 			cRefReportSpamStatuses().remove(_peer->id);
@@ -1872,7 +1884,7 @@ void HistoryWidget::updateReportSpamStatus() {
 		}
 	}
 	auto status = dbiprsRequesting;
-	if (!Auth().data().contactsLoaded().value() || _firstLoadRequest) {
+	if (!Auth().data().contactsLoaded().value() || firstLoadInProgress()) {
 		status = dbiprsUnknown;
 	} else if (_peer->isUser()
 		&& _peer->asUser()->contactStatus() == UserData::ContactStatus::Contact) {
@@ -1951,9 +1963,9 @@ void HistoryWidget::updateControlsVisibility() {
 		_pinnedBar->cancel->show();
 		_pinnedBar->shadow->show();
 	}
-	if (_firstLoadRequest && !_scroll->isHidden()) {
+	if (firstLoadInProgress() && !_scroll->isHidden()) {
 		_scroll->hide();
-	} else if (!_firstLoadRequest && _scroll->isHidden()) {
+	} else if (!firstLoadInProgress() && _scroll->isHidden()) {
 		_scroll->show();
 	}
 	if (_reportSpamPanel) {
@@ -2241,6 +2253,9 @@ bool HistoryWidget::messagesFailed(const RPCError &error, mtpRequestId requestId
 	} else if (_firstLoadRequest == requestId) {
 		_firstLoadRequest = 0;
 		controller()->showBackFromStack();
+	} else if (_cacheRefreshRequest == requestId) {
+		_cacheRefreshRequest = 0;
+		_cachedMessageIds.clear();
 	} else if (_delayedShowAtRequest == requestId) {
 		_delayedShowAtRequest = 0;
 	}
@@ -2289,7 +2304,9 @@ void HistoryWidget::messagesReceived(PeerData *peer, const MTPmessages_Messages
 		count = d.vcount.v;
 	} break;
 	case mtpc_messages_messagesNotModified: {
-		LOG(("API Error: received messages.messagesNotModified! (HistoryWidget::messagesReceived)"));
+		if (_cacheRefreshRequest != requestId) {
+			LOG(("API Error: received messages.messagesNotModified! (HistoryWidget::messagesReceived)"));
+		}
 	} break;
 	}
 
@@ -2331,6 +2348,9 @@ void HistoryWidget::messagesReceived(PeerData *peer, const MTPmessages_Messages
 		} else if (_migrated) {
 			_migrated->unloadBlocks();
 		}
+		if (!toMigrated && _history->loadedAtBottom()) {
+			_history->owner().historyCache().save(_history, messages);
+		}
 		addMessagesToFront(peer, *histList);
 		_firstLoadRequest = 0;
 		if (_history->loadedAtTop() && _history->isEmpty() && count > 0) {
@@ -2339,6 +2359,13 @@ void HistoryWidget::messagesReceived(PeerData *peer, const MTPmessages_Messages
 		}
 
 		historyLoaded();
+	} else if (_cacheRefreshRequest == requestId) {
+		_cacheRefreshRequest = 0;
+		if (messages.type() != mtpc_messages_messagesNotModified) {
+			_history->owner().historyCache().save(_history, messages);
+			cachedMessagesRefreshed(*histList);
+		}
+		_cachedMessageIds.clear();
 	} else if (_delayedShowAtRequest == requestId) {
 		if (toMigrated) {
 			_history->unloadBlocks();
@@ -2394,7 +2421,7 @@ void HistoryWidget::windowShown() {
 
 bool HistoryWidget::doWeReadServerHistory() const {
 	if (!_history || !_list) return true;
-	if (_firstLoadRequest || _a_show.animating()) return false;
+	if (firstLoadInProgress() || _a_show.animating()) return false;
 	if (_history->loadedAtBottom()) {
 		int scrollTop = _scroll->scrollTop();
 		if (scrollTop + 1 > _scroll->scrollTopMax()) return true;
@@ -2415,12 +2442,12 @@ bool HistoryWidget::doWeReadServerHistory() const {
 
 bool HistoryWidget::doWeReadMentions() const {
 	if (!_history || !_list) return true;
-	if (_firstLoadRequest || _a_show.animating()) return false;
+	if (firstLoadInProgress() || _a_show.animating()) return false;
 	return true;
 }
 
 void HistoryWidget::firstLoadMessages() {
-	if (!_history || _firstLoadRequest) return;
+	if (!_history || firstLoadInProgress()) return;
 
 	auto from = _peer;
 	auto offsetId = 0;
@@ -2457,12 +2484,40 @@ void HistoryWidget::firstLoadMessages() {
 		}
 	}
 
+	if (from == _peer && !offsetId && !offset && _history->isEmpty()) {
+		// Show the newest cached messages while the server answers.
+		_firstLoadFromCache = true;
+		const auto history = _history;
+		const auto done = [=](QVector<MTPMessage> &&messages) {
+			if (_history == history && _firstLoadFromCache) {
+				_firstLoadFromCache = false;
+				cachedMessagesLoaded(loadCount, std::move(messages));
+			}
+		};
+		history->owner().historyCache().load(
+			history,
+			crl::guard(this, done));
+		return;
+	}
+	_firstLoadRequest = sendFirstLoadRequest(
+		from,
+		offsetId,
+		offset,
+		loadCount,
+		0);
+}
+
+mtpRequestId HistoryWidget::sendFirstLoadRequest(
+		not_null<PeerData*> from,
+		MsgId offsetId,
+		int offset,
+		int loadCount,
+		int32 historyHash) {
 	auto offsetDate = 0;
 	auto maxId = 0;
 	auto minId = 0;
-	auto historyHash = 0;
 
-	_firstLoadRequest = MTP::send(
+	return MTP::send(
 		MTPmessages_GetHistory(
 			from->input,
 			MTP_int(offsetId),
@@ -2472,10 +2527,80 @@ void HistoryWidget::firstLoadMessages() {
 			MTP_int(maxId),
 			MTP_int(minId),
 			MTP_int(historyHash)),
-		rpcDone(&HistoryWidget::messagesReceived, from),
+		rpcDone(&HistoryWidget::messagesReceived, from.get()),
 		rpcFail(&HistoryWidget::messagesFailed));
 }
 
+void HistoryWidget::cachedMessagesLoaded(
+		int loadCount,
+		QVector<MTPMessage> &&messages) {
+	if (messages.isEmpty()) {
+		_firstLoadRequest = sendFirstLoadRequest(_peer, 0, 0, loadCount, 0);
+		return;
+	}
+	if (_migrated) {
+		_migrated->unloadBlocks();
+	}
+	addMessagesToFront(_peer, messages);
+	historyLoaded();
+
+	for (const auto &message : messages) {
+		_cachedMessageIds.emplace(IdFromMessage(message));
+	}
+	_cacheRefreshRequest = sendFirstLoadRequest(
+		_peer,
+		0,
+		0,
+		loadCount,
+		_history->owner().historyCache().hash(_history));
+}
+
+void HistoryWidget::cachedMessagesRefreshed(
+		const QVector<MTPMessage> &messages) {
+	const auto cached = base::take(_cachedMessageIds);
+	if (cached.empty()) {
+		return;
+	}
+
+	auto fresh = base::flat_set<MsgId>();
+	auto newer = QVector<MTPMessage>();
+	auto gap = false;
+	for (const auto &message : messages) {
+		const auto id = IdFromMessage(message);
+		fresh.emplace(id);
+		if (cached.contains(id)) {
+			App::updateEditedMessage(message);
+		} else if (id > cached.back()) {
+			newer.push_back(message);
+		} else {
+			gap = true;
+		}
+	}
+
+	// Cached messages missing in the fresh slice were deleted meanwhile.
+	const auto from = fresh.empty() ? MsgId(0) : fresh.front();
+	for (const auto id : cached) {
+		if (id >= from && !fresh.contains(id)) {
+			if (const auto item = App::histItemById(_channel, id)) {
+				item->destroy();
+			}
+		}
+	}
+
+	if (gap || fresh.empty() || fresh.front() > cached.back()) {
+		// Some messages in between were not cached, show the fresh slice.
+		if (_preloadRequest) {
+			MTP::cancel(base::take(_preloadRequest));
+		}
+		_history->unloadBlocks();
+		_history->getReadyFor(ShowAtTheEndMsgId);
+		addMessagesToFront(_peer, messages);
+		historyLoaded();
+	} else if (!newer.isEmpty()) {
+		addMessagesToBack(_peer, newer);
+	}
+}
+
 void HistoryWidget::loadMessages() {
 	if (!_history || _preloadRequest) return;
 
@@ -2634,6 +2759,17 @@ void HistoryWidget::visibleAreaUpdated() {
 		auto scrollTop = _scroll->scrollTop();
 		auto scrollBottom = scrollTop + _scroll->height();
 		_list->visibleAreaUpdated(scrollTop, scrollBottom);
+		if (!_resizingPendingBlocks
+			&& _list->resizePendingBlocks(scrollTop, scrollBottom)) {
+			// Blocks with estimated heights came close to the visible
+			// area, scroll is restored by the updated scrollTopItem.
+			_resizingPendingBlocks = true;
+			handlePendingHistoryUpdate();
+			_resizingPendingBlocks = false;
+
+			scrollTop = _scroll->scrollTop();
+			scrollBottom = scrollTop + _scroll->height();
+		}
 		if (_history->loadedAtBottom() && (_history->unreadCount() > 0 || (_migrated && _migrated->unreadCount() > 0))) {
 			const auto unread = firstUnreadMessage();
 			const auto unreadVisible = unread
@@ -2649,7 +2785,7 @@ void HistoryWidget::visibleAreaUpdated() {
 }
 
 void HistoryWidget::preloadHistoryIfNeeded() {
-	if (_firstLoadRequest || _scroll->isHidden() || !_peer) {
+	if (firstLoadInProgress() || _scroll->isHidden() || !_peer) {
 		return;
 	}
 
@@ -2667,7 +2803,7 @@ void HistoryWidget::preloadHistoryIfNeeded() {
 }
 
 void HistoryWidget::preloadHistoryByScroll() {
-	if (_firstLoadRequest || _scroll->isHidden() || !_peer) {
+	if (firstLoadInProgress() || _scroll->isHidden() || !_peer) {
 		return;
 	}
 
@@ -2683,7 +2819,7 @@ void HistoryWidget::preloadHistoryByScroll() {
 }
 
 void HistoryWidget::checkReplyReturns() {
-	if (_firstLoadRequest || _scroll->isHidden() || !_peer) {
+	if (firstLoadInProgress() || _scroll->isHidden() || !_peer) {
 		return;
 	}
 	auto scrollTop = _scroll->scrollTop();
@@ -4785,6 +4921,9 @@ int HistoryWidget::countInitialScrollTop() {
 		result = _list->historyScrollTop();
 	} else if (_showAtMsgId && (_showAtMsgId > 0 || -_showAtMsgId < ServerMaxMsgId)) {
 		auto item = getItemFromHistoryOrMigrated(_showAtMsgId);
+		if (item && _list->ensureBlockLaidOut(item->mainView())) {
+			updateListSize();
+		}
 		auto itemTop = _list->itemTop(item);
 		if (itemTop < 0) {
 			setMsgId(0);
@@ -4796,8 +4935,11 @@ int HistoryWidget::countInitialScrollTop() {
 			result = itemTopForHighlight(view);
 			enqueueMessageHighlight(view);
 		}
-	} else if (const auto top = unreadBarTop()) {
-		result = *top;
+	} else if (const auto bar = unreadBar()) {
+		if (_list->ensureBlockLaidOut(bar)) {
+			updateListSize();
+		}
+		result = *unreadBarTop();
 	} else {
 		return countAutomaticScrollTop();
 	}
@@ -4807,6 +4949,9 @@ int HistoryWidget::countInitialScrollTop() {
 int HistoryWidget::countAutomaticScrollTop() {
 	auto result = ScrollMax;
 	if (const auto unread = firstUnreadMessage()) {
+		if (_list->ensureBlockLaidOut(unread)) {
+			updateListSize();
+		}
 		result = _list->itemTop(unread);
 		const auto possibleUnreadBarTop = _scroll->scrollTopMax()
 			+ HistoryView::UnreadBar::height()
@@ -4835,7 +4980,7 @@ void HistoryWidget::updateHistoryGeometry(bool initial, bool loadedDown, const S
 	if (!_history || (initial && _historyInited) || (!initial && !_historyInited)) {
 		return;
 	}
-	if (_firstLoadRequest || _a_show.animating()) {
+	if (firstLoadInProgress() || _a_show.animating()) {
 		return; // scrollTopMax etc are not working after recountHistoryGeometry()
 	}
 
@@ -4961,16 +5106,17 @@ bool HistoryWidget::hasPendingResizedItems() const {
 		|| (_migrated && _migrated->hasPendingResizedItems());
 }
 
+HistoryView::Element *HistoryWidget::unreadBar() const {
+	if (const auto bar = _migrated ? _migrated->unreadBar() : nullptr) {
+		return bar;
+	} else if (const auto bar = _history->unreadBar()) {
+		return bar;
+	}
+	return nullptr;
+}
+
 std::optional<int> HistoryWidget::unreadBarTop() const {
-	auto getUnreadBar = [this]() -> HistoryView::Element* {
-		if (const auto bar = _migrated ? _migrated->unreadBar() : nullptr) {
-			return bar;
-		} else if (const auto bar = _history->unreadBar()) {
-			return bar;
-		}
-		return nullptr;
-	};
-	if (const auto bar = getUnreadBar()) {
+	if (const auto bar = unreadBar()) {
 		const auto result = _list->itemTop(bar)
 			+ HistoryView::UnreadBar::marginTop();
 		if (bar->Has<HistoryView::DateBadge>()) {
@@ -4992,7 +5138,7 @@ HistoryView::Element *HistoryWidget::firstUnreadMessage() const {
 
 void HistoryWidget::addMessagesToFront(PeerData *peer, const QVector<MTPMessage> &messages) {
 	_list->messagesReceived(peer, messages);
-	if (!_firstLoadRequest) {
+	if (!firstLoadInProgress()) {
 		updateHistoryGeometry();
 		updateBotKeyboard();
 	}
@@ -5000,7 +5146,7 @@ void HistoryWidget::addMessagesToFront(PeerData *peer, const QVector<MTPMessage>
 
 void HistoryWidget::addMessagesToBack(PeerData *peer, const QVector<MTPMessage> &messages) {
 	_list->messagesReceivedDown(peer, messages);
-	if (!_firstLoadRequest) {
+	if (!firstLoadInProgress()) {
 		updateHistoryGeometry(false, true, { ScrollChangeNoJumpToBottom, 0 });
 	}
 }
@@ -5131,7 +5277,7 @@ void HistoryWidget::updateHistoryDownVisibility() {
 		return (top >= _scroll->scrollTop() + _scroll->height());
 	};
 	auto historyDownIsVisible = [&] {
-		if (!_list || _firstLoadRequest) {
+		if (!_list || firstLoadInProgress()) {
 			return false;
 		}
 		if (!_history->loadedAtBottom() || _replyReturn) {
@@ -5174,7 +5320,7 @@ void HistoryWidget::updateUnreadMentionsVisibility() {
 		Auth().api().preloadEnoughUnreadMentions(_history);
 	}
 	auto unreadMentionsIsVisible = [this, showUnreadMentions] {
-		if (!showUnreadMentions || _firstLoadRequest) {
+		if (!showUnreadMentions || firstLoadInProgress()) {
 			return false;
 		}
 		return (_history->getUnreadMentionsLoadedCount() > 0);
@@ -243,6 +243,7 @@ public:
 	void showHistory(const PeerId &peer, MsgId showAtMsgId, bool reload = false);
 	void clearDelayedShowAt();
 	void clearAllLoadRequests();
+	bool firstLoadInProgress() const;
 	void saveFieldToHistoryLocalDraft();
 
 	void applyCloudDraft(History *history);
@@ -600,6 +601,14 @@ private:
 	QList<MsgId> _replyReturns;
 
 	bool messagesFailed(const RPCError &error, mtpRequestId requestId);
+	mtpRequestId sendFirstLoadRequest(
+		not_null<PeerData*> from,
+		MsgId offsetId,
+		int offset,
+		int loadCount,
+		int32 historyHash);
+	void cachedMessagesLoaded(int loadCount, QVector<MTPMessage> &&messages);
+	void cachedMessagesRefreshed(const QVector<MTPMessage> &messages);
 	void addMessagesToFront(PeerData *peer, const QVector<MTPMessage> &messages);
 	void addMessagesToBack(PeerData *peer, const QVector<MTPMessage> &messages);
 
@@ -633,6 +642,7 @@ private:
 
 	// Counts scrollTop for placing the scroll right at the unread
 	// messages bar, choosing from _history and _migrated unreadBar.
+	HistoryView::Element *unreadBar() const;
 	std::optional<int> unreadBarTop() const;
 	int itemTopForHighlight(not_null<HistoryView::Element*> view) const;
 	void scrollToCurrentVoiceMessage(FullMsgId fromId, FullMsgId toId);
@@ -695,6 +705,11 @@ private:
 	mtpRequestId _preloadRequest = 0;
 	mtpRequestId _preloadDownRequest = 0;
 
+	// Messages shown from the local cache while they're requested again.
+	bool _firstLoadFromCache = false;
+	mtpRequestId _cacheRefreshRequest = 0;
+	base::flat_set<MsgId> _cachedMessageIds;
+
 	MsgId _delayedShowAtMsgId = -1;
 	mtpRequestId _delayedShowAtRequest = 0;
 
@@ -715,6 +730,7 @@ private:
 
 	crl::time _lastUserScrolled = 0;
 	bool _synteticScrollEvent = false;
+	bool _resizingPendingBlocks = false;
 	Animation _scrollToAnimation;
 
 	Animation _historyDownShown;
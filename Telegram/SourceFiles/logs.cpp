@@ -42,15 +42,46 @@ QString _logsFilePath(LogDataType type, const QString &postfix = QString()) {
 	return path;
 }
 
+// Debug log entries are written by a background thread in batches.
+constexpr auto kDebugFlushTimeout = 100; // ms
+constexpr auto kDebugFlushEntriesCount = 1024;
+constexpr auto kDebugMaxPendingEntries = 64 * 1024;
+
+// Debug log files are switched each 15 minutes or when they grow too big.
+constexpr auto kDebugMaxFileSize = qint64(128 * 1024 * 1024);
+
 int32 LogsStartIndexChosen = -1;
-QString _logsEntryStart() {
-	static int32 index = 0;
-	QDateTime tm(QDateTime::currentDateTime());
+std::atomic<int32> LogsEntryIndex = 0;
 
-	auto thread = qobject_cast<MTP::internal::Thread*>(QThread::currentThread());
-	auto threadId = thread ? thread->getThreadIndex() : 0;
+int _logsCurrentThreadIndex() {
+	const auto thread = qobject_cast<MTP::internal::Thread*>(
+		QThread::currentThread());
+	return thread ? thread->getThreadIndex() : 0;
+}
 
-	return QString("[%1 %2-%3]").arg(tm.toString("hh:mm:ss.zzz")).arg(QString("%1").arg(threadId, 2, 10, QChar('0'))).arg(++index, 7, 10, QChar('0'));
+QString _logsEntryStart(const QDateTime &tm, int threadId, int32 index) {
+	return QString("[%1 %2-%3]").arg(tm.toString("hh:mm:ss.zzz")).arg(QString("%1").arg(threadId, 2, 10, QChar('0'))).arg(index, 7, 10, QChar('0'));
+}
+
+QString _logsEntryStart() {
+	return _logsEntryStart(
+		QDateTime::currentDateTime(),
+		_logsCurrentThreadIndex(),
+		++LogsEntryIndex);
+}
+
+const char *_logsFileBasename(const char *file) {
+	const char *last = strstr(file, "/"), *found = 0;
+	while (last) {
+		found = last;
+		last = strstr(last + 1, "/");
+	}
+	last = strstr(file, "\\");
+	while (last) {
+		found = last;
+		last = strstr(last + 1, "\\");
+	}
+	return found ? (found + 1) : file;
 }
 
 class LogsDataFields {
@@ -95,19 +126,28 @@ public:
 		QMutexLocker lock(_logsMutex(type));
 		if (type != LogDataMain) {
 			reopenDebug();
+			if (sizes[type] >= kDebugMaxFileSize) {
+				reopenBySize(type);
+			}
 		}
 		const auto file = files[type].get();
 		if (!file || !file->isOpen()) {
 			return;
 		}
-		file->write(msg.toUtf8());
+		const auto utf8 = msg.toUtf8();
+		file->write(utf8);
 		file->flush();
+		sizes[type] += utf8.size();
 	}
 
 private:
 	std::unique_ptr<QFile> files[LogDataCount];
+	qint64 sizes[LogDataCount] = { 0 };
+	int32 sizeParts[LogDataCount] = { 0 };
 
 	int32 part = -1;
+	int32 partDayIndex = 0;
+	QString partPostfix;
 
 	bool reopen(LogDataType type, int32 dayIndex, const QString &postfix) {
 		if (files[type] && files[type]->isOpen()) {
@@ -192,6 +232,7 @@ private:
 			}
 		}
 		if (files[type]->open(mode)) {
+			sizes[type] = files[type]->size();
 			if (type != LogDataMain) {
 				files[type]->write(((mode & QIODevice::Append)
 					? qsl("\
@@ -223,21 +264,221 @@ NEW LOGGING INSTANCE STARTED!!!\n\
 		int32 dayIndex = (tm.tm_year + 1900) * 10000 + (tm.tm_mon + 1) * 100 + tm.tm_mday;
 		QString postfix = QString("_%4_%5").arg((part * switchEach) / 60, 2, 10, QChar('0')).arg((part * switchEach) % 60, 2, 10, QChar('0'));
 
+		partDayIndex = dayIndex;
+		partPostfix = postfix;
+		for (auto &sizePart : sizeParts) {
+			sizePart = 0;
+		}
+
 		reopen(LogDataDebug, dayIndex, postfix);
 		reopen(LogDataTcp, dayIndex, postfix);
 		reopen(LogDataMtp, dayIndex, postfix);
 	}
 
+	void reopenBySize(LogDataType type) {
+		const auto postfix = partPostfix
+			+ QString("_%1").arg(++sizeParts[type]);
+		reopen(type, partDayIndex, postfix);
+	}
+
 };
 
 LogsDataFields *LogsData = 0;
 
+class LogsWriter final : public QThread {
+public:
+	LogsWriter();
+
+	void push(
+		LogDataType type,
+		const char *file,
+		int32 line,
+		int32 dc,
+		const QString &message);
+	void stop();
+
+protected:
+	void run() override;
+
+private:
+	// Only cheap fields are filled when logging,
+	// the entry is formatted by the writer thread.
+	struct Entry {
+		LogDataType type = LogDataDebug;
+		qint64 when = 0;
+		int32 index = 0;
+		int32 thread = 0;
+		int32 dc = 0;
+		int32 line = 0;
+		const char *file = nullptr;
+		QString message;
+	};
+
+	void write(std::vector<Entry> &&entries);
+	QString formatTime(qint64 when);
+
+	QMutex _mutex;
+	QWaitCondition _condition;
+	std::vector<Entry> _pending;
+	bool _stopping = false;
+
+	std::atomic<uint64> _dropped = 0;
+	uint64 _droppedReported = 0;
+
+	qint64 _cachedSecond = -1;
+	QString _cachedTime;
+
+};
+
+// Producers push to the writer under the read lock,
+// so it is deleted only after the last push has finished.
+std::atomic<LogsWriter*> LogsWriterInstance = nullptr;
+QReadWriteLock LogsWriterLock;
+
+LogsWriter::LogsWriter() {
+	_pending.reserve(kDebugFlushEntriesCount);
+}
+
+void LogsWriter::push(
+		LogDataType type,
+		const char *file,
+		int32 line,
+		int32 dc,
+		const QString &message) {
+	auto entry = Entry();
+	entry.type = type;
+	entry.when = QDateTime::currentMSecsSinceEpoch();
+	entry.index = ++LogsEntryIndex;
+	entry.thread = _logsCurrentThreadIndex();
+	entry.dc = dc;
+	entry.line = line;
+	entry.file = file;
+	entry.message = message;
+
+	QMutexLocker lock(&_mutex);
+	if (_pending.size() >= kDebugMaxPendingEntries) {
+		++_dropped;
+		return;
+	}
+	_pending.push_back(std::move(entry));
+	if (_pending.size() == kDebugFlushEntriesCount) {
+		_condition.wakeOne();
+	}
+}
+
+void LogsWriter::stop() {
+	{
+		QMutexLocker lock(&_mutex);
+		_stopping = true;
+		_condition.wakeOne();
+	}
+	wait();
+}
+
+void LogsWriter::run() {
+	auto entries = std::vector<Entry>();
+	QMutexLocker lock(&_mutex);
+	while (true) {
+		const auto stopping = _stopping;
+		if (!stopping && _pending.size() < kDebugFlushEntriesCount) {
+			_condition.wait(&_mutex, kDebugFlushTimeout);
+		}
+		std::swap(entries, _pending);
+		_pending.reserve(kDebugFlushEntriesCount);
+		lock.unlock();
+
+		write(base::take(entries));
+
+		lock.relock();
+		if (stopping && _pending.empty()) {
+			break;
+		}
+	}
+}
+
+QString LogsWriter::formatTime(qint64 when) {
+	const auto second = when / 1000;
+	if (second != _cachedSecond) {
+		_cachedSecond = second;
+		_cachedTime = QDateTime::fromMSecsSinceEpoch(
+			second * 1000).toString("hh:mm:ss");
+	}
+	return _cachedTime + QString(".%1").arg(int(when % 1000), 3, 10, QChar('0'));
+}
+
+void LogsWriter::write(std::vector<Entry> &&entries) {
+	const auto dropped = _dropped.load();
+	if (entries.empty() && dropped == _droppedReported) {
+		return;
+	}
+
+	QString texts[LogDataCount];
+	for (const auto &entry : entries) {
+		auto &text = texts[entry.type];
+		text += QString("[%1 %2-%3] ").arg(formatTime(entry.when)).arg(QString("%1").arg(entry.thread, 2, 10, QChar('0'))).arg(entry.index, 7, 10, QChar('0'));
+		if (entry.type == LogDataMtp) {
+			text += QString("(dc:%1) ").arg(entry.dc);
+		}
+		text += entry.message;
+		if (entry.file) {
+			text += QString(" (%1 : %2)").arg(_logsFileBasename(entry.file)).arg(entry.line);
+		}
+		text += '\n';
+	}
+	if (dropped != _droppedReported) {
+		texts[LogDataDebug] += QString("[%1] Logs: %2 entries dropped.\n").arg(formatTime(QDateTime::currentMSecsSinceEpoch())).arg(dropped - _droppedReported);
+		_droppedReported = dropped;
+	}
+	if (!LogsData) {
+		return;
+	}
+	for (auto type = 0; type != LogDataCount; ++type) {
+		if (!texts[type].isEmpty()) {
+			LogsData->write(LogDataType(type), texts[type]);
+		}
+	}
+}
+
 using LogsInMemoryList = QList<QPair<LogDataType, QString>>;
 LogsInMemoryList *LogsInMemory = 0;
 LogsInMemoryList *DeletedLogsInMemory = SharedMemoryLocation<LogsInMemoryList, 0>();
 
 QString LogsBeforeSingleInstanceChecked; // LogsInMemory already dumped in LogsData, but LogsData is about to be deleted
 
+// Returns false if the entry should be formatted and written in place.
+bool _logsWriteAsync(
+		LogDataType type,
+		const char *file,
+		int32 line,
+		int32 dc,
+		const QString &message) {
+	if (!LogsWriterInstance.load()
+		|| !LogsData
+		|| LogsStartIndexChosen >= 0) {
+		return false;
+	}
+	QReadLocker lock(&LogsWriterLock);
+	const auto writer = LogsWriterInstance.load();
+	if (!writer) {
+		return false;
+	} else if (Logs::DebugEnabled()) {
+		writer->push(type, file, line, dc, message);
+	}
+	return true;
+}
+
+void _logsStopWriter() {
+	auto writer = static_cast<LogsWriter*>(nullptr);
+	{
+		QWriteLocker lock(&LogsWriterLock);
+		writer = LogsWriterInstance.exchange(nullptr);
+	}
+	if (writer) {
+		writer->stop();
+		delete writer;
+	}
+}
+
 void _logsWrite(LogDataType type, const QString &msg) {
 	if (LogsData && (type == LogDataMain || LogsStartIndexChosen < 0)) {
 		if (type == LogDataMain || Logs::DebugEnabled()) {
@@ -445,6 +686,8 @@ void start(not_null<Core::Launcher*> launcher) {
 }
 
 void finish() {
+	_logsStopWriter();
+
 	delete LogsData;
 	LogsData = 0;
 
@@ -489,6 +732,10 @@ bool instanceChecked() {
 	}
 	LogsInMemory = DeletedLogsInMemory;
 
+	const auto writer = new LogsWriter();
+	writer->start(QThread::LowPriority);
+	LogsWriterInstance = writer;
+
 	DEBUG_LOG(("Debug logs started."));
 	LogsBeforeSingleInstanceChecked.clear();
 	return true;
@@ -509,6 +756,7 @@ void multipleInstances() {
 
 void closeMain() {
 	LOG(("Explicitly closing main log and finishing crash handlers."));
+	_logsStopWriter();
 	if (LogsData) {
 		LogsData->closeMain();
 	}
@@ -522,26 +770,17 @@ void writeMain(const QString &v) {
 	QString msg(QString("[%1.%2.%3 %4:%5:%6] %7\n").arg(tm.tm_year + 1900).arg(tm.tm_mon + 1, 2, 10, QChar('0')).arg(tm.tm_mday, 2, 10, QChar('0')).arg(tm.tm_hour, 2, 10, QChar('0')).arg(tm.tm_min, 2, 10, QChar('0')).arg(tm.tm_sec, 2, 10, QChar('0')).arg(v));
 	_logsWrite(LogDataMain, msg);
 
-	QString debugmsg(QString("%1 %2\n").arg(_logsEntryStart()).arg(v));
-	_logsWrite(LogDataDebug, debugmsg);
+	if (!_logsWriteAsync(LogDataDebug, nullptr, 0, 0, v)) {
+		QString debugmsg(QString("%1 %2\n").arg(_logsEntryStart()).arg(v));
+		_logsWrite(LogDataDebug, debugmsg);
+	}
 }
 
 void writeDebug(const char *file, int32 line, const QString &v) {
-	const char *last = strstr(file, "/"), *found = 0;
-	while (last) {
-		found = last;
-		last = strstr(last + 1, "/");
-	}
-	last = strstr(file, "\\");
-	while (last) {
-		found = last;
-		last = strstr(last + 1, "\\");
-	}
-	if (found) {
-		file = found + 1;
+	if (_logsWriteAsync(LogDataDebug, file, line, 0, v)) {
+		return;
 	}
-
-	QString msg(QString("%1 %2 (%3 : %4)\n").arg(_logsEntryStart()).arg(v).arg(file).arg(line));
+	QString msg(QString("%1 %2 (%3 : %4)\n").arg(_logsEntryStart()).arg(v).arg(_logsFileBasename(file)).arg(line));
 	_logsWrite(LogDataDebug, msg);
 
 #ifdef Q_OS_WIN
@@ -554,11 +793,17 @@ void writeDebug(const char *file, int32 line, const QString &v) {
 }
 
 void writeTcp(const QString &v) {
+	if (_logsWriteAsync(LogDataTcp, nullptr, 0, 0, v)) {
+		return;
+	}
 	QString msg(QString("%1 %2\n").arg(_logsEntryStart()).arg(v));
 	_logsWrite(LogDataTcp, msg);
 }
 
 void writeMtp(int32 dc, const QString &v) {
+	if (_logsWriteAsync(LogDataMtp, nullptr, 0, dc, v)) {
+		return;
+	}
 	QString msg(QString("%1 (dc:%2) %3\n").arg(_logsEntryStart()).arg(dc).arg(v));
 	_logsWrite(LogDataMtp, msg);
 }
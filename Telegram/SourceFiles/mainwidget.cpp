@@ -15,6 +15,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "data/data_game.h"
 #include "data/data_peer_values.h"
 #include "data/data_drafts.h"
+#include "data/data_history_cache.h"
 #include "data/data_session.h"
 #include "data/data_media_types.h"
 #include "data/data_feed.h"
@@ -2974,6 +2975,7 @@ void MainWidget::gotChannelDifference(
 
 void MainWidget::feedChannelDifference(
 		const MTPDupdates_channelDifference &data) {
+	session().data().startUpdatesBatch();
 	session().data().processUsers(data.vusers);
 	session().data().processChats(data.vchats);
 
@@ -2982,6 +2984,7 @@ void MainWidget::feedChannelDifference(
 	App::feedMsgs(data.vnew_messages, NewMessageUnread);
 	feedUpdateVector(data.vother_updates, true);
 	_handlingChannelDifference = false;
+	session().data().finishUpdatesBatch();
 }
 
 bool MainWidget::failChannelDifference(ChannelData *channel, const RPCError &error) {
@@ -3123,11 +3126,35 @@ void MainWidget::feedDifference(
 		const MTPVector<MTPMessage> &msgs,
 		const MTPVector<MTPUpdate> &other) {
 	session().checkAutoLock();
+
+	// Chats list, unread counter and history views are updated only once,
+	// after the whole difference is applied.
+	const auto started = crl::now();
+	session().data().startUpdatesBatch();
 	session().data().processUsers(users);
 	session().data().processChats(chats);
+	const auto peersFed = crl::now();
 	feedMessageIds(other);
 	App::feedMsgs(msgs, NewMessageUnread);
+	const auto messagesFed = crl::now();
 	feedUpdateVector(other, true);
+	const auto updatesFed = crl::now();
+	session().data().finishUpdatesBatch();
+	const auto finished = crl::now();
+
+	DEBUG_LOG(("Difference Info: "
+		"%1 users and %2 chats in %3 ms, "
+		"%4 messages in %5 ms, "
+		"%6 updates in %7 ms, "
+		"batch finished in %8 ms."
+		).arg(users.v.size()
+		).arg(chats.v.size()
+		).arg(peersFed - started
+		).arg(msgs.v.size()
+		).arg(messagesFed - peersFed
+		).arg(other.v.size()
+		).arg(updatesFed - messagesFed
+		).arg(finished - updatesFed));
 }
 
 bool MainWidget::failDifference(const RPCError &error) {
@@ -3258,6 +3285,7 @@ void MainWidget::start() {
 	session().api().requestNotifySettings(MTP_inputNotifyChats());
 	session().api().requestNotifySettings(MTP_inputNotifyBroadcasts());
 
+	Local::prefetchStartupFiles();
 	Local::readSavedPeers();
 	cSetOtherOnline(0);
 	session().user()->loadUserpic();
@@ -3417,6 +3445,8 @@ void MainWidget::incrementSticker(DocumentData *sticker) {
 
 	bool writeRecentStickers = false;
 	auto &sets = session().data().stickerSetsRef();
+	session().data().stickersEmojiIndex().markSetChanged(
+		Stickers::CloudRecentSetId);
 	auto it = sets.find(Stickers::CloudRecentSetId);
 	if (it == sets.cend()) {
 		if (it == sets.cend()) {
@@ -3864,6 +3894,7 @@ void MainWidget::feedUpdates(const MTPUpdates &updates, uint64 randomId) {
 					if (!wasAlready) {
 						item->indexAsNewItem();
 					}
+					session().data().historyCache().sentMessage(item, d, text);
 				}
 			}
 		}
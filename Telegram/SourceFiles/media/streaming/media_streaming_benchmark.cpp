@@ -0,0 +1,205 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "media/streaming/media_streaming_benchmark.h"
+
+#include "media/streaming/media_streaming_player.h"
+#include "media/streaming/media_streaming_loader_local.h"
+#include "base/weak_ptr.h"
+#include "base/timer.h"
+#include "data/data_session.h"
+#include "auth_session.h"
+
+namespace Media {
+namespace Streaming {
+namespace {
+
+// Play that long from the start and that long after the seek.
+constexpr auto kPlayTime = 5 * crl::time(1000);
+
+struct Profile {
+	QString name;
+	SimulatedNetwork network;
+};
+
+std::vector<Profile> Profiles() {
+	return {
+		{ qsl("local"), { 0, 0 } },
+		{ qsl("fast"), { 50, 4 * 1024 * 1024 } },
+		{ qsl("slow"), { 300, 256 * 1024 } },
+	};
+}
+
+class PlaybackBenchmark final : public base::has_weak_ptr {
+public:
+	PlaybackBenchmark(
+		not_null<Data::Session*> owner,
+		const QString &path,
+		Fn<void(QString)> done);
+
+	void start();
+
+private:
+	void startProfile();
+	void handleUpdate(Update &&update);
+	void played();
+	void seek();
+	void finishProfile(const QString &error = QString());
+	void finishProfileLater(const QString &error = QString());
+
+	const not_null<Data::Session*> _owner;
+	const QString _path;
+	const Fn<void(QString)> _done;
+	const std::vector<Profile> _profiles;
+	int _index = 0;
+	std::unique_ptr<Player> _player;
+	base::Timer _timer;
+	crl::time _duration = kTimeUnknown;
+	PlaybackStats _startStats;
+	bool _seeked = false;
+	QStringList _report;
+
+};
+
+PlaybackBenchmark::PlaybackBenchmark(
+	not_null<Data::Session*> owner,
+	const QString &path,
+	Fn<void(QString)> done)
+: _owner(owner)
+, _path(path)
+, _done(std::move(done))
+, _profiles(Profiles())
+, _timer([=] { played(); }) {
+}
+
+void PlaybackBenchmark::start() {
+	_report.push_back(qsl("File: %1").arg(_path));
+	startProfile();
+}
+
+void PlaybackBenchmark::startProfile() {
+	if (_index == int(_profiles.size())) {
+		_done(_report.join('\n'));
+		return;
+	}
+	const auto &profile = _profiles[_index];
+	_player = std::make_unique<Player>(
+		_owner,
+		MakeSimulatedFileLoader(_path, profile.network));
+	_duration = kTimeUnknown;
+	_startStats = PlaybackStats();
+	_seeked = false;
+
+	_player->updates(
+	) | rpl::start_with_next_error([=](Update &&update) {
+		handleUpdate(std::move(update));
+	}, [=](Error &&error) {
+		finishProfileLater(
+			qsl("playback failed, error %1").arg(int(error)));
+	}, _player->lifetime());
+
+	auto options = PlaybackOptions();
+	options.mode = Mode::Video;
+	options.position = 0;
+	_player->play(options);
+}
+
+void PlaybackBenchmark::handleUpdate(Update &&update) {
+	update.data.match([&](Information &update) {
+		_duration = update.video.state.duration;
+		_timer.callOnce(kPlayTime);
+	}, [&](Finished) {
+		finishProfileLater();
+	}, [](const auto &update) {
+	});
+}
+
+void PlaybackBenchmark::played() {
+	if (_seeked) {
+		finishProfile();
+	} else {
+		seek();
+	}
+}
+
+void PlaybackBenchmark::seek() {
+	_startStats = _player->playbackStats();
+	_seeked = true;
+
+	auto options = PlaybackOptions();
+	options.mode = Mode::Video;
+	options.position = (_duration != kTimeUnknown) ? (_duration / 2) : 0;
+	_player->play(options);
+}
+
+void PlaybackBenchmark::finishProfileLater(const QString &error) {
+	// Don't destroy the player while it is firing an update.
+	crl::on_main(this, [=, player = _player.get()] {
+		if (_player.get() == player) {
+			finishProfile(error);
+		}
+	});
+}
+
+void PlaybackBenchmark::finishProfile(const QString &error) {
+	if (!_player) {
+		return;
+	}
+	_timer.cancel();
+
+	const auto &profile = _profiles[_index];
+	const auto network = qsl("%1 (latency %2 ms, %3 bytes/s)"
+	).arg(profile.name
+	).arg(profile.network.latency
+	).arg(profile.network.bytesPerSecond);
+	if (!error.isEmpty()) {
+		_report.push_back(qsl("%1: %2.").arg(network).arg(error));
+	} else {
+		const auto stats = _player->playbackStats();
+		const auto first = _seeked ? _startStats : stats;
+		const auto rebuffers = first.rebuffersCount
+			+ (_seeked ? stats.rebuffersCount : 0);
+		_report.push_back(qsl("%1: first frame %2 ms, "
+			"after seek %3 ms, rebuffers %4."
+		).arg(network
+		).arg(first.startupTime
+		).arg(_seeked ? QString::number(stats.startupTime) : qsl("-")
+		).arg(rebuffers));
+	}
+	_player = nullptr;
+	++_index;
+	startProfile();
+}
+
+} // namespace
+
+void BenchmarkPlayback(
+		not_null<Data::Session*> owner,
+		const QString &path,
+		Fn<void(QString)> done) {
+	static auto Running = std::unique_ptr<PlaybackBenchmark>();
+	if (Running) {
+		return;
+	}
+	auto finished = [=](QString report) {
+		// The benchmark is destroyed after it has finished reporting.
+		crl::on_main([] {
+			Running = nullptr;
+		});
+		done(report);
+	};
+	Running = std::make_unique<PlaybackBenchmark>(
+		owner,
+		path,
+		std::move(finished));
+	owner->session().lifetime().add([] {
+		Running = nullptr;
+	});
+	Running->start();
+}
+
+} // namespace Streaming
+} // namespace Media
@@ -0,0 +1,24 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Data {
+class Session;
+} // namespace Data
+
+namespace Media {
+namespace Streaming {
+
+// Plays a local video file through several simulated networks and
+// reports the startup, seek and rebuffering stats for each of them.
+void BenchmarkPlayback(
+	not_null<Data::Session*> owner,
+	const QString &path,
+	Fn<void(QString)> done);
+
+} // namespace Streaming
+} // namespace Media
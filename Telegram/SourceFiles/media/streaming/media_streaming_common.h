@@ -32,6 +32,20 @@ enum class Mode {
 	Inspection,
 };
 
+struct ReaderOptions {
+	// Slices of 8 MB of the file kept in memory after they were used.
+	int slicesInMemory = 2;
+
+	// Parts of 128 KB requested from cloud ahead of reading demand,
+	// up to Loader::kMaxLoadingParts.
+	int preloadPartsAhead = 16;
+};
+
+struct PlaybackStats {
+	crl::time startupTime = kTimeUnknown;
+	int rebuffersCount = 0;
+};
+
 struct PlaybackOptions {
 	Mode mode = Mode::Both;
 	crl::time position = 0;
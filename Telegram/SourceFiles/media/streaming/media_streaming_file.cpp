@@ -244,6 +244,7 @@ void File::Context::start(crl::time position) {
 
 	_reader->headerDone();
 	if (video.codec || audio.codec) {
+		_reader->seekStarted();
 		seekToPosition(format.get(), video.codec ? video : audio, position);
 	}
 	if (unroll()) {
@@ -326,8 +327,9 @@ bool File::Context::finished() const {
 
 File::File(
 	not_null<Data::Session*> owner,
-	std::unique_ptr<Loader> loader)
-: _reader(owner, std::move(loader)) {
+	std::unique_ptr<Loader> loader,
+	const ReaderOptions &options)
+: _reader(owner, std::move(loader), options) {
 }
 
 void File::start(not_null<FileDelegate*> delegate, crl::time position) {
@@ -26,7 +26,10 @@ class FileDelegate;
 
 class File final {
 public:
-	File(not_null<Data::Session*> owner, std::unique_ptr<Loader> loader);
+	File(
+		not_null<Data::Session*> owner,
+		std::unique_ptr<Loader> loader,
+		const ReaderOptions &options = ReaderOptions());
 
 	File(const File &other) = delete;
 	File &operator=(const File &other) = delete;
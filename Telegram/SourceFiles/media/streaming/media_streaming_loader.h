@@ -20,6 +20,10 @@ class Loader {
 public:
 	static constexpr auto kPartSize = 128 * 1024;
 
+	// Both the parts requested at once by the reader
+	// and the parts loaded in parallel are limited by it.
+	static constexpr auto kMaxLoadingParts = 16;
+
 	[[nodiscard]] virtual auto baseCacheKey() const
 	-> std::optional<Storage::Cache::Key> = 0;
 	[[nodiscard]] virtual int size() const = 0;
@@ -21,9 +21,12 @@ int ValidateLocalSize(int64 size) {
 
 } // namespace
 
-LoaderLocal::LoaderLocal(std::unique_ptr<QIODevice> device)
+LoaderLocal::LoaderLocal(
+	std::unique_ptr<QIODevice> device,
+	SimulatedNetwork network)
 : _device(std::move(device))
-, _size(ValidateLocalSize(_device->size())) {
+, _size(ValidateLocalSize(_device->size()))
+, _network(network) {
 	Expects(_device != nullptr);
 
 	if (!_size || !_device->open(QIODevice::ReadOnly)) {
@@ -51,11 +54,31 @@ void LoaderLocal::load(int offset) {
 		fail();
 		return;
 	}
+	const auto delay = simulatedDelay(result.size());
 	crl::on_main(this, [=, result = std::move(result)]() mutable {
-		_parts.fire({ offset, std::move(result) });
+		if (!delay) {
+			_parts.fire({ offset, std::move(result) });
+			return;
+		}
+		App::CallDelayed(int(delay), this, [=] {
+			_parts.fire({ offset, result });
+		});
 	});
 }
 
+crl::time LoaderLocal::simulatedDelay(int bytes) {
+	if (!_network.latency && !_network.bytesPerSecond) {
+		return 0;
+	}
+	// Parts go through the simulated link one after another.
+	const auto now = crl::now();
+	const auto transfer = _network.bytesPerSecond
+		? (crl::time(bytes) * 1000 / _network.bytesPerSecond)
+		: crl::time(0);
+	_linkFreeAt = std::max(_linkFreeAt, now) + transfer;
+	return (_linkFreeAt - now) + _network.latency;
+}
+
 void LoaderLocal::fail() {
 	crl::on_main(this, [=] {
 		_parts.fire({ LoadedPart::kFailedOffset });
@@ -79,6 +102,14 @@ std::unique_ptr<LoaderLocal> MakeFileLoader(const QString &path) {
 	return std::make_unique<LoaderLocal>(std::make_unique<QFile>(path));
 }
 
+std::unique_ptr<LoaderLocal> MakeSimulatedFileLoader(
+		const QString &path,
+		SimulatedNetwork network) {
+	return std::make_unique<LoaderLocal>(
+		std::make_unique<QFile>(path),
+		network);
+}
+
 std::unique_ptr<LoaderLocal> MakeBytesLoader(const QByteArray &bytes) {
 	auto device = std::make_unique<QBuffer>();
 	auto copy = new QByteArray(bytes);
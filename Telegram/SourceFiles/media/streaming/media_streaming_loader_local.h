@@ -15,9 +15,17 @@ class ApiWrap;
 namespace Media {
 namespace Streaming {
 
+// Network conditions for benchmarking the streaming with a local file.
+struct SimulatedNetwork {
+	crl::time latency = 0;
+	int bytesPerSecond = 0; // Zero means unlimited.
+};
+
 class LoaderLocal : public Loader, public base::has_weak_ptr {
 public:
-	LoaderLocal(std::unique_ptr<QIODevice> device);
+	LoaderLocal(
+		std::unique_ptr<QIODevice> device,
+		SimulatedNetwork network = SimulatedNetwork());
 
 	[[nodiscard]] auto baseCacheKey() const
 		->std::optional<Storage::Cache::Key> override;
@@ -33,15 +41,21 @@ public:
 
 private:
 	void fail();
+	[[nodiscard]] crl::time simulatedDelay(int bytes);
 
 	const std::unique_ptr<QIODevice> _device;
 	const int _size = 0;
+	const SimulatedNetwork _network;
+	crl::time _linkFreeAt = 0;
 	rpl::event_stream<LoadedPart> _parts;
 
 };
 
 std::unique_ptr<LoaderLocal> MakeFileLoader(const QString &path);
 std::unique_ptr<LoaderLocal> MakeBytesLoader(const QByteArray &bytes);
+std::unique_ptr<LoaderLocal> MakeSimulatedFileLoader(
+	const QString &path,
+	SimulatedNetwork network);
 
 } // namespace Streaming
 } // namespace Media
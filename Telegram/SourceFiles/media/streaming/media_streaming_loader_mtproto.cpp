@@ -13,7 +13,10 @@ namespace Media {
 namespace Streaming {
 namespace {
 
-constexpr auto kMaxConcurrentRequests = 2;
+constexpr auto kMinConcurrentRequests = 2;
+constexpr auto kMaxConcurrentRequests = Loader::kMaxLoadingParts;
+constexpr auto kRttSamplesCount = 16;
+constexpr auto kIntervalSmoothFactor = 4;
 constexpr auto kDocumentBaseCacheTag = 0x0000000000010000ULL;
 constexpr auto kDocumentBaseCacheMask = 0x000000000000FF00ULL;
 
@@ -29,7 +32,8 @@ LoaderMtproto::LoaderMtproto(
 , _dcId(dcId)
 , _location(location)
 , _size(size)
-, _origin(origin) {
+, _origin(origin)
+, _maxRequests(kMinConcurrentRequests) {
 }
 
 std::optional<Storage::Cache::Key> LoaderMtproto::baseCacheKey() const {
@@ -63,18 +67,17 @@ void LoaderMtproto::load(int offset) {
 
 void LoaderMtproto::stop() {
 	crl::on_main(this, [=] {
-		ranges::for_each(
-			base::take(_requests),
-			_sender.requestCanceller(),
-			&base::flat_map<int, mtpRequestId>::value_type::second);
+		for (const auto &[offset, request] : base::take(_requests)) {
+			_sender.request(request.id).cancel();
+		}
 		_requested.clear();
 	});
 }
 
 void LoaderMtproto::cancel(int offset) {
 	crl::on_main(this, [=] {
-		if (const auto requestId = _requests.take(offset)) {
-			_sender.request(*requestId).cancel();
+		if (const auto request = _requests.take(offset)) {
+			_sender.request(request->id).cancel();
 			sendNext();
 		} else {
 			_requested.remove(offset);
@@ -89,7 +92,7 @@ void LoaderMtproto::increasePriority() {
 }
 
 void LoaderMtproto::sendNext() {
-	if (_requests.size() >= kMaxConcurrentRequests) {
+	if (_requests.size() >= _maxRequests) {
 		return;
 	}
 	const auto offset = _requested.take().value_or(-1);
@@ -110,14 +113,47 @@ void LoaderMtproto::sendNext() {
 	}).toDC(
 		MTP::downloadDcId(_dcId, (++DcIndex) % MTP::kDownloadSessionsCount)
 	).send();
-	_requests.emplace(offset, id);
+	_requests.emplace(offset, Request{ id, crl::now() });
 
 	sendNext();
 }
 
+void LoaderMtproto::updateWindow(crl::time sent) {
+	const auto now = crl::now();
+	_rttSamples.push_back(now - sent);
+	if (_rttSamples.size() > kRttSamplesCount) {
+		_rttSamples.pop_front();
+	}
+
+	// Parts arriving one after another while the window was full
+	// show the time the connection needs to deliver one part.
+	if (_lastReceived && _requests.size() + 1 >= _maxRequests) {
+		const auto interval = std::max(now - _lastReceived, crl::time(1));
+		_partInterval = _partInterval
+			? ((_partInterval * (kIntervalSmoothFactor - 1) + interval)
+				/ kIntervalSmoothFactor)
+			: interval;
+	}
+	_lastReceived = now;
+	if (!_partInterval) {
+		return;
+	}
+
+	// Keep one more part in flight than the link holds, so that the
+	// window grows until the parts start to queue up on the server side.
+	const auto latency = ranges::min(_rttSamples);
+	const auto partsInLink = (latency + _partInterval - 1) / _partInterval;
+	_maxRequests = snap(
+		int(partsInLink) + 1,
+		kMinConcurrentRequests,
+		kMaxConcurrentRequests);
+}
+
 void LoaderMtproto::requestDone(int offset, const MTPupload_File &result) {
 	result.match([&](const MTPDupload_file &data) {
-		_requests.erase(offset);
+		if (const auto request = _requests.take(offset)) {
+			updateWindow(request->sent);
+		}
 		sendNext();
 		_parts.fire({ offset, data.vbytes.v });
 	}, [&](const MTPDupload_fileCdnRedirect &data) {
@@ -39,7 +39,13 @@ public:
 	~LoaderMtproto();
 
 private:
+	struct Request {
+		mtpRequestId id = 0;
+		crl::time sent = 0;
+	};
+
 	void sendNext();
+	void updateWindow(crl::time sent);
 
 	void requestDone(int offset, const MTPupload_File &result);
 	void requestFailed(
@@ -68,9 +74,15 @@ private:
 	MTP::Sender _sender;
 
 	PriorityQueue _requested;
-	base::flat_map<int, mtpRequestId> _requests;
+	base::flat_map<int, Request> _requests;
 	rpl::event_stream<LoadedPart> _parts;
 
+	// The in-flight window is sized by the measured bandwidth-delay product.
+	std::deque<crl::time> _rttSamples;
+	crl::time _partInterval = 0;
+	crl::time _lastReceived = 0;
+	int _maxRequests = 0;
+
 };
 
 } // namespace Streaming
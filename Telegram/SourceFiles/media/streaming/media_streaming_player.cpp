@@ -78,8 +78,9 @@ void SaveValidStartInformation(Information &to, Information &&from) {
 
 Player::Player(
 	not_null<Data::Session*> owner,
-	std::unique_ptr<Loader> loader)
-: _file(std::make_unique<File>(owner, std::move(loader)))
+	std::unique_ptr<Loader> loader,
+	const ReaderOptions &options)
+: _file(std::make_unique<File>(owner, std::move(loader), options))
 , _remoteLoader(_file->isRemoteLoader())
 , _renderFrameTimer([=] { checkNextFrameRender(); }) {
 }
@@ -434,6 +435,9 @@ void Player::provideStartInformation() {
 		fail(Error::OpenFailed);
 	} else {
 		_stage = Stage::Ready;
+		_stats.startupTime = crl::now() - _playRequestedTime;
+		DEBUG_LOG(("Streaming Info: Ready in %1 ms."
+			).arg(_stats.startupTime));
 
 		// Don't keep the reference to the video cover.
 		auto copy = _information;
@@ -473,6 +477,8 @@ void Player::play(const PlaybackOptions &options) {
 		_options.speed = 1.;
 	}
 	_stage = Stage::Initializing;
+	_playRequestedTime = crl::now();
+	_stats = PlaybackStats();
 	_file->start(delegate(), _options.position);
 }
 
@@ -625,6 +631,7 @@ void Player::start() {
 	) | rpl::filter([=] {
 		return !bothReceivedEnough(kBufferFor);
 	}) | rpl::start_with_next([=] {
+		++_stats.rebuffersCount;
 		_pausedByWaitingForData = true;
 		updatePausedState();
 		_updates.fire({ WaitingForData{ true } });
@@ -681,6 +688,10 @@ void Player::checkVideoStep() {
 }
 
 void Player::stop() {
+	if (_stage == Stage::Started) {
+		DEBUG_LOG(("Streaming Info: Stopped after %1 rebuffers."
+			).arg(_stats.rebuffersCount));
+	}
 	_file->stop();
 	_sessionLifetime = rpl::lifetime();
 	_stage = Stage::Uninitialized;
@@ -818,6 +829,10 @@ crl::time Player::getCurrentReceivedTill(crl::time duration) const {
 		: result;
 }
 
+PlaybackStats Player::playbackStats() const {
+	return _stats;
+}
+
 rpl::lifetime &Player::lifetime() {
 	return _lifetime;
 }
@@ -32,7 +32,10 @@ class VideoTrack;
 class Player final : private FileDelegate {
 public:
 	// Public interfaces is used from the main thread.
-	Player(not_null<Data::Session*> owner, std::unique_ptr<Loader> loader);
+	Player(
+		not_null<Data::Session*> owner,
+		std::unique_ptr<Loader> loader,
+		const ReaderOptions &options = ReaderOptions());
 
 	// Because we remember 'this' in calls to crl::on_main.
 	Player(const Player &other) = delete;
@@ -62,6 +65,9 @@ public:
 
 	[[nodiscard]] Media::Player::TrackState prepareLegacyState() const;
 
+	// Startup time and rebuffers count of the current playback.
+	[[nodiscard]] PlaybackStats playbackStats() const;
+
 	[[nodiscard]] rpl::lifetime &lifetime();
 
 	~Player();
@@ -171,6 +177,8 @@ private:
 
 	crl::time _startedTime = kTimeUnknown;
 	crl::time _pausedTime = kTimeUnknown;
+	crl::time _playRequestedTime = kTimeUnknown;
+	PlaybackStats _stats;
 	crl::time _nextFrameTime = kTimeUnknown;
 	base::Timer _renderFrameTimer;
 	rpl::event_stream<Update, Error> _updates;
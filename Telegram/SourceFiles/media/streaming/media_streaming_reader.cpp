@@ -21,14 +21,13 @@ constexpr auto kInSlice = kPartsInSlice * kPartSize;
 constexpr auto kMaxPartsInHeader = 64;
 constexpr auto kMaxOnlyInHeader = 80 * kPartSize;
 constexpr auto kPartsOutsideFirstSliceGood = 8;
-constexpr auto kSlicesInMemory = 2;
 
 // 1 MB of header parts can be outside the first slice for us to still
 // put the whole first slice of the file in the header cache entry.
 //constexpr auto kMaxOutsideHeaderPartsForOptimizedMode = 8;
 
-// 1 MB of parts are requested from cloud ahead of reading demand.
-constexpr auto kPreloadPartsAhead = 8;
+// When reading jumps this far from the loading parts they are cancelled.
+constexpr auto kStaleLoadDistance = kInSlice;
 
 bool IsContiguousSerialization(int serializedSize, int maxSliceSize) {
 	return !(serializedSize % kPartSize) || (serializedSize == maxSliceSize);
@@ -201,14 +200,14 @@ void Reader::Slice::addPart(int offset, QByteArray bytes) {
 	}
 }
 
-auto Reader::Slice::prepareFill(int from, int till) -> PrepareFillResult {
+auto Reader::Slice::prepareFill(int from, int till, int preloadParts)
+-> PrepareFillResult {
 	auto result = PrepareFillResult();
 
 	result.ready = false;
 	const auto fromOffset = (from / kPartSize) * kPartSize;
 	const auto tillPart = (till + kPartSize - 1) / kPartSize;
-	const auto preloadTillOffset = (tillPart + kPreloadPartsAhead)
-		* kPartSize;
+	const auto preloadTillOffset = (tillPart + preloadParts) * kPartSize;
 
 	const auto after = ranges::upper_bound(
 		parts,
@@ -271,8 +270,14 @@ auto Reader::Slice::offsetsFromLoader(int from, int till) const
 	return result;
 }
 
-Reader::Slices::Slices(int size, bool useCache)
-: _size(size) {
+Reader::Slices::Slices(
+	int size,
+	bool useCache,
+	const ReaderOptions &options)
+: _size(size)
+, _slicesInMemory(std::max(options.slicesInMemory, 1))
+, _preloadPartsAhead(
+	snap(options.preloadPartsAhead, 0, kLoadFromRemoteMax)) {
 	Expects(size > 0);
 
 	if (useCache) {
@@ -470,9 +475,15 @@ auto Reader::Slices::fill(int offset, bytes::span buffer) -> FillResult {
 	const auto firstTill = std::min(kInSlice, till - fromSlice * kInSlice);
 	const auto secondFrom = 0;
 	const auto secondTill = till - (fromSlice + 1) * kInSlice;
-	const auto first = _data[fromSlice].prepareFill(firstFrom, firstTill);
+	const auto first = _data[fromSlice].prepareFill(
+		firstFrom,
+		firstTill,
+		_preloadPartsAhead);
 	const auto second = (fromSlice + 1 < tillSlice)
-		? _data[fromSlice + 1].prepareFill(secondFrom, secondTill)
+		? _data[fromSlice + 1].prepareFill(
+			secondFrom,
+			secondTill,
+			_preloadPartsAhead)
 		: Slice::PrepareFillResult();
 	handlePrepareResult(fromSlice, first);
 	if (fromSlice + 1 < tillSlice) {
@@ -510,7 +521,10 @@ auto Reader::Slices::fillFromHeader(int offset, bytes::span buffer)
 	const auto from = offset;
 	const auto till = int(offset + buffer.size());
 
-	const auto prepared = _header.prepareFill(from, till);
+	const auto prepared = _header.prepareFill(
+		from,
+		till,
+		_preloadPartsAhead);
 	for (const auto full : prepared.offsetsFromLoader.values()) {
 		if (full < _size) {
 			result.offsetsFromLoader.add(full);
@@ -550,7 +564,7 @@ int Reader::Slices::maxSliceSize(int sliceNumber) const {
 
 Reader::SerializedSlice Reader::Slices::serializeAndUnloadUnused() {
 	if (_headerMode == HeaderMode::Unknown
-		|| _usedSlices.size() <= kSlicesInMemory) {
+		|| _usedSlices.size() <= _slicesInMemory) {
 		return {};
 	}
 	const auto purgeSlice = _usedSlices.front();
@@ -669,11 +683,12 @@ Reader::SerializedSlice Reader::Slices::unloadToCache() {
 
 Reader::Reader(
 	not_null<Data::Session*> owner,
-	std::unique_ptr<Loader> loader)
+	std::unique_ptr<Loader> loader,
+	const ReaderOptions &options)
 : _owner(owner)
 , _loader(std::move(loader))
 , _cacheHelper(InitCacheHelper(_loader->baseCacheKey()))
-, _slices(_loader->size(), _cacheHelper != nullptr) {
+, _slices(_loader->size(), _cacheHelper != nullptr, options) {
 	_loader->parts(
 	) | rpl::start_with_next([=](LoadedPart &&part) {
 		QMutexLocker lock(&_loadedPartsMutex);
@@ -750,6 +765,10 @@ void Reader::headerDone() {
 	_slices.headerDone(false);
 }
 
+void Reader::seekStarted() {
+	_seeking = true;
+}
+
 bool Reader::fill(
 		int offset,
 		bytes::span buffer,
@@ -837,7 +856,17 @@ void Reader::cancelLoadInRange(int from, int till) {
 }
 
 void Reader::checkLoadWillBeFirst(int offset) {
+	const auto seeking = base::take(_seeking);
 	if (_loadingOffsets.front().value_or(offset) != offset) {
+		if (seeking) {
+			// After a seek don't wait for the parts far from the new position.
+			if (offset > kStaleLoadDistance) {
+				cancelLoadInRange(0, offset - kStaleLoadDistance);
+			}
+			if (offset + kStaleLoadDistance < size()) {
+				cancelLoadInRange(offset + kStaleLoadDistance, size());
+			}
+		}
 		_loadingOffsets.increasePriority();
 		_loader->increasePriority();
 	}
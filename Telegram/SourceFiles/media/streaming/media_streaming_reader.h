@@ -6,6 +6,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 */
 #pragma once
 
+#include "media/streaming/media_streaming_common.h"
 #include "media/streaming/media_streaming_loader.h"
 #include "base/bytes.h"
 
@@ -28,7 +29,10 @@ enum class Error;
 
 class Reader final {
 public:
-	Reader(not_null<Data::Session*> owner, std::unique_ptr<Loader> loader);
+	Reader(
+		not_null<Data::Session*> owner,
+		std::unique_ptr<Loader> loader,
+		const ReaderOptions &options = ReaderOptions());
 
 	[[nodiscard]] int size() const;
 	[[nodiscard]] bool fill(
@@ -39,6 +43,10 @@ public:
 
 	void headerDone();
 
+	// Next load request is for the new position, parts far from it
+	// are not needed anymore. Called on the reading thread.
+	void seekStarted();
+
 	void stop();
 
 	[[nodiscard]] bool isRemoteLoader() const;
@@ -46,7 +54,7 @@ public:
 	~Reader();
 
 private:
-	static constexpr auto kLoadFromRemoteMax = 8;
+	static constexpr auto kLoadFromRemoteMax = Loader::kMaxLoadingParts;
 
 	struct CacheHelper;
 
@@ -97,7 +105,7 @@ private:
 			bytes::const_span data,
 			int maxSize);
 		void addPart(int offset, QByteArray bytes);
-		PrepareFillResult prepareFill(int from, int till);
+		PrepareFillResult prepareFill(int from, int till, int preloadParts);
 
 		// Get up to kLoadFromRemoteMax not loaded parts in from-till range.
 		StackIntVector<kLoadFromRemoteMax> offsetsFromLoader(
@@ -111,7 +119,7 @@ private:
 
 	class Slices {
 	public:
-		Slices(int size, bool useCache);
+		Slices(int size, bool useCache, const ReaderOptions &options);
 
 		void headerDone(bool fromCache);
 		[[nodiscard]] bool headerWontBeFilled() const;
@@ -152,6 +160,8 @@ private:
 		Slice _header;
 		std::deque<int> _usedSlices;
 		int _size = 0;
+		int _slicesInMemory = 0;
+		int _preloadPartsAhead = 0;
 		HeaderMode _headerMode = HeaderMode::Unknown;
 
 	};
@@ -181,6 +191,7 @@ private:
 	std::vector<LoadedPart> _loadedParts;
 	std::atomic<crl::semaphore*> _waiting = nullptr;
 	PriorityQueue _loadingOffsets;
+	bool _seeking = false;
 
 	Slices _slices;
 	std::optional<Error> _failed;
@@ -9,6 +9,8 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "media/streaming/media_streaming_common.h"
 #include "ui/image/image_prepare.h"
 
+#include <QtCore/QElapsedTimer>
+
 extern "C" {
 #include <libavutil/opt.h>
 } // extern "C"
@@ -23,6 +25,8 @@ constexpr auto kPixelBytesSize = 4;
 constexpr auto kImageFormat = QImage::Format_ARGB32_Premultiplied;
 constexpr auto kAvioBlockSize = 4096;
 constexpr auto kMaxScaleByAspectRatio = 16;
+constexpr auto kMaxPooledFrames = 3;
+constexpr auto kBenchmarkFrames = 30;
 
 void AlignedImageBufferCleanupHandler(void* data) {
 	const auto buffer = static_cast<uchar*>(data);
@@ -234,7 +238,7 @@ SwscalePointer MakeSwscalePointer(
 		resize.width(),
 		resize.height(),
 		AV_PIX_FMT_BGRA,
-		0,
+		SwscaleFlags(QSize(frame->width, frame->height), resize),
 		nullptr,
 		nullptr,
 		nullptr);
@@ -246,6 +250,43 @@ SwscalePointer MakeSwscalePointer(
 		{ resize, QSize{ frame->width, frame->height }, frame->format });
 }
 
+int SwscaleFlags(QSize frameSize, QSize resize) {
+	if (frameSize == resize) {
+		return SWS_POINT;
+	} else if (resize.width() <= frameSize.width()
+		&& resize.height() <= frameSize.height()) {
+		// Downscaling for display, fast bilinear has SIMD kernels.
+		return SWS_FAST_BILINEAR;
+	}
+	return SWS_BICUBIC;
+}
+
+QImage FrameStoragePool::take(QSize size) {
+	const auto i = ranges::find_if(_images, [&](const QImage &image) {
+		return GoodStorageForFrame(image, size);
+	});
+	if (i == end(_images)) {
+		return CreateFrameStorage(size);
+	}
+	auto result = std::move(*i);
+	_images.erase(i);
+	return result;
+}
+
+void FrameStoragePool::release(QImage &&storage) {
+	if (storage.isNull()) {
+		return;
+	}
+	const auto size = storage.size();
+	_images.erase(ranges::remove_if(_images, [&](const QImage &image) {
+		return (image.size() != size);
+	}), end(_images));
+	if (_images.size() >= kMaxPooledFrames) {
+		_images.erase(begin(_images));
+	}
+	_images.push_back(std::move(storage));
+}
+
 void SwscaleDeleter::operator()(SwsContext *value) {
 	if (value) {
 		sws_freeContext(value);
@@ -437,7 +478,9 @@ QImage ConvertFrame(
 	}
 
 	if (!GoodStorageForFrame(storage, resize)) {
-		storage = CreateFrameStorage(resize);
+		// The main thread may still paint the previous frame from it.
+		stream.storagePool.release(std::move(storage));
+		storage = stream.storagePool.take(resize);
 	}
 	const auto format = AV_PIX_FMT_BGRA;
 	const auto hasDesiredFormat = (frame->format == format);
@@ -509,5 +552,76 @@ QImage PrepareByRequest(
 	return storage;
 }
 
+QString BenchmarkFrameConversion() {
+	struct Case {
+		AVPixelFormat format = AV_PIX_FMT_NONE;
+		QSize frameSize;
+		QSize resize;
+	};
+	const auto full = [](int height) {
+		return QSize(height * 16 / 9, height);
+	};
+	const auto cases = std::vector<Case>{
+		{ AV_PIX_FMT_YUV420P, full(360), full(360) },
+		{ AV_PIX_FMT_YUV420P, full(720), full(720) },
+		{ AV_PIX_FMT_YUV420P, full(1080), full(1080) },
+		{ AV_PIX_FMT_YUV420P, full(1080), full(540) },
+		{ AV_PIX_FMT_YUV420P, full(2160), full(1080) },
+		{ AV_PIX_FMT_NV12, full(720), full(720) },
+		{ AV_PIX_FMT_NV12, full(1080), full(1080) },
+		{ AV_PIX_FMT_NV12, full(1080), full(540) },
+	};
+	auto result = QStringList();
+	for (const auto &entry : cases) {
+		auto stream = Stream();
+		auto storage = QImage();
+		auto nanoseconds = qint64(0);
+		auto converted = 0;
+		for (auto i = 0; i != kBenchmarkFrames; ++i) {
+			auto frame = MakeFramePointer();
+			if (!frame) {
+				break;
+			}
+			frame->format = entry.format;
+			frame->width = entry.frameSize.width();
+			frame->height = entry.frameSize.height();
+			if (av_frame_get_buffer(frame.get(), kAlignImageBy) < 0) {
+				break;
+			}
+			for (auto plane = 0; plane != AV_NUM_DATA_POINTERS; ++plane) {
+				if (frame->buf[plane]) {
+					memset(
+						frame->buf[plane]->data,
+						(i * 7 + plane * 31) & 0xFF,
+						frame->buf[plane]->size);
+				}
+			}
+			auto timer = QElapsedTimer();
+			timer.start();
+			storage = ConvertFrame(
+				stream,
+				frame.get(),
+				entry.resize,
+				std::move(storage));
+			nanoseconds += timer.nsecsElapsed();
+			if (storage.isNull()) {
+				break;
+			}
+			++converted;
+		}
+		result.push_back(qsl("%1 %2x%3 -> %4x%5: %6").arg(
+			(entry.format == AV_PIX_FMT_NV12) ? qsl("NV12") : qsl("YUV420P")
+		).arg(entry.frameSize.width()
+		).arg(entry.frameSize.height()
+		).arg(entry.resize.width()
+		).arg(entry.resize.height()
+		).arg(converted
+			? qsl("%1 ms/frame"
+			).arg(nanoseconds / (1000000. * converted), 0, 'f', 2)
+			: qsl("failed")));
+	}
+	return result.join('\n');
+}
+
 } // namespace Streaming
 } // namespace Media
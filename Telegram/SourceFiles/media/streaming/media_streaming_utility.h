@@ -162,6 +162,22 @@ using SwscalePointer = std::unique_ptr<SwsContext, SwscaleDeleter>;
 	QSize resize,
 	SwscalePointer *existing = nullptr);
 
+// Picks the cheapest scaler that still looks good for the conversion.
+// Conversions without resize use the unscaled (SIMD) yuv2rgb kernels.
+[[nodiscard]] int SwscaleFlags(QSize frameSize, QSize resize);
+
+// Keeps converted frame images for reuse, so that a frame still held by
+// the main thread doesn't force a new allocation for the next one.
+class FrameStoragePool final {
+public:
+	[[nodiscard]] QImage take(QSize size);
+	void release(QImage &&storage);
+
+private:
+	std::vector<QImage> _images;
+
+};
+
 struct Stream {
 	int index = -1;
 	crl::time duration = kTimeUnknown;
@@ -178,6 +194,7 @@ struct Stream {
 	int rotation = 0;
 	AVRational aspect = kNormalAspect;
 	SwscalePointer swscale;
+	FrameStoragePool storagePool;
 };
 
 void LogError(QLatin1String method);
@@ -219,5 +236,9 @@ void LogError(QLatin1String method, AvErrorWrap error);
 	const FrameRequest &request,
 	QImage storage);
 
+// Converts synthetic YUV420P and NV12 frames of common resolutions
+// and returns a ms/frame report. Slow, don't call on the main thread.
+[[nodiscard]] QString BenchmarkFrameConversion();
+
 } // namespace Streaming
 } // namespace Media
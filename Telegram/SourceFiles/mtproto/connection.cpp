@@ -39,6 +39,9 @@ constexpr auto kRecreateKeyId = AuthKey::KeyId(0xFFFFFFFFFFFFFFFFULL);
 constexpr auto kIntSize = static_cast<int>(sizeof(mtpPrime));
 constexpr auto kMaxModExpSize = 256;
 constexpr auto kWaitForBetterTimeout = crl::time(2000);
+constexpr auto kMinStaggerDelay = crl::time(300);
+constexpr auto kMaxStaggerDelay = crl::time(1000);
+constexpr auto kHistoricallyBestPriority = 100;
 constexpr auto kMinConnectedTimeout = crl::time(1000);
 constexpr auto kMaxConnectedTimeout = crl::time(8000);
 constexpr auto kMinReceiveTimeout = crl::time(4000);
@@ -340,14 +343,86 @@ Connection::~Connection() {
 	}
 }
 
+DcOptions::EndpointKey ConnectionPrivate::endpointKey(
+		const TestEndpoint &endpoint) const {
+	const auto dcId = BareDcId(_shiftedDcId);
+	const auto &proxy = _connectionOptions->proxy;
+	auto result = DcOptions::EndpointKey();
+	result.dcId = isTemporaryDcId(dcId)
+		? getRealIdFromTemporaryDcId(dcId)
+		: dcId;
+	result.protocol = endpoint.protocol;
+	result.ip = endpoint.ip.toStdString();
+	result.port = endpoint.port;
+	if (proxy.type != ProxyData::Type::None) {
+		result.proxy = (proxy.host + ':' + QString::number(proxy.port))
+			.toStdString();
+	}
+	return result;
+}
+
+void ConnectionPrivate::startTestConnections(
+		std::vector<TestEndpoint> &&endpoints) {
+	// Start the endpoint that connected fine the last time right away
+	// and race the others against it only if it is slow to connect.
+	const auto options = _instance->dcOptions();
+	const auto rate = [](const DcOptions::EndpointStats &stats) {
+		return stats.successes / double(stats.successes + stats.failures);
+	};
+	auto best = end(endpoints);
+	auto bestStats = DcOptions::EndpointStats();
+	for (auto i = begin(endpoints); i != end(endpoints); ++i) {
+		const auto stats = options->endpointStats(endpointKey(*i));
+		if (!stats.successes || stats.lastFailure > stats.lastSuccess) {
+			continue;
+		}
+		if (best == end(endpoints)
+			|| rate(stats) > rate(bestStats)
+			|| (rate(stats) == rate(bestStats) && stats.rtt < bestStats.rtt)) {
+			best = i;
+			bestStats = stats;
+		}
+	}
+	if (best == end(endpoints) || endpoints.size() == 1) {
+		for (const auto &endpoint : endpoints) {
+			appendTestConnection(endpoint);
+		}
+		return;
+	}
+	DEBUG_LOG(("MTP Info: starting with historically best %1:%2, rtt %3."
+		).arg(best->ip
+		).arg(best->port
+		).arg(bestStats.rtt));
+	appendTestConnection(*best, true);
+	endpoints.erase(best);
+	_delayedTestEndpoints = std::move(endpoints);
+
+	// Start the others before the whole attempt times out.
+	const auto delay = snap(
+		bestStats.rtt * 2,
+		kMinStaggerDelay,
+		kMaxStaggerDelay);
+	_startDelayedTestsTimer.callOnce(std::min(delay, _waitForConnected / 2));
+}
+
+void ConnectionPrivate::startDelayedTestConnections() {
+	_startDelayedTestsTimer.cancel();
+	for (const auto &endpoint : base::take(_delayedTestEndpoints)) {
+		appendTestConnection(endpoint);
+	}
+}
+
 void ConnectionPrivate::appendTestConnection(
-		DcOptions::Variants::Protocol protocol,
-		const QString &ip,
-		int port,
-		const bytes::vector &protocolSecret) {
+		const TestEndpoint &endpoint,
+		bool historicallyBest) {
 	QWriteLocker lock(&stateConnMutex);
 
-	const auto priority = (qthelp::is_ipv6(ip) ? 0 : 1)
+	const auto protocol = endpoint.protocol;
+	const auto &ip = endpoint.ip;
+	const auto port = endpoint.port;
+	const auto &protocolSecret = endpoint.protocolSecret;
+	const auto priority = (historicallyBest ? kHistoricallyBestPriority : 0)
+		+ (qthelp::is_ipv6(ip) ? 0 : 1)
 		+ (protocol == DcOptions::Variants::Tcp ? 1 : 0)
 		+ (protocolSecret.empty() ? 0 : 1);
 	_testConnections.push_back({
@@ -356,7 +431,8 @@ void ConnectionPrivate::appendTestConnection(
 			protocol,
 			thread(),
 			_connectionOptions->proxy),
-		priority
+		priority,
+		endpointKey(endpoint)
 	});
 	auto weak = _testConnections.back().data.get();
 	connect(weak, &AbstractConnection::error, [=](int errorCode) {
@@ -398,6 +474,8 @@ int16 ConnectionPrivate::getProtocolDcId() const {
 
 void ConnectionPrivate::destroyAllConnections() {
 	_waitForBetterTimer.cancel();
+	_startDelayedTestsTimer.cancel();
+	_delayedTestEndpoints.clear();
 	_waitForReceivedTimer.cancel();
 	_waitForConnectedTimer.cancel();
 	_testConnections.clear();
@@ -420,6 +498,7 @@ ConnectionPrivate::ConnectionPrivate(
 , _waitForConnectedTimer(thread, [=] { waitConnectedFailed(); })
 , _waitForReceivedTimer(thread, [=] { waitReceivedFailed(); })
 , _waitForBetterTimer(thread, [=] { waitBetterFailed(); })
+, _startDelayedTestsTimer(thread, [=] { startDelayedTestConnections(); })
 , _waitForReceived(kMinReceiveTimeout)
 , _waitForConnected(kMinConnectedTimeout)
 , _pingSender(thread, [=] { sendPingByTimer(); })
@@ -1105,9 +1184,10 @@ void ConnectionPrivate::connectToServer(bool afterConfig) {
 	}
 
 	destroyAllConnections();
+	auto endpoints = std::vector<TestEndpoint>();
 	if (_connectionOptions->proxy.type == ProxyData::Type::Mtproto) {
 		// host, port, secret for mtproto proxy are taken from proxy.
-		appendTestConnection(DcOptions::Variants::Tcp, {}, 0, {});
+		endpoints.push_back(TestEndpoint());
 	} else {
 		using Variants = DcOptions::Variants;
 		const auto special = (_dcType == DcType::Temporary);
@@ -1138,15 +1218,17 @@ void ConnectionPrivate::connectToServer(bool afterConfig) {
 					continue;
 				}
 				for (const auto &endpoint : variants.data[address][protocol]) {
-					appendTestConnection(
+					endpoints.push_back({
 						static_cast<Variants::Protocol>(protocol),
 						QString::fromStdString(endpoint.ip),
 						endpoint.port,
-						endpoint.secret);
+						endpoint.secret
+					});
 				}
 			}
 		}
 	}
+	startTestConnections(std::move(endpoints));
 	if (_testConnections.empty()) {
 		if (_instance->isKeysDestroyer()) {
 			LOG(("MTP Error: DC %1 options for not found for auth key destruction!").arg(_shiftedDcId));
@@ -1165,7 +1247,7 @@ void ConnectionPrivate::connectToServer(bool afterConfig) {
 	}
 	DEBUG_LOG(("Connection Info: Connecting to %1 with %2 test connections."
 		).arg(_shiftedDcId
-		).arg(_testConnections.size()));
+		).arg(_testConnections.size() + _delayedTestEndpoints.size()));
 
 	if (!_startedConnectingAt) {
 		_startedConnectingAt = crl::now();
@@ -1322,6 +1404,14 @@ void ConnectionPrivate::waitConnectedFailed() {
 	auto maxTimeout = kMaxConnectedTimeout;
 	for (const auto &connection : _testConnections) {
 		accumulate_max(maxTimeout, connection.data->fullConnectTimeout());
+		if (!connection.data->isConnected()) {
+			_instance->dcOptions()->reportEndpointFailed(connection.endpoint);
+		}
+	}
+	if (!_testConnections.empty()) {
+		InvokeQueued(_instance, [instance = _instance] {
+			instance->endpointStatsChanged();
+		});
 	}
 	if (_waitForConnected < maxTimeout) {
 		_waitForConnected = std::min(maxTimeout, 2 * _waitForConnected);
@@ -1400,15 +1490,17 @@ void ConnectionPrivate::handleReceived() {
 	}
 
 	while (!_connection->received().empty()) {
-		auto intsBuffer = std::move(_connection->received().front());
+		auto packet = std::move(_connection->received().front());
 		_connection->received().pop_front();
 
 		constexpr auto kExternalHeaderIntsCount = 6U; // 2 auth_key_id, 4 msg_key
 		constexpr auto kEncryptedHeaderIntsCount = 8U; // 2 salt, 2 session, 2 msg_id, 1 seq_no, 1 length
 		constexpr auto kMinimalEncryptedIntsCount = kEncryptedHeaderIntsCount + 4U; // + 1 data + 3 padding
 		constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
-		auto intsCount = uint32(intsBuffer.size());
-		auto ints = intsBuffer.constData();
+		CountReceivedPacket();
+
+		auto intsCount = uint32(packet.size());
+		auto ints = packet.constData();
 		if ((intsCount < kMinimalIntsCount) || (intsCount > kMaxMessageLength / kIntSize)) {
 			LOG(("TCP Error: bad message received, len %1").arg(intsCount * kIntSize));
 			TCP_LOG(("TCP Error: bad message %1").arg(Logs::mb(ints, intsCount * kIntSize).str()));
@@ -1422,19 +1514,21 @@ void ConnectionPrivate::handleReceived() {
 			return restartOnError();
 		}
 
-		auto encryptedInts = ints + kExternalHeaderIntsCount;
+		// The packet is decrypted in place, the message bodies are passed
+		// to the session as slices of the same buffer.
+		auto encryptedInts = packet.data() + kExternalHeaderIntsCount;
+		ints = packet.constData();
 		auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount) & ~0x03U;
 		auto encryptedBytesCount = encryptedIntsCount * kIntSize;
-		auto decryptedBuffer = QByteArray(encryptedBytesCount, Qt::Uninitialized);
 		auto msgKey = *(MTPint128*)(ints + 2);
 
 #ifdef TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt_oldmtp(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, key, msgKey);
+		aesIgeDecrypt_oldmtp(encryptedInts, encryptedInts, encryptedBytesCount, key, msgKey);
 #else // TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, key, msgKey);
+		aesIgeDecrypt(encryptedInts, encryptedInts, encryptedBytesCount, key, msgKey);
 #endif // TDESKTOP_MTPROTO_OLD
 
-		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decryptedBuffer.constData());
+		auto decryptedInts = static_cast<const mtpPrime*>(encryptedInts);
 		auto serverSalt = *(uint64*)&decryptedInts[0];
 		auto session = *(uint64*)&decryptedInts[2];
 		auto msgId = *(uint64*)&decryptedInts[4];
@@ -1555,7 +1649,7 @@ void ConnectionPrivate::handleReceived() {
 			needToHandle = sessionData->receivedIdsSet().registerMsgId(msgId, needAck);
 		}
 		if (needToHandle) {
-			res = handleOneReceived(from, end, msgId, serverTime, serverSalt, badTime);
+			res = handleOneReceived(packet.buffer, from, end, msgId, serverTime, serverSalt, badTime);
 		}
 		{
 			QWriteLocker lock(sessionData->receivedIdsMutex());
@@ -1606,7 +1700,7 @@ void ConnectionPrivate::handleReceived() {
 	}
 }
 
-ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpPrime *from, const mtpPrime *end, uint64 msgId, int32 serverTime, uint64 serverSalt, bool badTime) {
+ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpBuffer &buffer, const mtpPrime *from, const mtpPrime *end, uint64 msgId, int32 serverTime, uint64 serverSalt, bool badTime) {
 	mtpTypeId cons = *from;
 	try {
 
@@ -1618,7 +1712,7 @@ ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpPr
 		if (response.empty()) {
 			return HandleResult::RestartConnection;
 		}
-		return handleOneReceived(response.data(), response.data() + response.size(), msgId, serverTime, serverSalt, badTime);
+		return handleOneReceived(response, response.constData(), response.constData() + response.size(), msgId, serverTime, serverSalt, badTime);
 	}
 
 	case mtpc_msg_container: {
@@ -1663,7 +1757,7 @@ ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpPr
 			}
 			auto res = HandleResult::Success; // if no need to handle, then succeed
 			if (needToHandle) {
-				res = handleOneReceived(from, otherEnd, inMsgId.v, serverTime, serverSalt, badTime);
+				res = handleOneReceived(buffer, from, otherEnd, inMsgId.v, serverTime, serverSalt, badTime);
 				badTime = false;
 			}
 			if (res != HandleResult::Success) {
@@ -2043,14 +2137,13 @@ ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpPr
 
 		if (typeId == mtpc_gzip_packed) {
 			DEBUG_LOG(("RPC Info: gzip container"));
-			response = ungzip(++from, end);
+			response = SerializedMessage(ungzip(++from, end));
 			if (!response.size()) {
 				return HandleResult::RestartConnection;
 			}
 			typeId = response[0];
 		} else {
-			response.resize(end - from);
-			memcpy(response.data(), from, (end - from) * sizeof(mtpPrime));
+			response = SerializedMessage(buffer, from, end);
 		}
 		if (typeId != mtpc_rpc_error) {
 			// An error could be some RPC_CALL_FAIL or other error inside
@@ -2103,12 +2196,9 @@ ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpPr
 		}
 		resendMany(toResend, 10, true);
 
-		mtpBuffer update(from - start);
-		if (from > start) memcpy(update.data(), start, (from - start) * sizeof(mtpPrime));
-
 		// Notify main process about new session - need to get difference.
 		QWriteLocker locker(sessionData->haveReceivedMutex());
-		sessionData->haveReceivedUpdates().push_back(SerializedMessage(update));
+		sessionData->haveReceivedUpdates().push_back(SerializedMessage(buffer, start, from));
 	} return HandleResult::Success;
 
 	case mtpc_ping: {
@@ -2160,12 +2250,9 @@ ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpPr
 	}
 
 	if (_dcType == DcType::Regular) {
-		mtpBuffer update(end - from);
-		if (end > from) memcpy(update.data(), from, (end - from) * sizeof(mtpPrime));
-
 		// Notify main process about the new updates.
 		QWriteLocker locker(sessionData->haveReceivedMutex());
-		sessionData->haveReceivedUpdates().push_back(SerializedMessage(update));
+		sessionData->haveReceivedUpdates().push_back(SerializedMessage(buffer, from, end));
 
 		if (cons != mtpc_updatesTooLong
 			&& cons != mtpc_updateShortMessage
@@ -2430,6 +2517,13 @@ void ConnectionPrivate::onConnected(
 		connection.get(),
 		[](const TestConnection &test) { return test.data.get(); });
 	Assert(i != end(_testConnections));
+	_instance->dcOptions()->reportEndpointConnected(
+		i->endpoint,
+		connection->pingTime());
+	InvokeQueued(_instance, [instance = _instance] {
+		instance->endpointStatsChanged();
+	});
+
 	const auto my = i->priority;
 	const auto j = ranges::find_if(
 		_testConnections,
@@ -2441,6 +2535,8 @@ void ConnectionPrivate::onConnected(
 	} else {
 		DEBUG_LOG(("MTP Info: connection through IPv4 succeed."));
 		_waitForBetterTimer.cancel();
+		_startDelayedTestsTimer.cancel();
+		_delayedTestEndpoints.clear();
 		_connection = std::move(i->data);
 		_testConnections.clear();
 
@@ -2451,9 +2547,12 @@ void ConnectionPrivate::onConnected(
 
 void ConnectionPrivate::onDisconnected(
 		not_null<AbstractConnection*> connection) {
+	reportTestConnectionFailed(connection);
 	removeTestConnection(connection);
 
-	if (_testConnections.empty()) {
+	if (_testConnections.empty() && !_delayedTestEndpoints.empty()) {
+		startDelayedTestConnections();
+	} else if (_testConnections.empty()) {
 		destroyAllConnections();
 		restart();
 	} else {
@@ -2479,12 +2578,29 @@ void ConnectionPrivate::confirmBestConnection() {
 	DEBUG_LOG(("MTP Info: can't connect through better, using %1."
 		).arg(i->data->tag()));
 
+	_startDelayedTestsTimer.cancel();
+	_delayedTestEndpoints.clear();
 	_connection = std::move(i->data);
 	_testConnections.clear();
 
 	updateAuthKey();
 }
 
+void ConnectionPrivate::reportTestConnectionFailed(
+		not_null<AbstractConnection*> connection) {
+	const auto i = ranges::find(
+		_testConnections,
+		connection.get(),
+		[](const TestConnection &test) { return test.data.get(); });
+	if (i == end(_testConnections) || i->data->isConnected()) {
+		return;
+	}
+	_instance->dcOptions()->reportEndpointFailed(i->endpoint);
+	InvokeQueued(_instance, [instance = _instance] {
+		instance->endpointStatsChanged();
+	});
+}
+
 void ConnectionPrivate::removeTestConnection(
 		not_null<AbstractConnection*> connection) {
 	_testConnections.erase(
@@ -3019,9 +3135,12 @@ void ConnectionPrivate::onError(
 			instance->badConfigurationError();
 		});
 	}
+	reportTestConnectionFailed(connection);
 	removeTestConnection(connection);
 
-	if (_testConnections.empty()) {
+	if (_testConnections.empty() && !_delayedTestEndpoints.empty()) {
+		startDelayedTestConnections();
+	} else if (_testConnections.empty()) {
 		handleError(errorCode);
 	} else {
 		confirmBestConnection();
@@ -3076,10 +3195,10 @@ bool ConnectionPrivate::readNotSecureResponse(Response &response) {
 		return false;
 	}
 
-	const auto buffer = std::move(_connection->received().front());
+	const auto packet = std::move(_connection->received().front());
 	_connection->received().pop_front();
 
-	const auto answer = _connection->parseNotSecureResponse(buffer);
+	const auto answer = _connection->parseNotSecureResponse(packet.ints());
 	if (answer.empty()) {
 		return false;
 	}
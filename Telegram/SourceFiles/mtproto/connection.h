@@ -146,9 +146,16 @@ public slots:
 	void onCDNConfigLoaded();
 
 private:
+	struct TestEndpoint {
+		DcOptions::Variants::Protocol protocol = DcOptions::Variants::Tcp;
+		QString ip;
+		int port = 0;
+		bytes::vector protocolSecret;
+	};
 	struct TestConnection {
 		ConnectionPointer data;
 		int priority = 0;
+		DcOptions::EndpointKey endpoint;
 	};
 	void connectToServer(bool afterConfig = false);
 	void doDisconnect();
@@ -194,7 +201,7 @@ private:
 		RestartConnection,
 		ResetSession,
 	};
-	HandleResult handleOneReceived(const mtpPrime *from, const mtpPrime *end, uint64 msgId, int32 serverTime, uint64 serverSalt, bool badTime);
+	HandleResult handleOneReceived(const mtpBuffer &buffer, const mtpPrime *from, const mtpPrime *end, uint64 msgId, int32 serverTime, uint64 serverSalt, bool badTime);
 	mtpBuffer ungzip(const mtpPrime *from, const mtpPrime *end) const;
 	void handleMsgsStates(const QVector<MTPlong> &ids, const QByteArray &states, QVector<MTPlong> &acked);
 
@@ -204,11 +211,13 @@ private:
 
 	bytes::vector encryptPQInnerRSA(const MTPP_Q_inner_data &data, const internal::RSAPublicKey &key);
 	std::string encryptClientDHInner(const MTPClient_DH_Inner_Data &data);
+	void startTestConnections(std::vector<TestEndpoint> &&endpoints);
+	void startDelayedTestConnections();
 	void appendTestConnection(
-		DcOptions::Variants::Protocol protocol,
-		const QString &ip,
-		int port,
-		const bytes::vector &protocolSecret);
+		const TestEndpoint &endpoint,
+		bool historicallyBest = false);
+	DcOptions::EndpointKey endpointKey(const TestEndpoint &endpoint) const;
+	void reportTestConnectionFailed(not_null<AbstractConnection*> connection);
 
 	// if badTime received - search for ids in sessionData->haveSent and sessionData->wereAcked and sync time/salt, return true if found
 	bool requestsFixTimeSalt(const QVector<MTPlong> &ids, int32 serverTime, uint64 serverSalt);
@@ -238,6 +247,7 @@ private:
 	not_null<Connection*> _owner;
 	ConnectionPointer _connection;
 	std::vector<TestConnection> _testConnections;
+	std::vector<TestEndpoint> _delayedTestEndpoints;
 	crl::time _startedConnectingAt = 0;
 
 	base::Timer _retryTimer; // exp retry timer
@@ -250,6 +260,7 @@ private:
 	base::Timer _waitForConnectedTimer;
 	base::Timer _waitForReceivedTimer;
 	base::Timer _waitForBetterTimer;
+	base::Timer _startDelayedTestsTimer;
 	crl::time _waitForReceived = 0;
 	crl::time _waitForConnected = 0;
 	crl::time firstSentAt = -1;
@@ -13,6 +13,33 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 
 namespace MTP {
 namespace internal {
+namespace {
+
+std::atomic<int64> ReceivedPackets = 0;
+std::atomic<int64> ReceiveAllocations = 0;
+std::atomic<int64> ReceiveCopiedBytes = 0;
+
+} // namespace
+
+ReceiveBuffersStats GetReceiveBuffersStats() {
+	auto result = ReceiveBuffersStats();
+	result.packets = ReceivedPackets.load();
+	result.allocations = ReceiveAllocations.load();
+	result.copiedBytes = ReceiveCopiedBytes.load();
+	return result;
+}
+
+void CountReceivedPacket() {
+	++ReceivedPackets;
+}
+
+void CountReceiveAllocation() {
+	++ReceiveAllocations;
+}
+
+void CountReceiveCopy(int64 bytes) {
+	ReceiveCopiedBytes += bytes;
+}
 
 ConnectionPointer::ConnectionPointer() = default;
 
@@ -97,9 +124,9 @@ mtpBuffer AbstractConnection::prepareSecurePacket(
 }
 
 gsl::span<const mtpPrime> AbstractConnection::parseNotSecureResponse(
-		const mtpBuffer &buffer) const {
-	const auto answer = buffer.data();
-	const auto len = buffer.size();
+		gsl::span<const mtpPrime> ints) const {
+	const auto answer = ints.data();
+	const auto len = int(ints.size());
 	if (len < 6) {
 		LOG(("Not Secure Error: bad request answer, len = %1"
 			).arg(len * sizeof(mtpPrime)));
@@ -138,8 +165,8 @@ mtpBuffer AbstractConnection::preparePQFake(const MTPint128 &nonce) const {
 }
 
 MTPResPQ AbstractConnection::readPQFakeReply(
-		const mtpBuffer &buffer) const {
-	const auto answer = parseNotSecureResponse(buffer);
+		gsl::span<const mtpPrime> ints) const {
+	const auto answer = parseNotSecureResponse(ints);
 	if (answer.empty()) {
 		throw Exception("bad pq reply");
 	}
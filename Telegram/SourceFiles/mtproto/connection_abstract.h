@@ -16,6 +16,47 @@ struct ConnectionOptions;
 
 class AbstractConnection;
 
+// Memory traffic of the received packets. Each packet should be allocated
+// once and its messages should reach the handlers without more copying.
+struct ReceiveBuffersStats {
+	int64 packets = 0;
+	int64 allocations = 0;
+	int64 copiedBytes = 0;
+};
+
+ReceiveBuffersStats GetReceiveBuffersStats();
+void CountReceivedPacket();
+void CountReceiveAllocation();
+void CountReceiveCopy(int64 bytes);
+
+// A received packet. Large packets are read to a buffer of their own and
+// become the packet itself, the protocol header in front of the data is
+// skipped by the offset instead of shifting the whole packet.
+struct ReceivedPacket {
+	ReceivedPacket() = default;
+	explicit ReceivedPacket(mtpBuffer &&buffer, int offset = 0)
+	: buffer(std::move(buffer))
+	, offset(offset) {
+		Expects(offset >= 0 && offset <= this->buffer.size());
+	}
+
+	int size() const {
+		return buffer.size() - offset;
+	}
+	const mtpPrime *constData() const {
+		return buffer.constData() + offset;
+	}
+	mtpPrime *data() {
+		return buffer.data() + offset;
+	}
+	gsl::span<const mtpPrime> ints() const {
+		return gsl::make_span(constData(), size());
+	}
+
+	mtpBuffer buffer;
+	int offset = 0;
+};
+
 class ConnectionPointer {
 public:
 	ConnectionPointer();
@@ -95,7 +136,7 @@ public:
 		_sentEncrypted = true;
 	}
 
-	using BuffersQueue = std::deque<mtpBuffer>;
+	using BuffersQueue = std::deque<ReceivedPacket>;
 	BuffersQueue &received() {
 		return _receivedQueue;
 	}
@@ -108,7 +149,7 @@ public:
 		uint32 size) const;
 
 	gsl::span<const mtpPrime> parseNotSecureResponse(
-		const mtpBuffer &buffer) const;
+		gsl::span<const mtpPrime> ints) const;
 
 	// Used to emit error(...) with no real code from the server.
 	static constexpr auto kErrorCodeOther = -499;
@@ -131,7 +172,7 @@ protected:
 	// first we always send fake MTPReq_pq to see if connection works at all
 	// we send them simultaneously through TCP/HTTP/IPv4/IPv6 to choose the working one
 	mtpBuffer preparePQFake(const MTPint128 &nonce) const;
-	MTPResPQ readPQFakeReply(const mtpBuffer &buffer) const;
+	MTPResPQ readPQFakeReply(gsl::span<const mtpPrime> ints) const;
 
 };
 
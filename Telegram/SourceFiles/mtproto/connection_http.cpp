@@ -164,11 +164,12 @@ void HttpConnection::requestFinished(QNetworkReply *reply) {
 			emit error(data[0]);
 		} else if (!data.isEmpty()) {
 			if (_status == Status::Ready) {
-				_receivedQueue.push_back(data);
+				_receivedQueue.push_back(ReceivedPacket(std::move(data)));
 				emit receivedData();
 			} else {
 				try {
-					const auto res_pq = readPQFakeReply(data);
+					const auto res_pq = readPQFakeReply(
+						gsl::make_span(data.constData(), data.size()));
 					const auto &data = res_pq.c_resPQ();
 					if (data.vnonce == _checkNonce) {
 						DEBUG_LOG(("Connection Info: "
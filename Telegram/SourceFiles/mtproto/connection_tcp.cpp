@@ -267,10 +267,14 @@ ConnectionPointer TcpConnection::clone(const ProxyData &proxy) {
 	return ConnectionPointer::New<TcpConnection>(thread(), proxy);
 }
 
+bytes::span TcpConnection::currentBuffer() {
+	return _usingLargeBuffer
+		? bytes::make_span(_largeBuffer)
+		: bytes::make_span(_smallBuffer);
+}
+
 void TcpConnection::ensureAvailableInBuffer(int amount) {
-	auto &buffer = _usingLargeBuffer ? _largeBuffer : _smallBuffer;
-	const auto full = bytes::make_span(buffer).subspan(
-		_offsetBytes);
+	const auto full = currentBuffer().subspan(_offsetBytes);
 	if (full.size() >= amount) {
 		return;
 	}
@@ -283,14 +287,16 @@ void TcpConnection::ensureAvailableInBuffer(int amount) {
 		} else {
 			bytes::move(_smallBuffer, read);
 		}
-	} else if (amount <= _largeBuffer.size()) {
+	} else if (amount <= _largeBuffer.size() * sizeof(mtpPrime)) {
 		Assert(_usingLargeBuffer);
-		bytes::move(_largeBuffer, read);
+		bytes::move(bytes::make_span(_largeBuffer), read);
 	} else {
-		auto enough = bytes::vector(amount);
-		bytes::copy(enough, read);
+		auto enough = mtpBuffer((amount + sizeof(mtpPrime) - 1)
+			/ sizeof(mtpPrime));
+		bytes::copy(bytes::make_span(enough), read);
 		_largeBuffer = std::move(enough);
 		_usingLargeBuffer = true;
+		CountReceiveAllocation();
 	}
 	_offsetBytes = 0;
 }
@@ -315,8 +321,7 @@ void TcpConnection::socketRead() {
 			: (kSmallBufferSize - _offsetBytes - _readBytes);
 		Assert(readLimit > 0);
 
-		auto &buffer = _usingLargeBuffer ? _largeBuffer : _smallBuffer;
-		const auto full = bytes::make_span(buffer).subspan(_offsetBytes);
+		const auto full = currentBuffer().subspan(_offsetBytes);
 		const auto free = full.subspan(_readBytes);
 		Assert(free.size() >= readLimit);
 
@@ -333,7 +338,12 @@ void TcpConnection::socketRead() {
 				Assert(readCount <= _leftBytes);
 				_leftBytes -= readCount;
 				if (!_leftBytes) {
-					socketPacket(full.subspan(0, _readBytes));
+					if (_usingLargeBuffer) {
+						Assert(_offsetBytes == 0);
+						socketPacket(parseLargePacket(_readBytes));
+					} else {
+						socketPacket(full.subspan(0, _readBytes));
+					}
 					_usingLargeBuffer = false;
 					_largeBuffer.clear();
 					_offsetBytes = _readBytes = 0;
@@ -414,9 +424,39 @@ mtpBuffer TcpConnection::parsePacket(bytes::const_span bytes) {
 	}
 	auto result = mtpBuffer(ints.size());
 	memcpy(result.data(), ints.data(), ints.size() * sizeof(mtpPrime));
+	CountReceiveAllocation();
+	CountReceiveCopy(ints.size() * sizeof(mtpPrime));
 	return result;
 }
 
+ReceivedPacket TcpConnection::parseLargePacket(int size) {
+	Expects(_usingLargeBuffer);
+
+	auto result = base::take(_largeBuffer);
+	const auto full = bytes::make_span(result).subspan(0, size);
+	const auto packet = _protocol->readPacket(full);
+	const auto intsCount = packet.size() / sizeof(mtpPrime);
+	if (intsCount < 3) {
+		return ReceivedPacket(parsePacket(full));
+	}
+	TCP_LOG(("TCP Info: large packet received, size = %1"
+		).arg(packet.size()));
+
+	// The protocol header is skipped by the offset, so the packet is
+	// neither reallocated nor shifted. All the protocols have headers
+	// of whole ints for such sizes, the shift is only a fallback.
+	const auto offset = packet.data() - full.data();
+	if (offset % sizeof(mtpPrime)) {
+		memmove(result.data(), packet.data(), intsCount * sizeof(mtpPrime));
+		CountReceiveCopy(intsCount * sizeof(mtpPrime));
+		result.resize(intsCount);
+		return ReceivedPacket(std::move(result));
+	}
+	const auto offsetInts = int(offset / sizeof(mtpPrime));
+	result.resize(offsetInts + intsCount);
+	return ReceivedPacket(std::move(result), offsetInts);
+}
+
 void TcpConnection::handleError(QAbstractSocket::SocketError e, QTcpSocket &socket) {
 	switch (e) {
 	case QAbstractSocket::ConnectionRefusedError:
@@ -620,22 +660,27 @@ crl::time TcpConnection::fullConnectTimeout() const {
 void TcpConnection::socketPacket(bytes::const_span bytes) {
 	if (_status == Status::Finished) return;
 
+	socketPacket(ReceivedPacket(parsePacket(bytes)));
+}
+
+void TcpConnection::socketPacket(ReceivedPacket &&data) {
+	if (_status == Status::Finished) return;
+
 	// old quickack?..
-	const auto data = parsePacket(bytes);
 	if (data.size() == 1) {
-		if (data[0] != 0) {
-			emit error(data[0]);
+		if (data.constData()[0] != 0) {
+			emit error(data.constData()[0]);
 		} else {
 			// nop
 		}
 	//} else if (data.size() == 2) {
 		// new quickack?..
 	} else if (_status == Status::Ready) {
-		_receivedQueue.push_back(data);
+		_receivedQueue.push_back(std::move(data));
 		emit receivedData();
 	} else if (_status == Status::Waiting) {
 		try {
-			const auto res_pq = readPQFakeReply(data);
+			const auto res_pq = readPQFakeReply(data.ints());
 			const auto &data = res_pq.c_resPQ();
 			if (data.vnonce == _checkNonce) {
 				DEBUG_LOG(("Connection Info: Valid pq response by TCP."));
@@ -51,12 +51,15 @@ private:
 	void writeConnectionStart();
 
 	void socketPacket(bytes::const_span bytes);
+	void socketPacket(ReceivedPacket &&data);
 
 	void socketConnected();
 	void socketDisconnected();
 	void socketError(QAbstractSocket::SocketError e);
 
 	mtpBuffer parsePacket(bytes::const_span bytes);
+	ReceivedPacket parseLargePacket(int size);
+	bytes::span currentBuffer();
 	void ensureAvailableInBuffer(int amount);
 	static void handleError(QAbstractSocket::SocketError e, QTcpSocket &sock);
 	static uint32 fourCharsToUInt(char ch1, char ch2, char ch3, char ch4) {
@@ -73,7 +76,10 @@ private:
 	int _readBytes = 0;
 	int _leftBytes = 0;
 	bytes::vector _smallBuffer;
-	bytes::vector _largeBuffer;
+
+	// Holds a single packet that didn't fit in the small buffer and
+	// becomes the received packet itself when it is read completely.
+	mtpBuffer _largeBuffer;
 	bool _usingLargeBuffer = false;
 
 	uchar _sendKey[CTRState::KeySize];
@@ -11,6 +11,10 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 namespace MTP {
 namespace {
 
+constexpr auto kMaxEndpointStats = 64;
+constexpr auto kEndpointStatsTTL = TimeId(30 * 86400);
+constexpr auto kRttSmoothFactor = 8;
+
 const char *(PublicRSAKeys[]) = { "\
 -----BEGIN RSA PUBLIC KEY-----\n\
 MIIBCgKCAQEAwVACPi9w23mF3tBkdZz+zwrzKOaaQdr01vAbU4E1pvkfj4sqDsm6\n\
@@ -370,7 +374,7 @@ QByteArray DcOptions::serialize() const {
 		}
 	}
 
-	constexpr auto kVersion = 1;
+	constexpr auto kVersion = 2;
 
 	auto result = QByteArray();
 	result.reserve(size);
@@ -405,10 +409,154 @@ QByteArray DcOptions::serialize() const {
 				<< Serialize::bytes(key.n)
 				<< Serialize::bytes(key.e);
 		}
+
+		// Endpoint connection stats.
+		writeEndpointStats(stream);
 	}
 	return result;
 }
 
+void DcOptions::writeEndpointStats(QDataStream &stream) const {
+	QMutexLocker lock(&_endpointStatsMutex);
+	stream << qint32(_endpointStats.size());
+	for (const auto &[key, stats] : _endpointStats) {
+		stream
+			<< qint32(key.dcId)
+			<< qint32(key.protocol)
+			<< QByteArray::fromStdString(key.ip)
+			<< qint32(key.port)
+			<< QByteArray::fromStdString(key.proxy)
+			<< qint32(stats.successes)
+			<< qint32(stats.failures)
+			<< qint64(stats.rtt)
+			<< qint32(stats.lastSuccess)
+			<< qint32(stats.lastFailure);
+	}
+}
+
+void DcOptions::readEndpointStats(QDataStream &stream) {
+	auto count = qint32(0);
+	stream >> count;
+	if (stream.status() != QDataStream::Ok
+		|| count < 0
+		|| count > kMaxEndpointStats) {
+		LOG(("MTP Error: Bad data for endpoint stats in DcOptions::constructFromSerialized()"));
+		return;
+	}
+
+	auto result = std::map<EndpointKey, EndpointStats>();
+	for (auto i = 0; i != count; ++i) {
+		qint32 dcId = 0, protocol = 0, port = 0;
+		qint32 successes = 0, failures = 0, lastSuccess = 0, lastFailure = 0;
+		qint64 rtt = 0;
+		QByteArray ip, proxy;
+		stream
+			>> dcId
+			>> protocol
+			>> ip
+			>> port
+			>> proxy
+			>> successes
+			>> failures
+			>> rtt
+			>> lastSuccess
+			>> lastFailure;
+		if (stream.status() != QDataStream::Ok
+			|| protocol < 0
+			|| protocol >= Variants::ProtocolCount) {
+			LOG(("MTP Error: Bad data for endpoint stats inside DcOptions::constructFromSerialized()"));
+			return;
+		}
+		auto key = EndpointKey();
+		key.dcId = dcId;
+		key.protocol = static_cast<Variants::Protocol>(protocol);
+		key.ip = ip.toStdString();
+		key.port = port;
+		key.proxy = proxy.toStdString();
+		auto &stats = result[key];
+		stats.successes = successes;
+		stats.failures = failures;
+		stats.rtt = rtt;
+		stats.lastSuccess = lastSuccess;
+		stats.lastFailure = lastFailure;
+	}
+
+	QMutexLocker lock(&_endpointStatsMutex);
+	_endpointStats = std::move(result);
+	pruneEndpointStats();
+}
+
+void DcOptions::pruneEndpointStats() {
+	const auto now = unixtime();
+	const auto lastUsed = [](const EndpointStats &stats) {
+		return std::max(stats.lastSuccess, stats.lastFailure);
+	};
+	for (auto i = begin(_endpointStats); i != end(_endpointStats);) {
+		if (lastUsed(i->second) + kEndpointStatsTTL < now) {
+			i = _endpointStats.erase(i);
+		} else {
+			++i;
+		}
+	}
+	while (_endpointStats.size() > kMaxEndpointStats) {
+		const auto oldest = ranges::min_element(
+			_endpointStats,
+			std::less<>(),
+			[&](const auto &pair) { return lastUsed(pair.second); });
+		_endpointStats.erase(oldest);
+	}
+}
+
+void DcOptions::reportEndpointConnected(
+		const EndpointKey &key,
+		crl::time rtt) {
+	QMutexLocker lock(&_endpointStatsMutex);
+	auto &stats = _endpointStats[key];
+	++stats.successes;
+	stats.rtt = stats.rtt
+		? ((stats.rtt * (kRttSmoothFactor - 1) + rtt) / kRttSmoothFactor)
+		: rtt;
+	stats.lastSuccess = unixtime();
+	pruneEndpointStats();
+}
+
+void DcOptions::reportEndpointFailed(const EndpointKey &key) {
+	QMutexLocker lock(&_endpointStatsMutex);
+	auto &stats = _endpointStats[key];
+	++stats.failures;
+	stats.lastFailure = unixtime();
+	pruneEndpointStats();
+}
+
+auto DcOptions::endpointStats(const EndpointKey &key) const
+-> EndpointStats {
+	QMutexLocker lock(&_endpointStatsMutex);
+	const auto i = _endpointStats.find(key);
+	return (i != end(_endpointStats)) ? i->second : EndpointStats();
+}
+
+QString DcOptions::endpointStatsDump() const {
+	QMutexLocker lock(&_endpointStatsMutex);
+	auto result = QStringList();
+	for (const auto &[key, stats] : _endpointStats) {
+		result.push_back(qsl("dc %1 %2 %3:%4%5 - ok %6, failed %7, "
+			"rtt %8ms, last ok %9, last failed %10"
+			).arg(key.dcId
+			).arg((key.protocol == Variants::Tcp) ? "tcp" : "http"
+			).arg(QString::fromStdString(key.ip)
+			).arg(key.port
+			).arg(key.proxy.empty()
+				? QString()
+				: (" via " + QString::fromStdString(key.proxy))
+			).arg(stats.successes
+			).arg(stats.failures
+			).arg(stats.rtt
+			).arg(stats.lastSuccess
+			).arg(stats.lastFailure));
+	}
+	return result.join('\n');
+}
+
 void DcOptions::constructFromSerialized(const QByteArray &serialized) {
 	QDataStream stream(serialized);
 	stream.setVersion(QDataStream::Qt_5_1);
@@ -499,6 +647,11 @@ void DcOptions::constructFromSerialized(const QByteArray &serialized) {
 			}
 		}
 	}
+
+	// Read endpoint connection stats
+	if (version > 1 && !stream.atEnd()) {
+		readEndpointStats(stream);
+	}
 }
 
 DcOptions::Ids DcOptions::configEnumDcIds() const {
@@ -84,6 +84,38 @@ public:
 	Variants lookup(DcId dcId, DcType type, bool throughProxy) const;
 	DcType dcType(ShiftedDcId shiftedDcId) const;
 
+	// Connection history of a single endpoint, used to rank the
+	// endpoints when connecting. Proxy is empty for direct connections.
+	struct EndpointKey {
+		DcId dcId = 0;
+		Variants::Protocol protocol = Variants::Tcp;
+		std::string ip;
+		int port = 0;
+		std::string proxy;
+
+		inline bool operator<(const EndpointKey &other) const {
+			return std::tie(dcId, protocol, ip, port, proxy)
+				< std::tie(
+					other.dcId,
+					other.protocol,
+					other.ip,
+					other.port,
+					other.proxy);
+		}
+	};
+	struct EndpointStats {
+		int successes = 0;
+		int failures = 0;
+		crl::time rtt = 0; // Smoothed connect time.
+		TimeId lastSuccess = 0;
+		TimeId lastFailure = 0;
+	};
+	// Thread safe.
+	void reportEndpointConnected(const EndpointKey &key, crl::time rtt);
+	void reportEndpointFailed(const EndpointKey &key);
+	EndpointStats endpointStats(const EndpointKey &key) const;
+	QString endpointStatsDump() const;
+
 	void setCDNConfig(const MTPDcdnConfig &config);
 	bool hasCDNKeysForDc(DcId dcId) const;
 	bool getDcRSAKey(DcId dcId, const QVector<MTPlong> &fingerprints, internal::RSAPublicKey *result) const;
@@ -116,6 +148,10 @@ private:
 
 	void readBuiltInPublicKeys();
 
+	void writeEndpointStats(QDataStream &stream) const;
+	void readEndpointStats(QDataStream &stream);
+	void pruneEndpointStats();
+
 	class WriteLocker;
 	friend class WriteLocker;
 
@@ -128,6 +164,9 @@ private:
 	std::map<DcId, std::map<uint64, internal::RSAPublicKey>> _cdnPublicKeys;
 	mutable QReadWriteLock _useThroughLockers;
 
+	std::map<EndpointKey, EndpointStats> _endpointStats;
+	mutable QMutex _endpointStatsMutex;
+
 	mutable base::Observable<Ids> _changed;
 
 	// True when we have overriden options from a .tdesktop-endpoints file.
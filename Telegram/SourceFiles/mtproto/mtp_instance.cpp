@@ -32,6 +32,7 @@ namespace {
 
 constexpr auto kConfigBecomesOldIn = 2 * 60 * crl::time(1000);
 constexpr auto kConfigBecomesOldForBlockedIn = 8 * crl::time(1000);
+constexpr auto kWriteEndpointStatsDelay = 30 * crl::time(1000);
 
 } // namespace
 
@@ -62,6 +63,7 @@ public:
 	void requestCDNConfig();
 	void setUserPhone(const QString &phone);
 	void badConfigurationError();
+	void endpointStatsChanged();
 
 	void restart();
 	void restart(ShiftedDcId shiftedDcId);
@@ -225,6 +227,7 @@ private:
 	Fn<void(ShiftedDcId shiftedDcId)> _sessionResetHandler;
 
 	base::Timer _checkDelayedTimer;
+	base::Timer _writeEndpointStatsTimer;
 
 	// Debug flag to find out how we end up crashing.
 	bool MustNotCreateSessions = false;
@@ -291,6 +294,7 @@ void Instance::Private::start(Config &&config) {
 	}
 
 	_checkDelayedTimer.setCallback([this] { checkDelayedRequests(); });
+	_writeEndpointStatsTimer.setCallback([] { Local::writeSettings(); });
 
 	Assert((_mainDcId == Config::kNoneMainDc) == isKeysDestroyer());
 	requestConfig();
@@ -438,6 +442,13 @@ void Instance::Private::requestConfigIfOld() {
 	}
 }
 
+void Instance::Private::endpointStatsChanged() {
+	// Only the main instance options are written to the settings.
+	if (isNormal() && !_writeEndpointStatsTimer.isActive()) {
+		_writeEndpointStatsTimer.callOnce(kWriteEndpointStatsDelay);
+	}
+}
+
 void Instance::Private::requestConfigIfExpired() {
 	const auto requestIn = (_configExpiresAt - crl::now());
 	if (requestIn > 0) {
@@ -1590,6 +1601,10 @@ void Instance::requestConfigIfOld() {
 	_private->requestConfigIfOld();
 }
 
+void Instance::endpointStatsChanged() {
+	_private->endpointStatsChanged();
+}
+
 void Instance::requestCDNConfig() {
 	_private->requestCDNConfig();
 }
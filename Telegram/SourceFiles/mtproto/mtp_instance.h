@@ -179,6 +179,7 @@ public:
 	void requestCDNConfig();
 	void setUserPhone(const QString &phone);
 	void badConfigurationError();
+	void endpointStatsChanged();
 
 	~Instance();
 
@@ -95,15 +95,45 @@ private:
 
 };
 
-using SerializedMessage = mtpBuffer;
+// A received message body, usually a slice of the whole decrypted packet.
+// It shares the packet memory, so large responses (like upload.getFile
+// parts) are handed to the handlers without being copied.
+class SerializedMessage {
+public:
+	SerializedMessage() = default;
+	explicit SerializedMessage(mtpBuffer &&buffer)
+	: _buffer(std::move(buffer))
+	, _size(_buffer.size()) {
+	}
+	SerializedMessage(
+		const mtpBuffer &buffer,
+		const mtpPrime *from,
+		const mtpPrime *end)
+	: _buffer(buffer)
+	, _offset(from - buffer.constData())
+	, _size(end - from) {
+		Expects(_offset >= 0 && _size >= 0);
+		Expects(_offset + _size <= _buffer.size());
+	}
 
-inline bool ResponseNeedsAck(const SerializedMessage &response) {
-	if (response.size() < 8) {
-		return false;
+	const mtpPrime *constData() const {
+		return _buffer.constData() + _offset;
 	}
-	auto seqNo = *(uint32*)(response.constData() + 6);
-	return (seqNo & 0x01) ? true : false;
-}
+	int size() const {
+		return _size;
+	}
+	mtpPrime operator[](int index) const {
+		Expects(index >= 0 && index < _size);
+
+		return constData()[index];
+	}
+
+private:
+	mtpBuffer _buffer;
+	int _offset = 0;
+	int _size = 0;
+
+};
 
 struct ConnectionOptions {
 	ConnectionOptions() = default;
@@ -17,11 +17,15 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "core/application.h"
 #include "mtproto/mtp_instance.h"
 #include "mtproto/dc_options.h"
+#include "mtproto/connection_abstract.h"
 #include "core/file_utilities.h"
 #include "core/update_checker.h"
 #include "window/themes/window_theme.h"
 #include "window/themes/window_theme_editor.h"
 #include "media/audio/media_audio_track.h"
+#include "media/streaming/media_streaming_utility.h"
+#include "media/streaming/media_streaming_benchmark.h"
+#include "chat_helpers/stickers_emoji_index.h"
 
 namespace Settings {
 
@@ -113,6 +117,73 @@ auto GenerateCodes() {
 			}
 		});
 	});
+	codes.emplace(qsl("dcstats"), [] {
+		const auto endpoints = Core::App().dcOptions()->endpointStatsDump();
+		const auto buffers = MTP::internal::GetReceiveBuffersStats();
+		const auto dump = (endpoints.isEmpty()
+			? qsl("No DC endpoint stats collected yet.")
+			: endpoints)
+			+ qsl("\nreceived packets %1, allocations %2, copied bytes %3"
+			).arg(buffers.packets
+			).arg(buffers.allocations
+			).arg(buffers.copiedBytes);
+		LOG(("DC endpoint stats:\n%1").arg(dump));
+		QApplication::clipboard()->setText(dump);
+		Ui::show(Box<InformBox>(qsl("DC endpoint stats were copied "
+			"to clipboard and written to 'log.txt'.")));
+	});
+	codes.emplace(qsl("framestats"), [] {
+		const auto dump = anim::FrameStatsDump();
+		LOG(("Animation frame stats:\n%1").arg(dump));
+		QApplication::clipboard()->setText(dump);
+		Ui::show(Box<InformBox>(qsl("Animation frame stats "
+			"were copied to clipboard and written to 'log.txt'.")));
+	});
+	codes.emplace(qsl("convertbench"), [] {
+		Ui::Toast::Show("Frame conversion benchmark started.");
+		crl::async([] {
+			auto report = Media::Streaming::BenchmarkFrameConversion();
+			crl::on_main([report = std::move(report)] {
+				LOG(("Frame conversion benchmark:\n%1").arg(report));
+				QApplication::clipboard()->setText(report);
+				Ui::show(Box<InformBox>(qsl("Frame conversion benchmark "
+					"results were copied to clipboard "
+					"and written to 'log.txt'.")));
+			});
+		});
+	});
+	codes.emplace(qsl("streamingbench"), [] {
+		if (!AuthSession::Exists()) {
+			return;
+		}
+		FileDialog::GetOpenPath(Core::App().getFileDialogParent(), "Open video file", FileDialog::AllFilesFilter(), [](const FileDialog::OpenResult &result) {
+			if (!AuthSession::Exists() || result.paths.isEmpty()) {
+				return;
+			}
+			Ui::Toast::Show("Streaming benchmark started.");
+			Media::Streaming::BenchmarkPlayback(
+				&Auth().data(),
+				result.paths.front(),
+				[](QString report) {
+					LOG(("Streaming benchmark:\n%1").arg(report));
+					QApplication::clipboard()->setText(report);
+					Ui::show(Box<InformBox>(qsl("Streaming benchmark "
+						"results were copied to clipboard "
+						"and written to 'log.txt'.")));
+				});
+		});
+	});
+	codes.emplace(qsl("stickersbench"), [] {
+		if (!AuthSession::Exists()) {
+			return;
+		}
+		const auto report = Stickers::BenchmarkEmojiIndex();
+		LOG(("Stickers emoji index benchmark:\n%1").arg(report));
+		QApplication::clipboard()->setText(report);
+		Ui::show(Box<InformBox>(qsl("Stickers emoji index benchmark "
+			"results were copied to clipboard "
+			"and written to 'log.txt'.")));
+	});
 	codes.emplace(qsl("registertg"), [] {
 		Platform::RegisterCustomScheme();
 		Ui::Toast::Show("Forced custom scheme register.");
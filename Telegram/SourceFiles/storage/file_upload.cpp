@@ -8,6 +8,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 
 #include "storage/localimageloader.h"
 #include "storage/file_download.h"
+#include "storage/storage_upload_source.h"
 #include "mtproto/connection.h" // for MTP::kAckSendWaiting
 #include "data/data_document.h"
 #include "data/data_photo.h"
@@ -62,9 +63,7 @@ struct Uploader::File {
 	uint64 thumbId() const;
 	const QString &filename() const;
 
-	HashMd5 md5Hash;
-
-	std::unique_ptr<QFile> docFile;
+	std::unique_ptr<UploadSource> docSource;
 	int32 docSentParts = 0;
 	int32 docSize = 0;
 	int32 docPartSize = 0;
@@ -332,8 +331,14 @@ void Uploader::sendNext() {
 				} else if (uploadingData.type() == SendMediaType::File
 					|| uploadingData.type() == SendMediaType::WallPaper
 					|| uploadingData.type() == SendMediaType::Audio) {
-					QByteArray docMd5(32, Qt::Uninitialized);
-					hashMd5Hex(uploadingData.md5Hash.result(), docMd5.data());
+					if (uploadingData.docSource
+						&& !uploadingData.docSource->md5Ready()) {
+						// Will be called again when the hash is ready.
+						return;
+					}
+					const auto docMd5 = uploadingData.docSource
+						? uploadingData.docSource->md5Hex()
+						: QByteArray(hashMd5Hex(nullptr, 0).data(), 32);
 
 					const auto file = (uploadingData.docSize > kUseBigFilesFrom)
 						? MTP_inputFileBig(
@@ -378,35 +383,41 @@ void Uploader::sendNext() {
 			return;
 		}
 
-		auto &content = uploadingData.file
-			? uploadingData.file->content
-			: uploadingData.media.data;
-		QByteArray toSend;
-		if (content.isEmpty()) {
-			if (!uploadingData.docFile) {
+		if (!uploadingData.docSource) {
+			const auto &content = uploadingData.file
+				? uploadingData.file->content
+				: uploadingData.media.data;
+			const auto computeMd5 = (uploadingData.docSize <= kUseBigFilesFrom);
+			if (content.isEmpty()) {
 				const auto filepath = uploadingData.file
 					? uploadingData.file->filepath
 					: uploadingData.media.file;
-				uploadingData.docFile = std::make_unique<QFile>(filepath);
-				if (!uploadingData.docFile->open(QIODevice::ReadOnly)) {
-					currentFailed();
-					return;
-				}
-			}
-			toSend = uploadingData.docFile->read(uploadingData.docPartSize);
-			if (uploadingData.docSize <= kUseBigFilesFrom) {
-				uploadingData.md5Hash.feed(toSend.constData(), toSend.size());
+				uploadingData.docSource = std::make_unique<UploadSource>(
+					filepath,
+					uploadingData.docPartSize,
+					computeMd5);
+			} else {
+				uploadingData.docSource = std::make_unique<UploadSource>(
+					content,
+					uploadingData.docPartSize,
+					computeMd5);
 			}
-		} else {
-			const auto offset = uploadingData.docSentParts
-				* uploadingData.docPartSize;
-			toSend = content.mid(offset, uploadingData.docPartSize);
-			if ((uploadingData.type() == SendMediaType::File
-				|| uploadingData.type() == SendMediaType::WallPaper
-				|| uploadingData.type() == SendMediaType::Audio)
-				&& uploadingData.docSentParts <= kUseBigFilesFrom) {
-				uploadingData.md5Hash.feed(toSend.constData(), toSend.size());
+			uploadingData.docSource->setReadyCallback([=] { sendNext(); });
+		}
+		if (uploadingData.docSource->failed()) {
+			currentFailed();
+			return;
+		}
+
+		// A view over the source memory, it must not outlive this call.
+		const auto toSend = uploadingData.docSource->takePart(
+			uploadingData.docSentParts);
+		if (toSend.isNull()) {
+			if (uploadingData.docSource->failed()) {
+				currentFailed();
 			}
+			// Otherwise will be called again when the part is read.
+			return;
 		}
 		if ((toSend.size() > uploadingData.docPartSize)
 			|| ((toSend.size() < uploadingData.docPartSize
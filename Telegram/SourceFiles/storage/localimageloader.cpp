@@ -85,6 +85,22 @@ bool FileThumbnailUploadRequired(const QString &filemime, int32 filesize) {
 			== end(kThumbnailKnownMimes));
 }
 
+// Splits the data to upload parts and computes its md5 in the same pass.
+void PrepareUploadParts(
+		const QByteArray &data,
+		UploadFileParts &parts,
+		QByteArray &md5) {
+	auto hash = HashMd5();
+	const auto size = data.size();
+	for (int32 i = 0, part = 0; i < size; i += kPhotoUploadPartSize, ++part) {
+		const auto length = std::min(size - i, int32(kPhotoUploadPartSize));
+		parts.insert(part, data.mid(i, length));
+		hash.feed(data.constData() + i, length);
+	}
+	md5.resize(32);
+	hashMd5Hex(hash.result(), md5.data());
+}
+
 PreparedFileThumbnail FinalizeFileThumbnail(
 		PreparedFileThumbnail &&prepared,
 		const QString &filemime,
@@ -164,12 +180,7 @@ SendMediaReady::SendMediaReady(
 , document(document)
 , photoThumbs(photoThumbs) {
 	if (!jpeg.isEmpty()) {
-		int32 size = jpeg.size();
-		for (int32 i = 0, part = 0; i < size; i += kPhotoUploadPartSize, ++part) {
-			parts.insert(part, jpeg.mid(i, kPhotoUploadPartSize));
-		}
-		jpeg_md5.resize(32);
-		hashMd5Hex(jpeg.constData(), jpeg.size(), jpeg_md5.data());
+		PrepareUploadParts(jpeg, parts, jpeg_md5);
 	}
 }
 
@@ -298,7 +309,8 @@ SendMediaReady PrepareWallPaper(const QImage &image) {
 		0);
 }
 
-TaskQueue::TaskQueue(crl::time stopTimeoutMs) {
+TaskQueue::TaskQueue(crl::time stopTimeoutMs, int threadsCount)
+: _threadsCount(std::max(threadsCount, 1)) {
 	if (stopTimeoutMs > 0) {
 		_stopTimer = new QTimer(this);
 		connect(_stopTimer, SIGNAL(timeout()), this, SLOT(stop()));
@@ -309,12 +321,13 @@ TaskQueue::TaskQueue(crl::time stopTimeoutMs) {
 
 TaskId TaskQueue::addTask(std::unique_ptr<Task> &&task) {
 	const auto result = task->id();
+	_tasksOrder.push_back(result);
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
 		_tasksToProcess.push_back(std::move(task));
 	}
 
-	wakeThread();
+	wakeThreads();
 
 	return result;
 }
@@ -323,24 +336,28 @@ void TaskQueue::addTasks(std::vector<std::unique_ptr<Task>> &&tasks) {
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
 		for (auto &task : tasks) {
+			_tasksOrder.push_back(task->id());
 			_tasksToProcess.push_back(std::move(task));
 		}
 	}
 
-	wakeThread();
+	wakeThreads();
 }
 
-void TaskQueue::wakeThread() {
-	if (!_thread) {
-		_thread = new QThread();
-
-		_worker = new TaskQueueWorker(this);
-		_worker->moveToThread(_thread);
+void TaskQueue::wakeThreads() {
+	if (_threads.empty()) {
+		for (auto i = 0; i != _threadsCount; ++i) {
+			const auto thread = new QThread();
+			const auto worker = new TaskQueueWorker(this);
+			worker->moveToThread(thread);
 
-		connect(this, SIGNAL(taskAdded()), _worker, SLOT(onTaskAdded()));
-		connect(_worker, SIGNAL(taskProcessed()), this, SLOT(onTaskProcessed()));
+			connect(this, SIGNAL(taskAdded()), worker, SLOT(onTaskAdded()));
+			connect(worker, SIGNAL(taskProcessed()), this, SLOT(onTaskProcessed()));
 
-		_thread->start();
+			thread->start();
+			_threads.push_back(thread);
+			_workers.push_back(worker);
+		}
 	}
 	if (_stopTimer) _stopTimer->stop();
 	emit taskAdded();
@@ -356,49 +373,75 @@ void TaskQueue::cancelTask(TaskId id) {
 			queue.erase(i);
 		}
 	};
+	const auto i = ranges::find(_tasksOrder, id);
+	if (i != _tasksOrder.end()) {
+		_tasksOrder.erase(i);
+	}
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
 		removeFrom(_tasksToProcess);
-		if (_taskInProcessId == id) {
-			_taskInProcessId = TaskId();
-		}
+		_tasksInProcess.remove(id);
+	}
+	{
+		QMutexLocker lock(&_tasksToFinishMutex);
+		removeFrom(_tasksToFinish);
 	}
-	QMutexLocker lock(&_tasksToFinishMutex);
-	removeFrom(_tasksToFinish);
+
+	// Some of the following tasks could wait for the cancelled one.
+	onTaskProcessed();
 }
 
 void TaskQueue::onTaskProcessed() {
-	do {
+	const auto proj = [](const std::unique_ptr<Task> &task) {
+		return task->id();
+	};
+	while (!_tasksOrder.empty()) {
 		auto task = std::unique_ptr<Task>();
 		{
 			QMutexLocker lock(&_tasksToFinishMutex);
-			if (_tasksToFinish.empty()) break;
-			task = std::move(_tasksToFinish.front());
-			_tasksToFinish.pop_front();
+			const auto i = ranges::find(
+				_tasksToFinish,
+				_tasksOrder.front(),
+				proj);
+			if (i == _tasksToFinish.end()) {
+				break;
+			}
+			task = std::move(*i);
+			_tasksToFinish.erase(i);
 		}
+		_tasksOrder.pop_front();
 		task->finish();
-	} while (true);
+	}
 
 	if (_stopTimer) {
 		QMutexLocker lock(&_tasksToProcessMutex);
-		if (_tasksToProcess.empty() && !_taskInProcessId) {
+		if (_tasksToProcess.empty() && _tasksInProcess.empty()) {
 			_stopTimer->start();
 		}
 	}
 }
 
 void TaskQueue::stop() {
-	if (_thread) {
-		_thread->requestInterruption();
-		_thread->quit();
+	if (!_threads.empty()) {
+		for (const auto thread : _threads) {
+			thread->requestInterruption();
+			thread->quit();
+		}
 		DEBUG_LOG(("Waiting for taskThread to finish"));
-		_thread->wait();
-		delete base::take(_worker);
-		delete base::take(_thread);
+		for (const auto thread : _threads) {
+			thread->wait();
+		}
+		for (const auto worker : base::take(_workers)) {
+			delete worker;
+		}
+		for (const auto thread : base::take(_threads)) {
+			delete thread;
+		}
 	}
 	_tasksToProcess.clear();
 	_tasksToFinish.clear();
-	_taskInProcessId = TaskId();
+	_tasksInProcess.clear();
+	_tasksOrder.clear();
 }
 
 TaskQueue::~TaskQueue() {
@@ -418,7 +461,7 @@ void TaskQueueWorker::onTaskAdded() {
 			if (!_queue->_tasksToProcess.empty()) {
 				task = std::move(_queue->_tasksToProcess.front());
 				_queue->_tasksToProcess.pop_front();
-				_queue->_taskInProcessId = task->id();
+				_queue->_tasksInProcess.emplace(task->id());
 			}
 		}
 
@@ -427,18 +470,20 @@ void TaskQueueWorker::onTaskAdded() {
 			bool emitTaskProcessed = false;
 			{
 				QMutexLocker lockToProcess(&_queue->_tasksToProcessMutex);
-				if (_queue->_taskInProcessId == task->id()) {
-					_queue->_taskInProcessId = TaskId();
-					someTasksLeft = !_queue->_tasksToProcess.empty();
-
+				someTasksLeft = !_queue->_tasksToProcess.empty();
+				if (_queue->_tasksInProcess.remove(task->id())) {
+					// With several workers the finished task may wait for
+					// an earlier one, so always notify the queue.
 					QMutexLocker lockToFinish(&_queue->_tasksToFinishMutex);
-					emitTaskProcessed = _queue->_tasksToFinish.empty();
 					_queue->_tasksToFinish.push_back(std::move(task));
+					emitTaskProcessed = true;
 				}
 			}
 			if (emitTaskProcessed) {
 				emit taskProcessed();
 			}
+		} else {
+			someTasksLeft = false;
 		}
 		QCoreApplication::processEvents();
 	} while (someTasksLeft && !thread()->isInterruptionRequested());
@@ -505,22 +550,13 @@ void FileLoadResult::setFileData(const QByteArray &filedata) {
 		partssize = 0;
 	} else {
 		partssize = filedata.size();
-		for (int32 i = 0, part = 0; i < partssize; i += kPhotoUploadPartSize, ++part) {
-			fileparts.insert(part, filedata.mid(i, kPhotoUploadPartSize));
-		}
-		filemd5.resize(32);
-		hashMd5Hex(filedata.constData(), filedata.size(), filemd5.data());
+		PrepareUploadParts(filedata, fileparts, filemd5);
 	}
 }
 
 void FileLoadResult::setThumbData(const QByteArray &thumbdata) {
 	if (!thumbdata.isEmpty()) {
-		int32 size = thumbdata.size();
-		for (int32 i = 0, part = 0; i < size; i += kPhotoUploadPartSize, ++part) {
-			thumbparts.insert(part, thumbdata.mid(i, kPhotoUploadPartSize));
-		}
-		thumbmd5.resize(32);
-		hashMd5Hex(thumbdata.constData(), thumbdata.size(), thumbmd5.data());
+		PrepareUploadParts(thumbdata, thumbparts, thumbmd5);
 	}
 }
 
@@ -104,7 +104,10 @@ class TaskQueue : public QObject {
 	Q_OBJECT
 
 public:
-	explicit TaskQueue(crl::time stopTimeoutMs = 0); // <= 0 - never stop worker
+	// stopTimeoutMs <= 0 - never stop workers.
+	// Tasks are processed by up to threadsCount workers in parallel,
+	// but finish() is always called in the order tasks were added.
+	explicit TaskQueue(crl::time stopTimeoutMs = 0, int threadsCount = 1);
 
 	TaskId addTask(std::unique_ptr<Task> &&task);
 	void addTasks(std::vector<std::unique_ptr<Task>> &&tasks);
@@ -122,14 +125,16 @@ public slots:
 private:
 	friend class TaskQueueWorker;
 
-	void wakeThread();
+	void wakeThreads();
 
 	std::deque<std::unique_ptr<Task>> _tasksToProcess;
 	std::deque<std::unique_ptr<Task>> _tasksToFinish;
-	TaskId _taskInProcessId = TaskId();
+	base::flat_set<TaskId> _tasksInProcess;
+	std::deque<TaskId> _tasksOrder; // accessed only from the main thread
 	QMutex _tasksToProcessMutex, _tasksToFinishMutex;
-	QThread *_thread = nullptr;
-	TaskQueueWorker *_worker = nullptr;
+	int _threadsCount = 1;
+	std::vector<QThread*> _threads;
+	std::vector<TaskQueueWorker*> _workers;
 	QTimer *_stopTimer = nullptr;
 
 };
@@ -20,6 +20,8 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "export/export_settings.h"
 #include "core/crash_reports.h"
 #include "core/update_checker.h"
+#include "core/startup_scheduler.h"
+#include "core/startup_trace.h"
 #include "observer_peer.h"
 #include "mainwidget.h"
 #include "mainwindow.h"
@@ -90,6 +92,15 @@ bool _started = false;
 internal::Manager *_manager = nullptr;
 TaskQueue *_localLoader = nullptr;
 
+struct PrefetchedFile {
+	int32 version = 0;
+	QByteArray data;
+	qint64 position = 0;
+};
+
+// Files decrypted by prefetchStartupFiles(), used on the main thread only.
+std::map<FileKey, PrefetchedFile> PrefetchedFiles;
+
 bool _working() {
 	return _manager && !_basePath.isEmpty();
 }
@@ -136,6 +147,7 @@ FileKey genKey(FileOptions options = FileOption::User | FileOption::Safe) {
 }
 
 void clearKey(const FileKey &key, FileOptions options = FileOption::User | FileOption::Safe) {
+	PrefetchedFiles.erase(key);
 	if (options & FileOption::User) {
 		if (!_userWorking()) return;
 	} else {
@@ -230,6 +242,7 @@ struct EncryptedDescriptor {
 
 struct FileWriteDescriptor {
 	FileWriteDescriptor(const FileKey &key, FileOptions options = FileOption::User | FileOption::Safe) {
+		PrefetchedFiles.erase(key);
 		init(toFilePart(key), options);
 	}
 	FileWriteDescriptor(const QString &name, FileOptions options = FileOption::User | FileOption::Safe) {
@@ -399,6 +412,7 @@ bool readFile(FileReadDescriptor &result, const QString &name, FileOptions optio
 
 		// read data
 		QByteArray bytes = f.read(f.size());
+		Core::StartupTrace::AddReadBytes(tdfMagicLen + sizeof(version) + bytes.size());
 		int32 dataSize = bytes.size() - 16;
 		if (dataSize < 0) {
 			DEBUG_LOG(("App Info: bad file '%1', could not read sign part").arg(name));
@@ -501,7 +515,29 @@ bool readEncryptedFile(FileReadDescriptor &result, const QString &name, FileOpti
 	return true;
 }
 
+bool takePrefetchedFile(FileReadDescriptor &result, const FileKey &fkey) {
+	const auto i = PrefetchedFiles.find(fkey);
+	if (i == end(PrefetchedFiles)) {
+		return false;
+	}
+	auto file = std::move(i->second);
+	PrefetchedFiles.erase(i);
+
+	result.version = file.version;
+	result.data = std::move(file.data);
+	result.buffer.setBuffer(&result.data);
+	result.buffer.open(QIODevice::ReadOnly);
+	result.buffer.seek(file.position);
+	result.stream.setDevice(&result.buffer);
+	result.stream.setVersion(QDataStream::Qt_5_1);
+
+	return true;
+}
+
 bool readEncryptedFile(FileReadDescriptor &result, const FileKey &fkey, FileOptions options = FileOption::User | FileOption::Safe, const MTP::AuthKeyPtr &key = LocalKey) {
+	if (key == LocalKey && takePrefetchedFile(result, fkey)) {
+		return true;
+	}
 	return readEncryptedFile(result, toFilePart(fkey), options, key);
 }
 
@@ -2858,6 +2894,7 @@ void reset() {
 	_cacheBigFileTotalSizeLimit = Database::Settings().totalSizeLimit;
 	_cacheBigFileTotalTimeLimit = Database::Settings().totalTimeLimit;
 	StoredAuthSessionCache.reset();
+	PrefetchedFiles.clear();
 	_mapChanged = true;
 	_writeMap(WriteMapWhen::Now);
 
@@ -3877,6 +3914,50 @@ void importOldRecentStickers() {
 	_writeMap();
 }
 
+void prefetchStartupFiles() {
+	const auto keys = {
+		std::make_pair("read saved peers", _savedPeersKey),
+		std::make_pair("read installed stickers", _installedStickersKey),
+		std::make_pair("read featured stickers", _featuredStickersKey),
+		std::make_pair("read recent stickers", _recentStickersKey),
+		std::make_pair("read faved stickers", _favedStickersKey),
+		std::make_pair("read saved gifs", _savedGifsKey),
+	};
+	auto files = std::vector<std::pair<FileKey, PrefetchedFile>>();
+	files.reserve(keys.size());
+	for (const auto &[name, key] : keys) {
+		if (key) {
+			files.emplace_back(key, PrefetchedFile());
+		}
+	}
+
+	// Each worker fills only its own entry, the vector is not resized.
+	auto scheduler = Core::StartupScheduler();
+	auto index = 0;
+	for (const auto &[name, key] : keys) {
+		if (!key) {
+			continue;
+		}
+		const auto file = &files[index++];
+		scheduler.add(name, {}, Core::StartupScheduler::Thread::Worker, [=] {
+			FileReadDescriptor read;
+			if (!readEncryptedFile(read, toFilePart(file->first))) {
+				return;
+			}
+			file->second.version = read.version;
+			file->second.data = read.data;
+			file->second.position = read.buffer.pos();
+		});
+	}
+	scheduler.run();
+
+	for (auto &[key, file] : files) {
+		if (file.version) {
+			PrefetchedFiles[key] = std::move(file);
+		}
+	}
+}
+
 void readInstalledStickers() {
 	if (!_installedStickersKey) {
 		return importOldRecentStickers();
@@ -126,6 +126,10 @@ void countVoiceWaveform(DocumentData *document);
 
 void cancelTask(TaskId id);
 
+// Reads and decrypts the sticker sets, saved gifs and saved peers
+// on worker threads, the next reads of them don't touch the disk.
+void prefetchStartupFiles();
+
 void writeInstalledStickers();
 void writeFeaturedStickers();
 void writeRecentStickers();
@@ -0,0 +1,256 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#include "storage/storage_upload_source.h"
+
+namespace Storage {
+namespace {
+
+constexpr auto kReadAheadParts = 8;
+
+} // namespace
+
+struct UploadSource::State {
+	enum class Mode {
+		Content,
+		Reading,
+	};
+
+	static void NotifyReady(std::shared_ptr<State> state);
+
+	void finishMd5();
+
+	Mode mode = Mode::Content;
+	QFile file;
+	qint64 size = 0;
+	bool computeMd5 = false;
+
+	// Fed from a single thread at a time: the main thread in the content
+	// mode and the reader otherwise.
+	HashMd5 md5;
+
+	std::atomic<bool> cancelled = false;
+	std::atomic<bool> failed = false;
+
+	// Guarded by the mutex.
+	QMutex mutex;
+	QByteArray md5Hex;
+	bool md5Done = false;
+	std::deque<QByteArray> parts;
+	int firstPartIndex = 0;
+	bool reading = false;
+	bool finished = false;
+	bool waiting = false;
+
+	// Accessed only from the main thread.
+	Fn<void()> readyCallback;
+
+};
+
+void UploadSource::State::finishMd5() {
+	auto result = QByteArray(32, Qt::Uninitialized);
+	hashMd5Hex(md5.result(), result.data());
+
+	QMutexLocker lock(&mutex);
+	md5Hex = std::move(result);
+	md5Done = true;
+}
+
+void UploadSource::State::NotifyReady(std::shared_ptr<State> state) {
+	crl::on_main([state = std::move(state)] {
+		if (!state->cancelled && state->readyCallback) {
+			state->readyCallback();
+		}
+	});
+}
+
+UploadSource::UploadSource(
+	const QByteArray &content,
+	int partSize,
+	bool computeMd5)
+: _state(std::make_shared<State>())
+, _content(content)
+, _partSize(partSize) {
+	_state->mode = State::Mode::Content;
+	_state->size = _content.size();
+	_state->computeMd5 = computeMd5;
+	if (!computeMd5) {
+		_state->md5Done = true;
+	} else if (!_state->size) {
+		_state->finishMd5();
+	}
+}
+
+UploadSource::UploadSource(
+	const QString &path,
+	int partSize,
+	bool computeMd5)
+: _state(std::make_shared<State>())
+, _partSize(partSize) {
+	_state->computeMd5 = computeMd5;
+	if (!computeMd5) {
+		_state->md5Done = true;
+	}
+	_state->file.setFileName(path);
+	if (!_state->file.open(QIODevice::ReadOnly)) {
+		_state->failed = true;
+		return;
+	}
+	_state->size = _state->file.size();
+	startReading();
+}
+
+UploadSource::~UploadSource() {
+	_state->cancelled = true;
+}
+
+bool UploadSource::failed() const {
+	return _state->failed;
+}
+
+void UploadSource::setReadyCallback(Fn<void()> callback) {
+	_state->readyCallback = std::move(callback);
+}
+
+void UploadSource::startReading() {
+	_state->mode = State::Mode::Reading;
+	scheduleReadAhead();
+}
+
+void UploadSource::scheduleReadAhead() {
+	{
+		QMutexLocker lock(&_state->mutex);
+		if (_state->reading
+			|| _state->finished
+			|| _state->parts.size() >= kReadAheadParts) {
+			return;
+		}
+		_state->reading = true;
+	}
+	crl::async([state = _state, partSize = _partSize] {
+		while (!state->cancelled) {
+			{
+				QMutexLocker lock(&state->mutex);
+				if (state->parts.size() >= kReadAheadParts) {
+					break;
+				}
+			}
+			auto part = state->file.read(partSize);
+			const auto error = (state->file.error() != QFileDevice::NoError);
+			const auto last = error
+				|| (part.size() < partSize)
+				|| state->file.atEnd();
+			if (error) {
+				state->failed = true;
+			} else if (state->computeMd5 && !part.isEmpty()) {
+				state->md5.feed(part.constData(), part.size());
+			}
+			if (last && !error && state->computeMd5) {
+				state->finishMd5();
+			}
+
+			QMutexLocker lock(&state->mutex);
+			if (!error && !part.isEmpty()) {
+				state->parts.push_back(std::move(part));
+			}
+			if (last) {
+				state->finished = true;
+				break;
+			}
+		}
+		auto notify = false;
+		{
+			QMutexLocker lock(&state->mutex);
+			state->reading = false;
+			notify = base::take(state->waiting);
+		}
+		if (notify) {
+			State::NotifyReady(state);
+		}
+	});
+}
+
+QByteArray UploadSource::takePart(int index) {
+	Expects(index >= 0);
+
+	if (_state->failed) {
+		return QByteArray();
+	}
+	const auto offset = qint64(index) * _partSize;
+	const auto length = int(std::min(
+		_state->size - offset,
+		qint64(_partSize)));
+	switch (_state->mode) {
+	case State::Mode::Content: {
+		if (length <= 0) {
+			LOG(("Upload Error: part %1 is out of the content size %2."
+				).arg(index
+				).arg(_state->size));
+			_state->failed = true;
+			return QByteArray();
+		}
+		const auto data = _content.constData() + offset;
+		if (_state->computeMd5) {
+			_state->md5.feed(data, length);
+			if (offset + length >= _state->size) {
+				_state->finishMd5();
+			}
+		}
+		return QByteArray::fromRawData(data, length);
+	} break;
+
+	case State::Mode::Reading: {
+		auto result = QByteArray();
+		{
+			QMutexLocker lock(&_state->mutex);
+			if (!_state->parts.empty() && _state->firstPartIndex == index) {
+				result = std::move(_state->parts.front());
+				_state->parts.pop_front();
+				++_state->firstPartIndex;
+			} else if (_state->finished) {
+				// The file ended before the part, it won't ever be read.
+				LOG(("Upload Error: part %1 is missing in the file '%2'."
+					).arg(index
+					).arg(_state->file.fileName()));
+				_state->failed = true;
+				return QByteArray();
+			} else {
+				_state->waiting = true;
+			}
+		}
+		scheduleReadAhead();
+		if (!result.isNull() && result.size() != length) {
+			// The file was changed while it was being uploaded.
+			LOG(("Upload Error: part %1 has size %2 instead of %3 "
+				"in the file '%4'."
+				).arg(index
+				).arg(result.size()
+				).arg(length
+				).arg(_state->file.fileName()));
+			_state->failed = true;
+			return QByteArray();
+		}
+		return result;
+	} break;
+	}
+	Unexpected("Mode in UploadSource::takePart.");
+}
+
+bool UploadSource::md5Ready() const {
+	QMutexLocker lock(&_state->mutex);
+	if (!_state->md5Done) {
+		_state->waiting = true;
+		return false;
+	}
+	return true;
+}
+
+QByteArray UploadSource::md5Hex() const {
+	QMutexLocker lock(&_state->mutex);
+	return _state->md5Hex;
+}
+
+} // namespace Storage
@@ -0,0 +1,55 @@
+/*
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Storage {
+
+// Hands out document upload parts without copying them where possible.
+//
+// In-memory content gives parts as views (QByteArray::fromRawData) over
+// the source memory. Files are read ahead by a background reader, which
+// computes the md5 hash off the main thread while parts are being sent.
+// Files are not memory-mapped: the user may truncate the file while it
+// is being uploaded and reading a mapping past the new end would crash.
+//
+// A part view is valid only until the source is destroyed, so it should
+// be serialized (MTP::send does that) and not stored.
+class UploadSource final {
+public:
+	UploadSource(const QByteArray &content, int partSize, bool computeMd5);
+	UploadSource(const QString &path, int partSize, bool computeMd5);
+	UploadSource(const UploadSource &other) = delete;
+	UploadSource &operator=(const UploadSource &other) = delete;
+	~UploadSource();
+
+	[[nodiscard]] bool failed() const;
+
+	// Called on the main thread when a part or the md5 hash,
+	// that was not ready when requested, becomes available.
+	void setReadyCallback(Fn<void()> callback);
+
+	// Parts must be requested sequentially from zero.
+	// Returns a null QByteArray if the part is not ready yet
+	// or if it can't be read at all, then failed() returns true.
+	[[nodiscard]] QByteArray takePart(int index);
+
+	[[nodiscard]] bool md5Ready() const;
+	[[nodiscard]] QByteArray md5Hex() const;
+
+private:
+	struct State;
+
+	void startReading();
+	void scheduleReadAhead();
+
+	const std::shared_ptr<State> _state;
+	QByteArray _content;
+	int _partSize = 0;
+
+};
+
+} // namespace Storage
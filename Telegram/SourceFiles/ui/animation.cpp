@@ -28,6 +28,10 @@ namespace {
 AnimationManager *_manager = nullptr;
 bool AnimationsDisabled = false;
 
+// Frame taking longer than expected frame duration multiplied
+// by this factor is counted as a dropped one.
+constexpr auto kDroppedFrameFactor = 1.5;
+
 } // namespace
 
 namespace anim {
@@ -109,6 +113,42 @@ void SetDisabled(bool disabled) {
 	}
 }
 
+FrameStats CurrentFrameStats() {
+	return _manager ? _manager->stats() : FrameStats();
+}
+
+QString FrameStatsDump() {
+	const auto stats = CurrentFrameStats();
+	return QString("Frames: %1, dropped: %2\n"
+		"Last frame time: %3 ms, delta: %4 ms, expected: %5 ms\n"
+		"Animations stepped: %6, widgets updated: %7\n"
+		"Paused: %8"
+	).arg(stats.framesCount
+	).arg(stats.droppedFrames
+	).arg(stats.frameTime
+	).arg(stats.frameDelta
+	).arg(stats.frameDuration
+	).arg(stats.animationsStepped
+	).arg(stats.widgetsUpdated
+	).arg(stats.paused ? "yes" : "no");
+}
+
+void UpdateRegion(not_null<QWidget*> widget, const QRect &rect) {
+	if (_manager) {
+		_manager->scheduleUpdate(widget, rect);
+	} else {
+		widget->update(rect);
+	}
+}
+
+void UpdateWidget(not_null<QWidget*> widget) {
+	if (_manager) {
+		_manager->scheduleUpdate(widget, QRect());
+	} else {
+		widget->update();
+	}
+}
+
 void DrawStaticLoading(
 		QPainter &p,
 		QRectF rect,
@@ -155,8 +195,9 @@ void BasicAnimation::stop() {
 }
 
 AnimationManager::AnimationManager() : _timer(this) {
-	_timer.setSingleShot(false);
-	connect(&_timer, &QTimer::timeout, this, &AnimationManager::step);
+	_timer.setSingleShot(true);
+	_timer.setTimerType(Qt::PreciseTimer);
+	connect(&_timer, &QTimer::timeout, this, &AnimationManager::timerStep);
 }
 
 void AnimationManager::start(BasicAnimation *obj) {
@@ -166,10 +207,11 @@ void AnimationManager::start(BasicAnimation *obj) {
 			_stopping.erase(obj);
 		}
 	} else {
-		if (_objects.empty()) {
-			_timer.start(AnimationTimerDelta);
-		}
+		const auto wasEmpty = _objects.empty();
 		_objects.insert(obj);
+		if (wasEmpty) {
+			scheduleNextFrame();
+		}
 	}
 }
 
@@ -185,6 +227,8 @@ void AnimationManager::stop(BasicAnimation *obj) {
 			_objects.erase(i);
 			if (_objects.empty()) {
 				_timer.stop();
+				_lastFrame = 0;
+				resume();
 			}
 		}
 	}
@@ -198,16 +242,83 @@ void AnimationManager::registerClip(not_null<Media::Clip::Manager*> clip) {
 		&AnimationManager::clipCallback);
 }
 
+void AnimationManager::scheduleUpdate(
+		not_null<QWidget*> widget,
+		const QRect &rect) {
+	if (!_iterating) {
+		if (rect.isNull()) {
+			widget->update();
+		} else {
+			widget->update(rect);
+		}
+		return;
+	}
+	auto &pending = _updates[widget.get()];
+	if (pending.widget.data() != widget.get()) {
+		pending = PendingUpdate();
+		pending.widget = widget.get();
+	}
+	if (rect.isNull()) {
+		pending.full = true;
+	} else if (!pending.full) {
+		pending.region += rect;
+	}
+}
+
+anim::FrameStats AnimationManager::stats() const {
+	return _stats;
+}
+
+bool AnimationManager::eventFilter(QObject *o, QEvent *e) {
+	if (!o->isWindowType()) {
+		return QObject::eventFilter(o, e);
+	}
+	switch (e->type()) {
+	case QEvent::Expose:
+	case QEvent::Show:
+	case QEvent::WindowStateChange:
+		if (_paused && hasVisibleWindows()) {
+			resume();
+		}
+		break;
+	default:
+		break;
+	}
+	return QObject::eventFilter(o, e);
+}
+
+void AnimationManager::timerStep() {
+	if (!hasVisibleWindows()) {
+		pause();
+		return;
+	}
+	step();
+}
+
 void AnimationManager::step() {
-	_iterating = true;
 	const auto ms = crl::now();
+	const auto duration = frameDuration();
+	if (_lastFrame) {
+		const auto delta = ms - _lastFrame;
+		if (delta > duration * kDroppedFrameFactor) {
+			_stats.droppedFrames += int(delta / duration) - 1;
+		}
+		_stats.frameDelta = delta;
+	}
+	_lastFrame = ms;
+
+	auto stepped = 0;
+	_iterating = true;
 	for (const auto object : _objects) {
 		if (!_stopping.contains(object)) {
 			object->step(ms, true);
+			++stepped;
 		}
 	}
 	_iterating = false;
 
+	flushUpdates();
+
 	if (!_starting.empty()) {
 		for (const auto object : _starting) {
 			_objects.emplace(object);
@@ -220,8 +331,99 @@ void AnimationManager::step() {
 		}
 		_stopping.clear();
 	}
+
+	_stats.frameTime = crl::now() - ms;
+	_stats.frameDuration = duration;
+	_stats.animationsStepped = stepped;
+	++_stats.framesCount;
+
 	if (_objects.empty()) {
 		_timer.stop();
+		_lastFrame = 0;
+	} else {
+		scheduleNextFrame();
+	}
+}
+
+void AnimationManager::scheduleNextFrame() {
+	if (_paused) {
+		return;
+	}
+	const auto duration = frameDuration();
+	const auto delay = _lastFrame
+		? std::max(_lastFrame + duration - crl::now(), crl::time(0))
+		: duration;
+	_timer.start(int(delay));
+}
+
+void AnimationManager::flushUpdates() {
+	if (_updates.empty()) {
+		_stats.widgetsUpdated = 0;
+		return;
+	}
+	auto updated = 0;
+	for (const auto &[key, pending] : base::take(_updates)) {
+		if (!pending.widget) {
+			continue;
+		}
+		if (pending.full) {
+			pending.widget->update();
+		} else {
+			pending.widget->update(pending.region);
+		}
+		++updated;
+	}
+	_stats.widgetsUpdated = updated;
+}
+
+crl::time AnimationManager::frameDuration() const {
+	const auto screen = QGuiApplication::primaryScreen();
+	const auto rate = screen ? screen->refreshRate() : 0.;
+	const auto result = (rate > 1.)
+		? crl::time(std::floor(1000. / rate))
+		: crl::time(AnimationTimerDelta);
+	return std::max(result, crl::time(AnimationTimerDelta));
+}
+
+bool AnimationManager::hasVisibleWindows() const {
+	for (const auto window : QGuiApplication::topLevelWindows()) {
+		if (window->isExposed()
+			&& !(window->windowState() & Qt::WindowMinimized)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void AnimationManager::pause() {
+	if (_paused) {
+		return;
+	}
+	_paused = true;
+	_stats.paused = true;
+	_timer.stop();
+	_lastFrame = 0;
+
+	// There is no signal for a window becoming exposed again, so we watch
+	// the events of all the windows, including ones created while paused.
+	qApp->installEventFilter(this);
+	_stateConnection = connect(
+		qApp,
+		&QGuiApplication::applicationStateChanged,
+		this,
+		[=] { if (hasVisibleWindows()) resume(); });
+}
+
+void AnimationManager::resume() {
+	if (!_paused) {
+		return;
+	}
+	_paused = false;
+	_stats.paused = false;
+	qApp->removeEventFilter(this);
+	disconnect(base::take(_stateConnection));
+	if (!_objects.empty()) {
+		_timer.start(0);
 	}
 }
 
@@ -417,6 +417,24 @@ QPainterPath path(QPointF (&from)[N]) {
 bool Disabled();
 void SetDisabled(bool disabled);
 
+struct FrameStats {
+	crl::time frameTime = 0; // How long the last frame step took.
+	crl::time frameDelta = 0; // Time between the last two frames.
+	crl::time frameDuration = 0; // Expected frame duration.
+	int animationsStepped = 0;
+	int widgetsUpdated = 0;
+	int droppedFrames = 0;
+	int framesCount = 0;
+	bool paused = false;
+};
+FrameStats CurrentFrameStats();
+QString FrameStatsDump();
+
+// Coalesces repaint requests from animation callbacks so that each
+// widget receives a single update() with the united region per frame.
+void UpdateRegion(not_null<QWidget*> widget, const QRect &rect);
+void UpdateWidget(not_null<QWidget*> widget);
+
 void DrawStaticLoading(
 	QPainter &p,
 	QRectF rect,
@@ -710,14 +728,39 @@ public:
 	void registerClip(not_null<Media::Clip::Manager*> clip);
 	void step();
 
+	void scheduleUpdate(not_null<QWidget*> widget, const QRect &rect);
+	anim::FrameStats stats() const;
+
+protected:
+	bool eventFilter(QObject *o, QEvent *e) override;
+
 private:
+	struct PendingUpdate {
+		QPointer<QWidget> widget;
+		QRegion region;
+		bool full = false;
+	};
+
 	void clipCallback(
 		Media::Clip::Reader *reader,
 		qint32 threadIndex,
 		qint32 notification);
 
+	void timerStep();
+	void scheduleNextFrame();
+	void flushUpdates();
+	crl::time frameDuration() const;
+	bool hasVisibleWindows() const;
+	void pause();
+	void resume();
+
 	base::flat_set<BasicAnimation*> _objects, _starting, _stopping;
+	base::flat_map<QWidget*, PendingUpdate> _updates;
+	QMetaObject::Connection _stateConnection;
 	QTimer _timer;
+	crl::time _lastFrame = 0;
+	anim::FrameStats _stats;
 	bool _iterating = false;
+	bool _paused = false;
 
 };
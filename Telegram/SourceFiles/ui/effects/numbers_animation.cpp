@@ -157,7 +157,7 @@ LabelWithNumbers::LabelWithNumbers(
 , _textTop(textTop)
 , _before(GetBefore(value))
 , _after(GetAfter(value))
-, _numbers(_st.style.font, [=] { update(); })
+, _numbers(_st.style.font, [=] { anim::UpdateWidget(this); })
 , _beforeWidth(_st.style.font->width(_before))
 , _afterWidth(st.style.font->width(_after)) {
 	Expects((value.offset < 0) == (value.length == 0));
@@ -193,7 +193,7 @@ void LabelWithNumbers::setValue(const StringWithNumbers &value) {
 		_beforeWidth,
 		_st.style.font->width(_before));
 	_beforeWidthAnimation.start(
-		[this] { update(); },
+		[this] { anim::UpdateWidget(this); },
 		oldBeforeWidth,
 		_beforeWidth,
 		st::slideWrapDuration,
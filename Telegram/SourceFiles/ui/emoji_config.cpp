@@ -13,6 +13,7 @@ https://github.com/bettergram/bettergram/blob/master/LEGAL
 #include "base/bytes.h"
 #include "base/openssl_help.h"
 #include "base/parse_helper.h"
+#include "core/startup_trace.h"
 #include "auth_session.h"
 
 namespace Ui {
@@ -40,13 +41,13 @@ const auto kSets = {
 // So all Instance::Instance() should happen before async generations.
 class Instance {
 public:
-	explicit Instance(int size);
+	Instance(int size, std::vector<QImage> &&prepared);
 
 	bool cached() const;
 	void draw(QPainter &p, EmojiPtr emoji, int x, int y);
 
 private:
-	void readCache();
+	void readCache(std::vector<QImage> &&prepared);
 	void generateCache();
 	void checkUniversalImages();
 	void pushSprite(QImage &&data);
@@ -82,6 +83,13 @@ auto SizeNormal = -1;
 auto SizeLarge = -1;
 auto SpritesCount = -1;
 
+struct Prepared {
+	int id = 0;
+	std::vector<QImage> normal;
+	std::vector<QImage> large;
+};
+auto PreparedSprites = std::optional<Prepared>();
+
 auto InstanceNormal = std::unique_ptr<Instance>();
 auto InstanceLarge = std::unique_ptr<Instance>();
 auto Universal = std::shared_ptr<UniversalImages>();
@@ -235,10 +243,11 @@ QImage LoadFromFile(int id, int size, int index) {
 		return QImage();
 	}
 	const auto read = [&](bytes::span data) {
-		return f.read(
+		const auto count = f.read(
 			reinterpret_cast<char*>(data.data()),
-			data.size()
-		) == data.size();
+			data.size());
+		Core::StartupTrace::AddReadBytes(std::max(count, qint64(0)));
+		return count == data.size();
 	};
 	uint32 header[4] = { 0 };
 	if (!read(bytes::make_span(header))
@@ -507,7 +516,9 @@ QString SetDataPath(int id) {
 
 } // namespace internal
 
-void Init() {
+void Prepare() {
+	Expects(!PreparedSprites.has_value());
+
 	internal::Init();
 
 	const auto count = internal::FullCount();
@@ -516,10 +527,37 @@ void Init() {
 
 	SizeNormal = ConvertScale(18, cScale() * cIntRetinaFactor());
 	SizeLarge = int(ConvertScale(18 * 4 / 3., cScale() * cIntRetinaFactor()));
-	Universal = std::make_shared<UniversalImages>(ReadCurrentSetId());
 
-	InstanceNormal = std::make_unique<Instance>(SizeNormal);
-	InstanceLarge = std::make_unique<Instance>(SizeLarge);
+	const auto id = ReadCurrentSetId();
+	const auto load = [&](int size) {
+		auto result = std::vector<QImage>();
+		for (auto i = 0; i != SpritesCount; ++i) {
+			auto image = LoadFromFile(id, size, i);
+			if (image.isNull()) {
+				break;
+			}
+			result.push_back(std::move(image));
+		}
+		return result;
+	};
+	PreparedSprites = Prepared{ id, load(SizeNormal), load(SizeLarge) };
+}
+
+void Init() {
+	if (!PreparedSprites) {
+		Prepare();
+	}
+	auto prepared = base::take(*PreparedSprites);
+	PreparedSprites = std::nullopt;
+
+	Universal = std::make_shared<UniversalImages>(prepared.id);
+
+	InstanceNormal = std::make_unique<Instance>(
+		SizeNormal,
+		std::move(prepared.normal));
+	InstanceLarge = std::make_unique<Instance>(
+		SizeLarge,
+		std::move(prepared.large));
 }
 
 void Clear() {
@@ -880,10 +918,12 @@ void Draw(QPainter &p, EmojiPtr emoji, int size, int x, int y) {
 	}
 }
 
-Instance::Instance(int size) : _id(Universal->id()), _size(size) {
+Instance::Instance(int size, std::vector<QImage> &&prepared)
+: _id(Universal->id())
+, _size(size) {
 	Expects(Universal != nullptr);
 
-	readCache();
+	readCache(std::move(prepared));
 	if (!cached()) {
 		generateCache();
 	}
@@ -911,12 +951,8 @@ void Instance::draw(QPainter &p, EmojiPtr emoji, int x, int y) {
 		QRect(emoji->column() * _size, emoji->row() * _size, _size, _size));
 }
 
-void Instance::readCache() {
-	for (auto i = 0; i != SpritesCount; ++i) {
-		auto image = LoadFromFile(_id, _size, i);
-		if (image.isNull()) {
-			return;
-		}
+void Instance::readCache(std::vector<QImage> &&prepared) {
+	for (auto &image : prepared) {
 		pushSprite(std::move(image));
 	}
 }
@@ -19,6 +19,10 @@ namespace internal {
 
 constexpr auto kRecentLimit = 42;
 
+// Reads the emoji sprites cache, may be called on any thread
+// after style::startManager() and before Init().
+void Prepare();
+
 void Init();
 void Clear();
 
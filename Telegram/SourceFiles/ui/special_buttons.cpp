@@ -298,7 +298,7 @@ void SendButton::setType(Type type) {
 		_type = type;
 		_a_typeChanged.finish();
 		_contentTo = grabContent();
-		_a_typeChanged.start([this] { update(); }, 0., 1., st::historyRecordVoiceDuration);
+		_a_typeChanged.start([this] { anim::UpdateWidget(this); }, 0., 1., st::historyRecordVoiceDuration);
 		update();
 	}
 	if (_type != Type::Record) {
@@ -788,7 +788,7 @@ void UserpicButton::startNewPhotoShowing() {
 
 void UserpicButton::startAnimation() {
 	_a_appearance.finish();
-	_a_appearance.start([this] { update(); }, 0, 1, _st.duration);
+	_a_appearance.start([this] { anim::UpdateWidget(this); }, 0, 1, _st.duration);
 }
 
 void UserpicButton::switchChangePhotoOverlay(bool enabled) {
@@ -823,7 +823,7 @@ bool UserpicButton::showSavedMessages() const {
 void UserpicButton::startChangeOverlayAnimation() {
 	auto over = isOver() || isDown();
 	_changeOverlayShown.start(
-		[this] { update(); },
+		[this] { anim::UpdateWidget(this); },
 		over ? 0. : 1.,
 		over ? 1. : 0.,
 		st::slideWrapDuration);
@@ -149,7 +149,7 @@ void RippleButton::onStateChanged(State was, StateChangeSource source) {
 
 void RippleButton::ensureRipple() {
 	if (!_ripple) {
-		_ripple = std::make_unique<RippleAnimation>(_st, prepareRippleMask(), [this] { update(); });
+		_ripple = std::make_unique<RippleAnimation>(_st, prepareRippleMask(), [this] { anim::UpdateWidget(this); });
 	}
 }
 
@@ -476,7 +476,7 @@ void IconButton::onStateChanged(State was, StateChangeSource source) {
 		if (_st.duration) {
 			auto from = over ? 0. : 1.;
 			auto to = over ? 1. : 0.;
-			_a_over.start([this] { update(); }, from, to, _st.duration);
+			_a_over.start([this] { anim::UpdateWidget(this); }, from, to, _st.duration);
 		} else {
 			update();
 		}
@@ -142,7 +142,7 @@ void DiscreteSlider::setSelectedSection(int index) {
 		_selected = index;
 		auto to = _sections[_selected].left;
 		auto duration = getAnimationDuration();
-		_a_left.start([this] { update(); }, from, to, duration);
+		_a_left.start([this] { anim::UpdateWidget(this); }, from, to, duration);
 		_callbackAfterMs = crl::now() + duration;
 	}
 }
@@ -247,7 +247,7 @@ void SettingsSlider::startRipple(int sectionIndex) {
 				section.ripple = std::make_unique<RippleAnimation>(
 					_st.ripple,
 					std::move(mask),
-					[this] { update(); });
+					[this] { anim::UpdateWidget(this); });
 			}
 			const auto point = mapFromGlobal(QCursor::pos());
 			section.ripple->add(point - QPoint(section.left, 0));
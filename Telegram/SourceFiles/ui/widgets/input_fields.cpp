@@ -1006,7 +1006,7 @@ void FlatInput::focusInEvent(QFocusEvent *e) {
 	if (!_focused) {
 		_focused = true;
 		_a_placeholderFocused.start(
-			[=] { update(); },
+			[=] { anim::UpdateWidget(this); },
 			0.,
 			1.,
 			_st.phDuration);
@@ -1020,7 +1020,7 @@ void FlatInput::focusOutEvent(QFocusEvent *e) {
 	if (_focused) {
 		_focused = false;
 		_a_placeholderFocused.start(
-			[=] { update(); },
+			[=] { anim::UpdateWidget(this); },
 			1.,
 			0.,
 			_st.phDuration);
@@ -1076,7 +1076,7 @@ void FlatInput::updatePlaceholder() {
 	if (_placeholderVisible != placeholderVisible) {
 		_placeholderVisible = placeholderVisible;
 		_a_placeholderVisible.start(
-			[=] { update(); },
+			[=] { anim::UpdateWidget(this); },
 			_placeholderVisible ? 0. : 1.,
 			_placeholderVisible ? 1. : 0.,
 			_st.phDuration);
@@ -1655,12 +1655,12 @@ void InputField::startBorderAnimation() {
 		_borderVisible = borderVisible;
 		if (_borderVisible) {
 			if (_a_borderOpacity.animating()) {
-				_a_borderOpacity.start([this] { update(); }, 0., 1., _st.duration);
+				_a_borderOpacity.start([this] { anim::UpdateWidget(this); }, 0., 1., _st.duration);
 			} else {
-				_a_borderShown.start([this] { update(); }, 0., 1., _st.duration);
+				_a_borderShown.start([this] { anim::UpdateWidget(this); }, 0., 1., _st.duration);
 			}
 		} else {
-			_a_borderOpacity.start([this] { update(); }, 1., 0., _st.duration);
+			_a_borderOpacity.start([this] { anim::UpdateWidget(this); }, 1., 0., _st.duration);
 		}
 	}
 }
@@ -1709,7 +1709,7 @@ void InputField::focusOutEventInner(QFocusEvent *e) {
 void InputField::setFocused(bool focused) {
 	if (_focused != focused) {
 		_focused = focused;
-		_a_focused.start([this] { update(); }, _focused ? 0. : 1., _focused ? 1. : 0., _st.duration);
+		_a_focused.start([this] { anim::UpdateWidget(this); }, _focused ? 0. : 1., _focused ? 1. : 0., _st.duration);
 		startPlaceholderAnimation();
 		startBorderAnimation();
 	}
@@ -2294,7 +2294,7 @@ void InputField::startPlaceholderAnimation() {
 	if (_placeholderShifted != placeholderShifted) {
 		_placeholderShifted = placeholderShifted;
 		_a_placeholderShifted.start(
-			[=] { update(); },
+			[=] { anim::UpdateWidget(this); },
 			_placeholderShifted ? 0. : 1.,
 			_placeholderShifted ? 1. : 0.,
 			_st.duration);
@@ -3444,7 +3444,7 @@ void InputField::showError() {
 void InputField::setErrorShown(bool error) {
 	if (_error != error) {
 		_error = error;
-		_a_error.start([this] { update(); }, _error ? 0. : 1., _error ? 1. : 0., _st.duration);
+		_a_error.start([this] { anim::UpdateWidget(this); }, _error ? 0. : 1., _error ? 1. : 0., _st.duration);
 		startBorderAnimation();
 	}
 }
@@ -3679,15 +3679,15 @@ void MaskedInputField::startBorderAnimation() {
 		_borderVisible = borderVisible;
 		if (_borderVisible) {
 			if (_a_borderOpacity.animating()) {
-				_a_borderOpacity.start([this] { update(); }, 0., 1., _st.duration);
+				_a_borderOpacity.start([this] { anim::UpdateWidget(this); }, 0., 1., _st.duration);
 			} else {
-				_a_borderShown.start([this] { update(); }, 0., 1., _st.duration);
+				_a_borderShown.start([this] { anim::UpdateWidget(this); }, 0., 1., _st.duration);
 			}
 		} else if (qFuzzyCompare(_a_borderShown.current(1.), 0.)) {
 			_a_borderShown.finish();
 			_a_borderOpacity.finish();
 		} else {
-			_a_borderOpacity.start([this] { update(); }, 1., 0., _st.duration);
+			_a_borderOpacity.start([this] { anim::UpdateWidget(this); }, 1., 0., _st.duration);
 		}
 	}
 }
@@ -3708,7 +3708,7 @@ void MaskedInputField::focusOutEvent(QFocusEvent *e) {
 void MaskedInputField::setFocused(bool focused) {
 	if (_focused != focused) {
 		_focused = focused;
-		_a_focused.start([this] { update(); }, _focused ? 0. : 1., _focused ? 1. : 0., _st.duration);
+		_a_focused.start([this] { anim::UpdateWidget(this); }, _focused ? 0. : 1., _focused ? 1. : 0., _st.duration);
 		startPlaceholderAnimation();
 		startBorderAnimation();
 	}
@@ -3765,7 +3765,7 @@ void MaskedInputField::showError() {
 void MaskedInputField::setErrorShown(bool error) {
 	if (_error != error) {
 		_error = error;
-		_a_error.start([this] { update(); }, _error ? 0. : 1., _error ? 1. : 0., _st.duration);
+		_a_error.start([this] { anim::UpdateWidget(this); }, _error ? 0. : 1., _error ? 1. : 0., _st.duration);
 		startBorderAnimation();
 	}
 }
@@ -3801,7 +3801,7 @@ void MaskedInputField::startPlaceholderAnimation() {
 	auto placeholderShifted = _forcePlaceholderHidden || (_focused && _st.placeholderScale > 0.) || !getLastText().isEmpty();
 	if (_placeholderShifted != placeholderShifted) {
 		_placeholderShifted = placeholderShifted;
-		_a_placeholderShifted.start([this] { update(); }, _placeholderShifted ? 0. : 1., _placeholderShifted ? 1. : 0., _st.duration);
+		_a_placeholderShifted.start([this] { anim::UpdateWidget(this); }, _placeholderShifted ? 0. : 1., _placeholderShifted ? 1. : 0., _st.duration);
 	}
 }
 
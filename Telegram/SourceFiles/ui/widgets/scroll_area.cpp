@@ -106,7 +106,7 @@ void ScrollBar::updateBar(bool force) {
 void ScrollBar::onHideTimer() {
 	if (!_hiding) {
 		_hiding = true;
-		_a_opacity.start([this] { update(); }, 1., 0., _st->duration);
+		_a_opacity.start([this] { anim::UpdateWidget(this); }, 1., 0., _st->duration);
 	}
 }
 
@@ -120,11 +120,11 @@ void ScrollBar::setOver(bool over) {
 		_over = over;
 		auto nowOver = (_over || _moving);
 		if (wasOver != nowOver) {
-			_a_over.start([this] { update(); }, nowOver ? 0. : 1., nowOver ? 1. : 0., _st->duration);
+			_a_over.start([this] { anim::UpdateWidget(this); }, nowOver ? 0. : 1., nowOver ? 1. : 0., _st->duration);
 		}
 		if (nowOver && _hiding) {
 			_hiding = false;
-			_a_opacity.start([this] { update(); }, 0., 1., _st->duration);
+			_a_opacity.start([this] { anim::UpdateWidget(this); }, 0., 1., _st->duration);
 		}
 	}
 }
@@ -135,7 +135,7 @@ void ScrollBar::setOverBar(bool overbar) {
 		_overbar = overbar;
 		auto nowBarOver = (_overbar || _moving);
 		if (wasBarOver != nowBarOver) {
-			_a_barOver.start([this] { update(); }, nowBarOver ? 0. : 1., nowBarOver ? 1. : 0., _st->duration);
+			_a_barOver.start([this] { anim::UpdateWidget(this); }, nowBarOver ? 0. : 1., nowBarOver ? 1. : 0., _st->duration);
 		}
 	}
 }
@@ -147,11 +147,11 @@ void ScrollBar::setMoving(bool moving) {
 		_moving = moving;
 		auto nowBarOver = (_overbar || _moving);
 		if (wasBarOver != nowBarOver) {
-			_a_barOver.start([this] { update(); }, nowBarOver ? 0. : 1., nowBarOver ? 1. : 0., _st->duration);
+			_a_barOver.start([this] { anim::UpdateWidget(this); }, nowBarOver ? 0. : 1., nowBarOver ? 1. : 0., _st->duration);
 		}
 		auto nowOver = (_over || _moving);
 		if (wasOver != nowOver) {
-			_a_over.start([this] { update(); }, nowOver ? 0. : 1., nowOver ? 1. : 0., _st->duration);
+			_a_over.start([this] { anim::UpdateWidget(this); }, nowOver ? 0. : 1., nowOver ? 1. : 0., _st->duration);
 		}
 		if (!nowOver && _st->hiding && !_hiding) {
 			_hideTimer.start(_hideIn);
@@ -191,7 +191,7 @@ void ScrollBar::paintEvent(QPaintEvent *e) {
 void ScrollBar::hideTimeout(crl::time dt) {
 	if (_hiding && dt > 0) {
 		_hiding = false;
-		_a_opacity.start([this] { update(); }, 0., 1., _st->duration);
+		_a_opacity.start([this] { anim::UpdateWidget(this); }, 0., 1., _st->duration);
 	}
 	_hideIn = dt;
 	if (!_moving) {
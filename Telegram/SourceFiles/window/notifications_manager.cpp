@@ -31,6 +31,12 @@ namespace {
 constexpr auto kMinimalAlertDelay = crl::time(500);
 constexpr auto kWaitingForAllGroupedDelay = crl::time(1000);
 
+// not more than 4 notifications in 3s, the rest waits and gets coalesced
+constexpr auto kRateLimitCount = 4;
+constexpr auto kRateLimitInterval = crl::time(3000);
+
+constexpr auto kDueQueueCompactSlack = 16;
+
 } // namespace
 
 System::System(AuthSession *session)
@@ -118,7 +124,7 @@ void System::schedule(History *history, HistoryItem *item) {
 		auto &addTo = haveSetting ? _waiters : _settingWaiters;
 		auto it = addTo.constFind(history);
 		if (it == addTo.cend() || it->when > when) {
-			addTo.insert(history, Waiter(item->id, when, notifyBy));
+			addWaiter(addTo, history, Waiter(item->id, when, notifyBy));
 		}
 	}
 	if (haveSetting) {
@@ -138,6 +144,7 @@ void System::clearAll() {
 	_whenAlerts.clear();
 	_waiters.clear();
 	_settingWaiters.clear();
+	_dueQueue.clear();
 }
 
 void System::clearFromHistory(History *history) {
@@ -164,6 +171,7 @@ void System::clearAllFast() {
 	_whenAlerts.clear();
 	_waiters.clear();
 	_settingWaiters.clear();
+	_dueQueue.clear();
 }
 
 void System::checkDelayed() {
@@ -201,7 +209,7 @@ void System::checkDelayed() {
 		}
 		if (loaded) {
 			if (!muted) {
-				_waiters.insert(i.key(), i.value());
+				addWaiter(_waiters, i.key(), i.value());
 			}
 			i = _settingWaiters.erase(i);
 		} else {
@@ -215,7 +223,8 @@ void System::checkDelayed() {
 void System::showGrouped() {
 	if (const auto lastItem = App::histItemById(_lastHistoryItemId)) {
 		_waitForAllGroupedTimer.cancel();
-		_manager->showNotification(lastItem, _lastForwardedCount);
+		_manager->showNotification(lastItem, _lastForwardedCount, 1);
+		notificationShown(crl::now());
 		_lastForwardedCount = 0;
 		_lastHistoryItemId = FullMsgId();
 	}
@@ -282,140 +291,119 @@ void System::showNext() {
 		return;
 	}
 
-	while (true) {
-		auto next = 0LL;
-		HistoryItem *notifyItem = nullptr;
-		History *notifyHistory = nullptr;
-		for (auto i = _waiters.begin(); i != _waiters.end();) {
-			History *history = i.key();
-			if (history->currentNotification() && history->currentNotification()->id != i.value().msg) {
-				auto j = _whenMaps.find(history);
-				if (j == _whenMaps.end()) {
-					history->clearNotifications();
-					i = _waiters.erase(i);
-					continue;
+	while (const auto notifyHistory = nextWaiter()) {
+		auto next = _waiters.constFind(notifyHistory)->when;
+		if (next <= ms) {
+			if (const auto till = rateLimitedTill(ms)) {
+				next = till;
+			}
+		}
+		if (next > ms) {
+			if (nextAlert && nextAlert < next) {
+				next = nextAlert;
+			}
+			nextAlert = 0;
+			_waitTimer.callOnce(next - ms);
+			break;
+		}
+		auto notifyItem = notifyHistory->currentNotification();
+		const auto isForwarded = notifyItem->Has<HistoryMessageForwarded>();
+		const auto isAlbum = notifyItem->groupId();
+
+		auto groupedItem = (isForwarded || isAlbum) ? notifyItem : nullptr; // forwarded and album notify grouping
+		auto forwardedCount = isForwarded ? 1 : 0;
+
+		// Plain messages that are already due are coalesced into one.
+		auto messagesCount = 1;
+
+		const auto history = notifyItem->history();
+		const auto j = _whenMaps.find(history);
+		if (j == _whenMaps.cend()) {
+			history->clearNotifications();
+		} else {
+			auto nextNotify = (HistoryItem*)nullptr;
+			auto nextWhen = crl::time(0);
+			do {
+				nextNotify = nullptr;
+				history->skipNotification();
+				if (!history->hasNotification()) {
+					break;
 				}
+
+				j.value().remove((groupedItem ? groupedItem : notifyItem)->id);
 				do {
-					auto k = j.value().constFind(history->currentNotification()->id);
+					const auto k = j.value().constFind(history->currentNotification()->id);
 					if (k != j.value().cend()) {
-						i.value().msg = k.key();
-						i.value().when = k.value();
+						nextNotify = history->currentNotification();
+						nextWhen = k.value();
+						addWaiter(_waiters, notifyHistory, Waiter(k.key(), k.value(), 0));
 						break;
 					}
 					history->skipNotification();
-				} while (history->currentNotification());
-			}
-			if (!history->currentNotification()) {
-				_whenMaps.remove(history);
-				i = _waiters.erase(i);
-				continue;
-			}
-			auto when = i.value().when;
-			if (!notifyItem || next > when) {
-				next = when;
-				notifyItem = history->currentNotification();
-				notifyHistory = history;
-			}
-			++i;
-		}
-		if (notifyItem) {
-			if (next > ms) {
-				if (nextAlert && nextAlert < next) {
-					next = nextAlert;
-					nextAlert = 0;
-				}
-				_waitTimer.callOnce(next - ms);
-				break;
-			} else {
-				const auto isForwarded = notifyItem->Has<HistoryMessageForwarded>();
-				const auto isAlbum = notifyItem->groupId();
-
-				auto groupedItem = (isForwarded || isAlbum) ? notifyItem : nullptr; // forwarded and album notify grouping
-				auto forwardedCount = isForwarded ? 1 : 0;
-
-				const auto history = notifyItem->history();
-				const auto j = _whenMaps.find(history);
-				if (j == _whenMaps.cend()) {
-					history->clearNotifications();
-				} else {
-					auto nextNotify = (HistoryItem*)nullptr;
-					do {
-						history->skipNotification();
-						if (!history->hasNotification()) {
-							break;
-						}
-
-						j.value().remove((groupedItem ? groupedItem : notifyItem)->id);
-						do {
-							const auto k = j.value().constFind(history->currentNotification()->id);
-							if (k != j.value().cend()) {
-								nextNotify = history->currentNotification();
-								_waiters.insert(notifyHistory, Waiter(k.key(), k.value(), 0));
-								break;
+				} while (history->hasNotification());
+				if (nextNotify) {
+					if (groupedItem) {
+						const auto canNextBeGrouped = (isForwarded && nextNotify->Has<HistoryMessageForwarded>())
+							|| (isAlbum && nextNotify->groupId());
+						const auto nextItem = canNextBeGrouped ? nextNotify : nullptr;
+						if (nextItem
+							&& qAbs(int64(nextItem->date()) - int64(groupedItem->date())) < 2) {
+							if (isForwarded
+								&& groupedItem->author() == nextItem->author()) {
+								++forwardedCount;
+								groupedItem = nextItem;
+								continue;
 							}
-							history->skipNotification();
-						} while (history->hasNotification());
-						if (nextNotify) {
-							if (groupedItem) {
-								const auto canNextBeGrouped = (isForwarded && nextNotify->Has<HistoryMessageForwarded>())
-									|| (isAlbum && nextNotify->groupId());
-								const auto nextItem = canNextBeGrouped ? nextNotify : nullptr;
-								if (nextItem
-									&& qAbs(int64(nextItem->date()) - int64(groupedItem->date())) < 2) {
-									if (isForwarded
-										&& groupedItem->author() == nextItem->author()) {
-										++forwardedCount;
-										groupedItem = nextItem;
-										continue;
-									}
-									if (isAlbum
-										&& groupedItem->groupId() == nextItem->groupId()) {
-										groupedItem = nextItem;
-										continue;
-									}
-								}
+							if (isAlbum
+								&& groupedItem->groupId() == nextItem->groupId()) {
+								groupedItem = nextItem;
+								continue;
 							}
-							nextNotify = nullptr;
 						}
-					} while (nextNotify);
+					} else if (nextWhen <= ms
+						&& !nextNotify->Has<HistoryMessageForwarded>()
+						&& !nextNotify->groupId()) {
+						++messagesCount;
+						notifyItem = nextNotify;
+						continue;
+					}
+					nextNotify = nullptr;
 				}
+			} while (nextNotify);
+		}
 
-				if (!_lastHistoryItemId && groupedItem) {
-					_lastHistoryItemId = groupedItem->fullId();
-				}
+		if (!_lastHistoryItemId && groupedItem) {
+			_lastHistoryItemId = groupedItem->fullId();
+		}
 
-				// If the current notification is grouped.
-				if (isAlbum || isForwarded) {
-					// If the previous notification is grouped
-					// then reset the timer.
-					if (_waitForAllGroupedTimer.isActive()) {
-						_waitForAllGroupedTimer.cancel();
-						// If this is not the same group
-						// then show the previous group immediately.
-						if (!isSameGroup(groupedItem)) {
-							showGrouped();
-						}
-					}
-					// We have to wait until all the messages in this group are loaded.
-					_lastForwardedCount += forwardedCount;
-					_lastHistoryItemId = groupedItem->fullId();
-					_waitForAllGroupedTimer.callOnce(kWaitingForAllGroupedDelay);
-				} else {
-					// If the current notification is not grouped
-					// then there is no reason to wait for the timer
-					// to show the previous notification.
+		// If the current notification is grouped.
+		if (isAlbum || isForwarded) {
+			// If the previous notification is grouped
+			// then reset the timer.
+			if (_waitForAllGroupedTimer.isActive()) {
+				_waitForAllGroupedTimer.cancel();
+				// If this is not the same group
+				// then show the previous group immediately.
+				if (!isSameGroup(groupedItem)) {
 					showGrouped();
-					_manager->showNotification(notifyItem, forwardedCount);
-				}
-
-				if (!history->hasNotification()) {
-					_waiters.remove(history);
-					_whenMaps.remove(history);
-					continue;
 				}
 			}
+			// We have to wait until all the messages in this group are loaded.
+			_lastForwardedCount += forwardedCount;
+			_lastHistoryItemId = groupedItem->fullId();
+			_waitForAllGroupedTimer.callOnce(kWaitingForAllGroupedDelay);
 		} else {
-			break;
+			// If the current notification is not grouped
+			// then there is no reason to wait for the timer
+			// to show the previous notification.
+			showGrouped();
+			_manager->showNotification(notifyItem, forwardedCount, messagesCount);
+			notificationShown(ms);
+		}
+
+		if (!history->hasNotification()) {
+			_waiters.remove(history);
+			_whenMaps.remove(history);
 		}
 	}
 	if (nextAlert) {
@@ -423,6 +411,98 @@ void System::showNext() {
 	}
 }
 
+void System::addWaiter(
+		Waiters &to,
+		History *history,
+		const Waiter &waiter) {
+	to.insert(history, waiter);
+	if (&to != &_waiters) {
+		return;
+	}
+	const auto compact = (_dueQueue.size()
+		> 2 * size_t(_waiters.size()) + kDueQueueCompactSlack);
+	if (compact) {
+		_dueQueue.clear();
+		for (auto i = _waiters.cbegin(), e = _waiters.cend(); i != e; ++i) {
+			_dueQueue.push_back({ i.value().when, i.key() });
+		}
+		std::make_heap(
+			begin(_dueQueue),
+			end(_dueQueue),
+			std::greater<>());
+	} else {
+		_dueQueue.push_back({ waiter.when, history });
+		std::push_heap(
+			begin(_dueQueue),
+			end(_dueQueue),
+			std::greater<>());
+	}
+}
+
+History *System::nextWaiter() {
+	const auto pop = [&] {
+		std::pop_heap(begin(_dueQueue), end(_dueQueue), std::greater<>());
+		_dueQueue.pop_back();
+	};
+	while (!_dueQueue.empty()) {
+		const auto [when, history] = _dueQueue.front();
+		auto i = _waiters.find(history);
+		if (i == _waiters.end() || i.value().when != when) {
+			pop();
+			continue;
+		}
+		const auto current = history->currentNotification();
+		if (current && current->id != i.value().msg) {
+			auto j = _whenMaps.find(history);
+			if (j == _whenMaps.end()) {
+				history->clearNotifications();
+				_waiters.erase(i);
+				pop();
+				continue;
+			}
+			do {
+				auto k = j.value().constFind(history->currentNotification()->id);
+				if (k != j.value().cend()) {
+					i.value().msg = k.key();
+					i.value().when = k.value();
+					break;
+				}
+				history->skipNotification();
+			} while (history->currentNotification());
+		}
+		if (!history->currentNotification()) {
+			_whenMaps.remove(history);
+			_waiters.erase(i);
+			pop();
+			continue;
+		} else if (i.value().when != when) {
+			const auto waiter = i.value();
+			pop();
+			addWaiter(_waiters, history, waiter);
+			continue;
+		}
+		return history;
+	}
+	return nullptr;
+}
+
+crl::time System::rateLimitedTill(crl::time now) {
+	while (!_shownTimes.empty()
+		&& _shownTimes.front() + kRateLimitInterval <= now) {
+		_shownTimes.pop_front();
+	}
+	return (int(_shownTimes.size()) < kRateLimitCount)
+		? crl::time(0)
+		: (_shownTimes.front() + kRateLimitInterval);
+}
+
+void System::notificationShown(crl::time now) {
+	_shownTimes.push_back(now);
+	while (int(_shownTimes.size()) > kRateLimitCount) {
+		_shownTimes.pop_front();
+	}
+}
+
 void System::ensureSoundCreated() {
 	if (_soundTrack) {
 		return;
@@ -511,16 +591,23 @@ void Manager::notificationReplied(
 	Auth().api().sendMessage(std::move(message));
 }
 
-void NativeManager::doShowNotification(HistoryItem *item, int forwardedCount) {
+void NativeManager::doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int messagesCount) {
 	const auto options = getNotificationOptions(item);
 
 	const auto title = options.hideNameAndPhoto ? qsl("Bettergram") : item->history()->peer->name;
 	const auto subtitle = options.hideNameAndPhoto ? QString() : item->notificationHeader();
 	const auto text = options.hideMessageText
 		? lang(lng_notification_preview)
-		: (forwardedCount < 2
-			? (item->groupId() ? lang(lng_in_dlg_album) : item->notificationText())
-			: lng_forward_messages(lt_count, forwardedCount));
+		: (forwardedCount > 1)
+		? lng_forward_messages(lt_count, forwardedCount)
+		: (messagesCount > 1)
+		? lng_notification_messages(lt_count, messagesCount)
+		: item->groupId()
+		? lang(lng_in_dlg_album)
+		: item->notificationText();
 
 	doShowNativeNotification(
 		item->history()->peer,
@@ -77,14 +77,6 @@ public:
 	~System();
 
 private:
-	void showNext();
-	void showGrouped();
-	void ensureSoundCreated();
-
-	AuthSession *_authSession = nullptr;
-
-	QMap<History*, QMap<MsgId, crl::time>> _whenMaps;
-
 	struct Waiter {
 		Waiter(MsgId msg, crl::time when, PeerData *notifyBy)
 		: msg(msg)
@@ -96,8 +88,38 @@ private:
 		PeerData *notifyBy;
 	};
 	using Waiters = QMap<History*, Waiter>;
+
+	void showNext();
+	void showGrouped();
+	void ensureSoundCreated();
+
+	void addWaiter(Waiters &to, History *history, const Waiter &waiter);
+	History *nextWaiter();
+	crl::time rateLimitedTill(crl::time now);
+	void notificationShown(crl::time now);
+
+	AuthSession *_authSession = nullptr;
+
+	QMap<History*, QMap<MsgId, crl::time>> _whenMaps;
+
 	Waiters _waiters;
 	Waiters _settingWaiters;
+
+	// Min-heap of (when, history) for _waiters, entries that don't match
+	// the current waiter of the history any more are skipped when popped.
+	struct Due {
+		crl::time when = 0;
+		History *history = nullptr;
+
+		inline bool operator>(const Due &other) const {
+			return (when > other.when);
+		}
+	};
+	std::vector<Due> _dueQueue;
+
+	// Times when the last notifications were shown, for rate limiting.
+	std::deque<crl::time> _shownTimes;
+
 	base::Timer _waitTimer;
 	base::Timer _waitForAllGroupedTimer;
 
@@ -119,8 +141,13 @@ public:
 	Manager(System *system) : _system(system) {
 	}
 
-	void showNotification(HistoryItem *item, int forwardedCount) {
-		doShowNotification(item, forwardedCount);
+	// Shows a single notification for messagesCount > 1 of the newest
+	// messages in the item history, ending with the item.
+	void showNotification(
+			HistoryItem *item,
+			int forwardedCount,
+			int messagesCount) {
+		doShowNotification(item, forwardedCount, messagesCount);
 	}
 	void updateAll() {
 		doUpdateAll();
@@ -159,7 +186,10 @@ protected:
 	}
 
 	virtual void doUpdateAll() = 0;
-	virtual void doShowNotification(HistoryItem *item, int forwardedCount) = 0;
+	virtual void doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int messagesCount) = 0;
 	virtual void doClearAll() = 0;
 	virtual void doClearAllFast() = 0;
 	virtual void doClearFromItem(HistoryItem *item) = 0;
@@ -190,7 +220,10 @@ protected:
 	}
 	void doClearFromItem(HistoryItem *item) override {
 	}
-	void doShowNotification(HistoryItem *item, int forwardedCount) override;
+	void doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int messagesCount) override;
 
 	virtual void doShowNativeNotification(PeerData *peer, MsgId msgId, const QString &title, const QString &subtitle, const QString &msg, bool hideNameAndPhoto, bool hideReplyButton) = 0;
 
@@ -66,12 +66,14 @@ Manager::Manager(System *system)
 
 Manager::QueuedNotification::QueuedNotification(
 	not_null<HistoryItem*> item
-	, int forwardedCount)
+	, int forwardedCount
+	, int messagesCount)
 : history(item->history())
 , peer(history->peer)
 , author((!peer->isUser() && !item->isPost()) ? item->author().get() : nullptr)
 , item((forwardedCount < 2) ? item.get() : nullptr)
-, forwardedCount(forwardedCount) {
+, forwardedCount(forwardedCount)
+, messagesCount(messagesCount) {
 }
 
 QPixmap Manager::hiddenUserpicPlaceholder() const {
@@ -191,27 +193,71 @@ void Manager::showNextFromQueue() {
 		return;
 	}
 
-	auto startPosition = notificationStartPosition();
-	auto startShift = 0;
-	auto shiftDirection = notificationShiftDirection();
 	do {
 		auto queued = _queuedNotifications.front();
 		_queuedNotifications.pop_front();
 
-		auto notification = std::make_unique<Notification>(
+		_notifications.push_back(createNotification(queued));
+		--count;
+	} while (count > 0 && !_queuedNotifications.empty());
+
+	_positionsOutdated = true;
+	checkLastInput();
+}
+
+auto Manager::createNotification(const QueuedNotification &queued)
+-> std::unique_ptr<Notification> {
+	const auto startPosition = notificationStartPosition();
+	const auto startShift = 0;
+	const auto shiftDirection = notificationShiftDirection();
+	if (_unusedNotifications.empty()) {
+		return std::make_unique<Notification>(
 			this,
 			queued.history,
 			queued.peer,
 			queued.author,
 			queued.item,
 			queued.forwardedCount,
+			queued.messagesCount,
 			startPosition, startShift, shiftDirection);
-		_notifications.push_back(std::move(notification));
-		--count;
-	} while (count > 0 && !_queuedNotifications.empty());
-
-	_positionsOutdated = true;
-	checkLastInput();
+	}
+	auto result = std::move(_unusedNotifications.back());
+	_unusedNotifications.pop_back();
+	result->reuse(
+		queued.history,
+		queued.peer,
+		queued.author,
+		queued.item,
+		queued.forwardedCount,
+		queued.messagesCount,
+		startPosition, startShift, shiftDirection);
+	return result;
+}
+
+bool Manager::coalesceNotification(
+		not_null<HistoryItem*> item,
+		int forwardedCount,
+		int messagesCount) {
+	if (forwardedCount > 1) {
+		return false;
+	}
+	const auto history = item->history();
+	for (auto i = _queuedNotifications.rbegin(); i != _queuedNotifications.rend(); ++i) {
+		if (i->history == history && i->item) {
+			*i = QueuedNotification(
+				item,
+				forwardedCount,
+				i->messagesCount + messagesCount);
+			return true;
+		}
+	}
+	for_const (auto &notification, _notifications) {
+		if (notification->coalesce(item, messagesCount)) {
+			checkLastInput();
+			return true;
+		}
+	}
+	return false;
 }
 
 void Manager::moveWidgets() {
@@ -276,10 +322,14 @@ void Manager::removeWidget(internal::Widget *remove) {
 	if (remove == _hideAll.get()) {
 		_hideAll.reset();
 	} else if (remove) {
-		auto it = std::find_if(_notifications.cbegin(), _notifications.cend(), [remove](auto &item) {
+		auto it = std::find_if(_notifications.begin(), _notifications.end(), [remove](auto &item) {
 			return item.get() == remove;
 		});
-		if (it != _notifications.cend()) {
+		if (it != _notifications.end()) {
+			if (int(_unusedNotifications.size()) < Global::NotificationsCount()) {
+				(*it)->recycle();
+				_unusedNotifications.push_back(std::move(*it));
+			}
 			_notifications.erase(it);
 			_positionsOutdated = true;
 		}
@@ -287,8 +337,15 @@ void Manager::removeWidget(internal::Widget *remove) {
 	showNextFromQueue();
 }
 
-void Manager::doShowNotification(HistoryItem *item, int forwardedCount) {
-	_queuedNotifications.push_back(QueuedNotification(item, forwardedCount));
+void Manager::doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int messagesCount) {
+	if (coalesceNotification(item, forwardedCount, messagesCount)) {
+		return;
+	}
+	_queuedNotifications.push_back(
+		QueuedNotification(item, forwardedCount, messagesCount));
 	showNextFromQueue();
 }
 
@@ -303,6 +360,7 @@ void Manager::doClearAll() {
 void Manager::doClearAllFast() {
 	_queuedNotifications.clear();
 	base::take(_notifications);
+	base::take(_unusedNotifications);
 	base::take(_hideAll);
 }
 
@@ -372,6 +430,22 @@ Widget::Widget(Manager *manager, QPoint startPosition, int shift, Direction shif
 	_a_opacity.start([this] { opacityAnimationCallback(); }, 0., 1., st::notifyFastAnim);
 }
 
+void Widget::reuse(
+		QPoint startPosition,
+		int shift,
+		Direction shiftDirection) {
+	_hiding = false;
+	_deleted = false;
+	_hidingDelayed = {};
+	_startPosition = startPosition;
+	_direction = shiftDirection;
+	a_shift = anim::value(shift);
+	_a_shift.stop();
+	setWindowOpacity(0.);
+
+	_a_opacity.start([this] { opacityAnimationCallback(); }, 0., 1., st::notifyFastAnim);
+}
+
 void Widget::destroyDelayed() {
 	hide();
 	if (_deleted) return;
@@ -500,6 +574,7 @@ Notification::Notification(
 	PeerData *author,
 	HistoryItem *msg,
 	int forwardedCount,
+	int messagesCount,
 	QPoint startPosition,
 	int shift,
 	Direction shiftDirection)
@@ -510,6 +585,7 @@ Notification::Notification(
 , _author(author)
 , _item(msg)
 , _forwardedCount(forwardedCount)
+, _messagesCount(messagesCount)
 , _close(this, st::notifyClose)
 , _reply(this, langFactory(lng_notification_reply), st::defaultBoxButton) {
 	subscribe(Lang::Current().updated(), [this] { refreshLang(); });
@@ -555,6 +631,75 @@ Notification::Notification(
 	show();
 }
 
+void Notification::recycle() {
+	QCoreApplication::instance()->removeEventFilter(this);
+	_hideTimer.stop();
+	_replySend.destroy();
+	_replyArea.destroy();
+	_background.destroy();
+	_actionsVisible = false;
+	a_actionsOpacity.finish();
+	_reply->clearState();
+	_reply->hide();
+	_history = nullptr;
+	_peer = nullptr;
+	_author = nullptr;
+	_item = nullptr;
+	_cache = QPixmap();
+}
+
+void Notification::reuse(
+		History *history,
+		PeerData *peer,
+		PeerData *author,
+		HistoryItem *item,
+		int forwardedCount,
+		int messagesCount,
+		QPoint startPosition,
+		int shift,
+		Direction shiftDirection) {
+	_started = crl::now();
+	_history = history;
+	_peer = peer;
+	_author = author;
+	_item = item;
+	_forwardedCount = forwardedCount;
+	_messagesCount = messagesCount;
+	_waitingForInput = true;
+	Widget::reuse(startPosition, shift, shiftDirection);
+
+	auto position = computePosition(st::notifyMinHeight);
+	updateGeometry(position.x(), position.y(), st::notifyWidth, st::notifyMinHeight);
+	updateReplyGeometry();
+
+	_userpicLoaded = _peer ? _peer->userpicLoaded() : true;
+	updateNotifyDisplay();
+
+	show();
+}
+
+bool Notification::coalesce(
+		not_null<HistoryItem*> item,
+		int messagesCount) {
+	if (_history != item->history()
+		|| !_item
+		|| _forwardedCount > 1
+		|| _replyArea
+		|| isHidden()) {
+		return false;
+	}
+	_started = crl::now();
+	_item = item;
+	_author = (!_peer->isUser() && !item->isPost())
+		? item->author().get()
+		: nullptr;
+	_messagesCount += messagesCount;
+	_waitingForInput = true;
+	stopHiding();
+	updateNotifyDisplay();
+	return true;
+}
+
 void Notification::updateReplyGeometry() {
 	_reply->moveToRight(_replyPadding, height() - _reply->height() - _replyPadding);
 }
@@ -679,7 +824,11 @@ void Notification::updateNotifyDisplay() {
 			const HistoryItem *textCachedFor = 0;
 			Text itemTextCache(itemWidth);
 			QRect r(st::notifyPhotoPos.x() + st::notifyPhotoSize + st::notifyTextLeft, st::notifyItemTop + st::msgNameFont->height, itemWidth, 2 * st::dialogsTextFont->height);
-			if (_item) {
+			if (_item && _messagesCount > 1) {
+				p.setFont(st::dialogsTextFont);
+				p.setPen(st::dialogsTextFg);
+				p.drawText(r.left(), r.top() + st::dialogsTextFont->ascent, lng_notification_messages(lt_count, _messagesCount));
+			} else if (_item) {
 				auto active = false, selected = false;
 				_item->drawInDialog(
 					p,
@@ -50,13 +50,24 @@ private:
 	QPixmap hiddenUserpicPlaceholder() const;
 
 	void doUpdateAll() override;
-	void doShowNotification(HistoryItem *item, int forwardedCount) override;
+	void doShowNotification(
+		HistoryItem *item,
+		int forwardedCount,
+		int messagesCount) override;
 	void doClearAll() override;
 	void doClearAllFast() override;
 	void doClearFromHistory(History *history) override;
 	void doClearFromItem(HistoryItem *item) override;
 
+	struct QueuedNotification;
+
 	void showNextFromQueue();
+	std::unique_ptr<Notification> createNotification(
+		const QueuedNotification &queued);
+	bool coalesceNotification(
+		not_null<HistoryItem*> item,
+		int forwardedCount,
+		int messagesCount);
 	void unlinkFromShown(Notification *remove);
 	void startAllHiding();
 	void stopAllHiding();
@@ -75,19 +86,26 @@ private:
 
 	std::vector<std::unique_ptr<Notification>> _notifications;
 
+	// Hidden notification widgets kept for the next ones to be shown.
+	std::vector<std::unique_ptr<Notification>> _unusedNotifications;
+
 	std::unique_ptr<HideAllButton> _hideAll;
 
 	bool _positionsOutdated = false;
 	base::Timer _inputCheckTimer;
 
 	struct QueuedNotification {
-		QueuedNotification(not_null<HistoryItem*> item, int forwardedCount);
+		QueuedNotification(
+			not_null<HistoryItem*> item,
+			int forwardedCount,
+			int messagesCount);
 
 		not_null<History*> history;
 		not_null<PeerData*> peer;
 		PeerData *author;
 		HistoryItem *item;
 		int forwardedCount;
+		int messagesCount;
 	};
 	std::deque<QueuedNotification> _queuedNotifications;
 
@@ -121,6 +139,7 @@ public:
 	void addToShift(int add);
 
 protected:
+	void reuse(QPoint startPosition, int shift, Direction shiftDirection);
 	void hideSlow();
 	void hideFast();
 	void hideStop();
@@ -165,7 +184,15 @@ protected:
 
 class Notification : public Widget {
 public:
-	Notification(Manager *manager, History *history, PeerData *peer, PeerData *author, HistoryItem *item, int forwardedCount, QPoint startPosition, int shift, Direction shiftDirection);
+	Notification(Manager *manager, History *history, PeerData *peer, PeerData *author, HistoryItem *item, int forwardedCount, int messagesCount, QPoint startPosition, int shift, Direction shiftDirection);
+
+	// Called only by Manager: recycle() when the widget is hidden and
+	// put aside, reuse() when it is taken for the next notification.
+	void recycle();
+	void reuse(History *history, PeerData *peer, PeerData *author, HistoryItem *item, int forwardedCount, int messagesCount, QPoint startPosition, int shift, Direction shiftDirection);
+
+	// Shows the newest message of the same history as a summary in place.
+	bool coalesce(not_null<HistoryItem*> item, int messagesCount);
 
 	void startHiding();
 	void stopHiding();
@@ -222,6 +249,7 @@ private:
 	PeerData *_author;
 	HistoryItem *_item;
 	int _forwardedCount;
+	int _messagesCount;
 	object_ptr<Ui::IconButton> _close;
 	object_ptr<Ui::RoundButton> _reply;
 	object_ptr<Background> _background = { nullptr };
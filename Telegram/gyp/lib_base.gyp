@@ -50,6 +50,7 @@
       '<(src_loc)/base/algorithm.h',
       '<(src_loc)/base/assertion.h',
       '<(src_loc)/base/basic_types.h',
+      '<(src_loc)/base/binary_delta.h',
       '<(src_loc)/base/binary_guard.h',
       '<(src_loc)/base/build_config.h',
       '<(src_loc)/base/bytes.h',
@@ -0,0 +1,216 @@
+'''
+This file is part of Bettergram.
+
+For license and copyright information please follow this link:
+https://github.com/bettergram/bettergram/blob/master/LEGAL
+'''
+from __future__ import print_function
+import sys
+import json
+import time
+import random
+import hashlib
+import threading
+
+try:
+  from http.server import BaseHTTPRequestHandler, HTTPServer
+  from socketserver import ThreadingMixIn
+  from urllib.parse import urlparse, parse_qs
+except ImportError:
+  from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+  from SocketServer import ThreadingMixIn
+  from urlparse import urlparse, parse_qs
+
+# Local stand-in for the crypto prices server.
+#
+# Usage: prices_stream_server.py [port]
+# Then start a debug build of Bettergram with
+# BETTERGRAM_PRICES_URL=http://127.0.0.1:<port>
+#
+# /currencies, /coins and /stats answer with ETag and 304 Not Modified,
+# /stream sends "prices" events with changed coins only, "stats" events
+# and heartbeat comments, so the client idle timer never fires.
+
+coins_count = 200
+price_interval = 1.0
+stats_interval = 30.0
+heartbeat_interval = 15.0
+
+lock = threading.Lock()
+coins = []
+stats = {}
+version = 0
+
+def init_coins():
+  for i in range(coins_count):
+    coins.append({
+      'type': 'coin',
+      'code': 'C%03d' % i,
+      'name': 'Coin %d' % i,
+      'url': 'c%03d' % i,
+      'icon': 'c%03d.png' % i,
+      'rank': i + 1,
+      'price': random.uniform(0.01, 10000.0),
+      'delta': { 'day': 1.0, 'minute': 1.0 },
+    })
+  update_stats()
+
+def update_stats():
+  stats.clear()
+  stats.update({
+    'success': True,
+    'cap': sum(coin['price'] * 1000000 for coin in coins),
+    'btcDominance': 0.5,
+    'freq': 60000,
+    'data': [to_stats(coin) for coin in coins[:3]],
+  })
+
+def to_stats(coin):
+  return {
+    'code': coin['code'],
+    'name': coin['name'],
+    'rank': coin['rank'],
+    'price': coin['price'],
+    'delta': coin['delta'],
+  }
+
+def to_delta(coin):
+  return { 'code': coin['code'], 'price': coin['price'], 'delta': coin['delta'] }
+
+def tick():
+  global version
+  changed = random.sample(coins, max(1, coins_count // 20))
+  for coin in changed:
+    factor = random.uniform(0.99, 1.01)
+    coin['price'] *= factor
+    coin['delta']['minute'] = factor
+    coin['delta']['day'] *= factor
+  version += 1
+  return changed
+
+def etag(body):
+  return '"%s"' % hashlib.sha1(body).hexdigest()
+
+def select(query):
+  only = query.get('only', [''])[0]
+  result = coins
+  if only:
+    codes = set(only.split(','))
+    result = [coin for coin in result if coin['code'] in codes]
+  search = query.get('search', [''])[0].lower()
+  if search:
+    result = [coin for coin in result
+      if search in coin['code'].lower() or search in coin['name'].lower()]
+  sort = query.get('sort', ['rank'])[0]
+  if sort != 'none':
+    key = sort if sort in ('rank', 'price', 'code', 'name') else 'rank'
+    reverse = query.get('order', ['ascending'])[0] == 'descending'
+    result = sorted(result, key=lambda coin: coin[key], reverse=reverse)
+  offset = int(query.get('offset', ['0'])[0])
+  limit = int(query.get('limit', [str(coins_count)])[0])
+  return result[offset:offset + limit]
+
+class ThreadingServer(ThreadingMixIn, HTTPServer):
+  daemon_threads = True
+
+class Handler(BaseHTTPRequestHandler):
+  protocol_version = 'HTTP/1.1'
+
+  def do_GET(self):
+    url = urlparse(self.path)
+    query = parse_qs(url.query)
+    if url.path == '/stream':
+      self.stream(query)
+      return
+    with lock:
+      if url.path == '/currencies':
+        body = {
+          'success': True,
+          'coinsUrlBase': 'https://www.livecoinwatch.com/price/',
+          'coinsIcon32Base': 'https://www.livecoinwatch.com/images/icons32/',
+          'data': select(query),
+        }
+      elif url.path == '/coins':
+        body = {
+          'success': True,
+          'total': coins_count,
+          'data': [to_delta(coin) for coin in select(query)],
+        }
+      elif url.path == '/stats':
+        body = stats
+      else:
+        self.send_error(404)
+        return
+      data = json.dumps(body).encode('utf-8')
+    tag = etag(data)
+    if self.headers.get('If-None-Match') == tag:
+      self.send_response(304)
+      self.send_header('ETag', tag)
+      self.send_header('Content-Length', '0')
+      self.end_headers()
+      return
+    self.send_response(200)
+    self.send_header('Content-Type', 'application/json')
+    self.send_header('ETag', tag)
+    self.send_header('Content-Length', str(len(data)))
+    self.end_headers()
+    self.wfile.write(data)
+
+  def stream(self, query):
+    only = query.get('only', [''])[0]
+    codes = set(only.split(',')) if only else None
+    self.send_response(200)
+    self.send_header('Content-Type', 'text/event-stream')
+    self.send_header('Cache-Control', 'no-cache')
+    self.send_header('Connection', 'close')
+    self.end_headers()
+    self.close_connection = True
+    last_version = version
+    last_stats = time.time()
+    last_heartbeat = time.time()
+    try:
+      while True:
+        time.sleep(price_interval)
+        now = time.time()
+        with lock:
+          if version == last_version:
+            continue
+          last_version = version
+          changed = [to_delta(coin) for coin in coins
+            if coin['delta']['minute'] != 1.0
+              and (codes is None or coin['code'] in codes)]
+          stats_data = json.dumps(stats) if now - last_stats >= stats_interval else None
+        if changed:
+          self.send_event('prices', json.dumps({ 'data': changed }))
+          last_heartbeat = now
+        if stats_data:
+          self.send_event('stats', stats_data)
+          last_stats = now
+          last_heartbeat = now
+        if now - last_heartbeat >= heartbeat_interval:
+          self.wfile.write(b': heartbeat\n\n')
+          self.wfile.flush()
+          last_heartbeat = now
+    except (IOError, OSError):
+      pass
+
+  def send_event(self, event, data):
+    self.wfile.write(('event: %s\ndata: %s\n\n' % (event, data)).encode('utf-8'))
+    self.wfile.flush()
+
+def ticker():
+  while True:
+    time.sleep(price_interval)
+    with lock:
+      for coin in coins:
+        coin['delta']['minute'] = 1.0
+      tick()
+      update_stats()
+
+port = int(sys.argv[1]) if len(sys.argv) > 1 else 8765
+init_coins()
+thread = threading.Thread(target=ticker)
+thread.daemon = True
+thread.start()
+print('Serving prices at http://127.0.0.1:%d' % port)
+ThreadingServer(('127.0.0.1', port), Handler).serve_forever()
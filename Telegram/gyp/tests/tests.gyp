@@ -56,6 +56,76 @@
       '<(src_loc)/base/algorithm.h',
       '<(src_loc)/base/algorithm_tests.cpp',
     ],
+  }, {
+    'target_name': 'tests_bettergram',
+    'includes': [
+      'common_test.gypi',
+      '../qt_moc.gypi',
+      '../pch.gypi',
+    ],
+    'variables': {
+      'pch_source': '<(src_loc)/bettergram/bettergram_tests_pch.cpp',
+      'pch_header': '<(src_loc)/bettergram/bettergram_tests_pch.h',
+    },
+    'dependencies': [
+      '../crl.gyp:crl',
+    ],
+    'copies': [{
+      'destination': '<(PRODUCT_DIR)/tests_bettergram_data',
+      'files': [
+        '<(src_loc)/bettergram/test_data/coins.json',
+        '<(src_loc)/bettergram/test_data/currencies.json',
+        '<(src_loc)/bettergram/test_data/resources.json',
+        '../../Resources/bettergram/default-resources.json',
+      ],
+    }],
+    'sources': [
+      '<(src_loc)/bettergram/abstractremotefile.cpp',
+      '<(src_loc)/bettergram/abstractremotefile.h',
+      '<(src_loc)/bettergram/basearticlegrouppreviewitem.cpp',
+      '<(src_loc)/bettergram/basearticlegrouppreviewitem.h',
+      '<(src_loc)/bettergram/basearticlepreviewitem.cpp',
+      '<(src_loc)/bettergram/basearticlepreviewitem.h',
+      '<(src_loc)/bettergram/bettergram_tests.cpp',
+      '<(src_loc)/bettergram/bettergram_tests_support.cpp',
+      '<(src_loc)/bettergram/cryptoprice.cpp',
+      '<(src_loc)/bettergram/cryptoprice.h',
+      '<(src_loc)/bettergram/cryptopricehistory.cpp',
+      '<(src_loc)/bettergram/cryptopricehistory.h',
+      '<(src_loc)/bettergram/cryptopricelist.cpp',
+      '<(src_loc)/bettergram/cryptopricelist.h',
+      '<(src_loc)/bettergram/cryptopricesearchindex.cpp',
+      '<(src_loc)/bettergram/cryptopricesearchindex.h',
+      '<(src_loc)/bettergram/imagefromsite.cpp',
+      '<(src_loc)/bettergram/imagefromsite.h',
+      '<(src_loc)/bettergram/remoteimage.cpp',
+      '<(src_loc)/bettergram/remoteimage.h',
+      '<(src_loc)/bettergram/remotejsonresource.cpp',
+      '<(src_loc)/bettergram/remotejsonresource.h',
+      '<(src_loc)/bettergram/remotetempdata.cpp',
+      '<(src_loc)/bettergram/remotetempdata.h',
+      '<(src_loc)/bettergram/resourcegroup.cpp',
+      '<(src_loc)/bettergram/resourcegroup.h',
+      '<(src_loc)/bettergram/resourcegrouplist.cpp',
+      '<(src_loc)/bettergram/resourcegrouplist.h',
+      '<(src_loc)/bettergram/resourceitem.cpp',
+      '<(src_loc)/bettergram/resourceitem.h',
+      '<(src_loc)/bettergram/rsschannel.cpp',
+      '<(src_loc)/bettergram/rsschannel.h',
+      '<(src_loc)/bettergram/rssitem.cpp',
+      '<(src_loc)/bettergram/rssitem.h',
+      '<(src_loc)/bettergram/siteimagescanner.cpp',
+      '<(src_loc)/bettergram/siteimagescanner.h',
+    ],
+  }, {
+    'target_name': 'tests_binary_delta',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'sources': [
+      '<(src_loc)/base/binary_delta.h',
+      '<(src_loc)/base/binary_delta_tests.cpp',
+    ],
   }, {
     'target_name': 'tests_flags',
     'includes': [
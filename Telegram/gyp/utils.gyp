@@ -110,6 +110,7 @@
     'sources': [
       '<(src_loc)/_other/packer.cpp',
       '<(src_loc)/_other/packer.h',
+      '<(src_loc)/base/binary_delta.h',
     ],
     'configurations': {
       'Debug': {